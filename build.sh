@@ -68,6 +68,8 @@ g++ -std=c++17 -O2 -mwindows \
     src/gui/gui_output.cpp \
     src/logic/logic.cpp \
     src/logic/csprng.cpp \
+    src/logic/encoding.cpp \
+    src/logic/wordlist.cpp \
     src/platform/dx11.cpp \
     src/logging/logger.cpp \
     src/entropy/clock_drift/clock_drift.cpp \
@@ -75,11 +77,18 @@ g++ -std=c++17 -O2 -mwindows \
     src/entropy/keystroke/keystroke.cpp \
     src/entropy/mouse/mouse.cpp \
     src/entropy/microphone/microphone.cpp \
+    src/entropy/cpu_hwrng/cpu_hwrng.cpp \
     src/entropy/pool.cpp \
+    src/entropy/collection_policy.cpp \
+    src/entropy/noise_export.cpp \
+    src/platform/mapped_file.cpp \
     src/crypto/sha512.cpp \
     src/crypto/hkdf.cpp \
     src/crypto/chacha20.cpp \
     src/crypto/aes.cpp \
+    src/crypto/quad_layer.cpp \
+    src/stats/quick_battery.cpp \
+    src/stats/stats_math.cpp \
     external/imgui/imgui.cpp \
     external/imgui/imgui_draw.cpp \
     external/imgui/imgui_tables.cpp \
@@ -1,9 +1,15 @@
 #!/bin/bash
-# Build the standalone TRNG generator for piping to test suites
+# Build the standalone TRNG generator for piping to test suites (MinGW or Linux)
 # Usage: ./build_gen.sh
 
 set -e
 
+# OS CSPRNG seed source: BCryptGenRandom on Windows
+case "$(uname -s)" in
+  MINGW*|MSYS*|CYGWIN*) SYSLIBS="-lbcrypt" ;;
+  *)                    SYSLIBS="" ;;
+esac
+
 echo "Building trng_gen.exe..."
 
 g++ -O3 -o trng_gen.exe \
@@ -12,10 +18,19 @@ g++ -O3 -o trng_gen.exe \
   src/crypto/hkdf.cpp \
   src/crypto/chacha20.cpp \
   src/crypto/aes.cpp \
-  -I src -std=c++17 -lpthread
+  src/platform/stream_output.cpp \
+  src/platform/numa_topology.cpp \
+  src/platform/system_seed.cpp \
+  src/crypto/quad_layer.cpp \
+  src/stats/quick_battery.cpp \
+  src/stats/stats_math.cpp \
+  -I src -std=c++17 -lpthread $SYSLIBS
 
 echo "Done! Built trng_gen.exe"
 echo ""
-echo "Quick test:  ./trng_gen.exe | head -c 1M > test.bin"
+echo "Quick test:  ./trng_gen.exe -n 1M -o test.bin"
 echo "PractRand:   ./trng_gen.exe | ./RNG_test stdin"
 echo "Dieharder:   ./trng_gen.exe | dieharder -a -g 200"
+echo "Benchmark:   ./trng_gen.exe --bench > bench.json"
+echo "Self-check:  ./trng_gen.exe --check | ./RNG_test stdin"
+echo "Options:     ./trng_gen.exe --help"
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build the input-event replay harness for the mouse/keystroke hook paths
+# Usage: ./build_input_replay.sh
+
+set -e
+
+echo "Building input_replay..."
+
+g++ -O2 -o input_replay \
+  src/tools/input_replay.cpp \
+  src/entropy/input_replay/input_replay.cpp \
+  src/entropy/mouse/mouse.cpp \
+  src/entropy/keystroke/keystroke.cpp \
+  src/logging/logger.cpp \
+  -I src -std=c++17 -lpthread
+
+echo "Done! Built input_replay"
+echo ""
+echo "8 kHz mouse:   ./input_replay --mouse 80000 --rate 8000"
+echo "Typing:        ./input_replay --typing 500 --wpm 120"
+echo "Recorded:      ./input_replay --trace session.trace"
@@ -0,0 +1,49 @@
+#!/bin/bash
+# Build libtrng, the embeddable Quad-Layer generator with a C API (Linux or MinGW)
+# Usage: ./build_lib.sh
+# Output: build/lib/libtrng.a plus libtrng.so.1 (Linux) or trng.dll + libtrng.dll.a (MinGW)
+# Header: src/lib/trng.h
+
+set -e
+
+SOURCES="src/lib/trng.cpp
+  src/crypto/quad_layer.cpp
+  src/crypto/sha512.cpp
+  src/crypto/hkdf.cpp
+  src/crypto/chacha20.cpp
+  src/crypto/aes.cpp
+  src/platform/system_seed.cpp"
+
+OUT=build/lib
+mkdir -p "$OUT/obj"
+
+case "$(uname -s)" in
+  MINGW*|MSYS*|CYGWIN*) WINDOWS=1; SYSLIBS="-lbcrypt" ;;
+  *)                    WINDOWS=0; SYSLIBS="-lpthread" ;;
+esac
+
+echo "Building libtrng..."
+
+OBJS=""
+for src in $SOURCES; do
+  obj="$OUT/obj/$(basename "${src%.cpp}").o"
+  g++ -O3 -std=c++17 -I src -fPIC -fvisibility=hidden -DTRNG_BUILD_SHARED -c "$src" -o "$obj"
+  OBJS="$OBJS $obj"
+done
+
+rm -f "$OUT/libtrng.a"
+ar rcs "$OUT/libtrng.a" $OBJS
+
+if [ "$WINDOWS" = "1" ]; then
+  g++ -shared -o "$OUT/trng.dll" $OBJS -Wl,--out-implib,"$OUT/libtrng.dll.a" -static-libgcc -static-libstdc++ $SYSLIBS
+  SHARED="$OUT/trng.dll"
+else
+  g++ -shared -o "$OUT/libtrng.so.1" $OBJS -Wl,-soname,libtrng.so.1 $SYSLIBS
+  ln -sf libtrng.so.1 "$OUT/libtrng.so"
+  SHARED="$OUT/libtrng.so.1"
+fi
+
+echo "Done! Built $OUT/libtrng.a and $SHARED"
+echo ""
+echo "Static:  gcc app.c -I src/lib build/lib/libtrng.a -lstdc++ $SYSLIBS"
+echo "Shared:  gcc app.c -I src/lib -L build/lib -ltrng"
@@ -0,0 +1,23 @@
+#!/bin/bash
+# Build the headless PCM audio ingestion tool (Linux or MinGW)
+# Usage: ./build_pcm_ingest.sh
+
+set -e
+
+echo "Building pcm_ingest..."
+
+g++ -O3 -o pcm_ingest \
+  src/tools/pcm_ingest.cpp \
+  src/entropy/pcm_file/pcm_file.cpp \
+  src/entropy/noise_export.cpp \
+  src/platform/mapped_file.cpp \
+  src/logging/logger.cpp \
+  -I src -std=c++17 -lpthread
+
+echo "Done! Built pcm_ingest"
+echo ""
+echo "WAV capture:  ./pcm_ingest capture.wav"
+echo "Raw device:   ./pcm_ingest --raw s16 /dev/adc0"
+echo "ALSA pipe:    arecord -f S16_LE -t raw | ./pcm_ingest --raw s16 -"
+echo "PractRand:    ./pcm_ingest --emit capture.wav | ./RNG_test stdin64"
+echo "90B capture:  ./pcm_ingest --capture lsb.bin capture.wav && ./ea_direct -b 1 lsb.bin"
@@ -23,21 +23,21 @@ namespace AppConfig {
     // Bit/Byte Generator Limits
     constexpr int BITBYTE_MIN_AMOUNT = 1;
     constexpr int BITBYTE_MAX_AMOUNT = INT_MAX;
+    constexpr size_t BASE58_MAX_BYTES = 65536;  // Base58 is quadratic in the length
 
     // Passphrase Generator Limits
     constexpr int PASSPHRASE_MIN_WORDS = 1;
     constexpr int PASSPHRASE_MAX_WORDS = 32767;
+    constexpr int PASSPHRASE_MIN_COUNT = 1;
+    constexpr int PASSPHRASE_MAX_COUNT = 1000000;  // Passphrases per request (bulk mode)
 
     // Integer Range Bound Limits
     constexpr long long INTEGER_RANGE_MIN = LLONG_MIN;
     constexpr long long INTEGER_RANGE_MAX = LLONG_MAX;
 
-    // ---------------------------------------------------------
-    // CSPRNG Logic Allocations
-    // ---------------------------------------------------------
-
-    // Integer Entropy Pool Sampling Request Size Block
-    constexpr size_t INTEGER_ENTROPY_BLOCK_BYTES = 32;
+    // Integer values per request
+    constexpr int INTEGER_MIN_COUNT = 1;
+    constexpr int INTEGER_MAX_COUNT = 100000000;
 
     // ---------------------------------------------------------
     // Dynamic Buffer Allocations
@@ -47,4 +47,7 @@ namespace AppConfig {
     constexpr size_t PASSPHRASE_SEPARATOR_MAX_BYTES = 16;
     constexpr size_t OTP_MESSAGE_MAX_BYTES = 1024 * 1024; // 1 MB limit
     constexpr size_t OTP_FILEPATH_MAX_BYTES = 512;
+    constexpr size_t WORDLIST_PATH_MAX_BYTES = 512;
+    constexpr size_t INTEGER_BOUND_MAX_BYTES = 1024;  // Arbitrary-precision bounds (digits)
+    constexpr size_t CUSTOM_CHARSET_MAX_BYTES = 1024; // Custom alphabet / exclusions (UTF-8)
 }
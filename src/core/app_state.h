@@ -6,12 +6,17 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <cstring>
 #include "../entropy/clock_drift/clock_drift.h"
 #include "../entropy/cpu_jitter/cpu_jitter.h"
 #include "../entropy/keystroke/keystroke.h"
 #include "../entropy/mouse/mouse.h"
 #include "../entropy/microphone/microphone.h"
+#include "../entropy/cpu_hwrng/cpu_hwrng.h"
 #include "../entropy/pool.h"
+#include "../entropy/collection_policy.h"
+#include "../entropy/noise_export.h"
+#include "../logic/wordlist.h"
 #include "../crypto/secure_mem.h"
 #include "../../config/AppConfig.h"
 
@@ -29,6 +34,13 @@ struct AppState {
         passphraseSeparator[0] = '-';
         otpMessage.assign(AppConfig::OTP_MESSAGE_MAX_BYTES, '\0');
         otpFilePath.assign(AppConfig::OTP_FILEPATH_MAX_BYTES, '\0');
+        passphraseWordListPath.assign(AppConfig::WORDLIST_PATH_MAX_BYTES, '\0');
+        integerMinText.assign(AppConfig::INTEGER_BOUND_MAX_BYTES, '\0');
+        integerMinText[0] = '0';
+        integerMaxText.assign(AppConfig::INTEGER_BOUND_MAX_BYTES, '\0');
+        memcpy(integerMaxText.data(), "1000000000000000000000000", 25);
+        customExtraChars.assign(AppConfig::CUSTOM_CHARSET_MAX_BYTES, '\0');
+        customExcludeChars.assign(AppConfig::CUSTOM_CHARSET_MAX_BYTES, '\0');
     }
 
     // Entropy Collectors
@@ -37,16 +49,21 @@ struct AppState {
     Entropy::KeystrokeCollector keystrokeCollector;
     Entropy::MouseCollector mouseCollector;
     Entropy::MicrophoneCollector microphoneCollector;
+    Entropy::CpuHwrngCollector cpuHwrngCollector;
     
     // Centralized entropy pool (stores all collected data with timestamps)
     Entropy::EntropyPool entropyPool;
 
+    // Throttles/parks background collectors once the target is met
+    Entropy::CollectionPolicy collectionPolicy;
+
     // Entropy sources enabled
     bool microphoneEnabled = true;
     bool keystrokeEnabled = true;
     bool clockDriftEnabled = true;
     bool cpuJitterEnabled = true;
     bool mouseMovementEnabled = true;
+    bool cpuHwrngEnabled = true;
     
     // Debug
     bool keepLogs = false;
@@ -55,6 +72,7 @@ struct AppState {
     // Collection state
     bool isCollecting = false;
     float collectedBits = 0.0f; // Total computed bits (Locked + New)
+    float freshBits = 0.0f;     // New bits only (collected after the last lock)
     
     // Pooling Logic State
     uint64_t lockedDataTimestamp = 0; // 0 = No lock. Data <= this timestamp is locked.
@@ -65,6 +83,7 @@ struct AppState {
     float entropyClock = 0.0f;
     float entropyJitter = 0.0f;
     float entropyMouse = 0.0f;
+    float entropyHwrng = 0.0f;
 
     // Visualization State
     struct VizPoint { float x, y; };
@@ -80,21 +99,32 @@ struct AppState {
     int decimalDigits = 16;
     long long integerMin = 0;
     long long integerMax = 100;
+    int integerCount = 1;
+    int integerSeparator = 0;       // 0=Newline, 1=Space, 2=Comma
+    bool integerBigRange = false;   // Bounds from the text fields, any size
+    std::vector<char> integerMinText;
+    std::vector<char> integerMaxText;
     int binaryLength = 64;
     int customLength = 16;
     bool includeNumbers = true;
     bool includeUppercase = true;
     bool includeLowercase = true;
     bool includeSpecial = false;
+    std::vector<char> customExtraChars;     // UTF-8 symbols added to the classes
+    std::vector<char> customExcludeChars;   // UTF-8 symbols removed from the alphabet
+    bool customExcludeAmbiguous = false;    // Also remove 0 O 1 I l |
     int bitByteAmount = 256;
     int bitByteUnit = 0;   // 0=Bits, 1=Bytes
-    int bitByteFormat = 0; // 0=Hex, 1=Base64, 2=Binary
+    int bitByteFormat = 0; // 0=Hex, 1=Base64, 2=Binary, 3=Base32, 4=Base58, 5=Z85
     bool binarySeparatorEnabled = true; // Use space separator for binary output
     int binarySeparatorInterval = 8;    // Number of bits between spaces
     
     // Passphrase params
     int passphraseWordCount = 6;
+    int passphraseCount = 1;             // Passphrases per request, one per line
     std::vector<char> passphraseSeparator;
+    int passphraseWordListSource = 0;    // 0=Built-in, 1=Custom file
+    std::vector<char> passphraseWordListPath; // Custom wordlist (text or .twl index)
     
     // One-Time Pad params
     std::vector<char> otpMessage; // Buffer for manual input
@@ -107,9 +137,9 @@ struct AppState {
     std::string timestamp = "";
     float entropyConsumed = 0.0f;
     
-    // Wordlist file content cache (loaded once, reused for generation)
-    std::vector<std::string> cachedWordList;  // Parsed words for generation
-    bool wordListCacheValid = false;          // Whether cache is valid
+    // Passphrase wordlist (built-in list preloaded at startup, reused for
+    // generation; replaced when a custom list is selected)
+    WordList wordList;
     
     // UI state
     int currentTab = 0;
@@ -127,10 +157,19 @@ struct AppState {
     bool showAboutModal = false;
     
     // NIST Export State
-    bool isExportingNist = false;
+    std::atomic<bool> isExportingNist{false};
     std::atomic<size_t> nistBytesWritten = 0;
     size_t nistTotalBytes = 0;
     std::string nistError = "";
+
+    // Raw noise export (per-source SP 800-90B sample files)
+    Entropy::RawNoiseExporter noiseExporter;
+    int noiseExportSamples = 1000000;
+    bool noiseExportMapped = true;
+    std::string noiseExportStatus;
+
+    // Output self-test (quick battery over every GenerateRandomBytes result)
+    std::atomic<uint64_t> outputCheckAlarms{0};
     
     // Helper to check if we have enough entropy for consolidation (True Randomness)
     bool isEntropyValid() const {
@@ -1,6 +1,6 @@
 #include "aes.h"
 #include <cstring>
-#include <windows.h> // For SecureZeroMemory
+#include "secure_mem.h"
 
 namespace Crypto {
 
@@ -213,9 +213,9 @@ std::vector<uint8_t> AES256::EncryptCTR(
     }
     
     // Secure cleanup
-    SecureZeroMemory(roundKeys, sizeof(roundKeys));
-    SecureZeroMemory(keystream, sizeof(keystream));
-    SecureZeroMemory(counterBuf, sizeof(counterBuf));
+    SecureZero(roundKeys, sizeof(roundKeys));
+    SecureZero(keystream, sizeof(keystream));
+    SecureZero(counterBuf, sizeof(counterBuf));
     
     return output;
 }
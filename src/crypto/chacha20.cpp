@@ -1,6 +1,6 @@
 #include "chacha20.h"
 #include <cstring>
-#include <windows.h> // For SecureZeroMemory
+#include "secure_mem.h"
 
 namespace Crypto {
 
@@ -75,40 +75,51 @@ void ChaCha20::Block(State& output, const State& input) {
     }
     
     // Secure cleanup
-    SecureZeroMemory(&working, sizeof(working));
+    SecureZero(&working, sizeof(working));
 }
 
 std::vector<uint8_t> ChaCha20::GenerateStream(const Key& key,
                                                const Nonce& nonce,
                                                size_t length,
                                                uint32_t counter) {
-    std::vector<uint8_t> output;
-    output.reserve(length);
-    
+    std::vector<uint8_t> output(length);
+    GenerateInto(key, nonce, output.data(), length, counter);
+    return output;
+}
+
+void ChaCha20::GenerateInto(const Key& key,
+                            const Nonce& nonce,
+                            uint8_t* out,
+                            size_t length,
+                            uint32_t counter) {
     State state = InitState(key, nonce, counter);
     State blockOutput;
+    uint8_t bytes[BLOCK_SIZE];
     
-    while (output.size() < length) {
+    size_t pos = 0;
+    while (pos < length) {
         // Generate block
         Block(blockOutput, state);
         
         // Convert state to bytes (little-endian)
-        for (int i = 0; i < 16 && output.size() < length; i++) {
-            if (output.size() < length) output.push_back((uint8_t)(blockOutput[i]));
-            if (output.size() < length) output.push_back((uint8_t)(blockOutput[i] >> 8));
-            if (output.size() < length) output.push_back((uint8_t)(blockOutput[i] >> 16));
-            if (output.size() < length) output.push_back((uint8_t)(blockOutput[i] >> 24));
+        for (int i = 0; i < 16; i++) {
+            bytes[i * 4 + 0] = (uint8_t)(blockOutput[i]);
+            bytes[i * 4 + 1] = (uint8_t)(blockOutput[i] >> 8);
+            bytes[i * 4 + 2] = (uint8_t)(blockOutput[i] >> 16);
+            bytes[i * 4 + 3] = (uint8_t)(blockOutput[i] >> 24);
         }
+        size_t take = (length - pos < BLOCK_SIZE) ? length - pos : BLOCK_SIZE;
+        memcpy(out + pos, bytes, take);
+        pos += take;
         
         // Increment counter
         state[12]++;
     }
     
     // Secure cleanup
-    SecureZeroMemory(&state, sizeof(state));
-    SecureZeroMemory(&blockOutput, sizeof(blockOutput));
-    
-    return output;
+    SecureZero(&state, sizeof(state));
+    SecureZero(&blockOutput, sizeof(blockOutput));
+    SecureZero(bytes, sizeof(bytes));
 }
 
 std::vector<uint8_t> ChaCha20::Process(const Key& key,
@@ -124,7 +135,7 @@ std::vector<uint8_t> ChaCha20::Process(const Key& key,
     }
     
     // Secure cleanup
-    SecureZeroMemory(keystream.data(), keystream.size());
+    SecureZero(keystream.data(), keystream.size());
     
     return output;
 }
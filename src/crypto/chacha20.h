@@ -27,6 +27,14 @@ public:
         const Nonce& nonce,
         size_t length,
         uint32_t counter = 0);
+
+    // Same stream written straight into a caller buffer (no allocation)
+    static void GenerateInto(
+        const Key& key,
+        const Nonce& nonce,
+        uint8_t* out,
+        size_t length,
+        uint32_t counter = 0);
     
     // XOR data with ChaCha20 stream (for encryption/decryption)
     static std::vector<uint8_t> Process(
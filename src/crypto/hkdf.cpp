@@ -1,7 +1,7 @@
 #include "hkdf.h"
 #include <cstring>
 #include <stdexcept>
-#include <windows.h> // For SecureZeroMemory
+#include "secure_mem.h"
 
 namespace Crypto {
 
@@ -60,12 +60,12 @@ std::vector<uint8_t> HKDF::Expand(const SHA512::Hash& prk,
         T_prev_len = SHA512::HASH_SIZE;
         
         // Secure cleanup
-        SecureZeroMemory(data.data(), data.size());
-        SecureZeroMemory(prkVec.data(), prkVec.size());
+        SecureZero(data.data(), data.size());
+        SecureZero(prkVec.data(), prkVec.size());
     }
     
     // Secure cleanup
-    SecureZeroMemory(T_prev.data(), T_prev.size());
+    SecureZero(T_prev.data(), T_prev.size());
     
     return output;
 }
@@ -78,7 +78,7 @@ std::vector<uint8_t> HKDF::DeriveKey(const std::vector<uint8_t>& ikm,
     std::vector<uint8_t> result = Expand(prk, info, length);
     
     // Secure cleanup
-    SecureZeroMemory(prk.data(), prk.size());
+    SecureZero(prk.data(), prk.size());
     
     return result;
 }
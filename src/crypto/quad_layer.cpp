@@ -0,0 +1,115 @@
+#include "quad_layer.h"
+#include <algorithm>
+#include "sha512.h"
+#include "hkdf.h"
+#include "chacha20.h"
+#include "aes.h"
+#include "secure_mem.h"
+#include "../platform/cycles.h"
+
+namespace Crypto {
+
+const char* QuadLayer::StageName(int stage) {
+    static const char* const NAMES[STAGE_COUNT] = {
+        "sha512_hkdf", "chacha20", "xor_fold", "aes256_ctr", "secure_wipe"
+    };
+    return (stage >= 0 && stage < STAGE_COUNT) ? NAMES[stage] : "unknown";
+}
+
+void QuadLayer::Generate(const std::vector<uint8_t>& entropy,
+                         const std::vector<uint8_t>& info,
+                         uint8_t* out,
+                         size_t numBytes,
+                         StageTimes* times) {
+    if (numBytes == 0) return;
+
+    uint64_t mark = times ? ReadCycleCounter() : 0;
+    auto lap = [&](Stage stage) {
+        if (!times) return;
+        uint64_t now = ReadCycleCounter();
+        times->cycles[stage] += now - mark;
+        mark = now;
+    };
+
+    //-------------------------------------------------------------------------
+    // LAYER 1: ChaCha20 Masking
+    //-------------------------------------------------------------------------
+    SHA512::Hash masterSeed = SHA512::Compute(entropy);
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> keyMaterial = HKDF::DeriveKey(
+        std::vector<uint8_t>(masterSeed.begin(), masterSeed.end()), salt, info, 44);
+
+    ChaCha20::Key key1;
+    ChaCha20::Nonce nonce1;
+    std::copy(keyMaterial.begin(), keyMaterial.begin() + 32, key1.begin());
+    std::copy(keyMaterial.begin() + 32, keyMaterial.begin() + 44, nonce1.begin());
+    lap(STAGE_SHA512_HKDF);
+
+    std::vector<uint8_t> stream1 = ChaCha20::GenerateStream(key1, nonce1, numBytes);
+    lap(STAGE_CHACHA20);
+
+    //-------------------------------------------------------------------------
+    // LAYER 2: Entropy Injection (XOR Fold)
+    //-------------------------------------------------------------------------
+    // Iterate over whichever is larger so ALL entropy is mixed in
+    if (!entropy.empty()) {
+        size_t loopCount = std::max(stream1.size(), entropy.size());
+        for (size_t i = 0; i < loopCount; i++) {
+            stream1[i % stream1.size()] ^= entropy[i % entropy.size()];
+        }
+    }
+    lap(STAGE_XOR_FOLD);
+
+    //-------------------------------------------------------------------------
+    // LAYER 3: AES-256 Transformation
+    //-------------------------------------------------------------------------
+    SHA512::Hash s1Hash = SHA512::Compute(stream1);
+    std::vector<uint8_t> aesKey(s1Hash.begin(), s1Hash.begin() + 32);
+    std::vector<uint8_t> aesIV(s1Hash.begin() + 32, s1Hash.begin() + 48);
+    lap(STAGE_SHA512_HKDF);
+    std::vector<uint8_t> stream3 = AES256::EncryptCTR(aesKey, aesIV, stream1);
+    lap(STAGE_AES256_CTR);
+
+    //-------------------------------------------------------------------------
+    // LAYER 4: ChaCha20 Final Whitening
+    //-------------------------------------------------------------------------
+    SHA512::Hash s3Hash = SHA512::Compute(stream3);
+    std::vector<uint8_t> info4 = {'L', 'A', 'Y', 'E', 'R', '4'};
+    std::vector<uint8_t> key4Mat = HKDF::DeriveKey(
+        std::vector<uint8_t>(s3Hash.begin(), s3Hash.end()), salt, info4, 44);
+
+    ChaCha20::Key key4;
+    ChaCha20::Nonce nonce4;
+    std::copy(key4Mat.begin(), key4Mat.begin() + 32, key4.begin());
+    std::copy(key4Mat.begin() + 32, key4Mat.begin() + 44, nonce4.begin());
+    lap(STAGE_SHA512_HKDF);
+
+    ChaCha20::GenerateInto(key4, nonce4, out, numBytes);
+    lap(STAGE_CHACHA20);
+
+    // Secure cleanup
+    SecureZero(masterSeed.data(), masterSeed.size());
+    SecureZero(keyMaterial.data(), keyMaterial.size());
+    SecureZero(key1.data(), key1.size());
+    SecureZero(nonce1.data(), nonce1.size());
+    SecureZero(stream1.data(), stream1.size());
+    SecureZero(s1Hash.data(), s1Hash.size());
+    SecureZero(aesKey.data(), aesKey.size());
+    SecureZero(aesIV.data(), aesIV.size());
+    SecureZero(stream3.data(), stream3.size());
+    SecureZero(s3Hash.data(), s3Hash.size());
+    SecureZero(key4Mat.data(), key4Mat.size());
+    SecureZero(key4.data(), key4.size());
+    SecureZero(nonce4.data(), nonce4.size());
+    lap(STAGE_SECURE_WIPE);
+}
+
+std::vector<uint8_t> QuadLayer::Generate(const std::vector<uint8_t>& entropy,
+                                         const std::vector<uint8_t>& info,
+                                         size_t numBytes) {
+    std::vector<uint8_t> result(numBytes);
+    Generate(entropy, info, result.data(), numBytes);
+    return result;
+}
+
+} // namespace Crypto
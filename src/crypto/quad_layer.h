@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Crypto {
+
+// The Quad-Layer pipeline shared by the GUI (CSPRNG::GenerateRandomBytes),
+// trng_gen and libtrng:
+//   Layer 1: HKDF(SHA-512(entropy), info) keys a ChaCha20 mask
+//   Layer 2: the whole entropy input is XOR-folded into the mask
+//   Layer 3: AES-256-CTR keyed from SHA-512 of layer 2
+//   Layer 4: ChaCha20 keyed from SHA-512 of layer 3, written to the output
+// `info` is the domain/context string; different info = independent output.
+class QuadLayer {
+public:
+    // Pipeline stages, for per-stage timing (trng_gen --bench)
+    enum Stage { STAGE_SHA512_HKDF, STAGE_CHACHA20, STAGE_XOR_FOLD, STAGE_AES256_CTR, STAGE_SECURE_WIPE, STAGE_COUNT };
+    static const char* StageName(int stage);
+
+    // Cycle totals per stage (ReadCycleCounter units), accumulated across calls
+    struct StageTimes {
+        uint64_t cycles[STAGE_COUNT] = {};
+    };
+
+    // Final layer written straight into `out` (numBytes long, at most 256 GiB).
+    // All intermediate keys and streams are wiped before returning.
+    static void Generate(
+        const std::vector<uint8_t>& entropy,
+        const std::vector<uint8_t>& info,
+        uint8_t* out,
+        size_t numBytes,
+        StageTimes* times = nullptr);
+
+    static std::vector<uint8_t> Generate(
+        const std::vector<uint8_t>& entropy,
+        const std::vector<uint8_t>& info,
+        size_t numBytes);
+};
+
+} // namespace Crypto
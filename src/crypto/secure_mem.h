@@ -1,15 +1,29 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#ifdef _WIN32
 #include <windows.h> // For SecureZeroMemory
+#endif
 
 namespace Crypto {
 
+// Zero memory in a way the optimizer can't elide.
+// SecureZeroMemory on Windows; volatile byte stores elsewhere (headless tools).
+inline void SecureZero(void* ptr, size_t len) {
+#ifdef _WIN32
+    SecureZeroMemory(ptr, len);
+#else
+    volatile unsigned char* p = (volatile unsigned char*)ptr;
+    while (len--) *p++ = 0;
+#endif
+}
+
 // Securely zero the memory of a vector before clearing it
 // This ensures that sensitive data (entropy, keys) doesn't linger in heap capacity
 template <typename T>
 void SecureClearVector(std::vector<T>& vec) {
     if (!vec.empty()) {
-        SecureZeroMemory(vec.data(), vec.size() * sizeof(T));
+        SecureZero(vec.data(), vec.size() * sizeof(T));
         vec.clear();
         // shrink_to_fit request to reduce capacity, though not guaranteed to zero the *freed* memory 
         // by the allocator, but at least we zeroed the *active* memory before release.
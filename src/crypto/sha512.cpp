@@ -1,6 +1,6 @@
 #include "sha512.h"
 #include <cstring>
-#include <windows.h> // For SecureZeroMemory
+#include "secure_mem.h"
 
 namespace Crypto {
 
@@ -76,7 +76,7 @@ void SHA512::Compress(uint64_t state[8], const uint8_t block[BLOCK_SIZE]) {
     state[4] += e; state[5] += f; state[6] += g; state[7] += h;
     
     // Secure cleanup of working variables
-    SecureZeroMemory(W, sizeof(W));
+    SecureZero(W, sizeof(W));
 }
 
 SHA512::Hash SHA512::Compute(const uint8_t* data, size_t length) {
@@ -136,8 +136,8 @@ SHA512::Hash SHA512::Compute(const uint8_t* data, size_t length) {
     }
     
     // Secure cleanup
-    SecureZeroMemory(state, sizeof(state));
-    SecureZeroMemory(finalBlock, sizeof(finalBlock));
+    SecureZero(state, sizeof(state));
+    SecureZero(finalBlock, sizeof(finalBlock));
     
     return hash;
 }
@@ -180,12 +180,12 @@ SHA512::Hash SHA512::HMAC(const uint8_t* key, size_t keyLen,
     Hash result = Compute(outerData.data(), outerData.size());
     
     // Secure cleanup
-    SecureZeroMemory(keyBlock, sizeof(keyBlock));
-    SecureZeroMemory(ipad, sizeof(ipad));
-    SecureZeroMemory(opad, sizeof(opad));
-    SecureZeroMemory(innerData.data(), innerData.size());
-    SecureZeroMemory(outerData.data(), outerData.size());
-    SecureZeroMemory(innerHash.data(), innerHash.size());
+    SecureZero(keyBlock, sizeof(keyBlock));
+    SecureZero(ipad, sizeof(ipad));
+    SecureZero(opad, sizeof(opad));
+    SecureZero(innerData.data(), innerData.size());
+    SecureZero(outerData.data(), outerData.size());
+    SecureZero(innerHash.data(), innerHash.size());
     
     return result;
 }
@@ -1,9 +1,9 @@
 #include <bitset> // Added for binary formatting
 #include "clock_drift.h"
 #include "../../logging/logger.h"
-#include <intrin.h> // For __rdtsc
 #include <chrono>
-#include <windows.h> // For SecureZeroMemory
+#include "../../crypto/secure_mem.h"
+#include "../../platform/cycles.h"
 
 namespace Entropy {
 
@@ -30,6 +30,7 @@ void ClockDriftCollector::Stop() {
     }
 
     Logger::Log(Logger::Level::INFO, "ClockDrift", "Stopping collector thread...");
+    m_gate.Wake(); // Release the thread if it is parked
     if (m_thread.joinable()) {
         m_thread.join();
     }
@@ -64,7 +65,7 @@ void ClockDriftCollector::SecureClearBuffer() {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (!m_buffer.empty()) {
         // Securely zero all memory before clearing
-        SecureZeroMemory(m_buffer.data(), m_buffer.size() * sizeof(EntropyDataPoint));
+        Crypto::SecureZero(m_buffer.data(), m_buffer.size() * sizeof(EntropyDataPoint));
         m_buffer.clear();
         m_buffer.shrink_to_fit(); // Release memory
     }
@@ -78,6 +79,10 @@ uint64_t ClockDriftCollector::GetSampleCount() const {
     return m_sampleCount;
 }
 
+void ClockDriftCollector::SetCollectionState(CollectionState state) {
+    m_gate.Set(state);
+}
+
 void ClockDriftCollector::CollectionLoop() {
     Logger::Log(Logger::Level::INFO, "ClockDrift", "Thread main loop started");
     
@@ -85,14 +90,17 @@ void ClockDriftCollector::CollectionLoop() {
     uint64_t lastSampleCount = 0;
     
     while (m_running) {
+        // Parked: block until the policy wants more entropy
+        if (!m_gate.WaitWhileParked(m_running)) break;
+
         // 1. Read CPU cycle counter BEFORE sleep
-        uint64_t before = __rdtsc();
+        uint64_t before = ReadCycleCounter();
         
         // 2. Sleep for ~1ms using OS timer
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
         
         // 3. Read CPU cycle counter AFTER sleep
-        uint64_t after = __rdtsc();
+        uint64_t after = ReadCycleCounter();
         
         // 4. Calculate delta (this captures the jitter)
         uint64_t delta = after - before;
@@ -125,6 +133,11 @@ void ClockDriftCollector::CollectionLoop() {
         }
         m_sampleCount++;
 
+        // Throttled: idle between samples; the 1ms measurement itself is unchanged
+        if (m_gate.Get() == CollectionState::Throttled) {
+            m_gate.SleepFor(std::chrono::milliseconds(THROTTLE_FACTOR - 1), m_running);
+        }
+
         // Rate calculation (approximate)
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastRateCheck).count();
@@ -4,6 +4,7 @@
 #include <vector>
 #include <mutex>
 #include "../entropy_common.h"
+#include "../collection_policy.h"
 
 namespace Entropy {
 
@@ -28,6 +29,9 @@ public:
     // Statistics for GUI
     double GetEntropyRate() const;     // samples/sec estimate
     uint64_t GetSampleCount() const;   // Total samples collected
+
+    // Duty cycle from the collection policy (throttle/park once target is met)
+    void SetCollectionState(CollectionState state);
     
 private:
     void CollectionLoop();
@@ -38,6 +42,7 @@ private:
     std::vector<EntropyDataPoint> m_buffer;
     std::atomic<uint64_t> m_sampleCount{0};
     std::atomic<double> m_rate{0.0};
+    DutyCycleGate m_gate;
     
     // Secure memory clearing helper
     void SecureClearBuffer();
@@ -0,0 +1,38 @@
+#include "collection_policy.h"
+#include <algorithm>
+
+namespace Entropy {
+
+// Throttle at target + margin, park at target + 2 * margin
+static constexpr float MARGIN_FRACTION = 0.25f;
+static constexpr float MARGIN_MIN_BITS = 128.0f;
+
+const char* CollectionStateName(CollectionState state) {
+    switch (state) {
+        case CollectionState::Active:    return "Active";
+        case CollectionState::Throttled: return "Throttled";
+        case CollectionState::Parked:    return "Parked";
+    }
+    return "Unknown";
+}
+
+float CollectionPolicy::Margin(float targetBits) {
+    return std::max(MARGIN_MIN_BITS, targetBits * MARGIN_FRACTION);
+}
+
+CollectionState CollectionPolicy::Update(float freshBits, float targetBits) {
+    float margin = Margin(targetBits);
+
+    if (freshBits < targetBits) {
+        m_state = CollectionState::Active;
+    } else if (freshBits >= targetBits + 2.0f * margin) {
+        m_state = CollectionState::Parked;
+    } else if (freshBits >= targetBits + margin && m_state == CollectionState::Active) {
+        m_state = CollectionState::Throttled;
+    }
+    // Between target and target + margin: keep the current state (hysteresis band)
+
+    return m_state;
+}
+
+} // namespace Entropy
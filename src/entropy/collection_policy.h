@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Entropy {
+
+// How hard the background collectors should work
+enum class CollectionState {
+    Active,     // Full rate: below target
+    Throttled,  // Target + margin met: slow trickle (1/THROTTLE_FACTOR duty)
+    Parked      // Well past target: threads blocked, no CPU or audio I/O
+};
+
+// Throttled collectors stretch their sampling interval by this factor
+constexpr int THROTTLE_FACTOR = 10;
+
+const char* CollectionStateName(CollectionState state);
+
+// Decides the collection state from fresh (post-lock) entropy vs the target.
+// Hysteresis: once throttled or parked, sources only wake when fresh bits drop
+// below the target again (Generate locks the pool, a larger output raises
+// the target, or the pool is cleared) - not on every small fluctuation.
+class CollectionPolicy {
+public:
+    // Returns the new state; the caller applies it to each collector's gate
+    CollectionState Update(float freshBits, float targetBits);
+
+    CollectionState GetState() const { return m_state; }
+
+    // Margin above target before throttling/parking (max of floor and fraction)
+    static float Margin(float targetBits);
+
+private:
+    CollectionState m_state = CollectionState::Active;
+};
+
+// Per-collector view of the policy. Worker threads park here instead of
+// spinning, and interval sleeps wake early when the state or m_running changes.
+class DutyCycleGate {
+public:
+    // Returns true if the state changed
+    bool Set(CollectionState state) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state == state) return false;
+            m_state = state;
+        }
+        m_cv.notify_all();
+        return true;
+    }
+
+    CollectionState Get() const { return m_state; }
+
+    // Called by Stop() after clearing m_running so parked threads exit
+    void Wake() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_all();
+    }
+
+    // Blocks while parked. Returns false if the collector is stopping.
+    bool WaitWhileParked(const std::atomic<bool>& running) {
+        if (m_state != CollectionState::Parked) return running;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&] { return m_state != CollectionState::Parked || !running; });
+        return running;
+    }
+
+    // Interruptible sleep: returns early on a state change or stop
+    void SleepFor(std::chrono::milliseconds duration, const std::atomic<bool>& running) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        CollectionState entry = m_state;
+        m_cv.wait_for(lock, duration, [&] { return m_state != entry || !running; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<CollectionState> m_state{CollectionState::Active};
+};
+
+} // namespace Entropy
@@ -0,0 +1,274 @@
+#include "cpu_hwrng.h"
+#include "drng.h"
+#include "../../logging/logger.h"
+#include "../../crypto/secure_mem.h"
+#include <chrono>
+#include <cmath>
+
+namespace Entropy {
+
+// 32 points x 32 credited bits = 1024 bits: twice the 512-bit minimum on the first harvest
+static constexpr size_t BOOTSTRAP_POINTS = 32;
+
+// Steady trickle after bootstrap (~800 points/sec, similar to the microphone)
+static constexpr size_t STEADY_POINTS = 8;
+static constexpr int STEADY_INTERVAL_MS = 10;
+
+// RDRAND is a DRBG output; fold 16 words into each point so the 32-bit
+// per-point cap works out to 2 credited bits per RDRAND word
+static constexpr size_t RDRAND_FOLD = 16;
+
+// Consecutive failing batches before the source disables itself
+static constexpr int MAX_CONSECUTIVE_FAILURES = 3;
+
+// Empty RDSEED batches in a row (sustained underflow: VMs, many cores
+// contending) before the batch is retried with RDRAND instead
+static constexpr int RDSEED_EMPTY_LIMIT = 4;
+
+// Bootstrap retries when a batch comes back short; the backoff doubles from
+// 100 us, so all of them together wait about 50 ms
+static constexpr int BOOTSTRAP_ATTEMPTS = 10;
+static constexpr int BOOTSTRAP_BACKOFF_US = 100;
+
+CpuHwrngCollector::CpuHwrngCollector() {
+}
+
+CpuHwrngCollector::~CpuHwrngCollector() {
+    Stop();
+    SecureClearBuffer();
+}
+
+bool CpuHwrngCollector::IsSupported() {
+    Drng::Support s = Drng::Detect();
+    return s.rdseed || s.rdrand;
+}
+
+void CpuHwrngCollector::Start() {
+    if (!IsSupported()) {
+        // Main loop calls Start() every frame while enabled; only say it once
+        if (!m_unsupportedLogged) {
+            Logger::Log(Logger::Level::WARN, "CpuHwrng", "CPU has no RDSEED/RDRAND; source unavailable.");
+            m_unsupportedLogged = true;
+        }
+        return;
+    }
+    if (m_failed) {
+        return; // Disabled by health tests until restart
+    }
+    if (m_running.exchange(true)) {
+        return; // Already running
+    }
+
+    Logger::Log(Logger::Level::INFO, "CpuHwrng", "Starting collector thread...");
+    m_thread = std::thread(&CpuHwrngCollector::CollectionLoop, this);
+}
+
+void CpuHwrngCollector::Stop() {
+    if (!m_running.exchange(false)) {
+        return; // Not running
+    }
+
+    Logger::Log(Logger::Level::INFO, "CpuHwrng", "Stopping collector thread...");
+    m_gate.Wake(); // Release the thread if it is parked
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    Logger::Log(Logger::Level::INFO, "CpuHwrng", "Collection stopped.");
+
+    SecureClearBuffer();
+}
+
+bool CpuHwrngCollector::IsRunning() const {
+    return m_running;
+}
+
+std::vector<EntropyDataPoint> CpuHwrngCollector::Harvest() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer.empty()) {
+        return {};
+    }
+
+    std::vector<EntropyDataPoint> harvested;
+    harvested.swap(m_buffer);
+    // SECURITY: Shrink to release heap block that held entropy data
+    m_buffer.shrink_to_fit();
+    return harvested;
+}
+
+void CpuHwrngCollector::SecureClearBuffer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Crypto::SecureClearVector(m_buffer);
+}
+
+double CpuHwrngCollector::GetEntropyRate() const {
+    return m_rate;
+}
+
+uint64_t CpuHwrngCollector::GetSampleCount() const {
+    return m_sampleCount;
+}
+
+const char* CpuHwrngCollector::GetModeName() const {
+    switch (m_mode.load()) {
+        case 1: return "RDSEED";
+        case 2: return "RDRAND";
+        default: return "Unavailable";
+    }
+}
+
+uint64_t CpuHwrngCollector::GetHealthFailures() const {
+    return m_healthFailures;
+}
+
+bool CpuHwrngCollector::HasFailed() const {
+    return m_failed;
+}
+
+void CpuHwrngCollector::SetCollectionState(CollectionState state) {
+    m_gate.Set(state);
+}
+
+// Health tests on raw DRNG words (before folding):
+//  - Stuck output: all-zero or all-one words (known AMD microcode failure mode)
+//  - Repetition count: a word identical to its predecessor (p ~ 2^-64 when healthy)
+//  - Proportion: total ones within 8 sigma of n/2
+bool CpuHwrngCollector::HealthCheck(const std::vector<uint64_t>& words) {
+    uint64_t ones = 0;
+    for (uint64_t w : words) {
+        if (w == 0 || w == ~0ULL) return false;
+        if (m_haveLastWord && w == m_lastWord) return false;
+        m_lastWord = w;
+        m_haveLastWord = true;
+        ones += (uint64_t)__builtin_popcountll(w);
+    }
+
+    double n = (double)words.size() * 64.0;
+    double sigma = std::sqrt(n) / 2.0;
+    return std::fabs((double)ones - n / 2.0) <= 8.0 * sigma;
+}
+
+CpuHwrngCollector::Batch CpuHwrngCollector::CollectPoints(size_t points, bool useSeed) {
+    size_t fold = useSeed ? 1 : RDRAND_FOLD;
+    m_words.resize(points * fold);
+    size_t got = useSeed ? Drng::ReadSeedBatch(m_words.data(), m_words.size())
+                         : Drng::ReadRandBatch(m_words.data(), m_words.size());
+
+    // RDSEED underflow just shortens this batch; keep only whole points
+    got -= got % fold;
+    m_words.resize(got);
+    if (got == 0) {
+        return Batch::Empty;
+    }
+
+    if (!HealthCheck(m_words)) {
+        Crypto::SecureClearVector(m_words);
+        m_healthFailures++;
+        m_consecutiveFailures++;
+        Logger::Log(Logger::Level::WARN, "CpuHwrng", "Health test failed; batch discarded (%d in a row).",
+                    m_consecutiveFailures);
+        if (m_consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
+            Logger::Log(Logger::Level::ERR, "CpuHwrng", "Repeated health failures; disabling CPU hardware RNG.");
+            m_failed = true;
+        }
+        return Batch::Unhealthy;
+    }
+    m_consecutiveFailures = 0;
+
+    uint64_t timestamp = GetNanosecondTimestamp();
+    size_t produced = got / fold;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t p = 0; p < produced; p++) {
+            uint64_t value = 0;
+            for (size_t k = 0; k < fold; k++) {
+                value ^= m_words[p * fold + k];
+            }
+            m_buffer.push_back({timestamp, value, EntropySource::CpuHwrng});
+        }
+    }
+    m_sampleCount += produced;
+
+    Crypto::SecureClearVector(m_words);
+    return Batch::Collected;
+}
+
+// RDSEED first; once it has come back empty RDSEED_EMPTY_LIMIT times in a row
+// the batch is retried with RDRAND, until RDSEED delivers again.
+bool CpuHwrngCollector::CollectBatch(size_t points) {
+    if (m_hasSeed) {
+        Batch batch = CollectPoints(points, true);
+        if (batch != Batch::Empty) {
+            if (m_emptySeedBatches >= RDSEED_EMPTY_LIMIT && m_hasRand) {
+                Logger::Log(Logger::Level::INFO, "CpuHwrng", "RDSEED delivering again; leaving RDRAND.");
+            }
+            m_emptySeedBatches = 0;
+            m_mode = 1;
+            return batch == Batch::Collected;
+        }
+        if (m_emptySeedBatches < RDSEED_EMPTY_LIMIT) m_emptySeedBatches++;
+        if (m_emptySeedBatches < RDSEED_EMPTY_LIMIT || !m_hasRand) {
+            return false;
+        }
+        if (m_mode != 2) {
+            Logger::Log(Logger::Level::WARN, "CpuHwrng", "RDSEED empty %d batches in a row; falling back to RDRAND.",
+                        RDSEED_EMPTY_LIMIT);
+        }
+    }
+    m_mode = 2;
+    return CollectPoints(points, false) == Batch::Collected;
+}
+
+void CpuHwrngCollector::CollectionLoop() {
+    Drng::Support support = Drng::Detect();
+    m_hasSeed = support.rdseed;
+    m_hasRand = support.rdrand;
+    m_mode = m_hasSeed ? 1 : 2;
+    m_haveLastWord = false;
+    m_consecutiveFailures = 0;
+    m_emptySeedBatches = 0;
+
+    Logger::Log(Logger::Level::INFO, "CpuHwrng", "Using %s.", GetModeName());
+
+    // Bootstrap burst: enough for the minimum before the first GUI frame.
+    // Short batches (RDSEED underflow) back off briefly and retry.
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t startCount = m_sampleCount;
+    for (int attempt = 0; attempt < BOOTSTRAP_ATTEMPTS && m_running && !m_failed; attempt++) {
+        uint64_t have = m_sampleCount - startCount;
+        if (have >= BOOTSTRAP_POINTS) break;
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(BOOTSTRAP_BACKOFF_US << (attempt - 1)));
+        }
+        CollectBatch(BOOTSTRAP_POINTS - (size_t)have);
+    }
+    auto bootUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+    Logger::Log(Logger::Level::INFO, "CpuHwrng", "Bootstrap: %llu points in %lld us.",
+                (unsigned long long)(m_sampleCount - startCount), (long long)bootUs);
+
+    auto lastRateCheck = std::chrono::steady_clock::now();
+    uint64_t lastSampleCount = m_sampleCount;
+
+    while (m_running && !m_failed) {
+        if (!m_gate.WaitWhileParked(m_running)) break;
+        int interval = STEADY_INTERVAL_MS;
+        if (m_gate.Get() == CollectionState::Throttled) interval *= THROTTLE_FACTOR;
+        m_gate.SleepFor(std::chrono::milliseconds(interval), m_running);
+        if (!m_running || m_gate.Get() == CollectionState::Parked) continue;
+        CollectBatch(STEADY_POINTS);
+
+        // Rate calculation (approximate)
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastRateCheck).count();
+        if (elapsed >= 1000) {
+            uint64_t count = m_sampleCount;
+            m_rate = (double)(count - lastSampleCount) * 1000.0 / elapsed;
+            lastSampleCount = count;
+            lastRateCheck = now;
+        }
+    }
+
+    m_rate = 0.0;
+}
+
+} // namespace Entropy
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include "../entropy_common.h"
+#include "../collection_policy.h"
+
+namespace Entropy {
+
+// CPU hardware RNG collector (RDSEED preferred, RDRAND fallback when RDSEED
+// is missing or keeps underflowing).
+// Fills a bootstrap burst the moment it starts so the 512-bit minimum is
+// reachable on the first harvest, then trickles at a low steady rate.
+class CpuHwrngCollector {
+public:
+    CpuHwrngCollector();
+    ~CpuHwrngCollector();
+
+    // Start background collection thread (no-op if the CPU has no DRNG)
+    void Start();
+
+    // Stop background thread
+    void Stop();
+
+    // Is the collector running?
+    bool IsRunning() const;
+
+    // Get collected entropy (clears internal buffer and returns data)
+    std::vector<EntropyDataPoint> Harvest();
+
+    // Statistics for GUI
+    double GetEntropyRate() const;     // samples/sec estimate
+    uint64_t GetSampleCount() const;   // Total samples collected
+
+    // Hardware / health status
+    static bool IsSupported();          // CPUID reports RDSEED or RDRAND
+    const char* GetModeName() const;    // "RDSEED", "RDRAND" or "Unavailable"
+    uint64_t GetHealthFailures() const; // Batches discarded by health tests
+    bool HasFailed() const;             // Disabled after repeated health failures
+
+    // Duty cycle from the collection policy (throttle/park once target is met)
+    void SetCollectionState(CollectionState state);
+
+private:
+    enum class Batch { Collected, Empty, Unhealthy };
+
+    void CollectionLoop();
+    bool CollectBatch(size_t points);
+    Batch CollectPoints(size_t points, bool useSeed);
+    bool HealthCheck(const std::vector<uint64_t>& words);
+    void SecureClearBuffer();
+
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::vector<EntropyDataPoint> m_buffer;
+    std::atomic<uint64_t> m_sampleCount{0};
+    std::atomic<double> m_rate{0.0};
+    DutyCycleGate m_gate;
+
+    // Health state
+    std::atomic<int> m_mode{0};         // 0 = none, 1 = RDSEED, 2 = RDRAND
+    std::atomic<uint64_t> m_healthFailures{0};
+    std::atomic<bool> m_failed{false};
+    int m_consecutiveFailures = 0;
+    bool m_hasSeed = false;
+    bool m_hasRand = false;
+    int m_emptySeedBatches = 0;         // RDSEED batches in a row that returned nothing
+    uint64_t m_lastWord = 0;
+    bool m_haveLastWord = false;
+    bool m_unsupportedLogged = false;
+
+    // Scratch for raw words (reused, wiped after each batch)
+    std::vector<uint64_t> m_words;
+};
+
+} // namespace Entropy
@@ -0,0 +1,111 @@
+#pragma once
+// On-die CPU random number generator (Intel/AMD DRNG) primitives.
+// Header-only so trng_gen can seed from it without linking the collector.
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define TRNG_HAS_DRNG 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#include <cpuid.h>
+#else
+#include <intrin.h>
+#endif
+#endif
+
+namespace Entropy {
+namespace Drng {
+
+// Intel DRNG guide: RDRAND failing 10 times in a row indicates a hardware fault.
+// RDSEED underflows under contention and needs a longer, paused retry loop.
+constexpr int RDRAND_RETRIES = 10;
+constexpr int RDSEED_RETRIES = 128;
+
+struct Support {
+    bool rdrand = false;
+    bool rdseed = false;
+};
+
+inline Support Detect() {
+    Support s;
+#ifdef TRNG_HAS_DRNG
+#if defined(__GNUC__)
+    unsigned int a, b, c, d;
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+        s.rdrand = (c >> 30) & 1;
+    }
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, a, b, c, d);
+        s.rdseed = (b >> 18) & 1;
+    }
+#else
+    int regs[4];
+    __cpuid(regs, 1);
+    s.rdrand = (regs[2] >> 30) & 1;
+    __cpuid(regs, 0);
+    if (regs[0] >= 7) {
+        __cpuidex(regs, 7, 0);
+        s.rdseed = (regs[1] >> 18) & 1;
+    }
+#endif
+#endif
+    return s;
+}
+
+#ifdef TRNG_HAS_DRNG
+
+#if defined(__GNUC__)
+#define TRNG_DRNG_TARGET(x) __attribute__((target(x)))
+#else
+#define TRNG_DRNG_TARGET(x)
+#endif
+
+TRNG_DRNG_TARGET("rdseed")
+inline bool ReadSeed64(uint64_t& out) {
+    unsigned long long v;
+    for (int i = 0; i < RDSEED_RETRIES; i++) {
+        if (_rdseed64_step(&v)) {
+            out = v;
+            return true;
+        }
+        _mm_pause();
+    }
+    return false;
+}
+
+TRNG_DRNG_TARGET("rdrnd")
+inline bool ReadRand64(uint64_t& out) {
+    unsigned long long v;
+    for (int i = 0; i < RDRAND_RETRIES; i++) {
+        if (_rdrand64_step(&v)) {
+            out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+#else
+
+inline bool ReadSeed64(uint64_t&) { return false; }
+inline bool ReadRand64(uint64_t&) { return false; }
+
+#endif
+
+// Fill up to `count` words; returns how many were read before retries ran out
+inline size_t ReadSeedBatch(uint64_t* out, size_t count) {
+    size_t n = 0;
+    while (n < count && ReadSeed64(out[n])) n++;
+    return n;
+}
+
+inline size_t ReadRandBatch(uint64_t* out, size_t count) {
+    size_t n = 0;
+    while (n < count && ReadRand64(out[n])) n++;
+    return n;
+}
+
+} // namespace Drng
+} // namespace Entropy
@@ -1,7 +1,7 @@
 #include "cpu_jitter.h"
 #include "../../logging/logger.h"
 #include <chrono>
-#include <windows.h> // For SecureZeroMemory
+#include "../../crypto/secure_mem.h"
 
 namespace Entropy {
 
@@ -21,6 +21,7 @@ void CpuJitterCollector::Start() {
     
     m_paused = false;
     m_counter = 0;
+    m_runnerGate.Set(CollectionState::Active);
     
     m_runnerThread = std::thread(&CpuJitterCollector::RunnerLoop, this);
     m_refereeThread = std::thread(&CpuJitterCollector::RefereeLoop, this);
@@ -32,6 +33,10 @@ void CpuJitterCollector::Stop() {
     }
 
     Logger::Log(Logger::Level::INFO, "CpuJitter", "Stopping collector threads...");
+
+    // Release threads blocked on a gate
+    m_gate.Wake();
+    m_runnerGate.Wake();
     
     // Wait for threads to finish
     if (m_runnerThread.joinable()) m_runnerThread.join();
@@ -46,6 +51,9 @@ bool CpuJitterCollector::IsRunning() const {
 
 void CpuJitterCollector::RunnerLoop() {
     while (m_running) {
+        // Rest while the referee is idle instead of burning a core
+        if (!m_runnerGate.WaitWhileParked(m_running)) break;
+
         if (!m_paused) {
             // Tight loop increment - execution speed depends on CPU state/contention
             m_counter.fetch_add(1, std::memory_order_relaxed);
@@ -63,6 +71,22 @@ void CpuJitterCollector::RefereeLoop() {
     uint64_t samplesSinceRateCheck = 0;
 
     while (m_running) {
+        // 0. Duty cycle: park the runner between samples (throttled) or entirely (parked)
+        CollectionState state = m_gate.Get();
+        if (state != CollectionState::Active) {
+            m_runnerGate.Set(CollectionState::Parked);
+            if (state == CollectionState::Parked) {
+                m_gate.WaitWhileParked(m_running);
+            } else {
+                m_gate.SleepFor(std::chrono::milliseconds(THROTTLE_FACTOR - 1), m_running);
+            }
+            if (!m_running) break;
+
+            // Re-arm the runner; restart the count so the idle gap isn't one huge delta
+            lastCount = m_counter.load(std::memory_order_relaxed);
+            m_runnerGate.Set(CollectionState::Active);
+        }
+
         // 1. Sleep ~1ms (OS scheduling jitter source)
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
         
@@ -125,10 +149,14 @@ uint64_t CpuJitterCollector::GetSampleCount() const {
     return m_sampleCount;
 }
 
+void CpuJitterCollector::SetCollectionState(CollectionState state) {
+    m_gate.Set(state);
+}
+
 void CpuJitterCollector::SecureClearBuffer() {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (!m_buffer.empty()) {
-        SecureZeroMemory(m_buffer.data(), m_buffer.size() * sizeof(EntropyDataPoint));
+        Crypto::SecureZero(m_buffer.data(), m_buffer.size() * sizeof(EntropyDataPoint));
         m_buffer.clear();
     }
 }
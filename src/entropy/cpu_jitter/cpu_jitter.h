@@ -4,6 +4,7 @@
 #include <vector>
 #include <mutex>
 #include "../entropy_common.h"
+#include "../collection_policy.h"
 
 namespace Entropy {
 
@@ -28,6 +29,9 @@ public:
     double GetEntropyRate() const;
     uint64_t GetSampleCount() const;
 
+    // Duty cycle from the collection policy (throttle/park once target is met)
+    void SetCollectionState(CollectionState state);
+
 private:
     void RunnerLoop();
     void RefereeLoop();
@@ -43,6 +47,11 @@ private:
     // Pause flag for precise snapshot
     std::atomic<bool> m_paused{false};
 
+    // Policy state (read by referee) and runner rest gate (set by referee).
+    // The runner only spins while the referee is about to take a sample.
+    DutyCycleGate m_gate;
+    DutyCycleGate m_runnerGate;
+
     std::mutex m_mutex;
     std::vector<EntropyDataPoint> m_buffer;
 
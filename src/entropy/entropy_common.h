@@ -10,9 +10,18 @@ enum class EntropySource {
     Keystroke,
     ClockDrift,
     CpuJitter,
-    Mouse
+    Mouse,
+    PcmAudio,       // Recorded/streamed PCM (file, FIFO, ADC device)
+    CpuHwrng        // On-die DRNG (RDSEED, RDRAND fallback)
 };
 
+// Upper bound on bits the pool may credit per data point from a source.
+// Most sources are left to the pool's Shannon estimate (64 = no extra cap).
+// The CPU DRNG is a black box we can't inspect, so it is capped at half a word.
+inline float MaxCreditBitsPerPoint(EntropySource source) {
+    return (source == EntropySource::CpuHwrng) ? 32.0f : 64.0f;
+}
+
 // High-precision timestamp (nanoseconds since epoch)
 inline uint64_t GetNanosecondTimestamp() {
     using namespace std::chrono;
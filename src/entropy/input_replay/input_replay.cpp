@@ -0,0 +1,246 @@
+#include "input_replay.h"
+#include "../../crypto/secure_mem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace Entropy {
+
+bool LoadInputTrace(const std::string& path, std::vector<InputEvent>& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open trace: " + path;
+        return false;
+    }
+
+    out.clear();
+    std::string line;
+    size_t lineNo = 0;
+    uint64_t lastOffset = 0;
+
+    while (std::getline(file, line)) {
+        lineNo++;
+        size_t start = line.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string kind;
+        double offsetUs = 0.0;
+        iss >> kind >> offsetUs;
+        if (!iss || offsetUs < 0.0) {
+            error = "Malformed event on line " + std::to_string(lineNo);
+            return false;
+        }
+
+        InputEvent ev{};
+        ev.offsetNs = (uint64_t)std::llround(offsetUs * 1000.0);
+        if (kind == "m") {
+            ev.type = InputEvent::Type::MouseMove;
+            if (!(iss >> ev.x >> ev.y)) {
+                error = "Mouse event missing coordinates on line " + std::to_string(lineNo);
+                return false;
+            }
+        } else if (kind == "kd") {
+            ev.type = InputEvent::Type::KeyDown;
+        } else if (kind == "ku") {
+            ev.type = InputEvent::Type::KeyUp;
+        } else {
+            error = "Unknown event type '" + kind + "' on line " + std::to_string(lineNo);
+            return false;
+        }
+
+        if (ev.offsetNs < lastOffset) {
+            error = "Offsets go backwards on line " + std::to_string(lineNo);
+            return false;
+        }
+        lastOffset = ev.offsetNs;
+        out.push_back(ev);
+    }
+    return true;
+}
+
+bool SaveInputTrace(const std::string& path, const std::vector<InputEvent>& events) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    file << "# TRNG input trace: m <offset_us> <x> <y> | kd <offset_us> | ku <offset_us>\n";
+    char line[96];
+    for (const auto& ev : events) {
+        double us = ev.offsetNs / 1000.0;
+        switch (ev.type) {
+            case InputEvent::Type::MouseMove:
+                snprintf(line, sizeof(line), "m %.3f %d %d\n", us, (int)ev.x, (int)ev.y);
+                break;
+            case InputEvent::Type::KeyDown:
+                snprintf(line, sizeof(line), "kd %.3f\n", us);
+                break;
+            case InputEvent::Type::KeyUp:
+                snprintf(line, sizeof(line), "ku %.3f\n", us);
+                break;
+        }
+        file << line;
+    }
+    return (bool)file;
+}
+
+std::vector<InputEvent> GenerateSyntheticMouseTrace(size_t count, double rateHz, uint32_t seed) {
+    std::vector<InputEvent> events;
+    events.reserve(count);
+    if (rateHz <= 0.0) rateHz = 1000.0;
+
+    // Smoothed random walk: mostly multi-pixel steps like a real sweep,
+    // with the occasional sub-threshold jitter the collector filters out
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> accel(0.0, 1.5);
+    double x = 960.0, y = 540.0, vx = 4.0, vy = 3.0;
+    const double periodNs = 1e9 / rateHz;
+
+    for (size_t i = 0; i < count; i++) {
+        vx = std::clamp(vx * 0.95 + accel(rng), -20.0, 20.0);
+        vy = std::clamp(vy * 0.95 + accel(rng), -20.0, 20.0);
+        x = std::clamp(x + vx, 0.0, 3839.0);
+        y = std::clamp(y + vy, 0.0, 2159.0);
+
+        InputEvent ev{};
+        ev.type = InputEvent::Type::MouseMove;
+        ev.offsetNs = (uint64_t)(i * periodNs);
+        ev.x = (int32_t)x;
+        ev.y = (int32_t)y;
+        events.push_back(ev);
+    }
+    return events;
+}
+
+std::vector<InputEvent> GenerateSyntheticTypingTrace(size_t keys, double wordsPerMinute, uint32_t seed) {
+    std::vector<InputEvent> events;
+    events.reserve(keys * 2);
+    if (wordsPerMinute <= 0.0) wordsPerMinute = 60.0;
+
+    // 5 characters per word; flight ~ exponential around the mean, dwell 60-140 ms
+    std::mt19937 rng(seed);
+    const double meanIntervalNs = 60e9 / (wordsPerMinute * 5.0);
+    std::exponential_distribution<double> flight(1.0 / meanIntervalNs);
+    std::uniform_real_distribution<double> dwell(60e6, 140e6);
+
+    double t = 0.0;
+    for (size_t i = 0; i < keys; i++) {
+        t += flight(rng);
+        InputEvent down{};
+        down.type = InputEvent::Type::KeyDown;
+        down.offsetNs = (uint64_t)t;
+        events.push_back(down);
+
+        t += dwell(rng);
+        InputEvent up{};
+        up.type = InputEvent::Type::KeyUp;
+        up.offsetNs = (uint64_t)t;
+        events.push_back(up);
+    }
+    return events;
+}
+
+static uint64_t Percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t idx = (size_t)std::ceil(p * sorted.size());
+    if (idx > 0) idx--;
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+ReplayReport ReplayInputTrace(const std::vector<InputEvent>& events,
+                              MouseCollector* mouse, KeystrokeCollector* keys,
+                              const ReplayOptions& options) {
+    using clock = std::chrono::steady_clock;
+
+    ReplayReport report;
+    const double periodNs = options.rateHz > 0.0 ? 1e9 / options.rateHz : 0.0;
+    const double speed = options.speed > 0.0 ? options.speed : 1.0;
+    const uint64_t budgetNs = options.budgetUs > 0.0 ? (uint64_t)(options.budgetUs * 1000.0)
+                            : periodNs > 0.0 ? (uint64_t)periodNs : 125000;
+    report.budgetUs = budgetNs / 1000.0;
+
+    std::vector<uint64_t> costs;
+    costs.reserve(events.size());
+
+    if (mouse) mouse->SetCanvasHovered(true);
+
+    auto harvestAndWipe = [&]() {
+        if (mouse) {
+            auto h = mouse->Harvest();
+            Crypto::SecureClearVector(h);
+        }
+        if (keys) {
+            auto h = keys->Harvest();
+            Crypto::SecureClearVector(h);
+        }
+    };
+
+    const auto start = clock::now();
+    for (size_t i = 0; i < events.size(); i++) {
+        const InputEvent& ev = events[i];
+        bool isMouse = ev.type == InputEvent::Type::MouseMove;
+        if ((isMouse && !mouse) || (!isMouse && !keys)) continue;
+
+        // Pace against the schedule. Sleeps are far too coarse for 125 us periods,
+        // so only the long gaps sleep and the last stretch spins.
+        uint64_t scheduledNs = periodNs > 0.0 ? (uint64_t)(i * periodNs) : (uint64_t)(ev.offsetNs / speed);
+        while (true) {
+            uint64_t elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+            if (elapsed >= scheduledNs) {
+                if (elapsed - scheduledNs > budgetNs) report.late++;
+                break;
+            }
+            if (scheduledNs - elapsed > 2000000) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        uint64_t before = isMouse ? mouse->GetSampleCount() : keys->GetSampleCount();
+
+        // Measure exactly what the hook callback does: timestamp + processing
+        auto t0 = clock::now();
+        uint64_t ts = GetNanosecondTimestamp();
+        switch (ev.type) {
+            case InputEvent::Type::MouseMove: mouse->ProcessMove(ev.x, ev.y, ts); break;
+            case InputEvent::Type::KeyDown:   keys->ProcessKeyEvent(true, ts); break;
+            case InputEvent::Type::KeyUp:     keys->ProcessKeyEvent(false, ts); break;
+        }
+        auto t1 = clock::now();
+
+        uint64_t cost = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        costs.push_back(cost);
+        if (cost > budgetNs) report.overBudget++;
+
+        uint64_t after = isMouse ? mouse->GetSampleCount() : keys->GetSampleCount();
+        if (after > before) report.accepted++;
+        else report.filtered++;
+        report.events++;
+
+        if (options.harvestEvery > 0 && report.events % options.harvestEvery == 0) {
+            harvestAndWipe();
+        }
+    }
+    report.wallSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    harvestAndWipe();
+    if (mouse) mouse->SetCanvasHovered(false);
+
+    if (!costs.empty()) {
+        double sum = 0.0;
+        for (uint64_t c : costs) sum += (double)c;
+        report.costMean = sum / costs.size();
+
+        std::sort(costs.begin(), costs.end());
+        report.costP50 = Percentile(costs, 0.50);
+        report.costP90 = Percentile(costs, 0.90);
+        report.costP99 = Percentile(costs, 0.99);
+        report.costP999 = Percentile(costs, 0.999);
+        report.costMax = costs.back();
+    }
+    return report;
+}
+
+} // namespace Entropy
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../mouse/mouse.h"
+#include "../keystroke/keystroke.h"
+
+namespace Entropy {
+
+// One recorded input event. offsetNs is relative to the start of the trace.
+struct InputEvent {
+    enum class Type : uint8_t { MouseMove, KeyDown, KeyUp };
+    Type type;
+    uint64_t offsetNs;
+    int32_t x;
+    int32_t y;
+};
+
+// Trace file format (text, one event per line, '#' comments):
+//   m  <offset_us> <x> <y>     mouse move
+//   kd <offset_us>             key down
+//   ku <offset_us>             key up
+// Returns false and fills `error` on a malformed line.
+bool LoadInputTrace(const std::string& path, std::vector<InputEvent>& out, std::string& error);
+
+// Write a trace in the same format (for recording synthetic or captured runs)
+bool SaveInputTrace(const std::string& path, const std::vector<InputEvent>& events);
+
+// Synthetic traces for when no recording is at hand
+std::vector<InputEvent> GenerateSyntheticMouseTrace(size_t count, double rateHz, uint32_t seed);
+std::vector<InputEvent> GenerateSyntheticTypingTrace(size_t keys, double wordsPerMinute, uint32_t seed);
+
+struct ReplayOptions {
+    double rateHz = 0.0;        // > 0: fixed event rate (e.g. 8000 for 8 kHz mice); 0: trace timing
+    double speed = 1.0;         // Trace timing multiplier when rateHz == 0
+    double budgetUs = 0.0;      // Per-event cost budget; 0 = one event period (or 125 us for trace timing)
+    size_t harvestEvery = 4096; // Harvest + wipe collector buffers like the main loop does
+};
+
+struct ReplayReport {
+    size_t events = 0;
+    size_t accepted = 0;        // Produced a data point
+    size_t filtered = 0;        // Dropped by collector filters (hover, drift, range)
+    size_t overBudget = 0;      // Processing cost exceeded the budget
+    size_t late = 0;            // Replay started > one budget behind schedule
+    double budgetUs = 0.0;
+    double wallSeconds = 0.0;
+
+    // Per-event processing cost (ns), including the hook's timestamp read
+    uint64_t costP50 = 0;
+    uint64_t costP90 = 0;
+    uint64_t costP99 = 0;
+    uint64_t costP999 = 0;
+    uint64_t costMax = 0;
+    double costMean = 0.0;
+};
+
+// Drive the collectors' hook processing paths with a trace, paced in real time.
+// The mouse collector is marked as hovered for the duration of the replay.
+// Either collector may be null; events for a missing collector are skipped.
+ReplayReport ReplayInputTrace(const std::vector<InputEvent>& events,
+                              MouseCollector* mouse, KeystrokeCollector* keys,
+                              const ReplayOptions& options);
+
+} // namespace Entropy
@@ -1,7 +1,5 @@
 #include "keystroke.h"
 #include "../../logging/logger.h"
-#include <windows.h>
-#include <chrono>
 #include "../../crypto/secure_mem.h"
 
 namespace Entropy {
@@ -25,12 +23,14 @@ void KeystrokeCollector::Start() {
         return; // Already running
     }
 
-    Logger::Log(Logger::Level::INFO, "Keystroke", "Installing keyboard hook...");
-    
     // Reset rate tracking state for new session
-    m_lastRateTime = std::chrono::steady_clock::now();
+    m_lastRateTime = 0;
+    m_lastRateCount = 0;
     m_sampleCount = 0;
     m_rate = 0.0;
+
+#ifdef _WIN32
+    Logger::Log(Logger::Level::INFO, "Keystroke", "Installing keyboard hook...");
     
     // IMPORTANT: SetWindowsHookEx requires a message loop, which we have in main.cpp
     // We install the hook here. content of module handle usually needed for global hooks, 
@@ -45,6 +45,11 @@ void KeystrokeCollector::Start() {
     }
     
     Logger::Log(Logger::Level::INFO, "Keystroke", "Keyboard hook installed successfully.");
+#else
+    // No low-level hook outside Windows; events arrive via ProcessKeyEvent (replay/tests)
+    Logger::Log(Logger::Level::WARN, "Keystroke", "No keyboard hook on this platform; use ProcessKeyEvent injection.");
+    m_running = false;
+#endif
 }
 
 void KeystrokeCollector::Stop() {
@@ -52,11 +57,13 @@ void KeystrokeCollector::Stop() {
         return; // Not running
     }
 
+#ifdef _WIN32
     Logger::Log(Logger::Level::INFO, "Keystroke", "Removing keyboard hook...");
     if (m_hook) {
         UnhookWindowsHookEx(m_hook);
         m_hook = nullptr;
     }
+#endif
     
     Logger::Log(Logger::Level::INFO, "Keystroke", "Collection stopped.");
         
@@ -93,6 +100,7 @@ uint64_t KeystrokeCollector::GetSampleCount() const {
     return m_sampleCount;
 }
 
+#ifdef _WIN32
 // Static callback
 LRESULT CALLBACK KeystrokeCollector::LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode == HC_ACTION && s_instance && s_instance->IsRunning()) {
@@ -111,6 +119,15 @@ void KeystrokeCollector::ProcessKey(WPARAM wParam, KBDLLHOOKSTRUCT* pKbStruct) {
         OnKeyUp(now);
     }
 }
+#endif
+
+void KeystrokeCollector::ProcessKeyEvent(bool keyDown, uint64_t timestamp) {
+    if (keyDown) {
+        OnKeyDown(timestamp);
+    } else {
+        OnKeyUp(timestamp);
+    }
+}
 
 void KeystrokeCollector::OnKeyDown(uint64_t timestamp) {
     // Flight time: Time since last KeyUp (if any)
@@ -143,13 +160,14 @@ void KeystrokeCollector::OnKeyDown(uint64_t timestamp) {
             m_buffer.push_back(pt);
             m_sampleCount++;
             
-            // Rate calc (simplified for intermittent events)
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastRateTime).count();
-            if (elapsed >= 1) {
-                // Just use raw count for now, it's very variable
-                m_rate = (double)m_sampleCount / (double)(elapsed + 1); // rough approx
-                m_lastRateTime = now;
+            // Rate calc from the event timestamp (no extra clock read in the hook)
+            if (m_lastRateTime == 0) m_lastRateTime = timestamp;
+            double seconds = (double)(timestamp - m_lastRateTime) / 1000000000.0;
+            if (seconds >= 1.0) {
+                uint64_t currentCount = m_sampleCount.load();
+                m_rate = (double)(currentCount - m_lastRateCount) / seconds;
+                m_lastRateCount = currentCount;
+                m_lastRateTime = timestamp;
             }
         }
     }
@@ -2,7 +2,9 @@
 #include <atomic>
 #include <mutex>
 #include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include "../entropy_common.h"
 
 namespace Entropy {
@@ -28,17 +30,25 @@ public:
     double GetEntropyRate() const;     // samples/sec estimate
     uint64_t GetSampleCount() const;   // Total samples collected
     
+    // Portable processing path for a key transition (hook, replay, tests)
+    // timestamp is Entropy::GetNanosecondTimestamp() at event time
+    void ProcessKeyEvent(bool keyDown, uint64_t timestamp);
+
+#ifdef _WIN32
     // Public method to handle key events (called by static hook)
     void ProcessKey(WPARAM wParam, KBDLLHOOKSTRUCT* pKbStruct);
+#endif
 
 private:
+#ifdef _WIN32
     static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
+    HHOOK m_hook = nullptr;
+#endif
     void OnKeyDown(uint64_t timestamp);
     void OnKeyUp(uint64_t timestamp);
     void SecureClearBuffer();
 
     std::atomic<bool> m_running{false};
-    HHOOK m_hook = nullptr;
     std::mutex m_mutex;
     std::vector<EntropyDataPoint> m_buffer;
     
@@ -49,8 +59,9 @@ private:
     std::atomic<uint64_t> m_sampleCount{0};
     std::atomic<double> m_rate{0.0};
     
-    // Rate calculation state (avoids static locals)
-    std::chrono::steady_clock::time_point m_lastRateTime{};
+    // Rate calculation state (event-timestamp based, avoids static locals)
+    uint64_t m_lastRateTime{0};
+    uint64_t m_lastRateCount{0};
     
     // Thread-local pointer for hook callback
     static KeystrokeCollector* s_instance;
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <vector>
 #include "../../crypto/secure_mem.h"
+#include "pcm_kernels.h"
 
 // Link against required libraries
 #pragma comment(lib, "ole32.lib")
@@ -44,6 +45,7 @@ void MicrophoneCollector::Stop() {
     }
 
     Logger::Log(Logger::Level::INFO, "Microphone", "Stopping audio capture...");
+    m_gate.Wake(); // Release the thread if it is parked
     if (m_captureThread.joinable()) {
         m_captureThread.join();
     }
@@ -83,6 +85,34 @@ uint64_t MicrophoneCollector::GetSampleCount() const {
     return m_sampleCount;
 }
 
+void MicrophoneCollector::SetCollectionState(CollectionState state) {
+    m_gate.Set(state);
+}
+
+// Decide the sample layout once per stream instead of once per frame
+static PcmFormat ResolvePcmFormat(const WAVEFORMATEX* pwfx, int& lsbShift) {
+    lsbShift = 0;
+    bool isFloat = pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT;
+    int validBits = pwfx->wBitsPerSample;
+
+    if (pwfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        const WAVEFORMATEXTENSIBLE* ext = (const WAVEFORMATEXTENSIBLE*)pwfx;
+        isFloat = ext->SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT_GUID;
+        if (ext->Samples.wValidBitsPerSample > 0) {
+            validBits = ext->Samples.wValidBitsPerSample;
+        }
+    }
+
+    if (pwfx->wBitsPerSample == 16) return PcmFormat::Int16;
+    if (pwfx->wBitsPerSample == 32) {
+        if (isFloat) return PcmFormat::Float32;
+        // 24-in-32 containers are left-justified: the noise LSB sits above the padding
+        if (validBits > 0 && validBits < 32) lsbShift = 32 - validBits;
+        return PcmFormat::Int32;
+    }
+    return PcmFormat::Unsupported;
+}
+
 void MicrophoneCollector::CaptureThread() {
     HRESULT hr;
     IMMDeviceEnumerator *pEnumerator = NULL;
@@ -142,12 +172,25 @@ void MicrophoneCollector::CaptureThread() {
         return;
     }
 
-    // Initialize Audio Client (Shared Mode, Capture)
+    int lsbShift = 0;
+    PcmFormat format = ResolvePcmFormat(pwfx, lsbShift);
+    if (format == PcmFormat::Unsupported) {
+        Logger::Log(Logger::Level::ERR, "Microphone", "Unsupported mix format (%d bits per sample)", (int)pwfx->wBitsPerSample);
+        CoTaskMemFree(pwfx);
+        pAudioClient->Release();
+        pDevice->Release();
+        pEnumerator->Release();
+        m_running = false;
+        CoUninitialize();
+        return;
+    }
+
+    // Initialize Audio Client (Shared Mode, Capture, Event-driven)
     // REFTIMES_PER_SEC = 10000000NS
     // Requested Duration = 1 second (buffer size)
     hr = pAudioClient->Initialize(
         AUDCLNT_SHAREMODE_SHARED,
-        0,
+        AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
         10000000, 
         0,
         pwfx,
@@ -164,6 +207,21 @@ void MicrophoneCollector::CaptureThread() {
         return;
     }
 
+    // The audio engine signals this event each time a device period is ready
+    HANDLE hBufferReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!hBufferReady) hr = HRESULT_FROM_WIN32(GetLastError());
+    if (!hBufferReady || FAILED(hr = pAudioClient->SetEventHandle(hBufferReady))) {
+        Logger::Log(Logger::Level::ERR, "Microphone", "Failed to set capture event. Error: 0x%08X", hr);
+        if (hBufferReady) CloseHandle(hBufferReady);
+        CoTaskMemFree(pwfx);
+        pAudioClient->Release();
+        pDevice->Release();
+        pEnumerator->Release();
+        m_running = false;
+        CoUninitialize();
+        return;
+    }
+
     // Get Capture Client
     hr = pAudioClient->GetService(
         __uuidof(IAudioCaptureClient),
@@ -171,6 +229,7 @@ void MicrophoneCollector::CaptureThread() {
         
     if (FAILED(hr)) {
         Logger::Log(Logger::Level::ERR, "Microphone", "Failed to get AudioCaptureClient. Error: 0x%08X", hr);
+        CloseHandle(hBufferReady);
         CoTaskMemFree(pwfx);
         pAudioClient->Release();
         pDevice->Release();
@@ -185,6 +244,7 @@ void MicrophoneCollector::CaptureThread() {
     if (FAILED(hr)) {
         Logger::Log(Logger::Level::ERR, "Microphone", "Failed to start recording. Error: 0x%08X", hr);
         pCaptureClient->Release();
+        CloseHandle(hBufferReady);
         CoTaskMemFree(pwfx);
         pAudioClient->Release();
         pDevice->Release();
@@ -194,27 +254,59 @@ void MicrophoneCollector::CaptureThread() {
         return;
     }
 
-    Logger::Log(Logger::Level::INFO, "Microphone", "Audio capture started. Initializing loop...");
+    Logger::Log(Logger::Level::INFO, "Microphone", "Audio capture started (%u Hz, %u ch, %u-bit). Initializing loop...",
+                (unsigned)pwfx->nSamplesPerSec, (unsigned)pwfx->nChannels, (unsigned)pwfx->wBitsPerSample);
 
     UINT32 packetLength = 0;
     BYTE *pData;
     UINT32 numFramesAvailable;
     DWORD flags;
 
+    const size_t channels = pwfx->nChannels ? pwfx->nChannels : 1;
+
     // Stats tracking
     auto lastRateTime = std::chrono::steady_clock::now();
     uint64_t samplesSinceLastRateCheck = 0;
     
-    // Bit packing state
-    uint64_t entropyAccumulator = 0;
-    int bitsCollected = 0;
+    // Bit packing state (persists across packets)
+    PcmBitPacker packer;
+
+    // Reused for every packet; sized for ~100 ms of audio up front.
+    // SecureClearVector wipes it but keeps the capacity.
+    std::vector<EntropyDataPoint> newPoints;
+    newPoints.reserve((size_t)pwfx->nSamplesPerSec * channels / 640 + 1);
+
+    // Throttled: only every THROTTLE_FACTOR-th packet is processed
+    uint64_t packetIndex = 0;
 
     while (m_running) {
-        // Sleep for half the buffer duration (approx 10ms for low latency)
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Parked: stop the stream entirely so the audio engine idles too
+        if (m_gate.Get() == CollectionState::Parked) {
+            pAudioClient->Stop();
+            pAudioClient->Reset(); // Drop stale frames captured before parking
+            packer.Reset();
+            m_rate = 0.0;
+            if (!m_gate.WaitWhileParked(m_running)) break;
+            hr = pAudioClient->Start();
+            if (FAILED(hr)) {
+                Logger::Log(Logger::Level::ERR, "Microphone", "Failed to resume recording. Error: 0x%08X", hr);
+                m_running = false;
+                break;
+            }
+            lastRateTime = std::chrono::steady_clock::now();
+            samplesSinceLastRateCheck = 0;
+        }
 
-        hr = pCaptureClient->GetNextPacketSize(&packetLength);
-        if (FAILED(hr)) continue;
+        // Wake when the engine has data; timeout keeps Stop() responsive
+        DWORD waitResult = WaitForSingleObject(hBufferReady, 200);
+        if (!m_running) break;
+
+        if (waitResult == WAIT_OBJECT_0) {
+            hr = pCaptureClient->GetNextPacketSize(&packetLength);
+            if (FAILED(hr)) packetLength = 0;
+        } else {
+            packetLength = 0;
+        }
 
         while (packetLength != 0) {
             hr = pCaptureClient->GetBuffer(
@@ -226,80 +318,35 @@ void MicrophoneCollector::CaptureThread() {
 
             if (FAILED(hr)) break;
 
+            bool skip = m_gate.Get() == CollectionState::Throttled &&
+                        (packetIndex++ % THROTTLE_FACTOR) != 0;
+
             if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
                 // Silent buffer, ignore
+            } else if (skip) {
+                // Throttled: drain without processing; keep packed words contiguous
+                packer.Reset();
             } else {
-                // Process audio data
-                int bytesPerFrame = pwfx->nBlockAlign;
-                int bitsPerSample = pwfx->wBitsPerSample;
-
-                // Simple RMS check for "dead" mic
-                double sumSquares = 0.0;
-                int validSamples = 0;
-
-                std::vector<EntropyDataPoint> newPoints;
-                newPoints.reserve(numFramesAvailable / 64 + 1); // Approx packing ratio
-
-                for (UINT32 i = 0; i < numFramesAvailable; i++) {
-                    // Extract first channel sample
-                    int32_t sampleVal = 0;
-                    
-                    if (bitsPerSample == 16) {
-                        int16_t* ptr = (int16_t*)(pData + i * bytesPerFrame);
-                        sampleVal = *ptr;
-                    } else if (bitsPerSample == 32) {
-                        // Float or Int32? Usually float for WASAPI shared
-                        // Use our local GUID definition
-                        if (pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT || 
-                            (pwfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE && 
-                             ((WAVEFORMATEXTENSIBLE*)pwfx)->SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT_GUID)) {
-                            float* ptr = (float*)(pData + i * bytesPerFrame);
-                            sampleVal = (int32_t)(*ptr * 32767.0f);
-                        } else {
-                            int32_t* ptr = (int32_t*)(pData + i * bytesPerFrame);
-                            sampleVal = *ptr;
-                        }
-                    }
-
-                    sumSquares += (double)sampleVal * sampleVal;
-                    validSamples++;
-
-                    // OPTIMIZATION: Pack bits instead of 1 event per sample
-                    // Extract LSB (0 or 1)
-                    uint64_t lsb = (std::abs(sampleVal) & 1);
-                    
-                    // Shift into accumulator
-                    entropyAccumulator = (entropyAccumulator << 1) | lsb;
-                    bitsCollected++;
-                    
-                    // When we have 64 bits, push a data point
-                    if (bitsCollected >= 64) {
-                        EntropyDataPoint pt;
-                        pt.timestamp = GetNanosecondTimestamp();
-                        pt.value = entropyAccumulator; // 64 bits of entropy
-                        pt.source = EntropySource::Microphone;
-                        newPoints.push_back(pt);
-                        
-                        entropyAccumulator = 0;
-                        bitsCollected = 0;
-                    }
-                }
-
-                // RMS Check
-                double rms = 0.0;
-                if (validSamples > 0) {
-                    rms = std::sqrt(sumSquares / validSamples);
-                }
+                // Every interleaved sample of every channel feeds the packer
+                uint64_t timestamp = GetNanosecondTimestamp();
+                PcmPacketStats stats = ExtractPcmPacket(
+                    format, pData, (size_t)numFramesAvailable * channels, lsbShift,
+                    timestamp, EntropySource::Microphone, packer, newPoints);
 
                 // Threshold for "dead" mic (digital silence or near silence)
-                if (rms > 2.0) { 
-                    std::lock_guard<std::mutex> lock(m_mutex);
-                    m_buffer.insert(m_buffer.end(), newPoints.begin(), newPoints.end());
-                    m_sampleCount += newPoints.size(); // Count EVENTS, not raw samples now
-                    samplesSinceLastRateCheck += newPoints.size();
+                if (stats.Rms() > PCM_DEAD_RMS_THRESHOLD) {
+                    if (!newPoints.empty()) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_buffer.insert(m_buffer.end(), newPoints.begin(), newPoints.end());
+                        m_sampleCount += newPoints.size(); // Count EVENTS, not raw samples now
+                        samplesSinceLastRateCheck += newPoints.size();
+                    }
+                } else {
+                    // Don't let bits from a dead packet leak into the next word
+                    packer.Reset();
                 }
                 
-                // Secure clear local buffer
+                // Secure clear local buffer (capacity is kept for reuse)
                 Crypto::SecureClearVector(newPoints);
             }
 
@@ -307,6 +354,7 @@ void MicrophoneCollector::CaptureThread() {
             if (FAILED(hr)) break;
 
             hr = pCaptureClient->GetNextPacketSize(&packetLength);
+            if (FAILED(hr)) break;
         }
 
         // Update rate stats once per second
@@ -319,9 +367,12 @@ void MicrophoneCollector::CaptureThread() {
         }
     }
 
+    packer.Reset();
+
     // Cleanup
     if (pAudioClient) pAudioClient->Stop();
     
+    CloseHandle(hBufferReady);
     CoTaskMemFree(pwfx);
     if (pCaptureClient) pCaptureClient->Release();
     if (pAudioClient) pAudioClient->Release();
@@ -7,6 +7,7 @@
 #include <mmdeviceapi.h>
 #include <audioclient.h>
 #include "../entropy_common.h"
+#include "../collection_policy.h"
 
 namespace Entropy {
 
@@ -31,6 +32,9 @@ public:
     double GetEntropyRate() const;     // samples/sec estimate
     uint64_t GetSampleCount() const;   // Total samples collected
 
+    // Duty cycle from the collection policy (throttle/park once target is met)
+    void SetCollectionState(CollectionState state);
+
 private:
     void CaptureThread();
     void SecureClearBuffer();
@@ -42,6 +46,7 @@ private:
     
     std::atomic<uint64_t> m_sampleCount{0};
     std::atomic<double> m_rate{0.0};
+    DutyCycleGate m_gate;
 };
 
 } // namespace Entropy
@@ -0,0 +1,238 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include "../entropy_common.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_PCM_SSE2 1
+#endif
+
+namespace Entropy {
+
+// PCM sample layouts we know how to extract LSB noise from.
+// Resolved once per stream so the per-sample loop never re-checks the format.
+enum class PcmFormat {
+    Int16,
+    Int32,      // Also covers 24-in-32 containers via lsbShift
+    Float32,
+    Unsupported
+};
+
+// Health gate: packets whose RMS (in int16 units for float streams) falls below
+// this are treated as digital silence / dead input and discarded.
+constexpr double PCM_DEAD_RMS_THRESHOLD = 2.0;
+
+// Packs extracted LSBs into 64-bit words (first sample -> lowest bit).
+// Each full word becomes one EntropyDataPoint appended to the caller's buffer.
+struct PcmBitPacker {
+    uint64_t accumulator = 0;
+    int bitsCollected = 0;
+
+    void Reset() {
+        accumulator = 0;
+        bitsCollected = 0;
+    }
+
+    // Append `count` bits (1..64) held in the low bits of `bits`; upper bits must be zero
+    inline void Push(uint64_t bits, int count, uint64_t timestamp,
+                     EntropySource source, std::vector<EntropyDataPoint>& out) {
+        if (bitsCollected + count < 64) {
+            accumulator |= bits << bitsCollected;
+            bitsCollected += count;
+            return;
+        }
+
+        int take = 64 - bitsCollected;
+        accumulator |= bits << bitsCollected;
+        out.push_back({timestamp, accumulator, source});
+
+        int remaining = count - take;
+        accumulator = (take < 64) ? (bits >> take) : 0;
+        bitsCollected = remaining;
+    }
+};
+
+// Per-packet signal statistics used by the health gate
+struct PcmPacketStats {
+    double sumSquares = 0.0;
+    size_t samples = 0;
+
+    double Rms() const {
+        return samples ? std::sqrt(sumSquares / (double)samples) : 0.0;
+    }
+};
+
+//=============================================================================
+// FORMAT-SPECIALIZED KERNELS
+//=============================================================================
+// Each kernel walks all interleaved samples (every channel), packs the noise
+// LSB of each sample and accumulates the sum of squares for the RMS check.
+// Samples are read with memcpy-style unaligned loads; callers pass raw bytes.
+
+template <PcmFormat F>
+struct PcmKernel;
+
+template <>
+struct PcmKernel<PcmFormat::Int16> {
+    static PcmPacketStats Process(const uint8_t* data, size_t sampleCount, int /*lsbShift*/,
+                                  uint64_t timestamp, EntropySource source,
+                                  PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+        PcmPacketStats stats;
+        stats.samples = sampleCount;
+        size_t i = 0;
+
+#ifdef TRNG_PCM_SSE2
+        // 16 samples per step: madd for squares, shift LSB into the sign bit and
+        // use a saturating pack + movemask to gather 16 LSBs in one instruction
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc64 = _mm_setzero_si128();
+        for (; i + 16 <= sampleCount; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(data + i * 2));
+            __m128i b = _mm_loadu_si128((const __m128i*)(data + i * 2 + 16));
+
+            // Pair sums of squares fit in uint32 (max 2 * 32768^2 = 2^31)
+            __m128i sa = _mm_madd_epi16(a, a);
+            __m128i sb = _mm_madd_epi16(b, b);
+            acc64 = _mm_add_epi64(acc64, _mm_unpacklo_epi32(sa, zero));
+            acc64 = _mm_add_epi64(acc64, _mm_unpackhi_epi32(sa, zero));
+            acc64 = _mm_add_epi64(acc64, _mm_unpacklo_epi32(sb, zero));
+            acc64 = _mm_add_epi64(acc64, _mm_unpackhi_epi32(sb, zero));
+
+            __m128i la = _mm_slli_epi16(a, 15);
+            __m128i lb = _mm_slli_epi16(b, 15);
+            uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(la, lb));
+            packer.Push(bits, 16, timestamp, source, out);
+        }
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, acc64);
+        stats.sumSquares = (double)lanes[0] + (double)lanes[1];
+#endif
+
+        for (; i < sampleCount; i++) {
+            int16_t s;
+            std::memcpy(&s, data + i * 2, sizeof(s));
+            stats.sumSquares += (double)s * s;
+            packer.Push((uint64_t)(s & 1), 1, timestamp, source, out);
+        }
+        return stats;
+    }
+};
+
+// Shared tail for 32-bit integer lanes (native int32 and scaled float)
+struct PcmInt32Lanes {
+#ifdef TRNG_PCM_SSE2
+    static inline void Accumulate(__m128i v, int lsbShift, __m128d& accLo, __m128d& accHi,
+                                  uint64_t timestamp, EntropySource source,
+                                  PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+        __m128d lo = _mm_cvtepi32_pd(v);
+        __m128d hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        accLo = _mm_add_pd(accLo, _mm_mul_pd(lo, lo));
+        accHi = _mm_add_pd(accHi, _mm_mul_pd(hi, hi));
+
+        __m128i lsb = _mm_sll_epi32(v, _mm_cvtsi32_si128(31 - lsbShift));
+        uint32_t bits = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(lsb));
+        packer.Push(bits, 4, timestamp, source, out);
+    }
+
+    static inline double Sum(__m128d accLo, __m128d accHi) {
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(accLo, accHi));
+        return lanes[0] + lanes[1];
+    }
+#endif
+
+    static inline void Scalar(int32_t s, int lsbShift, PcmPacketStats& stats,
+                              uint64_t timestamp, EntropySource source,
+                              PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+        stats.sumSquares += (double)s * s;
+        packer.Push((uint64_t)(((uint32_t)s >> lsbShift) & 1), 1, timestamp, source, out);
+    }
+};
+
+template <>
+struct PcmKernel<PcmFormat::Int32> {
+    static PcmPacketStats Process(const uint8_t* data, size_t sampleCount, int lsbShift,
+                                  uint64_t timestamp, EntropySource source,
+                                  PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+        PcmPacketStats stats;
+        stats.samples = sampleCount;
+        size_t i = 0;
+
+#ifdef TRNG_PCM_SSE2
+        __m128d accLo = _mm_setzero_pd(), accHi = _mm_setzero_pd();
+        for (; i + 4 <= sampleCount; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i * 4));
+            PcmInt32Lanes::Accumulate(v, lsbShift, accLo, accHi, timestamp, source, packer, out);
+        }
+        stats.sumSquares = PcmInt32Lanes::Sum(accLo, accHi);
+#endif
+
+        for (; i < sampleCount; i++) {
+            int32_t s;
+            std::memcpy(&s, data + i * 4, sizeof(s));
+            PcmInt32Lanes::Scalar(s, lsbShift, stats, timestamp, source, packer, out);
+        }
+        return stats;
+    }
+};
+
+template <>
+struct PcmKernel<PcmFormat::Float32> {
+    // Floats are scaled to int16 range and truncated before LSB extraction
+    static PcmPacketStats Process(const uint8_t* data, size_t sampleCount, int /*lsbShift*/,
+                                  uint64_t timestamp, EntropySource source,
+                                  PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+        PcmPacketStats stats;
+        stats.samples = sampleCount;
+        size_t i = 0;
+
+#ifdef TRNG_PCM_SSE2
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        __m128d accLo = _mm_setzero_pd(), accHi = _mm_setzero_pd();
+        for (; i + 4 <= sampleCount; i += 4) {
+            __m128 f = _mm_loadu_ps((const float*)(data + i * 4));
+            __m128i v = _mm_cvttps_epi32(_mm_mul_ps(f, scale));
+            PcmInt32Lanes::Accumulate(v, 0, accLo, accHi, timestamp, source, packer, out);
+        }
+        stats.sumSquares = PcmInt32Lanes::Sum(accLo, accHi);
+#endif
+
+        for (; i < sampleCount; i++) {
+            float f;
+            std::memcpy(&f, data + i * 4, sizeof(f));
+            // Match _mm_cvttps_epi32: NaN and out-of-range map to INT32_MIN
+            // (a plain cast is undefined behaviour for them)
+            float g = f * 32767.0f;
+            int32_t s = (g >= -2147483648.0f && g < 2147483648.0f) ? (int32_t)g : INT32_MIN;
+            PcmInt32Lanes::Scalar(s, 0, stats, timestamp, source, packer, out);
+        }
+        return stats;
+    }
+};
+
+// Runtime dispatch (one switch per packet, not per sample)
+inline PcmPacketStats ExtractPcmPacket(PcmFormat format, const uint8_t* data, size_t sampleCount,
+                                       int lsbShift, uint64_t timestamp, EntropySource source,
+                                       PcmBitPacker& packer, std::vector<EntropyDataPoint>& out) {
+    switch (format) {
+    case PcmFormat::Int16:
+        return PcmKernel<PcmFormat::Int16>::Process(data, sampleCount, lsbShift, timestamp, source, packer, out);
+    case PcmFormat::Int32:
+        return PcmKernel<PcmFormat::Int32>::Process(data, sampleCount, lsbShift, timestamp, source, packer, out);
+    case PcmFormat::Float32:
+        return PcmKernel<PcmFormat::Float32>::Process(data, sampleCount, lsbShift, timestamp, source, packer, out);
+    default:
+        return PcmPacketStats{};
+    }
+}
+
+// Bytes occupied by one sample of the given format
+inline size_t PcmBytesPerSample(PcmFormat format) {
+    return (format == PcmFormat::Int16) ? 2 : (format == PcmFormat::Unsupported ? 0 : 4);
+}
+
+} // namespace Entropy
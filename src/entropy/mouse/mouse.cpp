@@ -2,7 +2,6 @@
 #include "../../logging/logger.h"
 #include <cmath>
 #include <algorithm>
-#include <windows.h> // For SecureZeroMemory
 #include "../../crypto/secure_mem.h"
 
 namespace Entropy {
@@ -28,6 +27,7 @@ void MouseCollector::Start() {
         return; // Already running
     }
 
+#ifdef _WIN32
     Logger::Log(Logger::Level::INFO, "Mouse", "Installing mouse hook...");
 
     // IMPORTANT: SetWindowsHookEx requires a message loop
@@ -40,6 +40,12 @@ void MouseCollector::Start() {
     }
 
     Logger::Log(Logger::Level::INFO, "Mouse", "Mouse hook installed successfully.");
+#else
+    // No low-level hook outside Windows; events arrive via ProcessMove (replay/tests)
+    Logger::Log(Logger::Level::WARN, "Mouse", "No mouse hook on this platform; use ProcessMove injection.");
+    m_running = false;
+    return;
+#endif
     
     // Reset state
     m_lastX = -1;
@@ -59,11 +65,13 @@ void MouseCollector::Stop() {
         return; // Not running
     }
 
+#ifdef _WIN32
     Logger::Log(Logger::Level::INFO, "Mouse", "Removing mouse hook...");
     if (m_hook) {
         UnhookWindowsHookEx(m_hook);
         m_hook = nullptr;
     }
+#endif
 
     // Flush any remaining local buffer
     FlushLocalBuffer();
@@ -98,6 +106,7 @@ void MouseCollector::FlushLocalBuffer() {
     }
 }
 
+#ifdef _WIN32
 // Static callback
 LRESULT CALLBACK MouseCollector::LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode == HC_ACTION && s_instance && s_instance->IsRunning()) {
@@ -111,8 +120,11 @@ LRESULT CALLBACK MouseCollector::LowLevelMouseProc(int nCode, WPARAM wParam, LPA
     }
     return CallNextHookEx(NULL, nCode, wParam, lParam);
 }
+#endif
 
-void MouseCollector::ProcessMouse(POINT pt, uint64_t timestamp) {
+// Runs inside the hook callback: keep it to one timestamp (taken by the caller)
+// and no clock reads of its own, so high polling rates never stall input.
+void MouseCollector::ProcessMove(int x, int y, uint64_t timestamp) {
     // TIME-WINDOW FILTERING: Only capture if canvas is currently hovered
     if (!m_canvasHovered.load(std::memory_order_relaxed)) {
         return; // Canvas not hovered, skip this event
@@ -120,13 +132,13 @@ void MouseCollector::ProcessMouse(POINT pt, uint64_t timestamp) {
 
     // First point initialization
     if (m_lastX == -1 || m_lastY == -1) {
-        m_lastX = pt.x;
-        m_lastY = pt.y;
+        m_lastX = x;
+        m_lastY = y;
         return;
     }
 
-    int dx = std::abs((int)pt.x - m_lastX);
-    int dy = std::abs((int)pt.y - m_lastY);
+    int dx = std::abs(x - m_lastX);
+    int dy = std::abs(y - m_lastY);
 
     // Filter small movements (sensor drift / noise)
     // Threshold: 2 pixels
@@ -143,8 +155,8 @@ void MouseCollector::ProcessMouse(POINT pt, uint64_t timestamp) {
     // Bits 16-31: Delta X (16 bits)
     // Bits 00-15: Delta Y (16 bits)
     
-    uint64_t value = ((uint64_t)(pt.x & 0xFFFF) << 48) |
-                     ((uint64_t)(pt.y & 0xFFFF) << 32) |
+    uint64_t value = ((uint64_t)(x & 0xFFFF) << 48) |
+                     ((uint64_t)(y & 0xFFFF) << 32) |
                      ((uint64_t)(dx & 0xFFFF) << 16) |
                      ((uint64_t)(dy & 0xFFFF));
 
@@ -161,8 +173,9 @@ void MouseCollector::ProcessMouse(POINT pt, uint64_t timestamp) {
         // FLUSH CONDITION:
         // 1. Buffer full (Batching for performance)
         // 2. Time elapsed > 15ms (Latency for smoothness)
+        // Event time doubles as "now": hook callbacks run within microseconds of it
         bool shouldFlush = false;
-        uint64_t now = GetNanosecondTimestamp();  // Current time for flush decision only
+        uint64_t now = eventTimeNs;
         if (m_localBuffer.size() >= BATCH_SIZE) {
             shouldFlush = true;
         } else {
@@ -183,11 +196,11 @@ void MouseCollector::ProcessMouse(POINT pt, uint64_t timestamp) {
     }
 
     // Update last position
-    m_lastX = pt.x;
-    m_lastY = pt.y;
+    m_lastX = x;
+    m_lastY = y;
 
     // Update rate (lightweight calculation)
-    uint64_t timeCheck = GetNanosecondTimestamp();
+    uint64_t timeCheck = eventTimeNs;
     if (m_lastRateTime == 0) m_lastRateTime = timeCheck;
     
     double seconds = (double)(timeCheck - m_lastRateTime) / 1000000000.0;
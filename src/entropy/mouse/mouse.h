@@ -2,7 +2,9 @@
 #include <atomic>
 #include <mutex>
 #include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include "../entropy_common.h"
 
 namespace Entropy {
@@ -28,21 +30,28 @@ public:
     // Get collected entropy (clears internal buffer and returns data)
     std::vector<EntropyDataPoint> Harvest();
     
+    // Portable processing path for a cursor position (hook, replay, tests)
+    // timestamp is Entropy::GetNanosecondTimestamp() at event time
+    void ProcessMove(int x, int y, uint64_t timestamp);
+
+#ifdef _WIN32
     // Public method to handle mouse events (called by static hook)
-    // timestamp is Entropy::GetNanosecondTimestamp()
-    void ProcessMouse(POINT pt, uint64_t timestamp);
+    void ProcessMouse(POINT pt, uint64_t timestamp) { ProcessMove(pt.x, pt.y, timestamp); }
+#endif
     
     // Statistics for GUI
     double GetEntropyRate() const;     // samples/sec estimate
     uint64_t GetSampleCount() const;   // Total samples collected
 
 private:
+#ifdef _WIN32
     static LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
+    HHOOK m_hook = nullptr;
+#endif
     void SecureClearBuffer();
     void FlushLocalBuffer();
 
     std::atomic<bool> m_running{false};
-    HHOOK m_hook = nullptr;
     std::mutex m_mutex;
     std::vector<EntropyDataPoint> m_buffer;  // Events during hover periods only
     
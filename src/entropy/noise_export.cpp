@@ -0,0 +1,234 @@
+#include "noise_export.h"
+#include "../crypto/secure_mem.h"
+#include "../logging/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace Entropy {
+
+NoiseSampleFormat DefaultNoiseSampleFormat(EntropySource source) {
+  NoiseSampleFormat format;
+  switch (source) {
+  case EntropySource::Microphone:
+  case EntropySource::PcmAudio:
+    format.bitsPerSample = 1;
+    format.samplesPerValue = 64;
+    break;
+  case EntropySource::CpuHwrng:
+    format.samplesPerValue = 8;
+    break;
+  default:
+    break;
+  }
+  return format;
+}
+
+const char *NoiseSourceName(EntropySource source) {
+  switch (source) {
+  case EntropySource::Microphone:
+    return "microphone";
+  case EntropySource::Keystroke:
+    return "keystroke";
+  case EntropySource::ClockDrift:
+    return "clock_drift";
+  case EntropySource::CpuJitter:
+    return "cpu_jitter";
+  case EntropySource::Mouse:
+    return "mouse";
+  case EntropySource::PcmAudio:
+    return "pcm_audio";
+  case EntropySource::CpuHwrng:
+    return "cpu_hwrng";
+  }
+  return "unknown";
+}
+
+RawNoiseExporter::~RawNoiseExporter() {
+  std::string error;
+  Stop(error);
+}
+
+RawNoiseExporter::Capture *RawNoiseExporter::Find(EntropySource source) const {
+  for (const auto &capture : m_captures) {
+    if (capture->source == source)
+      return capture.get();
+  }
+  return nullptr;
+}
+
+bool RawNoiseExporter::AddSource(EntropySource source, const std::string &path,
+                                 const NoiseSampleFormat &format,
+                                 uint64_t maxSamples, NoiseExportOutput output,
+                                 std::string &error) {
+  if (format.bitsPerSample < 1 || format.bitsPerSample > 8 ||
+      format.bitShift < 0 || format.samplesPerValue < 1 ||
+      format.bitShift + format.bitsPerSample * format.samplesPerValue > 64) {
+    error = "sample format selects bits outside the 64-bit value";
+    return false;
+  }
+  if (output == NoiseExportOutput::Mapped && maxSamples == 0) {
+    error = "memory-mapped capture needs a sample count";
+    return false;
+  }
+
+  std::unique_ptr<Capture> capture(new Capture());
+  capture->source = source;
+  capture->path = path;
+  capture->format = format;
+  capture->target = maxSamples;
+  capture->output = output;
+
+  if (output == NoiseExportOutput::Mapped) {
+    if (!capture->mapped.Create(path, maxSamples, error))
+      return false;
+  } else {
+    capture->file = fopen(path.c_str(), "wb");
+    if (!capture->file) {
+      error = "cannot create " + path + ": " + strerror(errno);
+      return false;
+    }
+    // Whole buffers are written at once; stdio buffering would only add a copy
+    setvbuf(capture->file, nullptr, _IONBF, 0);
+    capture->buffer.resize(BUFFER_BYTES);
+  }
+  capture->open = true;
+
+  Logger::Log(Logger::Level::WARN, "NoiseExport",
+              "Capturing raw %s samples to %s (%d bit%s, shift %d, %d per "
+              "value, %s). Samples on disk: do not generate secrets from "
+              "this session.",
+              NoiseSourceName(source), path.c_str(), format.bitsPerSample,
+              format.bitsPerSample == 1 ? "" : "s", format.bitShift,
+              format.samplesPerValue,
+              output == NoiseExportOutput::Mapped ? "mapped" : "buffered");
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &existing : m_captures) {
+    if (existing->source == source) {
+      Finish(*existing);
+      existing = std::move(capture);
+      return true;
+    }
+  }
+  m_captures.push_back(std::move(capture));
+  return true;
+}
+
+void RawNoiseExporter::Tap(EntropySource source,
+                           const std::vector<EntropyDataPoint> &points) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Capture *capture = Find(source);
+  if (!capture || !capture->open)
+    return;
+
+  const NoiseSampleFormat &format = capture->format;
+  const uint64_t mask = (1ull << format.bitsPerSample) - 1;
+  const size_t perValue = (size_t)format.samplesPerValue;
+  const bool mapped = capture->output == NoiseExportOutput::Mapped;
+
+  for (const auto &point : points) {
+    size_t count = perValue;
+    if (capture->target > 0)
+      count = (size_t)std::min<uint64_t>(count,
+                                         capture->target - capture->written);
+
+    uint8_t *out;
+    if (mapped) {
+      out = capture->mapped.Data() + capture->written;
+    } else {
+      if (capture->buffered + count > capture->buffer.size() &&
+          !Flush(*capture)) {
+        Finish(*capture);
+        return;
+      }
+      out = capture->buffer.data() + capture->buffered;
+      capture->buffered += count;
+    }
+
+    uint64_t value = point.value >> format.bitShift;
+    for (size_t i = 0; i < count; i++) {
+      out[i] = (uint8_t)(value & mask);
+      value >>= format.bitsPerSample;
+    }
+    capture->written += count;
+
+    if (capture->target > 0 && capture->written >= capture->target) {
+      Finish(*capture);
+      Logger::Log(Logger::Level::INFO, "NoiseExport",
+                  "Captured %llu %s samples to %s",
+                  (unsigned long long)capture->written,
+                  NoiseSourceName(source), capture->path.c_str());
+      return;
+    }
+  }
+}
+
+bool RawNoiseExporter::Flush(Capture &capture) {
+  if (capture.buffered == 0)
+    return true;
+  bool ok = fwrite(capture.buffer.data(), 1, capture.buffered, capture.file) ==
+            capture.buffered;
+  Crypto::SecureZero(capture.buffer.data(), capture.buffered);
+  capture.buffered = 0;
+  if (!ok && capture.error.empty())
+    capture.error = "write to " + capture.path + " failed: " + strerror(errno);
+  return ok;
+}
+
+bool RawNoiseExporter::Finish(Capture &capture) {
+  if (!capture.open)
+    return capture.error.empty();
+  capture.open = false;
+
+  if (capture.output == NoiseExportOutput::Mapped) {
+    if (!capture.mapped.Close(capture.written) && capture.error.empty())
+      capture.error = "cannot finish " + capture.path;
+  } else {
+    Flush(capture);
+    if (fclose(capture.file) != 0 && capture.error.empty())
+      capture.error = "write to " + capture.path + " failed: " + strerror(errno);
+    capture.file = nullptr;
+    Crypto::SecureClearVector(capture.buffer);
+  }
+  if (!capture.error.empty()) {
+    Logger::Log(Logger::Level::ERR, "NoiseExport", "%s capture: %s",
+                NoiseSourceName(capture.source), capture.error.c_str());
+  }
+  return capture.error.empty();
+}
+
+bool RawNoiseExporter::IsActive() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto &capture : m_captures) {
+    if (capture->open)
+      return true;
+  }
+  return false;
+}
+
+uint64_t RawNoiseExporter::SamplesWritten(EntropySource source) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Capture *capture = Find(source);
+  return capture ? capture->written : 0;
+}
+
+uint64_t RawNoiseExporter::TargetSamples(EntropySource source) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Capture *capture = Find(source);
+  return capture ? capture->target : 0;
+}
+
+bool RawNoiseExporter::Stop(std::string &error) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  bool ok = true;
+  for (auto &capture : m_captures) {
+    if (!Finish(*capture) && error.empty())
+      error = capture->error;
+    ok = ok && capture->error.empty();
+  }
+  m_captures.clear();
+  return ok;
+}
+
+} // namespace Entropy
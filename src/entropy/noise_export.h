@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "entropy_common.h"
+#include "../platform/mapped_file.h"
+
+namespace Entropy {
+
+// Which bits of each raw 64-bit value become SP 800-90B samples.
+// Sample i of a value is (value >> (bitShift + i * bitsPerSample)) & mask,
+// written one sample per byte, the input format of ea_iid / ea_non_iid.
+struct NoiseSampleFormat {
+    int bitsPerSample = 8;      // 1..8
+    int bitShift = 0;           // Lowest bit taken from each value
+    int samplesPerValue = 1;    // Consecutive fields per value (packed sources)
+};
+
+// Per-source default: packed LSB words (microphone, PCM) give 64 one-bit
+// samples in capture order, DRNG words 8 bytes, timing and input deltas
+// their low byte.
+NoiseSampleFormat DefaultNoiseSampleFormat(EntropySource source);
+
+// Short lowercase name for file names and logs ("microphone", "cpu_jitter", ...)
+const char* NoiseSourceName(EntropySource source);
+
+enum class NoiseExportOutput {
+    Buffered,   // Staged in a 1 MB buffer, one write per fill
+    Mapped      // File pre-sized to the sample target and written in place
+};
+
+// Streams raw collector output to per-source sample files for entropy
+// assessment. Tap() sees each harvest before it is pooled; values are never
+// copied whole, only the selected samples are written.
+// Captured samples still feed the pool, but they are now on disk: do not use
+// a capture session to generate secrets.
+class RawNoiseExporter {
+public:
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    RawNoiseExporter() = default;
+    ~RawNoiseExporter();
+    RawNoiseExporter(const RawNoiseExporter&) = delete;
+    RawNoiseExporter& operator=(const RawNoiseExporter&) = delete;
+
+    // Start capturing `source` into `path`, stopping after `maxSamples`
+    // (0 = until Stop(); Mapped output needs a bound). Replaces any capture
+    // already running for the source.
+    bool AddSource(EntropySource source, const std::string& path, const NoiseSampleFormat& format,
+                   uint64_t maxSamples, NoiseExportOutput output, std::string& error);
+
+    // Append the samples of one harvest (no-op for sources not being captured)
+    void Tap(EntropySource source, const std::vector<EntropyDataPoint>& points);
+
+    // Any capture still below its target?
+    bool IsActive() const;
+
+    // Samples written so far / target (0 when the source is not captured)
+    uint64_t SamplesWritten(EntropySource source) const;
+    uint64_t TargetSamples(EntropySource source) const;
+
+    // Flush and close every capture. Returns false if any write failed.
+    bool Stop(std::string& error);
+
+private:
+    struct Capture {
+        EntropySource source;
+        std::string path;
+        NoiseSampleFormat format;
+        uint64_t target = 0;
+        uint64_t written = 0;
+        NoiseExportOutput output = NoiseExportOutput::Buffered;
+        FILE* file = nullptr;
+        std::vector<uint8_t> buffer;
+        size_t buffered = 0;
+        MappedOutputFile mapped;
+        bool open = false;
+        std::string error;
+    };
+
+    Capture* Find(EntropySource source) const;
+    static bool Flush(Capture& capture);
+    static bool Finish(Capture& capture);
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Capture>> m_captures;
+};
+
+} // namespace Entropy
@@ -0,0 +1,467 @@
+#include "pcm_file.h"
+#include "../../logging/logger.h"
+#include "../../crypto/secure_mem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Entropy {
+
+// Harvest backpressure: the reader pauses once this many points are waiting
+static constexpr size_t MAX_BUFFERED_POINTS = 1 << 20; // 16 MB of EntropyDataPoint
+
+// Streamed reads go through a buffer of this size; mapped files are walked in slices
+static constexpr size_t STREAM_BLOCK_BYTES = 1 << 20;
+static constexpr size_t MAP_BLOCK_BYTES = 8 << 20;
+
+//=============================================================================
+// INPUT (mmap for regular files, blocking reads for pipes/devices)
+//=============================================================================
+
+namespace {
+
+class PcmInput {
+public:
+    ~PcmInput() { Close(); }
+
+    bool Open(const std::string& path) {
+#ifdef _WIN32
+        if (path == "-") {
+            _setmode(_fileno(stdin), _O_BINARY);
+            m_file = stdin;
+            m_ownsFile = false;
+        } else {
+            m_file = fopen(path.c_str(), "rb");
+            m_ownsFile = true;
+        }
+        if (!m_file) return false;
+        setvbuf(m_file, NULL, _IONBF, 0); // We already read in 1 MB blocks
+#else
+        if (path == "-") {
+            m_fd = STDIN_FILENO;
+            m_ownsFd = false;
+        } else {
+            m_fd = open(path.c_str(), O_RDONLY);
+            m_ownsFd = true;
+        }
+        if (m_fd < 0) return false;
+
+        struct stat st;
+        if (fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+            if (map != MAP_FAILED) {
+                madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+                m_map = (const uint8_t*)map;
+                m_mapSize = (size_t)st.st_size;
+            }
+        }
+#endif
+        if (!m_map) m_stream.resize(STREAM_BLOCK_BYTES);
+        return true;
+    }
+
+    void Close() {
+        if (!m_stream.empty()) {
+            Crypto::SecureZero(m_stream.data(), m_stream.size());
+            m_stream.clear();
+        }
+#ifdef _WIN32
+        if (m_file && m_ownsFile) fclose(m_file);
+        m_file = NULL;
+#else
+        if (m_map) munmap((void*)m_map, m_mapSize);
+        m_map = NULL;
+        if (m_fd >= 0 && m_ownsFd) close(m_fd);
+        m_fd = -1;
+#endif
+    }
+
+    bool IsMapped() const { return m_map != NULL; }
+
+    // Cap the remaining payload (WAV data chunk size)
+    void SetLimit(uint64_t bytes) { m_limit = bytes; }
+
+    // Exact read for headers; false on EOF/cancel
+    bool ReadExact(void* dst, size_t n, const std::atomic<bool>& keepRunning) {
+        uint8_t* out = (uint8_t*)dst;
+        if (m_map) {
+            if (m_mapSize - m_mapPos < n) return false;
+            memcpy(out, m_map + m_mapPos, n);
+            m_mapPos += n;
+            return true;
+        }
+        while (n > 0) {
+            size_t got = RawRead(out, n, keepRunning);
+            if (got == 0) return false;
+            out += got;
+            n -= got;
+        }
+        return true;
+    }
+
+    // Skip bytes (unknown WAV chunks); streams can't seek so they are read and dropped
+    bool Skip(uint64_t n, const std::atomic<bool>& keepRunning) {
+        if (m_map) {
+            if (m_mapSize - m_mapPos < n) return false;
+            m_mapPos += (size_t)n;
+            return true;
+        }
+        uint8_t scratch[4096];
+        while (n > 0) {
+            size_t step = (size_t)std::min<uint64_t>(n, sizeof(scratch));
+            if (!ReadExact(scratch, step, keepRunning)) return false;
+            n -= step;
+        }
+        return true;
+    }
+
+    // Next run of whole samples. The pointer stays valid until the next call.
+    bool NextBlock(const uint8_t*& data, size_t& len, size_t align, const std::atomic<bool>& keepRunning) {
+        if (m_map) {
+            size_t remaining = m_mapSize - m_mapPos;
+            size_t take = (size_t)std::min<uint64_t>(std::min(remaining, MAP_BLOCK_BYTES), m_limit);
+            take -= take % align;
+            if (take == 0) return false;
+            data = m_map + m_mapPos;
+            len = take;
+            m_mapPos += take;
+            m_limit -= take;
+            return true;
+        }
+
+        // Move the partial sample left over from the previous block to the front
+        size_t carry = 0;
+        if (m_tailLen > 0) {
+            memmove(m_stream.data(), m_stream.data() + m_tailOff, m_tailLen);
+            carry = m_tailLen;
+            m_tailLen = 0;
+        }
+
+        while (true) {
+            size_t want = (size_t)std::min<uint64_t>(m_stream.size() - carry, m_limit);
+            if (want == 0) return false;
+            size_t got = RawRead(m_stream.data() + carry, want, keepRunning);
+            if (got == 0) return false; // EOF; a trailing partial sample is dropped
+            m_limit -= got;
+
+            size_t total = carry + got;
+            size_t usable = total - total % align;
+            if (usable == 0) {
+                carry = total;
+                continue;
+            }
+            m_tailOff = usable;
+            m_tailLen = total - usable;
+            data = m_stream.data();
+            len = usable;
+            return true;
+        }
+    }
+
+private:
+    // One blocking read; 0 means EOF, error or cancel
+    size_t RawRead(uint8_t* dst, size_t n, const std::atomic<bool>& keepRunning) {
+#ifdef _WIN32
+        if (!keepRunning) return 0;
+        return fread(dst, 1, n, m_file);
+#else
+        while (keepRunning) {
+            // Poll with a timeout so Stop() isn't stuck behind an idle FIFO writer
+            struct pollfd pfd = {m_fd, POLLIN, 0};
+            int pr = poll(&pfd, 1, 200);
+            if (pr < 0 && errno != EINTR) return 0;
+            if (pr <= 0) continue;
+
+            ssize_t got = read(m_fd, dst, n);
+            if (got > 0) return (size_t)got;
+            if (got == 0) return 0;
+            if (errno != EINTR && errno != EAGAIN) return 0;
+        }
+        return 0;
+#endif
+    }
+
+#ifdef _WIN32
+    FILE* m_file = NULL;
+    bool m_ownsFile = false;
+#else
+    int m_fd = -1;
+    bool m_ownsFd = false;
+#endif
+    const uint8_t* m_map = NULL;
+    size_t m_mapSize = 0;
+    size_t m_mapPos = 0;
+    uint64_t m_limit = UINT64_MAX;
+
+    std::vector<uint8_t> m_stream;
+    size_t m_tailOff = 0;
+    size_t m_tailLen = 0;
+};
+
+inline uint16_t ReadLE16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t ReadLE32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Parse RIFF/RF64 WAVE headers up to the start of the data chunk
+bool ParseWavHeader(PcmInput& in, const std::atomic<bool>& keepRunning,
+                    PcmFormat& format, int& lsbShift, uint32_t& channels, uint32_t& sampleRate) {
+    uint8_t riff[12];
+    if (!in.ReadExact(riff, sizeof(riff), keepRunning)) return false;
+    if ((memcmp(riff, "RIFF", 4) != 0 && memcmp(riff, "RF64", 4) != 0) || memcmp(riff + 8, "WAVE", 4) != 0) {
+        Logger::Log(Logger::Level::ERR, "PcmFile", "Input is not a WAVE file (use raw mode for headerless PCM)");
+        return false;
+    }
+
+    bool haveFmt = false;
+    format = PcmFormat::Unsupported;
+    lsbShift = 0;
+
+    while (true) {
+        uint8_t hdr[8];
+        if (!in.ReadExact(hdr, sizeof(hdr), keepRunning)) return false;
+        uint32_t size = ReadLE32(hdr + 4);
+
+        if (memcmp(hdr, "fmt ", 4) == 0) {
+            if (size < 16 || size > 1024) return false;
+            std::vector<uint8_t> fmt(size + (size & 1));
+            if (!in.ReadExact(fmt.data(), fmt.size(), keepRunning)) return false;
+
+            uint16_t tag = ReadLE16(&fmt[0]);
+            channels = ReadLE16(&fmt[2]);
+            sampleRate = ReadLE32(&fmt[4]);
+            uint16_t bits = ReadLE16(&fmt[14]);
+            uint16_t validBits = bits;
+
+            // WAVE_FORMAT_EXTENSIBLE: real tag is the first word of the SubFormat GUID
+            if (tag == 0xFFFE && size >= 40) {
+                validBits = ReadLE16(&fmt[18]);
+                tag = ReadLE16(&fmt[24]);
+            }
+
+            if (tag == 1 && bits == 16) {
+                format = PcmFormat::Int16;
+            } else if (tag == 1 && bits == 32) {
+                format = PcmFormat::Int32;
+                if (validBits > 0 && validBits < 32) lsbShift = 32 - validBits;
+            } else if (tag == 3 && bits == 32) {
+                format = PcmFormat::Float32;
+            } else {
+                Logger::Log(Logger::Level::ERR, "PcmFile", "Unsupported WAV format (tag %u, %u bits)",
+                            (unsigned)tag, (unsigned)bits);
+                return false;
+            }
+            haveFmt = true;
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            if (!haveFmt) return false;
+            // 0 / 0xFFFFFFFF: streamed or RF64 — read until EOF
+            if (size != 0 && size != 0xFFFFFFFFu) in.SetLimit(size);
+            return true;
+        } else {
+            if (!in.Skip((uint64_t)size + (size & 1), keepRunning)) return false;
+        }
+    }
+}
+
+} // namespace
+
+//=============================================================================
+// COLLECTOR
+//=============================================================================
+
+PcmFileCollector::PcmFileCollector() {}
+
+PcmFileCollector::~PcmFileCollector() {
+    Stop();
+    SecureClearBuffer();
+}
+
+void PcmFileCollector::Configure(const PcmFileConfig& config) {
+    if (m_running) return;
+    m_config = config;
+    if (m_config.windowSamples < 64) m_config.windowSamples = 64;
+}
+
+void PcmFileCollector::Start() {
+    if (m_config.path.empty()) {
+        Logger::Log(Logger::Level::WARN, "PcmFile", "No input configured.");
+        return;
+    }
+    if (m_running.exchange(true)) {
+        return; // Already running
+    }
+
+    m_finished = false;
+    Logger::Log(Logger::Level::INFO, "PcmFile", "Starting PCM reader thread...");
+    m_readerThread = std::thread(&PcmFileCollector::ReaderThread, this);
+}
+
+void PcmFileCollector::Stop() {
+    if (!m_running.exchange(false)) {
+        return; // Not running
+    }
+
+    Logger::Log(Logger::Level::INFO, "PcmFile", "Stopping PCM reader...");
+    if (m_readerThread.joinable()) {
+        m_readerThread.join();
+    }
+
+    Logger::Log(Logger::Level::INFO, "PcmFile", "Collection stopped.");
+
+    SecureClearBuffer();
+}
+
+bool PcmFileCollector::IsRunning() const {
+    return m_running;
+}
+
+bool PcmFileCollector::IsFinished() const {
+    return m_finished;
+}
+
+std::vector<EntropyDataPoint> PcmFileCollector::Harvest() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer.empty()) {
+        return {};
+    }
+
+    std::vector<EntropyDataPoint> harvested;
+    harvested.swap(m_buffer);
+    // SECURITY: Shrink to release heap block that held entropy data
+    m_buffer.shrink_to_fit();
+    return harvested;
+}
+
+void PcmFileCollector::SecureClearBuffer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Crypto::SecureClearVector(m_buffer);
+}
+
+double PcmFileCollector::GetEntropyRate() const {
+    return m_rate;
+}
+
+uint64_t PcmFileCollector::GetSampleCount() const {
+    return m_sampleCount;
+}
+
+uint64_t PcmFileCollector::GetBytesRead() const {
+    return m_bytesRead;
+}
+
+uint64_t PcmFileCollector::GetRejectedWindows() const {
+    return m_rejectedWindows;
+}
+
+bool PcmFileCollector::Run(const std::function<void(const std::vector<EntropyDataPoint>&)>& sink,
+                           const std::atomic<bool>& keepRunning) {
+    PcmInput input;
+    if (!input.Open(m_config.path)) {
+        Logger::Log(Logger::Level::ERR, "PcmFile", "Failed to open input: %s", m_config.path.c_str());
+        return false;
+    }
+
+    PcmFormat format = m_config.rawFormat;
+    int lsbShift = m_config.rawLsbShift;
+    uint32_t channels = 0, sampleRate = 0;
+    if (!m_config.rawInput) {
+        if (!ParseWavHeader(input, keepRunning, format, lsbShift, channels, sampleRate)) {
+            Logger::Log(Logger::Level::ERR, "PcmFile", "Failed to parse WAV header: %s", m_config.path.c_str());
+            return false;
+        }
+    }
+
+    const size_t sampleBytes = PcmBytesPerSample(format);
+    if (sampleBytes == 0) {
+        Logger::Log(Logger::Level::ERR, "PcmFile", "Unsupported sample format");
+        return false;
+    }
+
+    Logger::Log(Logger::Level::INFO, "PcmFile", "Reading %s (%s, %u Hz, %u ch, %zu-byte samples)",
+                m_config.path.c_str(), input.IsMapped() ? "mapped" : "streamed",
+                (unsigned)sampleRate, (unsigned)channels, sampleBytes);
+
+    // Bit packing state (persists across windows, like the live capture loop)
+    PcmBitPacker packer;
+    std::vector<EntropyDataPoint> points;
+    points.reserve(m_config.windowSamples / 64 + 2);
+
+    const size_t windowBytes = m_config.windowSamples * sampleBytes;
+    const uint8_t* data = NULL;
+    size_t len = 0;
+
+    while (keepRunning && input.NextBlock(data, len, sampleBytes, keepRunning)) {
+        m_bytesRead += len;
+
+        for (size_t off = 0; off < len; off += windowBytes) {
+            size_t samples = std::min(windowBytes, len - off) / sampleBytes;
+            PcmPacketStats stats = ExtractPcmPacket(
+                format, data + off, samples, lsbShift,
+                GetNanosecondTimestamp(), EntropySource::PcmAudio, packer, points);
+
+            // Same dead-input gate as the microphone
+            if (stats.Rms() > PCM_DEAD_RMS_THRESHOLD) {
+                if (!points.empty()) {
+                    m_sampleCount += points.size();
+                    sink(points);
+                }
+            } else {
+                packer.Reset();
+                m_rejectedWindows++;
+            }
+
+            Crypto::SecureClearVector(points);
+        }
+    }
+
+    packer.Reset();
+    return true;
+}
+
+void PcmFileCollector::ReaderThread() {
+    auto lastRateTime = std::chrono::steady_clock::now();
+    uint64_t pointsSinceLastRateCheck = 0;
+
+    bool ok = Run([&](const std::vector<EntropyDataPoint>& points) {
+        // Backpressure: a file can be read far faster than the GUI harvests
+        while (m_running) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_buffer.size() < MAX_BUFFERED_POINTS) {
+                    m_buffer.insert(m_buffer.end(), points.begin(), points.end());
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        pointsSinceLastRateCheck += points.size();
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastRateTime).count();
+        if (elapsed >= 1) {
+            m_rate = (double)pointsSinceLastRateCheck / (double)elapsed;
+            pointsSinceLastRateCheck = 0;
+            lastRateTime = now;
+        }
+    }, m_running);
+
+    m_finished = true;
+    m_rate = 0.0;
+    Logger::Log(Logger::Level::INFO, "PcmFile", "Reader thread exited (%s, %llu bytes read).",
+                ok ? "end of input" : "error", (unsigned long long)m_bytesRead.load());
+}
+
+} // namespace Entropy
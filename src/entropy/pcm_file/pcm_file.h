@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <functional>
+#include "../entropy_common.h"
+#include "../microphone/pcm_kernels.h"
+
+namespace Entropy {
+
+// Input description for the PCM file/pipe source
+struct PcmFileConfig {
+    std::string path;                   // Regular file, FIFO, character device, or "-" for stdin
+    bool rawInput = false;              // false: parse a WAV header; true: headerless PCM
+    PcmFormat rawFormat = PcmFormat::Int16;
+    int rawLsbShift = 0;                // Raw 24-in-32 captures: padding bits below the LSB
+    size_t windowSamples = 4800;        // Samples per health-gate window (~100 ms mono @ 48 kHz)
+};
+
+// PCM audio entropy source backed by a file or stream.
+// Regular files are memory-mapped (POSIX); pipes and devices are streamed.
+// Uses the same LSB packing kernels and RMS health gate as MicrophoneCollector,
+// so recorded lab captures are conditioned exactly like live capture.
+class PcmFileCollector {
+public:
+    PcmFileCollector();
+    ~PcmFileCollector();
+
+    // Set the input (ignored while running)
+    void Configure(const PcmFileConfig& config);
+
+    // Start background reader thread
+    void Start();
+
+    // Stop background reader
+    void Stop();
+
+    // Is the collector running?
+    bool IsRunning() const;
+
+    // Has the reader reached end of input (or failed)?
+    bool IsFinished() const;
+
+    // Get collected entropy (clears internal buffer and returns data)
+    std::vector<EntropyDataPoint> Harvest();
+
+    // Statistics for GUI / tools
+    double GetEntropyRate() const;        // data points/sec estimate
+    uint64_t GetSampleCount() const;      // Total data points collected
+    uint64_t GetBytesRead() const;        // Raw PCM bytes consumed
+    uint64_t GetRejectedWindows() const;  // Windows dropped by the health gate
+
+    // Headless path: run the whole input through the kernels on the calling thread,
+    // handing each accepted window's points to `sink` (buffer is wiped afterwards).
+    // Returns false if the input could not be opened or parsed.
+    bool Run(const std::function<void(const std::vector<EntropyDataPoint>&)>& sink,
+             const std::atomic<bool>& keepRunning);
+
+private:
+    void ReaderThread();
+    void SecureClearBuffer();
+
+    PcmFileConfig m_config;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_finished{false};
+    std::thread m_readerThread;
+    std::mutex m_mutex;
+    std::vector<EntropyDataPoint> m_buffer;
+
+    std::atomic<uint64_t> m_sampleCount{0};
+    std::atomic<uint64_t> m_bytesRead{0};
+    std::atomic<uint64_t> m_rejectedWindows{0};
+    std::atomic<double> m_rate{0.0};
+};
+
+} // namespace Entropy
@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <map>
-#include <windows.h> // For SecureZeroMemory
+#include "../crypto/secure_mem.h"
 
 namespace Entropy {
 
@@ -54,7 +54,7 @@ void EntropyPool::Clear() {
   std::lock_guard<std::mutex> lock(m_mutex);
   if (!m_data.empty()) {
     // Securely zero all memory before clearing
-    SecureZeroMemory(m_data.data(), m_data.size() * sizeof(EntropyDataPoint));
+    Crypto::SecureZero(m_data.data(), m_data.size() * sizeof(EntropyDataPoint));
     m_data.clear();
     m_data.shrink_to_fit(); // Release memory
   }
@@ -84,22 +84,49 @@ static float CalculateBytesEntropy(const std::vector<uint8_t>& data) {
     return entropyPerByte * totalSamples;
 }
 
+// Collects point bytes for estimation. Sources with a per-point credit cap
+// (see MaxCreditBitsPerPoint) go to a separate stream whose Shannon estimate
+// is clamped to the sum of their caps; everything else shares one stream.
+namespace {
+struct CreditAccumulator {
+  std::vector<uint8_t> shared;
+  std::vector<uint8_t> capped;
+  float cappedCeiling = 0.0f;
+
+  explicit CreditAccumulator(size_t points) { shared.reserve(points * 8); }
+
+  void Add(const EntropyDataPoint &point) {
+    float cap = MaxCreditBitsPerPoint(point.source);
+    std::vector<uint8_t> &stream = (cap < 64.0f) ? capped : shared;
+    if (cap < 64.0f)
+      cappedCeiling += cap;
+
+    uint64_t val = point.value;
+    for (int i = 0; i < 8; i++) {
+      stream.push_back(static_cast<uint8_t>((val >> (i * 8)) & 0xFF));
+    }
+  }
+
+  float Total() const {
+    float bits = CalculateBytesEntropy(shared);
+    if (!capped.empty())
+      bits += std::min(CalculateBytesEntropy(capped), cappedCeiling);
+    return bits;
+  }
+};
+} // namespace
+
 float EntropyPool::GetTotalBits() const {
   std::lock_guard<std::mutex> lock(m_mutex);
 
   if (m_data.empty()) return 0.0f;
 
-  std::vector<uint8_t> byteStream;
-  byteStream.reserve(m_data.size() * 8);
-  
+  CreditAccumulator acc(m_data.size());
   for (const auto& point : m_data) {
-      uint64_t val = point.value;
-      for (int i = 0; i < 8; i++) {
-          byteStream.push_back(static_cast<uint8_t>((val >> (i * 8)) & 0xFF));
-      }
+      acc.Add(point);
   }
   
-  return CalculateBytesEntropy(byteStream);
+  return acc.Total();
 }
 
 float EntropyPool::GetEntropyBitsBefore(uint64_t timestamp) const {
@@ -107,42 +134,34 @@ float EntropyPool::GetEntropyBitsBefore(uint64_t timestamp) const {
 
   if (timestamp == 0 || m_data.empty()) return 0.0f;
 
-  std::vector<uint8_t> byteStream;
-  byteStream.reserve(m_data.size() * 8); // Conservative reserve
+  CreditAccumulator acc(m_data.size()); // Conservative reserve
 
   for (const auto &point : m_data) {
     if (point.timestamp <= timestamp) {
-        uint64_t val = point.value;
-        for (int i = 0; i < 8; i++) {
-            byteStream.push_back(static_cast<uint8_t>((val >> (i * 8)) & 0xFF));
-        }
+        acc.Add(point);
     } else {
       break; // Sorted
     }
   }
 
-  return CalculateBytesEntropy(byteStream);
+  return acc.Total();
 }
 
 float EntropyPool::GetEntropyBitsAfter(
     uint64_t timestamp, const std::set<EntropySource> &includedSources) const {
   std::lock_guard<std::mutex> lock(m_mutex);
 
-  std::vector<uint8_t> byteStream;
-  byteStream.reserve(m_data.size() * 8); // Conservative reserve
+  CreditAccumulator acc(m_data.size()); // Conservative reserve
 
   for (const auto &point : m_data) {
     if (point.timestamp > timestamp) {
       if (includedSources.find(point.source) != includedSources.end()) {
-          uint64_t val = point.value;
-          for (int i = 0; i < 8; i++) {
-              byteStream.push_back(static_cast<uint8_t>((val >> (i * 8)) & 0xFF));
-          }
+          acc.Add(point);
       }
     }
   }
 
-  return CalculateBytesEntropy(byteStream);
+  return acc.Total();
 }
 
 float EntropyPool::GetTotalBits(
@@ -150,8 +169,7 @@ float EntropyPool::GetTotalBits(
     const std::set<EntropySource> &includedSources) const {
   std::lock_guard<std::mutex> lock(m_mutex);
 
-  std::vector<uint8_t> byteStream;
-  byteStream.reserve(m_data.size() * 8);
+  CreditAccumulator acc(m_data.size());
 
   for (const auto &point : m_data) {
     bool include = false;
@@ -165,14 +183,11 @@ float EntropyPool::GetTotalBits(
     }
     
     if (include) {
-        uint64_t val = point.value;
-        for (int i = 0; i < 8; i++) {
-            byteStream.push_back(static_cast<uint8_t>((val >> (i * 8)) & 0xFF));
-        }
+        acc.Add(point);
     }
   }
 
-  return CalculateBytesEntropy(byteStream);
+  return acc.Total();
 }
 
 size_t EntropyPool::GetDataPointCount() const {
@@ -184,7 +199,7 @@ void EntropyPool::SecureWipe() {
   std::lock_guard<std::mutex> lock(m_mutex);
   if (!m_data.empty()) {
     // Securely zero all memory before clearing
-    SecureZeroMemory(m_data.data(), m_data.size() * sizeof(EntropyDataPoint));
+    Crypto::SecureZero(m_data.data(), m_data.size() * sizeof(EntropyDataPoint));
     m_data.clear();
     m_data.shrink_to_fit(); // Release memory
   }
@@ -159,6 +159,7 @@ void RenderMenuBar() {
             out << "Clock Drift: " << (g_state.clockDriftEnabled ? "ON" : "OFF") << std::endl;
             out << "CPU Jitter: " << (g_state.cpuJitterEnabled ? "ON" : "OFF") << std::endl;
             out << "Mouse Movement: " << (g_state.mouseMovementEnabled ? "ON" : "OFF") << std::endl;
+            out << "CPU Hardware RNG: " << (g_state.cpuHwrngEnabled ? "ON" : "OFF") << std::endl;
             out << "Target Bits: " << g_state.targetBits << std::endl;
             out << "Output Format: " << g_state.outputFormat << std::endl;
             out.close();
@@ -188,6 +189,7 @@ void RenderMenuBar() {
         g_state.clockDriftEnabled = true;
         g_state.cpuJitterEnabled = true;
         g_state.mouseMovementEnabled = true;
+        g_state.cpuHwrngEnabled = true;
         g_state.outputFormat = 0;
         g_state.decimalDigits = 16;
         // ... reset other fields as needed
@@ -241,7 +243,9 @@ static void ClearAllEntropyData() {
   g_state.entropyClock = 0.0f;
   g_state.entropyJitter = 0.0f;
   g_state.entropyMouse = 0.0f;
+  g_state.entropyHwrng = 0.0f;
   g_state.collectedBits = 0.0f;
+  g_state.freshBits = 0.0f;
   g_state.lockedDataTimestamp = 0; // Reset lock
 
   // From this point onwards, treat session as clean: don't show logging warning
@@ -274,6 +278,8 @@ void RenderEntropyPoolBar() {
     enabledSources.insert(Entropy::EntropySource::CpuJitter);
   if (g_state.mouseMovementEnabled)
     enabledSources.insert(Entropy::EntropySource::Mouse);
+  if (g_state.cpuHwrngEnabled)
+    enabledSources.insert(Entropy::EntropySource::CpuHwrng);
 
   // Calculate split entropy for visualization
   float lockedBits =
@@ -283,6 +289,7 @@ void RenderEntropyPoolBar() {
 
   // Total is sum of both
   g_state.collectedBits = lockedBits + newBits;
+  g_state.freshBits = newBits; // Drives the collection policy
 
   // Progress bar visualization
   float progressTotal = g_state.collectedBits / g_state.targetBits;
@@ -385,18 +392,38 @@ void RenderEntropyPoolBar() {
   ImGui::SameLine(ImGui::GetWindowWidth() - barRightMargin - clearBtnW -
                   spacing - stopStartBtnW -
                   120.0f); // move to same line, left of status area
-  const char *statusStr =
-      g_state.isCollecting ? "[Collecting...]" : "[Stopped]";
+  Entropy::CollectionState policyState = g_state.collectionPolicy.GetState();
+  const char *statusStr = "[Stopped]";
+  const char *statusTip = "Collection stopped.";
+  if (g_state.isCollecting) {
+    switch (policyState) {
+    case Entropy::CollectionState::Throttled:
+      statusStr = "[Throttled]";
+      statusTip = "Target met: background sources sample at a reduced "
+                  "rate.\nFull rate resumes after Generate or a larger target.";
+      break;
+    case Entropy::CollectionState::Parked:
+      statusStr = "[Idle]";
+      statusTip = "Target well exceeded: background sources are parked.\n"
+                  "Full rate resumes after Generate or a larger target.";
+      break;
+    default:
+      statusStr = "[Collecting...]";
+      statusTip = "Collection in progress.";
+      break;
+    }
+  }
   ImVec2 statusSz = ImGui::CalcTextSize(statusStr);
   ImGui::SetCursorPosX(statusEndX - statusSz.x);
-  if (g_state.isCollecting) {
-    ImGui::TextColored(ImVec4(0.3f, 1.0f, 0.5f, 1.0f), "%s", statusStr);
-  } else {
+  if (!g_state.isCollecting) {
     ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "%s", statusStr);
+  } else if (policyState != Entropy::CollectionState::Active) {
+    ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", statusStr);
+  } else {
+    ImGui::TextColored(ImVec4(0.3f, 1.0f, 0.5f, 1.0f), "%s", statusStr);
   }
   if (ImGui::IsItemHovered()) {
-    ImGui::SetTooltip("%s", g_state.isCollecting ? "Collection in progress."
-                                                 : "Collection stopped.");
+    ImGui::SetTooltip("%s", statusTip);
   }
 
   ImGui::SameLine(buttonStartX);
@@ -483,6 +510,8 @@ void SimulateEntropyCollection() {
     total += g_state.entropyJitter;
   if (g_state.mouseMovementEnabled)
     total += g_state.entropyMouse;
+  if (g_state.cpuHwrngEnabled)
+    total += g_state.entropyHwrng;
 
   g_state.collectedBits = total;
 }
@@ -523,6 +552,10 @@ void RenderNistProgressModal() {
             if (g_state.nistError.empty()) {
                 ImGui::Spacing();
                 ImGui::TextColored(ImVec4(0.2f, 1.0f, 0.2f, 1.0f), "Export Complete!");
+                if (g_state.outputCheckAlarms > 0) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Output self-test raised %llu alarm(s); see the log.",
+                                       (unsigned long long)g_state.outputCheckAlarms.load());
+                }
                 ImGui::Spacing();
                 
                 // Center the close button
@@ -4,12 +4,14 @@
 
 #include "../core/app_state.h"
 #include "../entropy/entropy_common.h"
+#include "../crypto/secure_mem.h"
 #include "../logging/logger.h"
 #include "../logic/csprng.h"
 #include "../logic/logic.h"
 #include "gui.h"
 
 #include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <mutex>
 #include <string>
@@ -93,36 +95,126 @@ void RenderOutputConfigSection() {
       ImGui::TableNextRow();
       ImGui::TableSetColumnIndex(0);
       ImGui::AlignTextToFramePadding();
-      ImGui::Text("Minimum:");
+      ImGui::Text("Range:");
       ImGui::TableSetColumnIndex(1);
-      ImGui::SetNextItemWidth(230);
-      if (ImGui::InputScalar("##Min", ImGuiDataType_S64, &g_state.integerMin)) {
+      if (ImGui::Checkbox("Arbitrary precision", &g_state.integerBigRange)) {
         parametersChanged = true;
         Logger::Log(Logger::Level::INFO, "GUI",
-                    "Output Config [Integer]: Min set to %lld",
-                    g_state.integerMin);
+                    "Output Config [Integer]: Arbitrary precision %s",
+                    g_state.integerBigRange ? "ON" : "OFF");
+      }
+
+      if (g_state.integerBigRange) {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Minimum:");
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::InputText("##MinText", g_state.integerMinText.data(),
+                             g_state.integerMinText.size(),
+                             ImGuiInputTextFlags_CharsDecimal)) {
+          parametersChanged = true;
+        }
+        if (ImGui::IsItemDeactivatedAfterEdit())
+          Logger::Log(Logger::Level::INFO, "GUI",
+                      "Output Config [Integer]: Min set to %s",
+                      g_state.integerMinText.data());
+
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Maximum:");
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::InputText("##MaxText", g_state.integerMaxText.data(),
+                             g_state.integerMaxText.size(),
+                             ImGuiInputTextFlags_CharsDecimal)) {
+          parametersChanged = true;
+        }
+        if (ImGui::IsItemDeactivatedAfterEdit())
+          Logger::Log(Logger::Level::INFO, "GUI",
+                      "Output Config [Integer]: Max set to %s",
+                      g_state.integerMaxText.data());
+
+        // Malformed bounds need no bytes (and generate an error message)
+        if (CSPRNG::BigIntegerBytesNeeded(g_state.integerMinText.data(),
+                                          g_state.integerMaxText.data(),
+                                          1) == 0) {
+          ImGui::TableNextRow();
+          ImGui::TableSetColumnIndex(1);
+          ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f),
+                             "Bounds must be whole decimal numbers.");
+        }
+      } else {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Minimum:");
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(230);
+        if (ImGui::InputScalar("##Min", ImGuiDataType_S64,
+                               &g_state.integerMin)) {
+          parametersChanged = true;
+          Logger::Log(Logger::Level::INFO, "GUI",
+                      "Output Config [Integer]: Min set to %lld",
+                      g_state.integerMin);
+        }
+        if (g_state.integerMin < AppConfig::INTEGER_RANGE_MIN)
+          g_state.integerMin = AppConfig::INTEGER_RANGE_MIN;
+        if (g_state.integerMin > AppConfig::INTEGER_RANGE_MAX)
+          g_state.integerMin = AppConfig::INTEGER_RANGE_MAX;
+
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Maximum:");
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(230);
+        if (ImGui::InputScalar("##Max", ImGuiDataType_S64,
+                               &g_state.integerMax)) {
+          parametersChanged = true;
+          Logger::Log(Logger::Level::INFO, "GUI",
+                      "Output Config [Integer]: Max set to %lld",
+                      g_state.integerMax);
+        }
+        if (g_state.integerMax < AppConfig::INTEGER_RANGE_MIN)
+          g_state.integerMax = AppConfig::INTEGER_RANGE_MIN;
+        if (g_state.integerMax > AppConfig::INTEGER_RANGE_MAX)
+          g_state.integerMax = AppConfig::INTEGER_RANGE_MAX;
       }
-      if (g_state.integerMin < AppConfig::INTEGER_RANGE_MIN)
-        g_state.integerMin = AppConfig::INTEGER_RANGE_MIN;
-      if (g_state.integerMin > AppConfig::INTEGER_RANGE_MAX)
-        g_state.integerMin = AppConfig::INTEGER_RANGE_MAX;
 
       ImGui::TableNextRow();
       ImGui::TableSetColumnIndex(0);
       ImGui::AlignTextToFramePadding();
-      ImGui::Text("Maximum:");
+      ImGui::Text("Count:");
       ImGui::TableSetColumnIndex(1);
       ImGui::SetNextItemWidth(230);
-      if (ImGui::InputScalar("##Max", ImGuiDataType_S64, &g_state.integerMax)) {
+      if (ImGui::InputInt("##IntCount", &g_state.integerCount)) {
         parametersChanged = true;
         Logger::Log(Logger::Level::INFO, "GUI",
-                    "Output Config [Integer]: Max set to %lld",
-                    g_state.integerMax);
+                    "Output Config [Integer]: Count set to %d",
+                    g_state.integerCount);
+      }
+      if (g_state.integerCount < AppConfig::INTEGER_MIN_COUNT)
+        g_state.integerCount = AppConfig::INTEGER_MIN_COUNT;
+      if (g_state.integerCount > AppConfig::INTEGER_MAX_COUNT)
+        g_state.integerCount = AppConfig::INTEGER_MAX_COUNT;
+
+      if (g_state.integerCount > 1) {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Separator:");
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(150);
+        const char *intSeps[] = {"Newline", "Space", "Comma"};
+        if (ImGui::Combo("##IntSep", &g_state.integerSeparator, intSeps, 3)) {
+          Logger::Log(Logger::Level::INFO, "GUI",
+                      "Output Config [Integer]: Separator set to %s",
+                      intSeps[g_state.integerSeparator]);
+        }
       }
-      if (g_state.integerMax < AppConfig::INTEGER_RANGE_MIN)
-        g_state.integerMax = AppConfig::INTEGER_RANGE_MIN;
-      if (g_state.integerMax > AppConfig::INTEGER_RANGE_MAX)
-        g_state.integerMax = AppConfig::INTEGER_RANGE_MAX;
       break;
 
     case 2: // Binary
@@ -196,6 +288,54 @@ void RenderOutputConfigSection() {
       }
       ImGui::SameLine();
       ImGui::TextDisabled("(!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~)");
+
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Also include:");
+      ImGui::TableSetColumnIndex(1);
+      ImGui::SetNextItemWidth(-1);
+      if (ImGui::InputText("##CustomExtra", g_state.customExtraChars.data(),
+                           g_state.customExtraChars.size()))
+        parametersChanged = true;
+      if (ImGui::IsItemDeactivatedAfterEdit())
+        Logger::Log(Logger::Level::INFO, "GUI",
+                    "Output Config [Custom]: Extra characters changed");
+
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Exclude:");
+      ImGui::TableSetColumnIndex(1);
+      ImGui::SetNextItemWidth(230);
+      if (ImGui::InputText("##CustomExclude", g_state.customExcludeChars.data(),
+                           g_state.customExcludeChars.size()))
+        parametersChanged = true;
+      if (ImGui::IsItemDeactivatedAfterEdit())
+        Logger::Log(Logger::Level::INFO, "GUI",
+                    "Output Config [Custom]: Excluded characters changed");
+      ImGui::SameLine();
+      if (ImGui::Checkbox("Ambiguous (0O1Il|)",
+                          &g_state.customExcludeAmbiguous)) {
+        parametersChanged = true;
+        Logger::Log(Logger::Level::INFO, "GUI",
+                    "Output Config [Custom]: Exclude ambiguous toggled %s",
+                    g_state.customExcludeAmbiguous ? "ON" : "OFF");
+      }
+
+      {
+        std::vector<std::string> alphabet;
+        std::string error;
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(1);
+        if (CSPRNG::CurrentCustomAlphabet(alphabet, error))
+          ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f),
+                             "%zu symbols, %.2f bits each", alphabet.size(),
+                             std::log2((double)alphabet.size()));
+        else
+          ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%s",
+                             error.c_str());
+      }
       break;
 
     case 4: { // Bit/Byte
@@ -236,14 +376,27 @@ void RenderOutputConfigSection() {
       ImGui::Text("Format:");
       ImGui::TableSetColumnIndex(1);
       ImGui::SetNextItemWidth(180);
-      const char *outFmts[] = {"Hexadecimal", "Base64", "Binary"};
-      if (ImGui::Combo("##OutFmt", &g_state.bitByteFormat, outFmts, 3)) {
+      const char *outFmts[] = {"Hexadecimal", "Base64", "Binary",
+                               "Base32",      "Base58", "Z85"};
+      if (ImGui::Combo("##OutFmt", &g_state.bitByteFormat, outFmts, 6)) {
         // Note: bitByteFormat logic might need update in core if used elsewhere
         Logger::Log(Logger::Level::INFO, "GUI",
                     "Output Config [Bit/Byte]: Format set to %s",
                     outFmts[g_state.bitByteFormat]);
       }
 
+      if (g_state.bitByteFormat == 4 || g_state.bitByteFormat == 5) {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(1);
+        if (g_state.bitByteFormat == 4)
+          ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f),
+                             "Base58: up to %zu bytes.",
+                             AppConfig::BASE58_MAX_BYTES);
+        else
+          ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f),
+                             "Z85: rounded up to whole 4-byte groups.");
+      }
+
       // Inline Binary Separator Config
       if (g_state.bitByteFormat == 2) { // Binary only
         ImGui::SameLine();
@@ -285,6 +438,23 @@ void RenderOutputConfigSection() {
       if (g_state.passphraseWordCount > AppConfig::PASSPHRASE_MAX_WORDS)
         g_state.passphraseWordCount = AppConfig::PASSPHRASE_MAX_WORDS;
 
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Passphrases:");
+      ImGui::TableSetColumnIndex(1);
+      ImGui::SetNextItemWidth(230);
+      if (ImGui::InputInt("##PassphraseCount", &g_state.passphraseCount)) {
+        parametersChanged = true;
+        Logger::Log(Logger::Level::INFO, "GUI",
+                    "Output Config [Passphrase]: Count set to %d",
+                    g_state.passphraseCount);
+      }
+      if (g_state.passphraseCount < AppConfig::PASSPHRASE_MIN_COUNT)
+        g_state.passphraseCount = AppConfig::PASSPHRASE_MIN_COUNT;
+      if (g_state.passphraseCount > AppConfig::PASSPHRASE_MAX_COUNT)
+        g_state.passphraseCount = AppConfig::PASSPHRASE_MAX_COUNT;
+
       ImGui::TableNextRow();
       ImGui::TableSetColumnIndex(0);
       ImGui::AlignTextToFramePadding();
@@ -303,12 +473,80 @@ void RenderOutputConfigSection() {
                     "Output Config [Passphrase]: Separator changed");
       }
 
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::AlignTextToFramePadding();
+      ImGui::Text("Wordlist:");
+      ImGui::TableSetColumnIndex(1);
+      ImGui::SetNextItemWidth(150);
+      static std::string s_wordListError;
+      const char *wordListSources[] = {"Built-in", "Custom file"};
+      if (ImGui::Combo("##WordListSource", &g_state.passphraseWordListSource,
+                       wordListSources, 2)) {
+        Logger::Log(Logger::Level::INFO, "GUI",
+                    "Output Config [Passphrase]: Wordlist set to %s",
+                    wordListSources[g_state.passphraseWordListSource]);
+        s_wordListError.clear();
+        if (g_state.passphraseWordListSource == 0 ||
+            g_state.passphraseWordListPath[0] != '\0')
+          LoadWordListForGeneration(&s_wordListError);
+        parametersChanged = true;
+      }
+
+      if (g_state.passphraseWordListSource == 1) {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(1);
+        ImGui::SetNextItemWidth(-90);
+        ImGui::InputText("##WordListPath",
+                         g_state.passphraseWordListPath.data(),
+                         g_state.passphraseWordListPath.size(),
+                         ImGuiInputTextFlags_ReadOnly);
+        ImGui::SameLine();
+        if (ImGui::Button("Browse...##WordList")) {
+          OPENFILENAMEA ofn;
+          char szFile[512] = {0};
+          ZeroMemory(&ofn, sizeof(ofn));
+          ofn.lStructSize = sizeof(ofn);
+          ofn.hwndOwner = NULL;
+          ofn.lpstrFile = szFile;
+          ofn.nMaxFile = sizeof(szFile);
+          ofn.lpstrFilter = "Wordlists (*.txt;*.twl)\0*.txt;*.twl\0All Files\0*.*\0";
+          ofn.nFilterIndex = 1;
+          ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
+
+          if (GetOpenFileNameA(&ofn) == TRUE) {
+            strncpy(g_state.passphraseWordListPath.data(), ofn.lpstrFile,
+                    g_state.passphraseWordListPath.size() - 1);
+            g_state.passphraseWordListPath
+                [g_state.passphraseWordListPath.size() - 1] = '\0';
+            s_wordListError.clear();
+            if (LoadWordListForGeneration(&s_wordListError))
+              Logger::Log(Logger::Level::INFO, "GUI",
+                          "Output Config [Passphrase]: Custom wordlist "
+                          "loaded (%zu words)",
+                          LoadedWordListSize());
+            parametersChanged = true;
+          }
+        }
+      }
+
       ImGui::TableNextRow();
       ImGui::TableSetColumnIndex(0);
       ImGui::TableSetColumnIndex(1);
-      ImGui::TextColored(
-          ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
-          "(Using built-in wordlist: 123,565 words, ~16.5 bits/word)");
+      const size_t wordListSize = LoadedWordListSize();
+      if (!s_wordListError.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "(%s)",
+                           s_wordListError.c_str());
+      } else if (wordListSize > 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+                           "(%s wordlist: %zu words, %.2f bits/word)",
+                           g_state.passphraseWordListSource == 1 ? "Custom"
+                                                                 : "Built-in",
+                           wordListSize, std::log2((double)wordListSize));
+      } else {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+                           "(Wordlist not loaded yet)");
+      }
       break;
     }
 
@@ -650,7 +888,7 @@ void RenderOutputSection() {
   if (ImGui::Button("Clear", ImVec2(80, 0))) {
     // SECURITY: Securely wipe output data before clearing
     if (!g_state.generatedOutput.empty()) {
-      SecureZeroMemory(g_state.generatedOutput.data(),
+      Crypto::SecureZero(g_state.generatedOutput.data(),
                        g_state.generatedOutput.size());
     }
     g_state.generatedOutput.clear();
@@ -3,6 +3,7 @@
 #include "gui.h"
 #include "imgui.h"
 #include <cmath>
+#include <cstdio>
 
 
 //=============================================================================
@@ -369,6 +370,8 @@ void RenderSystemInputTab() {
     enabledSources.insert(Entropy::EntropySource::CpuJitter);
   if (g_state.mouseMovementEnabled)
     enabledSources.insert(Entropy::EntropySource::Mouse);
+  if (g_state.cpuHwrngEnabled)
+    enabledSources.insert(Entropy::EntropySource::CpuHwrng);
 
   // Calculate total based on lock-in logic:
   // 1. Locked entropy (everything <= lockedTimestamp) - Always included
@@ -488,6 +491,166 @@ void RenderSystemInputTab() {
     }
   }
   ImGui::Unindent();
+
+  ImGui::Spacing();
+  ImGui::Separator();
+  ImGui::Spacing();
+
+  // 3. CPU Hardware RNG Section
+  ImGui::Text("CPU Hardware RNG (RDSEED / RDRAND)");
+  ImGui::Indent();
+  if (ImGui::CollapsingHeader("How it works##hwrng")) {
+    ImGui::TextWrapped(
+        "Reads the processor's built-in noise source via RDSEED (or RDRAND "
+        "when RDSEED is missing). It fills the 512-bit minimum within "
+        "microseconds of starting, so output is available immediately. "
+        "Because the hardware can't be inspected, each 64-bit sample is "
+        "credited with at most 32 bits, and RDRAND output is folded 16:1. "
+        "Stuck, repeating or biased output fails the health tests and is "
+        "discarded; repeated failures disable the source.");
+  }
+  bool hwrngSupported = Entropy::CpuHwrngCollector::IsSupported();
+  ImGui::BeginDisabled(g_state.isCollecting || !hwrngSupported);
+  if (ImGui::Checkbox("Include CPU Hardware RNG in Final Calculation",
+                      &g_state.cpuHwrngEnabled)) {
+    Logger::Log(Logger::Level::INFO, "GUI", "CPU Hardware RNG source toggled: %s",
+                g_state.cpuHwrngEnabled ? "ON" : "OFF");
+  }
+  ImGui::EndDisabled();
+
+  ImGui::SameLine();
+  if (!hwrngSupported) {
+    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "[Unavailable]");
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("This CPU does not report RDSEED or RDRAND support.");
+    }
+  } else if (g_state.cpuHwrngCollector.HasFailed()) {
+    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "[Health Test Failed]");
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("The hardware RNG produced stuck or biased output and "
+                        "was disabled.\nFailed batches: %llu",
+                        g_state.cpuHwrngCollector.GetHealthFailures());
+    }
+  } else if (!g_state.cpuHwrngEnabled) {
+    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "[Excluded]");
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("This source is disabled by the user and will not "
+                        "contribute to entropy collection.");
+    }
+  } else if (g_state.isCollecting && g_state.cpuHwrngCollector.IsRunning()) {
+    ImGui::TextColored(ImVec4(0.3f, 1.0f, 0.5f, 1.0f), "[Active]");
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Mode: %s\n"
+                        "Samples collected: %llu\n"
+                        "Collection rate: %.0f samples/sec\n"
+                        "Collected entropy: %.1f bits (32 bits/sample max)\n"
+                        "Health test failures: %llu",
+                        g_state.cpuHwrngCollector.GetModeName(),
+                        g_state.cpuHwrngCollector.GetSampleCount(),
+                        g_state.cpuHwrngCollector.GetEntropyRate(),
+                        g_state.entropyHwrng,
+                        g_state.cpuHwrngCollector.GetHealthFailures());
+    }
+    ImGui::Text("    Mode: %s | Samples: %llu | Rate: %.0f samples/sec",
+                g_state.cpuHwrngCollector.GetModeName(),
+                g_state.cpuHwrngCollector.GetSampleCount(),
+                g_state.cpuHwrngCollector.GetEntropyRate());
+  } else {
+    ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "[Ready]");
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip(
+          "CPU hardware RNG is enabled and ready.\n"
+          "A bootstrap burst is read as soon as collection begins.");
+    }
+  }
+  ImGui::Unindent();
+
+  ImGui::Spacing();
+  ImGui::Separator();
+  ImGui::Spacing();
+
+  // 4. Raw Noise Export
+  ImGui::Text("Raw Noise Export (SP 800-90B)");
+  ImGui::Indent();
+  if (ImGui::CollapsingHeader("How it works##noiseexport")) {
+    ImGui::TextWrapped(
+        "Writes the unconditioned samples of every enabled source to "
+        "noise_<source>.bin in the working directory, one sample per byte, "
+        "for ea_iid / ea_non_iid / ea_direct. Samples are taken from each "
+        "collector before pooling: microphone LSBs as 1-bit samples, "
+        "timing and input deltas as their low byte, hardware RNG words as "
+        "bytes. Capture runs while collecting and keeps the background "
+        "sources at full rate until every file is complete. The samples "
+        "also feed the pool, so do not generate secrets from a capture "
+        "session.");
+  }
+
+  static const Entropy::EntropySource EXPORT_SOURCES[] = {
+      Entropy::EntropySource::Microphone, Entropy::EntropySource::Keystroke,
+      Entropy::EntropySource::Mouse,      Entropy::EntropySource::ClockDrift,
+      Entropy::EntropySource::CpuJitter,  Entropy::EntropySource::CpuHwrng};
+  auto sourceEnabled = [](Entropy::EntropySource source) {
+    switch (source) {
+    case Entropy::EntropySource::Microphone: return g_state.microphoneEnabled;
+    case Entropy::EntropySource::Keystroke: return g_state.keystrokeEnabled;
+    case Entropy::EntropySource::Mouse: return g_state.mouseMovementEnabled;
+    case Entropy::EntropySource::ClockDrift: return g_state.clockDriftEnabled;
+    case Entropy::EntropySource::CpuJitter: return g_state.cpuJitterEnabled;
+    case Entropy::EntropySource::CpuHwrng: return g_state.cpuHwrngEnabled;
+    default: return false;
+    }
+  };
+
+  bool capturing = g_state.noiseExporter.IsActive();
+  ImGui::BeginDisabled(capturing);
+  ImGui::SetNextItemWidth(150);
+  if (ImGui::InputInt("Samples per source", &g_state.noiseExportSamples, 100000, 1000000)) {
+    if (g_state.noiseExportSamples < 1000) g_state.noiseExportSamples = 1000;
+  }
+  ImGui::Checkbox("Memory-mapped output", &g_state.noiseExportMapped);
+  ImGui::EndDisabled();
+
+  if (!capturing) {
+    if (ImGui::Button("Start Raw Capture", ImVec2(180, 0))) {
+      g_state.noiseExportStatus.clear();
+      for (Entropy::EntropySource source : EXPORT_SOURCES) {
+        if (!sourceEnabled(source)) continue;
+        std::string path = std::string("noise_") + Entropy::NoiseSourceName(source) + ".bin";
+        std::string error;
+        if (!g_state.noiseExporter.AddSource(source, path, Entropy::DefaultNoiseSampleFormat(source),
+                                             (uint64_t)g_state.noiseExportSamples,
+                                             g_state.noiseExportMapped ? Entropy::NoiseExportOutput::Mapped
+                                                                       : Entropy::NoiseExportOutput::Buffered,
+                                             error)) {
+          g_state.noiseExportStatus = error;
+          Logger::Log(Logger::Level::ERR, "GUI", "Raw capture of %s failed: %s",
+                      Entropy::NoiseSourceName(source), error.c_str());
+        }
+      }
+    }
+  } else if (ImGui::Button("Stop Capture", ImVec2(180, 0))) {
+    std::string error;
+    if (!g_state.noiseExporter.Stop(error)) g_state.noiseExportStatus = error;
+  }
+
+  for (Entropy::EntropySource source : EXPORT_SOURCES) {
+    uint64_t target = g_state.noiseExporter.TargetSamples(source);
+    if (target == 0) continue;
+    uint64_t written = g_state.noiseExporter.SamplesWritten(source);
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "%llu / %llu", (unsigned long long)written,
+             (unsigned long long)target);
+    ImGui::ProgressBar((float)written / (float)target, ImVec2(300, 0), overlay);
+    ImGui::SameLine();
+    ImGui::Text("%s", Entropy::NoiseSourceName(source));
+  }
+  if (capturing && !g_state.isCollecting) {
+    ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "Start collection to capture samples.");
+  }
+  if (!g_state.noiseExportStatus.empty()) {
+    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", g_state.noiseExportStatus.c_str());
+  }
+  ImGui::Unindent();
 }
 
 //=============================================================================
@@ -556,6 +719,8 @@ void RenderCollectionWindow() {
     StatusLine("Clock", true, g_state.clockDriftEnabled, g_state.clockDriftCollector.IsRunning(), g_state.entropyClock);
     ImGui::NextColumn();
     StatusLine("Jitter", FEATURE_CPU_JITTER_IMPLEMENTED, g_state.cpuJitterEnabled, g_state.cpuJitterCollector.IsRunning(), g_state.entropyJitter);
+    ImGui::NextColumn();
+    StatusLine("HWRNG", Entropy::CpuHwrngCollector::IsSupported(), g_state.cpuHwrngEnabled, g_state.cpuHwrngCollector.IsRunning(), g_state.entropyHwrng);
     
     ImGui::Columns(1); // Reset columns
     
@@ -0,0 +1,239 @@
+// libtrng - C ABI over the Quad-Layer pipeline
+// Each pipeline pass uses seed || counter as entropy input and
+// "TRNG-LIB|C:<counter>|P:<personalization>" as HKDF info, so every pass is an
+// independent derivation. Generation runs outside the context lock.
+
+#include "trng.h"
+#include "../crypto/quad_layer.h"
+#include "../crypto/secure_mem.h"
+#include "../crypto/sha512.h"
+#include "../platform/system_seed.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+struct trng_ctx {
+    std::mutex mutex;
+    std::vector<uint8_t> seed;              // Raw seed material || SHA-512 of the previous state
+    std::vector<uint8_t> personalization;
+    uint64_t counter = 0;
+    uint64_t reseedInterval = TRNG_DEFAULT_RESEED_INTERVAL;
+    uint64_t maxRequest = TRNG_DEFAULT_MAX_REQUEST;
+    uint32_t flags = 0;
+    uint32_t sources = 0;
+    uint64_t bytesGenerated = 0;
+    uint64_t fillCalls = 0;
+    uint64_t reseeds = 0;
+    uint64_t sinceReseed = 0;
+#ifndef _WIN32
+    pid_t pid = 0;                          // A forked child must not repeat the parent's stream
+#endif
+};
+
+// Fresh system seed, chained to the previous state and `extra`. Caller holds the lock.
+static int ReseedLocked(trng_ctx* ctx, const void* extra, size_t extraLen) {
+    uint32_t sources = 0;
+    std::vector<uint8_t> fresh = CollectSystemSeed(&sources);
+    if ((ctx->flags & TRNG_FLAG_REQUIRE_OS) && !(sources & SEED_SOURCE_OS)) {
+        Crypto::SecureClearVector(fresh);
+        return TRNG_ERR_ENTROPY;
+    }
+
+    // Carry the old state forward so a weak fresh seed never loses strength
+    std::vector<uint8_t> chain = ctx->seed;
+    if (extra && extraLen > 0) {
+        const uint8_t* p = static_cast<const uint8_t*>(extra);
+        chain.insert(chain.end(), p, p + extraLen);
+    }
+    Crypto::SHA512::Hash carried = Crypto::SHA512::Compute(chain);
+    fresh.insert(fresh.end(), carried.begin(), carried.end());
+
+    Crypto::SecureClearVector(ctx->seed);
+    ctx->seed.swap(fresh);
+    ctx->sources = sources;
+    ctx->sinceReseed = 0;
+#ifndef _WIN32
+    ctx->pid = getpid();
+#endif
+
+    Crypto::SecureClearVector(chain);
+    Crypto::SecureZero(carried.data(), carried.size());
+    return TRNG_OK;
+}
+
+extern "C" {
+
+void trng_config_init(trng_config* cfg) {
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->struct_size = sizeof(trng_config);
+    cfg->reseed_interval = TRNG_DEFAULT_RESEED_INTERVAL;
+    cfg->max_request = TRNG_DEFAULT_MAX_REQUEST;
+}
+
+int trng_open(trng_ctx** out, const trng_config* cfg) {
+    if (!out) return TRNG_ERR_INVALID;
+    *out = nullptr;
+
+    // Read only the fields the caller's header knew about
+    trng_config config;
+    trng_config_init(&config);
+    if (cfg) {
+        if (cfg->struct_size < offsetof(trng_config, max_request)) return TRNG_ERR_INVALID;
+        memcpy(&config, cfg, std::min<size_t>(cfg->struct_size, sizeof(config)));
+    }
+    if (config.max_request == 0) config.max_request = TRNG_DEFAULT_MAX_REQUEST;
+    if (config.personalization_len > 0 && !config.personalization) return TRNG_ERR_INVALID;
+
+    try {
+        trng_ctx* ctx = new trng_ctx;
+        ctx->flags = config.flags;
+        ctx->reseedInterval = config.reseed_interval;
+        ctx->maxRequest = config.max_request;
+        if (config.personalization_len > 0) {
+            const uint8_t* p = static_cast<const uint8_t*>(config.personalization);
+            ctx->personalization.assign(p, p + config.personalization_len);
+        }
+        int rc = ReseedLocked(ctx, nullptr, 0);
+        if (rc != TRNG_OK) {
+            trng_close(ctx);
+            return rc;
+        }
+        *out = ctx;
+        return TRNG_OK;
+    } catch (const std::bad_alloc&) {
+        return TRNG_ERR_NOMEM;
+    } catch (...) {
+        return TRNG_ERR_INTERNAL;
+    }
+}
+
+int trng_fill(trng_ctx* ctx, void* buf, size_t len) {
+    if (!ctx || (!buf && len > 0)) return TRNG_ERR_INVALID;
+    if (len == 0) return TRNG_OK;
+
+    try {
+        // Reserve a counter range and snapshot the seed; generate unlocked
+        const uint64_t passes = (len + ctx->maxRequest - 1) / ctx->maxRequest;
+        uint64_t first = 0;
+        std::vector<uint8_t> seed;
+        std::vector<uint8_t> personalization;
+        {
+            std::lock_guard<std::mutex> lock(ctx->mutex);
+            bool forked = false;
+#ifndef _WIN32
+            forked = ctx->pid != getpid();
+#endif
+            if (forked || (ctx->reseedInterval > 0 && ctx->sinceReseed >= ctx->reseedInterval)) {
+                int rc = ReseedLocked(ctx, nullptr, 0);
+                if (rc != TRNG_OK) return rc;
+                ctx->reseeds++;
+            }
+            first = ctx->counter;
+            ctx->counter += passes;
+            ctx->bytesGenerated += len;
+            ctx->sinceReseed += len;
+            ctx->fillCalls++;
+            seed = ctx->seed;
+            personalization = ctx->personalization;
+        }
+
+        uint8_t* out = static_cast<uint8_t*>(buf);
+        std::vector<uint8_t> entropy;
+        std::vector<uint8_t> info;
+        for (uint64_t pass = 0; pass < passes; pass++) {
+            const uint64_t counter = first + pass + 1;
+            entropy = seed;
+            for (int i = 0; i < 8; i++) entropy.push_back(static_cast<uint8_t>(counter >> (i * 8)));
+
+            std::string label = "TRNG-LIB|C:" + std::to_string(counter) + "|P:";
+            info.assign(label.begin(), label.end());
+            info.insert(info.end(), personalization.begin(), personalization.end());
+
+            size_t piece = (size_t)std::min<uint64_t>(ctx->maxRequest, len);
+            Crypto::QuadLayer::Generate(entropy, info, out, piece);
+            out += piece;
+            len -= piece;
+            Crypto::SecureClearVector(entropy);
+        }
+
+        Crypto::SecureClearVector(seed);
+        Crypto::SecureClearVector(info);
+        Crypto::SecureClearVector(personalization);
+        return TRNG_OK;
+    } catch (const std::bad_alloc&) {
+        return TRNG_ERR_NOMEM;
+    } catch (...) {
+        return TRNG_ERR_INTERNAL;
+    }
+}
+
+int trng_reseed(trng_ctx* ctx, const void* extra, size_t extra_len) {
+    if (!ctx || (!extra && extra_len > 0)) return TRNG_ERR_INVALID;
+    try {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        int rc = ReseedLocked(ctx, extra, extra_len);
+        if (rc == TRNG_OK) ctx->reseeds++;
+        return rc;
+    } catch (const std::bad_alloc&) {
+        return TRNG_ERR_NOMEM;
+    } catch (...) {
+        return TRNG_ERR_INTERNAL;
+    }
+}
+
+int trng_stats(trng_ctx* ctx, trng_stats_t* stats) {
+    if (!ctx || !stats || stats->struct_size < sizeof(uint32_t)) return TRNG_ERR_INVALID;
+
+    trng_stats_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        snapshot.seed_sources = ctx->sources;
+        snapshot.bytes_generated = ctx->bytesGenerated;
+        snapshot.fill_calls = ctx->fillCalls;
+        snapshot.reseeds = ctx->reseeds;
+        snapshot.bytes_since_reseed = ctx->sinceReseed;
+    }
+    size_t size = std::min<size_t>(stats->struct_size, sizeof(snapshot));
+    snapshot.struct_size = (uint32_t)size;
+    memcpy(stats, &snapshot, size);
+    return TRNG_OK;
+}
+
+void trng_close(trng_ctx* ctx) {
+    if (!ctx) return;
+    {
+        std::lock_guard<std::mutex> lock(ctx->mutex);
+        Crypto::SecureClearVector(ctx->seed);
+        Crypto::SecureClearVector(ctx->personalization);
+        ctx->counter = 0;
+    }
+    delete ctx;
+}
+
+const char* trng_strerror(int err) {
+    switch (err) {
+        case TRNG_OK:           return "success";
+        case TRNG_ERR_INVALID:  return "invalid argument";
+        case TRNG_ERR_NOMEM:    return "out of memory";
+        case TRNG_ERR_ENTROPY:  return "required entropy source unavailable";
+        case TRNG_ERR_INTERNAL: return "internal error";
+    }
+    return "unknown error";
+}
+
+uint32_t trng_abi_version(void) {
+    return TRNG_ABI_VERSION;
+}
+
+} // extern "C"
@@ -0,0 +1,112 @@
+/*
+ * libtrng - Embeddable TRNG Quad-Layer generator with a stable C ABI
+ *
+ * Draw random bytes in-process instead of piping from trng_gen: the final
+ * pipeline layer is written straight into the caller's buffer.
+ *
+ *   trng_ctx* ctx;
+ *   if (trng_open(&ctx, NULL) == TRNG_OK) {
+ *       uint8_t key[32];
+ *       trng_fill(ctx, key, sizeof(key));
+ *       trng_close(ctx);
+ *   }
+ *
+ * A context is seeded from the OS CSPRNG, the CPU DRNG (RDSEED/RDRAND) and
+ * timing samples, and reseeds itself automatically (interval, fork).
+ * All functions are thread-safe; concurrent trng_fill calls on one context
+ * run in parallel. Build with build_lib.sh (Linux and MinGW).
+ *
+ * ABI rules: functions are only ever added; structs carry struct_size and only
+ * grow at the end, so a binary built against an older header keeps working.
+ */
+
+#ifndef TRNG_LIB_H
+#define TRNG_LIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(TRNG_BUILD_SHARED)
+#    define TRNG_API __declspec(dllexport)
+#  elif defined(TRNG_USE_SHARED)
+#    define TRNG_API __declspec(dllimport)
+#  else
+#    define TRNG_API
+#  endif
+#elif defined(__GNUC__)
+#  define TRNG_API __attribute__((visibility("default")))
+#else
+#  define TRNG_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRNG_ABI_VERSION 1
+
+/* Return codes (negative = error) */
+#define TRNG_OK            0
+#define TRNG_ERR_INVALID  -1    /* NULL context/buffer or bad config */
+#define TRNG_ERR_NOMEM    -2    /* Allocation failed */
+#define TRNG_ERR_ENTROPY  -3    /* Required seed source unavailable */
+#define TRNG_ERR_INTERNAL -4    /* Unexpected failure inside the pipeline */
+
+/* Seed sources (trng_stats_t.seed_sources) */
+#define TRNG_SOURCE_TIMING 0x1u  /* Cycle counter jitter, clocks, ids */
+#define TRNG_SOURCE_OS     0x2u  /* getrandom(2) / BCryptGenRandom */
+#define TRNG_SOURCE_DRNG   0x4u  /* RDSEED, RDRAND fallback */
+
+/* Config flags */
+#define TRNG_FLAG_REQUIRE_OS 0x1u  /* Fail open/reseed without the OS CSPRNG */
+
+#define TRNG_DEFAULT_RESEED_INTERVAL (1ull << 30)  /* 1 GiB */
+#define TRNG_DEFAULT_MAX_REQUEST     (1u << 20)    /* 1 MiB per pipeline pass */
+
+typedef struct trng_ctx trng_ctx;
+
+typedef struct trng_config {
+    uint32_t struct_size;           /* sizeof(trng_config), set by trng_config_init */
+    uint32_t flags;                 /* TRNG_FLAG_* */
+    uint64_t reseed_interval;       /* Bytes between automatic reseeds; 0 = never */
+    uint64_t max_request;           /* Bytes per pipeline pass (scratch memory bound) */
+    const void* personalization;    /* Optional domain label mixed into every request */
+    size_t personalization_len;
+} trng_config;
+
+typedef struct trng_stats_t {
+    uint32_t struct_size;           /* Set by the caller to sizeof(trng_stats_t) */
+    uint32_t seed_sources;          /* TRNG_SOURCE_* bits of the current seed */
+    uint64_t bytes_generated;       /* Total bytes handed out */
+    uint64_t fill_calls;            /* Successful trng_fill calls */
+    uint64_t reseeds;               /* Reseeds since open (manual, interval, fork) */
+    uint64_t bytes_since_reseed;
+} trng_stats_t;
+
+/* Fill `cfg` with defaults (always call before changing fields) */
+TRNG_API void trng_config_init(trng_config* cfg);
+
+/* Create and seed a context. `cfg` may be NULL for defaults. */
+TRNG_API int trng_open(trng_ctx** ctx, const trng_config* cfg);
+
+/* Fill `buf` with `len` random bytes */
+TRNG_API int trng_fill(trng_ctx* ctx, void* buf, size_t len);
+
+/* Collect a fresh seed now; `extra` (optional) is mixed in as additional input */
+TRNG_API int trng_reseed(trng_ctx* ctx, const void* extra, size_t extra_len);
+
+/* Snapshot counters. Set stats->struct_size first; unknown trailing fields stay untouched. */
+TRNG_API int trng_stats(trng_ctx* ctx, trng_stats_t* stats);
+
+/* Wipe and free the context (NULL is ignored) */
+TRNG_API void trng_close(trng_ctx* ctx);
+
+TRNG_API const char* trng_strerror(int err);
+TRNG_API uint32_t trng_abi_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRNG_LIB_H */
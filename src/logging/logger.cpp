@@ -1,5 +1,9 @@
 #include "logger.h"
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/time.h>
+#endif
 #include <cstdio>
 #include <cstdarg>
 #include <ctime>
@@ -18,6 +22,37 @@ static bool g_enabled = false;
 static std::string g_logDir;
 static std::string g_currentLogPath;
 
+// Worst case of the timestamp format: seven ints of up to 11 characters,
+// six separators and the terminator (a valid clock needs 24)
+static constexpr size_t TIMESTAMP_BYTES = 7 * 11 + 6 + 1;
+
+// "YYYY-MM-DD HH:MM:SS.mmm" in local time
+static void FormatTimestamp(char* out, size_t size) {
+#ifdef _WIN32
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+             st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    time_t secs = tv.tv_sec;
+    struct tm t;
+    localtime_r(&secs, &t);
+    snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+             t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec,
+             (int)(tv.tv_usec / 1000));
+#endif
+}
+
+// Mirror a log line to the debugger (Windows) and stdout
+static void EmitLine(const char* logLine) {
+#ifdef _WIN32
+    OutputDebugStringA(logLine);
+#endif
+    printf("%s", logLine);
+}
+
 void Init(const char* logDir) {
     std::lock_guard<std::mutex> lock(g_logMutex);
     if (g_initialized) return;
@@ -54,7 +89,11 @@ void SetEnabled(bool enabled) {
         if (!g_logFile.is_open()) {
             time_t now = time(nullptr);
             struct tm t;
+#ifdef _WIN32
             localtime_s(&t, &now);
+#else
+            localtime_r(&now, &t);
+#endif
             // Create directory lazily when first enabled
             std::error_code ec;
             std::filesystem::create_directories(g_logDir, ec);
@@ -72,36 +111,28 @@ void SetEnabled(bool enabled) {
             g_enabled = true;
             // We can't use LogInternal here easily because we are holding the lock and LogInternal is static/helper
             // Let's just define LogInternal as a proper helper first.
-            SYSTEMTIME st;
-            GetLocalTime(&st);
-            char timestamp[32];
-            snprintf(timestamp, sizeof(timestamp), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
-                 st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+            char timestamp[TIMESTAMP_BYTES];
+            FormatTimestamp(timestamp, sizeof(timestamp));
             char logLine[4096];
             snprintf(logLine, sizeof(logLine), "[%s] [INFO ] [Logger] Logging enabled by user.\n", timestamp);
             if (g_logFile.is_open()) {
                  g_logFile << logLine;
                  g_logFile.flush();
             }
-            OutputDebugStringA(logLine);
-            printf("%s", logLine);
+            EmitLine(logLine);
         }
     } else {
         // Disable
         if (g_enabled) {
-            SYSTEMTIME st;
-            GetLocalTime(&st);
-            char timestamp[32];
-            snprintf(timestamp, sizeof(timestamp), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
-                 st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+            char timestamp[TIMESTAMP_BYTES];
+            FormatTimestamp(timestamp, sizeof(timestamp));
             char logLine[4096];
             snprintf(logLine, sizeof(logLine), "[%s] [INFO ] [Logger] Logging disabled by user.\n", timestamp);
             if (g_logFile.is_open()) {
                  g_logFile << logLine;
                  g_logFile.flush();
             }
-            OutputDebugStringA(logLine);
-            printf("%s", logLine);
+            EmitLine(logLine);
 
             g_enabled = false;
             // Keep file open? Or close? User said "only start keep keeping logs if this option is turned on".
@@ -117,11 +148,8 @@ void SetEnabled(bool enabled) {
 // Helper that doesn't lock (assumes caller holds lock)
 void LogInternal(Level level, const char* module, const char* message) {
     // 1. Format timestamp
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-    char timestamp[32];
-    snprintf(timestamp, sizeof(timestamp), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
-             st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+    char timestamp[TIMESTAMP_BYTES];
+    FormatTimestamp(timestamp, sizeof(timestamp));
 
     const char* levelStr = "UNKNOWN";
     switch (level) {
@@ -144,8 +172,7 @@ void LogInternal(Level level, const char* module, const char* message) {
     // This implies if keeps logs IS on, we probably still want debug output? 
     // Or maybe they meant "logging function" generally.
     // Let's keep debug output when enabled for developer sanity, but strictly bypass when disabled.
-    OutputDebugStringA(logLine);
-    printf("%s", logLine);
+    EmitLine(logLine);
 }
 
 bool IsEnabled() {
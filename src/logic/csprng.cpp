@@ -1,24 +1,63 @@
 #include "csprng.h"
 #include "../../config/AppConfig.h"
 #include "../core/app_state.h"
-#include "../crypto/aes.h"
-#include "../crypto/chacha20.h"
 #include "../crypto/hkdf.h"
+#include "../crypto/quad_layer.h"
 #include "../crypto/secure_mem.h"
-#include "../crypto/sha512.h"
 #include "../logging/logger.h"
+#include "../stats/quick_battery.h"
+#include "encoding.h"
 #include "logic.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
-#include <iomanip>
+#include <mutex>
 #include <set>
 #include <sstream>
-#include <windows.h> // For SecureZeroMemory
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_BINARY_SSE2 1
+#endif
 
 
 namespace CSPRNG {
 
+//=============================================================================
+// OUTPUT SELF-TEST
+//=============================================================================
+
+// Every GenerateRandomBytes output of at least one window is run through the
+// quick battery in place. Outputs are passwords, passphrases and keys, so
+// nothing is copied or kept between calls: the output is split into equal
+// windows of at least MIN_WINDOW bytes (a remainder of under 8 bytes per
+// window goes untested). Shorter outputs are too small to test on their own.
+static void CheckOutput(const std::vector<uint8_t> &bytes) {
+  const size_t windows = bytes.size() / Stats::QuickBattery::MIN_WINDOW;
+  if (windows == 0)
+    return;
+  const size_t windowBytes = (bytes.size() / windows) & ~(size_t)7;
+  Stats::QuickBattery battery(windowBytes);
+  int alarms = battery.Feed(bytes.data(), windows * windowBytes);
+  if (alarms == 0)
+    return;
+
+  g_state.outputCheckAlarms += alarms;
+  const Stats::QuickBattery::Alarm &alarm = battery.LastAlarm();
+  Logger::Log(Logger::Level::ERR, "CSPRNG",
+              "Output self-test alarm: %s p=%.3g in window %llu of %zu "
+              "(%d alarm(s) in this output)",
+              Stats::QuickBattery::ResultName(alarm.result), alarm.pValue,
+              (unsigned long long)alarm.window, windows, alarms);
+}
+
 //=============================================================================
 // ENTROPY SERIALIZATION
 //=============================================================================
@@ -87,12 +126,7 @@ GenerateRandomBytes(const std::vector<Entropy::EntropyDataPoint> &entropyData,
   // Layer 3: AES-256 Transformation (Block Cipher)
   // Layer 4: ChaCha20 Final Whitening (Stream Cipher)
 
-  //-------------------------------------------------------------------------
-  // LAYER 1: ChaCha20 Masking
-  //-------------------------------------------------------------------------
-  // Hash pool + params to get master seed
-  Crypto::SHA512::Hash masterSeed = Crypto::SHA512::Compute(entropyBytes);
-
+  // HKDF info for Layer 1: format + params ensure avalanche between requests
   std::ostringstream infoStream;
   infoStream << "TRNG-L1|Len:" << numBytes << "|Fmt:" << g_state.outputFormat
              << "|";
@@ -102,7 +136,12 @@ GenerateRandomBytes(const std::vector<Entropy::EntropyDataPoint> &entropyData,
     infoStream << "D:" << g_state.decimalDigits;
     break;
   case 1:
-    infoStream << "I:" << g_state.integerMin << ":" << g_state.integerMax;
+    if (g_state.integerBigRange)
+      infoStream << "I:" << g_state.integerMinText.data() << ":"
+                 << g_state.integerMaxText.data();
+    else
+      infoStream << "I:" << g_state.integerMin << ":" << g_state.integerMax;
+    infoStream << "N:" << g_state.integerCount;
     break;
   case 2:
     infoStream << "B:" << g_state.binaryLength;
@@ -114,7 +153,8 @@ GenerateRandomBytes(const std::vector<Entropy::EntropyDataPoint> &entropyData,
     infoStream << "U:" << g_state.bitByteUnit << "A:" << g_state.bitByteAmount;
     break;
   case 5:
-    infoStream << "W:" << g_state.passphraseWordCount;
+    infoStream << "W:" << g_state.passphraseWordCount
+               << "N:" << g_state.passphraseCount;
     break;
   case 6:
     infoStream << "O:" << g_state.otpInputMode;
@@ -124,86 +164,15 @@ GenerateRandomBytes(const std::vector<Entropy::EntropyDataPoint> &entropyData,
   std::string infoStr = infoStream.str();
   std::vector<uint8_t> info(infoStr.begin(), infoStr.end());
 
-  std::vector<uint8_t> salt;
-  std::vector<uint8_t> keyMaterial = Crypto::HKDF::DeriveKey(
-      std::vector<uint8_t>(masterSeed.begin(), masterSeed.end()), salt, info,
-      44);
-
-  Crypto::ChaCha20::Key key1;
-  Crypto::ChaCha20::Nonce nonce1;
-  std::copy(keyMaterial.begin(), keyMaterial.begin() + 32, key1.begin());
-  std::copy(keyMaterial.begin() + 32, keyMaterial.begin() + 44, nonce1.begin());
-
-  std::vector<uint8_t> stream1 =
-      Crypto::ChaCha20::GenerateStream(key1, nonce1, numBytes);
-
-  //-------------------------------------------------------------------------
-  // LAYER 2: Entropy Injection (XOR Fold)
-  //-------------------------------------------------------------------------
-  // Fold full entropy pool into stream1
-  // Fold full entropy pool into stream1
-  // FIX: Iterate over whichever is larger to ensure ALL entropy is mixed in
-  // If pool > stream, we wrap around stream index
-  // If stream > pool, we wrap around pool index
-  if (!entropyBytes.empty()) {
-    size_t loopCount = std::max(stream1.size(), entropyBytes.size());
-    for (size_t i = 0; i < loopCount; i++) {
-      stream1[i % stream1.size()] ^= entropyBytes[i % entropyBytes.size()];
-    }
-  }
-  // Logger::Log(Logger::Level::DEBUG, "CSPRNG", "Layer 2: Entropy Fold
-  // Complete");
-
-  //-------------------------------------------------------------------------
-  // LAYER 3: AES-256 Transformation
-  //-------------------------------------------------------------------------
-  // Use Hash(Stream1) to key AES-256 for transforming Stream1
-  Crypto::SHA512::Hash s1Hash = Crypto::SHA512::Compute(stream1);
-
-  std::vector<uint8_t> aesKey(s1Hash.begin(),
-                              s1Hash.begin() + 32); // 32 bytes Key
-  std::vector<uint8_t> aesIV(s1Hash.begin() + 32,
-                             s1Hash.begin() + 48); // 16 bytes IV
-
-  std::vector<uint8_t> stream3 =
-      Crypto::AES256::EncryptCTR(aesKey, aesIV, stream1);
-  // Logger::Log(Logger::Level::DEBUG, "CSPRNG", "Layer 3: AES-256
-  // Transformation Complete");
-
-  //-------------------------------------------------------------------------
-  // LAYER 4: ChaCha20 Final Whitening
-  //-------------------------------------------------------------------------
-  // Use Hash(Stream3) to seed final ChaCha20 pass
-  // This ensures AES bias (if any existed, which shouldn't) is washed away
-  Crypto::SHA512::Hash s3Hash = Crypto::SHA512::Compute(stream3);
-
-  std::vector<uint8_t> info4 = {'L', 'A', 'Y', 'E', 'R', '4'};
-  std::vector<uint8_t> key4Mat = Crypto::HKDF::DeriveKey(
-      std::vector<uint8_t>(s3Hash.begin(), s3Hash.end()), salt, info4, 44);
-
-  Crypto::ChaCha20::Key key4;
-  Crypto::ChaCha20::Nonce nonce4;
-  std::copy(key4Mat.begin(), key4Mat.begin() + 32, key4.begin());
-  std::copy(key4Mat.begin() + 32, key4Mat.begin() + 44, nonce4.begin());
-
+  // Layers 1-4 (shared with trng_gen and libtrng)
   std::vector<uint8_t> result =
-      Crypto::ChaCha20::GenerateStream(key4, nonce4, numBytes);
-  // Logger::Log(Logger::Level::DEBUG, "CSPRNG", "Layer 4: Final Whitening
-  // Complete");
-
-  // 7. Debug Logging REMOVED for Security
-
-  // 8. Secure Cleanup
-  SecureZeroMemory(entropyBytes.data(), entropyBytes.size());
-  SecureZeroMemory(masterSeed.data(), masterSeed.size());
-  SecureZeroMemory(keyMaterial.data(), keyMaterial.size());
-  SecureZeroMemory(stream1.data(), stream1.size());
-  SecureZeroMemory(s1Hash.data(), s1Hash.size());
-  SecureZeroMemory(aesKey.data(), aesKey.size());
-  SecureZeroMemory(stream3.data(), stream3.size());
-  SecureZeroMemory(s3Hash.data(), s3Hash.size());
-  SecureZeroMemory(key4Mat.data(), key4Mat.size());
+      Crypto::QuadLayer::Generate(entropyBytes, info, numBytes);
+
+  // Secure Cleanup (QuadLayer wipes its own intermediates)
+  Crypto::SecureZero(entropyBytes.data(), entropyBytes.size());
+  Crypto::SecureZero(info.data(), info.size());
 
+  CheckOutput(result);
   return result;
 }
 
@@ -222,10 +191,200 @@ std::vector<uint8_t> ExpandEntropy(const std::vector<uint8_t> &entropyBytes,
   return {};
 }
 
+//=============================================================================
+// RANDOM WORD READER
+//=============================================================================
+
+namespace {
+
+// Sequential 64-bit words over a GenerateRandomBytes buffer. Rejection
+// samplers request enough words for their worst realistic case (see
+// RejectionWords); running dry anyway is reported as an error rather than
+// falling back to a biased value.
+class RandomWords {
+public:
+  explicit RandomWords(const std::vector<uint8_t> &bytes) : m_bytes(bytes) {}
+
+  uint64_t Next() {
+    if (m_pos + 8 > m_bytes.size())
+      throw std::runtime_error(
+          "Random data exhausted by rejection sampling. Please retry.");
+    uint64_t word;
+    memcpy(&word, m_bytes.data() + m_pos, 8);
+    m_pos += 8;
+    return word;
+  }
+
+private:
+  const std::vector<uint8_t> &m_bytes;
+  size_t m_pos = 0;
+};
+
+// Words to request for `accepted` draws when each word is accepted with
+// probability `acceptance`: the mean plus 16 standard deviations plus a
+// fixed 64 for short outputs, so running out is never seen in practice.
+uint64_t RejectionWords(uint64_t accepted, double acceptance) {
+  double mean = (double)accepted / acceptance;
+  double spread = std::sqrt((double)accepted * (1.0 - acceptance)) / acceptance;
+  return (uint64_t)std::ceil(mean + 16.0 * spread) + 64;
+}
+
+} // namespace
+
+//=============================================================================
+// BINARY EXPANSION
+//=============================================================================
+
+namespace {
+
+// Input bytes expanded per step: 64 KB of digits, small enough to stay in
+// L1/L2 while separators are inserted
+constexpr size_t BINARY_CHUNK_BYTES = 8192;
+
+// "00000000".."11111111" for every byte value, most and least significant
+// bit first. Used for the scalar path and partial bytes.
+struct BinaryDigitTable {
+  char digits[2][256][8];
+  BinaryDigitTable() {
+    for (int b = 0; b < 256; b++) {
+      for (int k = 0; k < 8; k++) {
+        digits[0][b][k] = ((b >> k) & 1) ? '1' : '0';
+        digits[1][b][k] = ((b >> (7 - k)) & 1) ? '1' : '0';
+      }
+    }
+  }
+};
+const BinaryDigitTable BINARY_DIGITS;
+
+// 8 digits per input byte, no separators. SSE2 turns 8 bytes into 64 digits
+// by broadcasting each byte to 8 lanes, testing one bit per lane and
+// subtracting the 0x00/0xFF result from '0'.
+void ExpandBits(const uint8_t *in, size_t bytes, char *out, bool msbFirst) {
+  size_t i = 0;
+#ifdef TRNG_BINARY_SSE2
+  const __m128i select =
+      msbFirst ? _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32,
+                              64, -128)
+               : _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16,
+                              8, 4, 2, 1);
+  const __m128i zero = _mm_set1_epi8('0');
+  for (; i + 8 <= bytes; i += 8) {
+    __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+    v = _mm_unpacklo_epi8(v, v);                   // b0 b0 b1 b1 .. b7 b7
+    __m128i lo = _mm_unpacklo_epi16(v, v);         // b0 x4 .. b3 x4
+    __m128i hi = _mm_unpackhi_epi16(v, v);         // b4 x4 .. b7 x4
+    __m128i q[4] = {_mm_unpacklo_epi32(lo, lo), _mm_unpackhi_epi32(lo, lo),
+                    _mm_unpacklo_epi32(hi, hi), _mm_unpackhi_epi32(hi, hi)};
+    for (int k = 0; k < 4; k++) {
+      __m128i set = _mm_cmpeq_epi8(_mm_and_si128(q[k], select), select);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 8 + k * 16),
+                       _mm_sub_epi8(zero, set));
+    }
+  }
+#endif
+  const int order = msbFirst ? 1 : 0;
+  for (; i < bytes; i++)
+    memcpy(out + i * 8, BINARY_DIGITS.digits[order][in[i]], 8);
+}
+
+// Digits of the first `bits` bits of `in` (ceil(bits / 8) bytes)
+void ExpandBitRange(const uint8_t *in, size_t bits, char *out, bool msbFirst) {
+  size_t whole = bits / 8;
+  ExpandBits(in, whole, out, msbFirst);
+  if (bits % 8)
+    memcpy(out + whole * 8, BINARY_DIGITS.digits[msbFirst ? 1 : 0][in[whole]],
+           bits % 8);
+}
+
+// Characters WriteBinary produces
+size_t BinaryChars(size_t bits, size_t interval) {
+  if (bits == 0)
+    return 0;
+  return bits + (interval ? (bits - 1) / interval : 0);
+}
+
+// Writes `bits` digits of `in`, a space after every `interval` digits
+// (0 = none) but not after the last. Digits are expanded a chunk at a time
+// into a staging buffer and copied out a group at a time.
+void WriteBinary(const uint8_t *in, size_t bits, bool msbFirst,
+                 size_t interval, char *out) {
+  if (interval == 0 || interval >= bits) {
+    for (size_t done = 0; done < bits; done += BINARY_CHUNK_BYTES * 8) {
+      if (g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+      size_t n = std::min(bits - done, BINARY_CHUNK_BYTES * 8);
+      ExpandBitRange(in + done / 8, n, out + done, msbFirst);
+    }
+    return;
+  }
+
+  std::vector<char> stage(BINARY_CHUNK_BYTES * 8);
+  size_t untilSeparator = interval;
+  for (size_t done = 0; done < bits; done += BINARY_CHUNK_BYTES * 8) {
+    if (g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    size_t n = std::min(bits - done, BINARY_CHUNK_BYTES * 8);
+    ExpandBitRange(in + done / 8, n, stage.data(), msbFirst);
+
+    for (size_t p = 0; p < n;) {
+      size_t take = std::min(untilSeparator, n - p);
+      memcpy(out, stage.data() + p, take);
+      out += take;
+      p += take;
+      untilSeparator -= take;
+      if (untilSeparator == 0) {
+        if (done + p < bits)
+          *out++ = ' ';
+        untilSeparator = interval;
+      }
+    }
+  }
+  Crypto::SecureClearVector(stage);
+}
+
+} // namespace
+
 //=============================================================================
 // FORMAT-SPECIFIC GENERATORS
 //=============================================================================
 
+// Decimal digits come in blocks of 18: a word below 18 * 10^18 is uniform
+// modulo 10^18 and is accepted with probability 0.976, so a digit costs
+// 0.456 bytes (the optimum is log2(10) / 8 = 0.415). 19-digit blocks fit a
+// word only once (10^19 > 2^64 / 2) and would reject 46% of words.
+static const uint64_t DECIMAL_BLOCK = 1000000000000000000ULL; // 10^18
+static const size_t DECIMAL_BLOCK_DIGITS = 18;
+static const uint64_t DECIMAL_LIMIT = 18 * DECIMAL_BLOCK;
+
+static const char DIGIT_PAIRS[] = "00010203040506070809"
+                                  "10111213141516171819"
+                                  "20212223242526272829"
+                                  "30313233343536373839"
+                                  "40414243444546474849"
+                                  "50515253545556575859"
+                                  "60616263646566676869"
+                                  "70717273747576777879"
+                                  "80818283848586878889"
+                                  "90919293949596979899";
+
+// Exactly 9 digits of v (< 10^9), leading zeros included
+static void WriteDigits9(char *out, uint32_t v) {
+  for (int pos = 7; pos >= 1; pos -= 2) {
+    memcpy(out + pos, DIGIT_PAIRS + (v % 100) * 2, 2);
+    v /= 100;
+  }
+  out[0] = static_cast<char>('0' + v);
+}
+
+size_t DecimalBytesNeeded(int digits) {
+  if (digits <= 0)
+    return 0;
+  uint64_t blocks =
+      (static_cast<uint64_t>(digits) + DECIMAL_BLOCK_DIGITS - 1) /
+      DECIMAL_BLOCK_DIGITS;
+  return static_cast<size_t>(
+      RejectionWords(blocks, (double)DECIMAL_LIMIT / 18446744073709551616.0) *
+      8);
+}
+
 std::vector<char> GenerateDecimal(const std::vector<uint8_t> &randomBytes,
                                   int digits) {
   if (randomBytes.empty() || digits <= 0) {
@@ -233,311 +392,714 @@ std::vector<char> GenerateDecimal(const std::vector<uint8_t> &randomBytes,
     return std::vector<char>(s.begin(), s.end());
   }
 
-  std::ostringstream oss;
-  oss << "0.";
-
-  // Rejection Sampling for base 10
-  // Range: 10. Source: 2 bytes (0-65535).
-  // Limit: 65535 - (65535 % 10) = 65530.
-  // Accept if val < 65530.
-  const uint16_t LIMIT = 65530;
+  std::vector<char> result(2 + static_cast<size_t>(digits));
+  result[0] = '0';
+  result[1] = '.';
+  char *out = result.data() + 2;
+  size_t remaining = static_cast<size_t>(digits);
+
+  RandomWords words(randomBytes);
+  char tail[DECIMAL_BLOCK_DIGITS];
+
+  for (uint64_t block = 0; remaining > 0; block++) {
+    if ((block & 0xFFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+
+    uint64_t word;
+    do {
+      word = words.Next();
+    } while (word >= DECIMAL_LIMIT);
+    word %= DECIMAL_BLOCK;
+
+    // Full blocks go straight into the output; the last one is cut to length
+    size_t count = std::min(remaining, DECIMAL_BLOCK_DIGITS);
+    char *dst = (count == DECIMAL_BLOCK_DIGITS) ? out : tail;
+    WriteDigits9(dst, static_cast<uint32_t>(word / 1000000000));
+    WriteDigits9(dst + 9, static_cast<uint32_t>(word % 1000000000));
+    if (dst == tail) {
+      memcpy(out, tail, count);
+      Crypto::SecureZero(tail, sizeof(tail));
+    }
+    out += count;
+    remaining -= count;
+  }
 
-  size_t byteIdx = 0;
+  return result;
+}
 
-  for (int i = 0; i < digits; i++) {
-    if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-    uint16_t val = 0;
-    bool found = false;
+//-----------------------------------------------------------------------------
+// Integers (64-bit)
+//-----------------------------------------------------------------------------
 
-    while (byteIdx + 1 < randomBytes.size()) {
-      val = (static_cast<uint16_t>(randomBytes[byteIdx]) << 8) |
-            randomBytes[byteIdx + 1];
-      byteIdx += 2;
+// Integer values are separated by newlines, spaces or commas
+static const char *IntegerSeparator(int separator) {
+  switch (separator) {
+  case 1:
+    return " ";
+  case 2:
+    return ", ";
+  default:
+    return "\n";
+  }
+}
 
-      if (val < LIMIT) {
-        found = true;
-        break;
-      }
-      // Reject and try next 2 bytes
+// Uniform in [0, range) by Lemire's multiply-shift: the high word of
+// x * range is uniform once the low word clears 2^64 mod range, and that
+// remainder is only computed when the low word falls below range.
+static uint64_t UniformBelow(RandomWords &words, uint64_t range) {
+  unsigned __int128 product = (unsigned __int128)words.Next() * range;
+  uint64_t low = static_cast<uint64_t>(product);
+  if (low < range) {
+    uint64_t threshold = (0 - range) % range;
+    while (low < threshold) {
+      product = (unsigned __int128)words.Next() * range;
+      low = static_cast<uint64_t>(product);
     }
+  }
+  return static_cast<uint64_t>(product >> 64);
+}
 
-    if (!found) {
-      // Should not happen with 4x buffer, but handle safe
-      val = 0;
-    }
+// Span of [min, max] minus one (UINT64_MAX for the full 64-bit range)
+static uint64_t IntegerSpan(long long &min, long long &max) {
+  if (min > max)
+    std::swap(min, max);
+  return static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+}
+
+static int64_t IntegerSample(RandomWords &words, long long min,
+                             uint64_t span) {
+  uint64_t offset =
+      (span == UINT64_MAX) ? words.Next() : UniformBelow(words, span + 1);
+  return static_cast<int64_t>(static_cast<uint64_t>(min) + offset);
+}
 
-    int digit = val % 10;
-    oss << digit;
+size_t IntegerBytesNeeded(long long min, long long max, size_t count) {
+  uint64_t span = IntegerSpan(min, max);
+  double acceptance = 1.0;
+  if (span != UINT64_MAX) {
+    uint64_t range = span + 1;
+    acceptance = 1.0 - (double)((0 - range) % range) / 18446744073709551616.0;
   }
+  return static_cast<size_t>(RejectionWords(count, acceptance) * 8);
+}
 
-  std::string s = oss.str();
-  std::vector<char> result(s.begin(), s.end());
-  SecureZeroMemory(s.data(), s.size());
-  return result;
+void GenerateIntegerValues(const std::vector<uint8_t> &randomBytes,
+                           long long min, long long max, int64_t *out,
+                           size_t count) {
+  uint64_t span = IntegerSpan(min, max);
+  RandomWords words(randomBytes);
+  for (size_t i = 0; i < count; i++) {
+    if ((i & 0xFFFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    out[i] = IntegerSample(words, min, span);
+  }
 }
 
-std::vector<char> GenerateInteger(const std::vector<uint8_t> &randomBytes,
-                                  int min, int max) {
-  if (min > max)
-    std::swap(min, max);
-  if (randomBytes.empty()) {
-    std::string s = std::to_string(min);
+std::vector<char> GenerateIntegers(const std::vector<uint8_t> &randomBytes,
+                                   long long min, long long max, size_t count,
+                                   int separator) {
+  if (randomBytes.empty() || count == 0) {
+    std::string s = std::to_string(std::min(min, max));
     return std::vector<char>(s.begin(), s.end());
   }
 
-  uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
-  if (range == 0)
-    range = 1; // Overflow case or single value
+  uint64_t span = IntegerSpan(min, max);
+  const char *sep = IntegerSeparator(separator);
+  const size_t sepLength = strlen(sep);
+
+  // At most 20 characters per value ("-9223372036854775808")
+  std::vector<char> result(count * (20 + sepLength));
+  char *out = result.data();
+  char *const end = result.data() + result.size();
+
+  RandomWords words(randomBytes);
+  for (size_t i = 0; i < count; i++) {
+    if ((i & 0xFFFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    if (i > 0) {
+      memcpy(out, sep, sepLength);
+      out += sepLength;
+    }
+    out = std::to_chars(out, end, IntegerSample(words, min, span)).ptr;
+  }
 
-  // Determine bytes needed
-  size_t bytesNeeded = (range <= 0xFF)         ? 1
-                       : (range <= 0xFFFF)     ? 2
-                       : (range <= 0xFFFFFFFF) ? 4
-                                               : 8;
+  Crypto::SecureZero(out, static_cast<size_t>(end - out));
+  result.resize(static_cast<size_t>(out - result.data()));
+  return result;
+}
 
-  // Calculate Rejection Limit
-  // We strictly assume Little Endian for internal logic simplicity,
-  // but the byte compositing works regardless.
-  uint64_t maxVal;
-  if (bytesNeeded == 8)
-    maxVal = 0xFFFFFFFFFFFFFFFFULL;
-  else
-    maxVal = (1ULL << (bytesNeeded * 8)) - 1;
+//-----------------------------------------------------------------------------
+// Integers (arbitrary precision)
+//-----------------------------------------------------------------------------
 
-  // limit is exclusive upper bound of valid range [0, limit)
-  // where range divides limit evenly.
-  uint64_t limit = maxVal - (maxVal % range);
+// Fixed-width two's complement, little-endian 64-bit limbs
+using BigLimbs = std::vector<uint64_t>;
 
-  uint64_t randVal = 0;
-  bool found = false;
-  size_t byteIdx = 0;
+// Limbs that hold any value of up to `digits` decimal digits with a sign bit
+static size_t BigLimbCount(size_t digits) {
+  return (digits * 3322 / 1000 + 1) / 64 + 2;
+}
 
-  // Rejection Sampling Loop
-  while (byteIdx + bytesNeeded <= randomBytes.size()) {
-    randVal = 0;
-    for (size_t i = 0; i < bytesNeeded; i++) {
-      randVal = (randVal << 8) | randomBytes[byteIdx++];
+// Optional '-' then decimal digits; false if malformed or too wide for `limbs`
+static bool ParseBigInteger(const std::string &text, size_t limbs,
+                            BigLimbs &value) {
+  value.assign(limbs, 0);
+  size_t pos = 0;
+  bool negative = false;
+  if (pos < text.size() && (text[pos] == '-' || text[pos] == '+'))
+    negative = text[pos++] == '-';
+  if (pos == text.size())
+    return false;
+
+  // Accumulate the magnitude 18 digits at a time
+  while (pos < text.size()) {
+    size_t chunk = std::min<size_t>(18, text.size() - pos);
+    uint64_t part = 0, scale = 1;
+    for (size_t k = 0; k < chunk; k++, pos++) {
+      if (text[pos] < '0' || text[pos] > '9')
+        return false;
+      part = part * 10 + (uint64_t)(text[pos] - '0');
+      scale *= 10;
+    }
+    uint64_t carry = part;
+    for (size_t l = 0; l < limbs; l++) {
+      unsigned __int128 t = (unsigned __int128)value[l] * scale + carry;
+      value[l] = static_cast<uint64_t>(t);
+      carry = static_cast<uint64_t>(t >> 64);
     }
+    if (carry != 0 || (value[limbs - 1] >> 63) != 0)
+      return false;
+  }
 
-    if (randVal < limit) {
-      found = true;
-      break;
+  if (negative) {
+    uint64_t carry = 1;
+    for (size_t l = 0; l < limbs; l++) {
+      uint64_t inverted = ~value[l];
+      value[l] = inverted + carry;
+      carry = (carry && value[l] == 0) ? 1 : 0;
     }
   }
+  return true;
+}
 
-  if (!found) {
-    // Fallback or use last generated (biased) if we run out
-    // With 32 bytes provided for max 8 bytes needed, this is rare.
-    // We'll proceed with randVal (it's random, just slightly biased)
+static bool BigIsNegative(const BigLimbs &a) { return (a.back() >> 63) != 0; }
+
+// a - b (mod 2^(64 * limbs))
+static BigLimbs BigSub(const BigLimbs &a, const BigLimbs &b) {
+  BigLimbs r(a.size());
+  uint64_t borrow = 0;
+  for (size_t l = 0; l < a.size(); l++) {
+    uint64_t d = a[l] - b[l];
+    uint64_t nextBorrow = (a[l] < b[l]) || (d < borrow);
+    r[l] = d - borrow;
+    borrow = nextBorrow;
   }
+  return r;
+}
 
-  int64_t resultVal = min + static_cast<int64_t>(randVal % range);
+// a += b (mod 2^(64 * limbs))
+static void BigAddInPlace(BigLimbs &a, const BigLimbs &b) {
+  uint64_t carry = 0;
+  for (size_t l = 0; l < a.size(); l++) {
+    uint64_t s = a[l] + b[l];
+    uint64_t c1 = s < a[l];
+    a[l] = s + carry;
+    carry = c1 | (a[l] < s);
+  }
+}
 
-  std::string s = std::to_string(resultVal);
-  std::vector<char> result(s.begin(), s.end());
-  SecureZeroMemory(s.data(), s.size());
-  return result;
+// Signed comparison of two's complement values of equal width
+static bool BigLess(const BigLimbs &a, const BigLimbs &b) {
+  if (BigIsNegative(a) != BigIsNegative(b))
+    return BigIsNegative(a);
+  for (size_t l = a.size(); l-- > 0;) {
+    if (a[l] != b[l])
+      return a[l] < b[l];
+  }
+  return false;
 }
 
-std::vector<char> GenerateBinary(const std::vector<uint8_t> &randomBytes,
-                                 int length) {
-  if (randomBytes.empty() || length <= 0)
+// Appends the decimal form of `value` (its limbs are consumed)
+static void BigAppendDecimal(BigLimbs &value, std::vector<char> &out) {
+  if (BigIsNegative(value)) {
+    out.push_back('-');
+    BigLimbs zero(value.size(), 0);
+    value = BigSub(zero, value);
+  }
+
+  // Split into base-10^18 chunks, least significant first
+  std::vector<uint64_t> chunks;
+  size_t top = value.size();
+  while (top > 0 && value[top - 1] == 0)
+    top--;
+  while (top > 0) {
+    unsigned __int128 rem = 0;
+    for (size_t l = top; l-- > 0;) {
+      unsigned __int128 cur = (rem << 64) | value[l];
+      value[l] = static_cast<uint64_t>(cur / DECIMAL_BLOCK);
+      rem = cur % DECIMAL_BLOCK;
+    }
+    chunks.push_back(static_cast<uint64_t>(rem));
+    while (top > 0 && value[top - 1] == 0)
+      top--;
+  }
+  if (chunks.empty())
+    chunks.push_back(0);
+
+  char digits[DECIMAL_BLOCK_DIGITS];
+  for (size_t c = chunks.size(); c-- > 0;) {
+    WriteDigits9(digits, static_cast<uint32_t>(chunks[c] / 1000000000));
+    WriteDigits9(digits + 9, static_cast<uint32_t>(chunks[c] % 1000000000));
+    size_t skip = 0;
+    if (c == chunks.size() - 1) {
+      while (skip < DECIMAL_BLOCK_DIGITS - 1 && digits[skip] == '0')
+        skip++;
+    }
+    out.insert(out.end(), digits + skip, digits + DECIMAL_BLOCK_DIGITS);
+  }
+  Crypto::SecureZero(digits, sizeof(digits));
+  Crypto::SecureClearVector(chunks);
+}
+
+// Parsed bounds: min, range - 1 and the bit length of range - 1
+struct BigRange {
+  BigLimbs min;
+  BigLimbs span;
+  size_t bits = 0;
+};
+
+static bool ParseBigRange(const std::string &minText,
+                          const std::string &maxText, BigRange &range) {
+  size_t limbs = BigLimbCount(std::max(minText.size(), maxText.size()));
+  BigLimbs lo, hi;
+  if (!ParseBigInteger(minText, limbs, lo) ||
+      !ParseBigInteger(maxText, limbs, hi))
+    return false;
+  if (BigLess(hi, lo))
+    std::swap(lo, hi);
+  range.min = lo;
+  range.span = BigSub(hi, lo);
+  range.bits = 0;
+  for (size_t l = limbs; l-- > 0;) {
+    if (range.span[l] != 0) {
+      range.bits = l * 64 + (64 - __builtin_clzll(range.span[l]));
+      break;
+    }
+  }
+  return true;
+}
+
+double BigIntegerRangeBits(const std::string &minText,
+                           const std::string &maxText) {
+  BigRange range;
+  if (!ParseBigRange(minText, maxText, range))
+    return 0.0;
+  return (double)range.bits;
+}
+
+size_t BigIntegerBytesNeeded(const std::string &minText,
+                             const std::string &maxText, size_t count) {
+  BigRange range;
+  if (!ParseBigRange(minText, maxText, range))
+    return 0;
+  // Masked rejection accepts at least half of all draws
+  uint64_t wordsPerDraw = std::max<size_t>(1, (range.bits + 63) / 64);
+  return static_cast<size_t>(RejectionWords(count, 0.5) * wordsPerDraw * 8);
+}
+
+std::vector<char> GenerateBigIntegers(const std::vector<uint8_t> &randomBytes,
+                                      const std::string &minText,
+                                      const std::string &maxText, size_t count,
+                                      int separator) {
+  BigRange range;
+  if (!ParseBigRange(minText, maxText, range)) {
+    std::string err = "[Error: Integer bounds must be decimal numbers]";
+    return std::vector<char>(err.begin(), err.end());
+  }
+  if (randomBytes.empty() || count == 0)
     return {};
 
+  const size_t limbs = range.min.size();
+  const size_t drawWords = (range.bits + 63) / 64;
+  const uint64_t topMask =
+      (range.bits % 64 == 0) ? ~0ULL : ((1ULL << (range.bits % 64)) - 1);
+  const char *sep = IntegerSeparator(separator);
+  const size_t sepLength = strlen(sep);
+
   std::vector<char> result;
-  result.reserve(length);
+  result.reserve(count * (range.bits * 3 / 10 + 2 + sepLength));
+  RandomWords words(randomBytes);
+  BigLimbs offset(limbs);
 
-  for (int i = 0; i < length; i++) {
-    if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-    size_t byteIdx = i / 8;
-    int bitIdx = i % 8;
+  for (size_t i = 0; i < count; i++) {
+    if ((i & 0x3FF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
 
-    if (byteIdx < randomBytes.size()) {
-      result.push_back(((randomBytes[byteIdx] >> bitIdx) & 1) ? '1' : '0');
-    } else {
-      result.push_back('0');
+    // Uniform in [0, span]: draw bits(span) bits, reject anything above span
+    std::fill(offset.begin(), offset.end(), 0);
+    if (drawWords > 0) {
+      do {
+        for (size_t l = 0; l < drawWords; l++)
+          offset[l] = words.Next();
+        offset[drawWords - 1] &= topMask;
+      } while (BigLess(range.span, offset));
     }
+    BigAddInPlace(offset, range.min);
+
+    if (i > 0)
+      result.insert(result.end(), sep, sep + sepLength);
+    BigAppendDecimal(offset, result);
   }
 
+  Crypto::SecureClearVector(offset);
   return result;
 }
 
-std::vector<char> GenerateCustomString(const std::vector<uint8_t> &randomBytes,
-                                       int length, bool includeNumbers,
-                                       bool includeUppercase,
-                                       bool includeLowercase,
-                                       bool includeSpecial) {
+std::vector<char> GenerateBinary(const std::vector<uint8_t> &randomBytes,
+                                 int length) {
+  if (randomBytes.empty() || length <= 0)
+    return {};
+
+  // Least significant bit of each byte first; digits past the end of the
+  // random data stay '0'
+  size_t bits = static_cast<size_t>(length);
+  size_t available = std::min(bits, randomBytes.size() * 8);
+  std::vector<char> result(bits, '0');
+  WriteBinary(randomBytes.data(), available, false, 0, result.data());
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+// Custom strings
+//-----------------------------------------------------------------------------
+
+// Glyphs that are easily confused when read back or typed
+static const char AMBIGUOUS_GLYPHS[] = "0O1Il|";
+
+// Splits UTF-8 text into code points; false on malformed sequences
+// (including overlong forms, surrogates and values above U+10FFFF) or on
+// C0/C1 control characters
+static bool SplitCodePoints(const std::string &text,
+                            std::vector<std::string> &out,
+                            std::string &error) {
+  for (size_t i = 0; i < text.size();) {
+    uint8_t lead = static_cast<uint8_t>(text[i]);
+    size_t length = (lead < 0x80)                  ? 1
+                    : (lead >= 0xC2 && lead <= 0xDF) ? 2
+                    : (lead >= 0xE0 && lead <= 0xEF) ? 3
+                    : (lead >= 0xF0 && lead <= 0xF4) ? 4
+                                                     : 0;
+    if (length == 0 || i + length > text.size()) {
+      error = "Character set is not valid UTF-8";
+      return false;
+    }
+    for (size_t k = 1; k < length; k++) {
+      if ((static_cast<uint8_t>(text[i + k]) & 0xC0) != 0x80) {
+        error = "Character set is not valid UTF-8";
+        return false;
+      }
+    }
+    // The second byte's range is narrower after these leads (RFC 3629)
+    uint8_t second = length > 1 ? static_cast<uint8_t>(text[i + 1]) : 0;
+    if ((lead == 0xE0 && second < 0xA0) || (lead == 0xED && second > 0x9F) ||
+        (lead == 0xF0 && second < 0x90) || (lead == 0xF4 && second > 0x8F)) {
+      error = "Character set is not valid UTF-8";
+      return false;
+    }
+    if (lead < 0x20 || lead == 0x7F || (lead == 0xC2 && second <= 0x9F)) {
+      error = "Character set contains control characters";
+      return false;
+    }
+    out.push_back(text.substr(i, length));
+    i += length;
+  }
+  return true;
+}
 
-  // Build character set
-  std::string charset;
+bool BuildCustomAlphabet(bool includeNumbers, bool includeUppercase,
+                         bool includeLowercase, bool includeSpecial,
+                         const std::string &extra, const std::string &exclude,
+                         bool excludeAmbiguous,
+                         std::vector<std::string> &alphabet,
+                         std::string &error) {
+  std::string text;
   if (includeNumbers)
-    charset += "0123456789";
+    text += "0123456789";
   if (includeUppercase)
-    charset += "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    text += "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
   if (includeLowercase)
-    charset += "abcdefghijklmnopqrstuvwxyz";
+    text += "abcdefghijklmnopqrstuvwxyz";
   if (includeSpecial)
-    charset += "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
-
-  if (charset.empty() || randomBytes.empty() || length <= 0)
-    return {};
+    text += "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+  text += extra;
+
+  std::vector<std::string> symbols, excluded;
+  if (!SplitCodePoints(text, symbols, error) ||
+      !SplitCodePoints(exclude, excluded, error))
+    return false;
+  if (excludeAmbiguous)
+    SplitCodePoints(AMBIGUOUS_GLYPHS, excluded, error);
+
+  // First occurrence wins, so the class order above is kept
+  std::set<std::string> seen(excluded.begin(), excluded.end());
+  alphabet.clear();
+  for (auto &symbol : symbols) {
+    if (seen.insert(symbol).second)
+      alphabet.push_back(std::move(symbol));
+  }
+  if (alphabet.empty()) {
+    error = "Character set is empty";
+    return false;
+  }
+  return true;
+}
 
-  std::vector<char> result;
-  result.reserve(length);
+bool CurrentCustomAlphabet(std::vector<std::string> &alphabet,
+                           std::string &error) {
+  return BuildCustomAlphabet(
+      g_state.includeNumbers, g_state.includeUppercase,
+      g_state.includeLowercase, g_state.includeSpecial,
+      g_state.customExtraChars.data(), g_state.customExcludeChars.data(),
+      g_state.customExcludeAmbiguous, alphabet, error);
+}
 
-  // Rejection sampling set up
-  size_t setSize = charset.size();
-  uint16_t limit = 65535 - (65535 % static_cast<uint16_t>(setSize));
+// Symbols drawn per 64-bit word: the largest k with N^k <= 2^64. One draw
+// uniform below N^k yields k symbols as its base-N digits, so each symbol
+// costs 64 / k bits (7.1 for N = 94) instead of a whole rejection-sampled
+// 16-bit value. Passphrase words are drawn the same way.
+struct SymbolBatch {
+  int perWord = 1;
+  uint64_t range = 0; // N^k; 0 stands for 2^64 (raw words, no rejection)
+};
+
+static SymbolBatch SymbolBatchFor(size_t symbols) {
+  SymbolBatch batch;
+  if (symbols < 2)
+    return batch;
+  unsigned __int128 power = symbols;
+  const unsigned __int128 limit = (unsigned __int128)1 << 64;
+  while (power * symbols <= limit) {
+    power *= symbols;
+    batch.perWord++;
+  }
+  batch.range = (power == limit) ? 0 : static_cast<uint64_t>(power);
+  return batch;
+}
 
-  size_t byteIdx = 0;
+// Random bytes for `count` symbols out of N, with rejection headroom
+static size_t BatchedBytesNeeded(size_t symbols, uint64_t count) {
+  SymbolBatch batch = SymbolBatchFor(symbols);
+  uint64_t draws = (count + batch.perWord - 1) / batch.perWord;
+  double acceptance = 1.0;
+  if (batch.range != 0)
+    acceptance = 1.0 - (double)((0 - batch.range) % batch.range) /
+                           18446744073709551616.0;
+  return static_cast<size_t>(RejectionWords(draws, acceptance) * 8);
+}
 
-  for (int i = 0; i < length; i++) {
-    if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-    uint16_t val = 0;
-    bool found = false;
+size_t CustomStringBytesNeeded(size_t alphabetSize, int length) {
+  if (alphabetSize < 2 || length <= 0)
+    return 0;
+  return BatchedBytesNeeded(alphabetSize, static_cast<uint64_t>(length));
+}
 
-    while (byteIdx + 1 < randomBytes.size()) {
-      val = (static_cast<uint16_t>(randomBytes[byteIdx]) << 8) |
-            randomBytes[byteIdx + 1];
-      byteIdx += 2;
+std::vector<char> GenerateCustomString(const std::vector<uint8_t> &randomBytes,
+                                       int length,
+                                       const std::vector<std::string> &alphabet) {
+  if (alphabet.empty()) {
+    std::string err = "[Error: Character set is empty]";
+    return std::vector<char>(err.begin(), err.end());
+  }
+  if (length <= 0 || (randomBytes.empty() && alphabet.size() > 1))
+    return {};
 
-      if (val < limit) {
-        found = true;
-        break;
+  const size_t N = alphabet.size();
+  const SymbolBatch batch = SymbolBatchFor(N);
+
+  // Symbols laid out back to back; single-byte alphabets copy one char
+  std::string flat;
+  std::vector<uint32_t> offsets(N + 1);
+  size_t widest = 0;
+  for (size_t s = 0; s < N; s++) {
+    offsets[s] = static_cast<uint32_t>(flat.size());
+    flat += alphabet[s];
+    widest = std::max(widest, alphabet[s].size());
+  }
+  offsets[N] = static_cast<uint32_t>(flat.size());
+
+  std::vector<char> result(static_cast<size_t>(length) * widest);
+  char *out = result.data();
+  RandomWords words(randomBytes);
+
+  for (size_t produced = 0, draw = 0; produced < (size_t)length; draw++) {
+    if ((draw & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    uint64_t x = 0;
+    if (N > 1)
+      x = (batch.range == 0) ? words.Next() : UniformBelow(words, batch.range);
+    size_t take =
+        std::min<size_t>(batch.perWord, static_cast<size_t>(length) - produced);
+    for (size_t k = 0; k < take; k++) {
+      size_t symbol = static_cast<size_t>(x % N);
+      x /= N;
+      if (widest == 1) {
+        *out++ = flat[symbol];
+      } else {
+        size_t size = offsets[symbol + 1] - offsets[symbol];
+        memcpy(out, flat.data() + offsets[symbol], size);
+        out += size;
       }
     }
-
-    if (!found)
-      val = 0;
-
-    size_t charIdx = val % setSize;
-    result.push_back(charset[charIdx]);
+    produced += take;
   }
 
+  result.resize(static_cast<size_t>(out - result.data()));
+  Crypto::SecureZero(&flat[0], flat.size());
   return result;
 }
 
-std::vector<char> GenerateBitByte(const std::vector<uint8_t> &randomBytes,
-                                  int amount, int unit, int format) {
-
-  // Calculate bytes needed
-  size_t bytesNeeded = (unit == 0) ? (amount + 7) / 8 : amount;
+// Bytes a Bit/Byte request covers: whole bytes, rounded up to Z85's 4-byte
+// groups
+static size_t BitByteBytes(int amount, int unit, int format) {
+  size_t bytes = (unit == 0) ? (static_cast<size_t>(amount) + 7) / 8
+                             : static_cast<size_t>(amount);
+  if (format == 5)
+    bytes = (bytes + 3) / 4 * 4;
+  return bytes;
+}
 
-  if (randomBytes.size() < bytesNeeded) {
-    bytesNeeded = randomBytes.size();
+// Input per encoder call: a multiple of 3, 4 and 5 bytes so Base64, Z85 and
+// Base32 groups never straddle two calls
+static constexpr size_t ENCODE_CHUNK_BYTES = 15 << 18;
+
+// Encodes in chunks (checking for cancellation) into `out`, sized by length()
+template <typename Length, typename Encode>
+static void EncodeInChunks(const uint8_t *in, size_t bytes, char *out,
+                           Length length, Encode encode) {
+  for (size_t done = 0; done < bytes; done += ENCODE_CHUNK_BYTES) {
+    if (g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    encode(in + done, std::min(ENCODE_CHUNK_BYTES, bytes - done),
+           out + length(done));
   }
+}
 
-  std::ostringstream oss;
+std::vector<char> GenerateBitByte(const std::vector<uint8_t> &randomBytes,
+                                  int amount, int unit, int format) {
+
+  size_t bytesNeeded =
+      std::min(BitByteBytes(amount, unit, format), randomBytes.size());
+  const uint8_t *in = randomBytes.data();
+  std::vector<char> res;
 
   switch (format) {
   case 0: // Hexadecimal
-    for (size_t i = 0; i < bytesNeeded; i++) {
-      if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-      oss << std::hex << std::setw(2) << std::setfill('0')
-          << static_cast<int>(randomBytes[i]);
-    }
+    res.resize(Encoding::HexLength(bytesNeeded));
+    EncodeInChunks(in, bytesNeeded, res.data(), Encoding::HexLength,
+                   Encoding::EncodeHex);
     break;
 
-  case 1: { // Base64
-    static const char *b64 =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    size_t i = 0;
-    while (i < bytesNeeded) {
-      if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-      uint32_t octet_a = i < bytesNeeded ? randomBytes[i++] : 0;
-      uint32_t octet_b = i < bytesNeeded ? randomBytes[i++] : 0;
-      uint32_t octet_c = i < bytesNeeded ? randomBytes[i++] : 0;
-
-      uint32_t triple = (octet_a << 16) + (octet_b << 8) + octet_c;
-
-      oss << b64[(triple >> 18) & 0x3F];
-      oss << b64[(triple >> 12) & 0x3F];
-      oss << b64[(triple >> 6) & 0x3F];
-      oss << b64[triple & 0x3F];
-    }
-
-    // Add padding if needed
-    size_t mod = bytesNeeded % 3;
-    if (mod == 1) {
-      std::string s = oss.str();
-      s.replace(s.length() - 2, 2, "==");
-      std::vector<char> res(s.begin(), s.end());
-      SecureZeroMemory(s.data(), s.size());
-      return res;
-    } else if (mod == 2) {
-      std::string s = oss.str();
-      s.replace(s.length() - 1, 1, "=");
-      std::vector<char> res(s.begin(), s.end());
-      SecureZeroMemory(s.data(), s.size());
-      return res;
-    }
+  case 1: // Base64
+    res.resize(Encoding::Base64Length(bytesNeeded));
+    EncodeInChunks(in, bytesNeeded, res.data(), Encoding::Base64Length,
+                   Encoding::EncodeBase64);
+    break;
+
+  case 2: { // Binary, most significant bit first, written in place
+    size_t bits = bytesNeeded * 8;
+    size_t interval = (g_state.binarySeparatorEnabled &&
+                       g_state.binarySeparatorInterval > 0)
+                          ? static_cast<size_t>(g_state.binarySeparatorInterval)
+                          : 0;
+    res.resize(BinaryChars(bits, interval));
+    WriteBinary(in, bits, true, interval, res.data());
     break;
   }
 
-  case 2: // Binary
-  {
-    int bitsPrinted = 0;
-    size_t totalBits = bytesNeeded * 8;
-    for (size_t i = 0; i < bytesNeeded; i++) {
-      if ((i & 0x3FFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-      for (int bit = 7; bit >= 0; bit--) {
-        oss << ((randomBytes[i] >> bit) & 1);
-        bitsPrinted++;
-
-        // Add separator if enabled, interval reached, and not the very last bit
-        if (g_state.binarySeparatorEnabled &&
-            g_state.binarySeparatorInterval > 0 &&
-            bitsPrinted % g_state.binarySeparatorInterval == 0 &&
-            bitsPrinted < totalBits) {
-          oss << ' ';
-        }
-      }
+  case 3: // Base32
+    res.resize(Encoding::Base32Length(bytesNeeded));
+    EncodeInChunks(in, bytesNeeded, res.data(), Encoding::Base32Length,
+                   Encoding::EncodeBase32);
+    break;
+
+  case 4: { // Base58 (whole-number conversion, so capped)
+    if (bytesNeeded > AppConfig::BASE58_MAX_BYTES) {
+      std::string err = "[Error: Base58 output is limited to " +
+                        std::to_string(AppConfig::BASE58_MAX_BYTES) +
+                        " bytes]";
+      return std::vector<char>(err.begin(), err.end());
     }
-  } break;
+    res.resize(Encoding::Base58MaxLength(bytesNeeded));
+    res.resize(Encoding::EncodeBase58(in, bytesNeeded, res.data()));
+    break;
+  }
+
+  case 5: // Z85
+    bytesNeeded &= ~static_cast<size_t>(3);
+    res.resize(Encoding::Z85Length(bytesNeeded));
+    EncodeInChunks(in, bytesNeeded, res.data(), Encoding::Z85Length,
+                   Encoding::EncodeZ85);
+    break;
   }
 
-  std::string s = oss.str();
-  std::vector<char> res(s.begin(), s.end());
-  SecureZeroMemory(s.data(), s.size());
   return res;
 }
 
+size_t PassphraseBytesNeeded(size_t wordListSize, int wordCount, int count) {
+  if (wordListSize < 2 || wordCount <= 0 || count <= 0)
+    return 0;
+  return BatchedBytesNeeded(wordListSize, static_cast<uint64_t>(wordCount) *
+                                              static_cast<uint64_t>(count));
+}
+
 std::vector<char> GeneratePassphrase(const std::vector<uint8_t> &randomBytes,
-                                     int wordCount,
+                                     int wordCount, int count,
                                      const std::string &separator,
-                                     const std::vector<std::string> &wordlist) {
+                                     const WordList &wordlist) {
 
   std::string err = "[Error: Wordlist not loaded]";
-  if (wordlist.empty() || randomBytes.empty() || wordCount <= 0) {
+  if (wordlist.Empty() || randomBytes.empty() || wordCount <= 0 ||
+      count <= 0) {
     return std::vector<char>(err.begin(), err.end());
   }
 
-  std::string result;
-  size_t bytesPerWord = 3; // 3 bytes = 24 bits, enough for ~16M words
-
-  for (int i = 0; i < wordCount; i++) {
-    if ((i & 0x3FF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
-    // Build index from 3 random bytes
-    size_t offset = i * bytesPerWord;
-    uint32_t randomIndex = 0;
-
-    for (size_t j = 0; j < bytesPerWord && (offset + j) < randomBytes.size();
-         j++) {
-      randomIndex = (randomIndex << 8) | randomBytes[offset + j];
+  const size_t N = wordlist.Size();
+  const SymbolBatch batch = SymbolBatchFor(N);
+  const uint64_t totalWords =
+      static_cast<uint64_t>(wordCount) * static_cast<uint64_t>(count);
+
+  // Presized for the longest word everywhere; trimmed at the end
+  const size_t perPhrase = static_cast<size_t>(wordCount) *
+                               wordlist.MaxWordBytes() +
+                           static_cast<size_t>(wordCount - 1) * separator.size();
+  std::vector<char> result(static_cast<size_t>(count) * (perPhrase + 1));
+  char *out = result.data();
+  RandomWords words(randomBytes);
+
+  // Words are taken from the batches in order, so one draw may span two
+  // passphrases; every word is still an independent uniform index
+  uint64_t x = 0;
+  int left = 0;
+  int inPhrase = 0;
+  for (uint64_t w = 0; w < totalWords; w++) {
+    if ((w & 0xFFFF) == 0 && g_state.cancelGeneration) throw std::runtime_error("Generation cancelled by user.");
+    if (left == 0) {
+      x = (batch.range == 0) ? words.Next() : UniformBelow(words, batch.range);
+      left = batch.perWord;
     }
-
-    // Select word using modular arithmetic
-    size_t wordIndex = randomIndex % wordlist.size();
-
-    if (i > 0)
-      result += separator;
-    result += wordlist[wordIndex];
+    std::string_view word = wordlist.Word(static_cast<size_t>(x % N));
+    x /= N;
+    left--;
+
+    if (inPhrase == wordCount) {
+      *out++ = '\n';
+      inPhrase = 0;
+    } else if (inPhrase > 0) {
+      memcpy(out, separator.data(), separator.size());
+      out += separator.size();
+    }
+    memcpy(out, word.data(), word.size());
+    out += word.size();
+    inPhrase++;
   }
 
-  std::vector<char> vec(result.begin(), result.end());
-  SecureZeroMemory(result.data(), result.size());
-  return vec;
+  Crypto::SecureZero(&x, sizeof(x));
+  result.resize(static_cast<size_t>(out - result.data()));
+  return result;
 }
 
 std::vector<char> GenerateOTP(const std::vector<uint8_t> &randomBytes,
@@ -583,7 +1145,7 @@ std::vector<char> GenerateOTP(const std::vector<uint8_t> &randomBytes,
   }
 
   std::vector<char> vec(result.begin(), result.end());
-  SecureZeroMemory(result.data(), result.size());
+  Crypto::SecureZero(result.data(), result.size());
   return vec;
 }
 
@@ -623,6 +1185,8 @@ GenerationResult GenerateOutput() {
     enabledSources.insert(Entropy::EntropySource::CpuJitter);
   if (g_state.mouseMovementEnabled)
     enabledSources.insert(Entropy::EntropySource::Mouse);
+  if (g_state.cpuHwrngEnabled)
+    enabledSources.insert(Entropy::EntropySource::CpuHwrng);
 
   // Get pooled entropy data
   // Note: If there's locked data, we include ALL locked data plus new data from
@@ -647,29 +1211,47 @@ GenerationResult GenerateOutput() {
   size_t bytesNeeded = 0;
 
   switch (g_state.outputFormat) {
-  case 0: // Decimal - uses 2 bytes per digit. Request 4x for rejection safety
-          // buffer.
-    bytesNeeded = static_cast<size_t>(g_state.decimalDigits) * 4;
+  case 0: // Decimal - one 64-bit word per 18 digits plus rejection headroom
+    bytesNeeded = DecimalBytesNeeded(g_state.decimalDigits);
     break;
-  case 1: // Integer - needs up to 8 bytes. Request configured size for multiple
-          // retries.
-    bytesNeeded = AppConfig::INTEGER_ENTROPY_BLOCK_BYTES;
+  case 1: // Integer - one 64-bit word per value (per limb for big ranges)
+          // plus rejection headroom
+    if (g_state.integerBigRange)
+      bytesNeeded = BigIntegerBytesNeeded(g_state.integerMinText.data(),
+                                          g_state.integerMaxText.data(),
+                                          g_state.integerCount);
+    else
+      bytesNeeded = IntegerBytesNeeded(g_state.integerMin, g_state.integerMax,
+                                       g_state.integerCount);
     break;
   case 2: // Binary - 1 bit per output bit, so ceil(length/8)
     bytesNeeded = (static_cast<size_t>(g_state.binaryLength) + 7) / 8;
     break;
-  case 3: // Custom - uses 2 bytes per character. Request 4x for rejection
-          // safety buffer.
-    bytesNeeded = static_cast<size_t>(g_state.customLength) * 4;
+  case 3: { // Custom - several symbols per 64-bit word plus rejection
+            // headroom
+    std::vector<std::string> alphabet;
+    std::string error;
+    if (CurrentCustomAlphabet(alphabet, error))
+      bytesNeeded = CustomStringBytesNeeded(alphabet.size(),
+                                            g_state.customLength);
     break;
-  case 4: // Bit/Byte - exact amount requested
-    bytesNeeded = (g_state.bitByteUnit == 0)
-                      ? (static_cast<size_t>(g_state.bitByteAmount) + 7) / 8
-                      : static_cast<size_t>(g_state.bitByteAmount);
+  }
+  case 4: // Bit/Byte - exact amount requested (Z85: whole 4-byte groups)
+    bytesNeeded = BitByteBytes(g_state.bitByteAmount, g_state.bitByteUnit,
+                               g_state.bitByteFormat);
     break;
-  case 5: // Passphrase - 3 bytes per word
-    bytesNeeded = static_cast<size_t>(g_state.passphraseWordCount) * 3;
+  case 5: { // Passphrase - several words per 64-bit word plus rejection
+            // headroom; the list size is only known once it is loaded
+    std::string error;
+    if (!LoadWordListForGeneration(&error)) {
+      result.errorMessage = "Failed to load wordlist: " + error;
+      return result;
+    }
+    bytesNeeded = PassphraseBytesNeeded(g_state.wordList.Size(),
+                                        g_state.passphraseWordCount,
+                                        g_state.passphraseCount);
     break;
+  }
   case 6: // OTP - 1 byte per input (Text Mode needs 2x for Rejection)
     if (g_state.otpInputMode == 0) {
       // Text mode: ASCII safe Modulo-95.
@@ -702,37 +1284,43 @@ GenerationResult GenerateOutput() {
     break;
 
   case 1: // Integer
-    result.output =
-        GenerateInteger(randomBytes, g_state.integerMin, g_state.integerMax);
+    if (g_state.integerBigRange)
+      result.output = GenerateBigIntegers(
+          randomBytes, g_state.integerMinText.data(),
+          g_state.integerMaxText.data(), g_state.integerCount,
+          g_state.integerSeparator);
+    else
+      result.output = GenerateIntegers(randomBytes, g_state.integerMin,
+                                       g_state.integerMax, g_state.integerCount,
+                                       g_state.integerSeparator);
     break;
 
   case 2: // Binary
     result.output = GenerateBinary(randomBytes, g_state.binaryLength);
     break;
 
-  case 3: // Custom
-    result.output =
-        GenerateCustomString(randomBytes, g_state.customLength,
-                             g_state.includeNumbers, g_state.includeUppercase,
-                             g_state.includeLowercase, g_state.includeSpecial);
+  case 3: { // Custom
+    std::vector<std::string> alphabet;
+    std::string error;
+    if (CurrentCustomAlphabet(alphabet, error)) {
+      result.output =
+          GenerateCustomString(randomBytes, g_state.customLength, alphabet);
+    } else {
+      std::string err = "[Error: " + error + "]";
+      result.output.assign(err.begin(), err.end());
+    }
     break;
+  }
 
   case 4: // Bit/Byte
     result.output = GenerateBitByte(randomBytes, g_state.bitByteAmount,
                                     g_state.bitByteUnit, g_state.bitByteFormat);
     break;
 
-  case 5: // Passphrase
-    // Load wordlist if needed
-    if (!LoadWordListForGeneration()) {
-      result.errorMessage = "Failed to load wordlist";
-      SecureZeroMemory(randomBytes.data(), randomBytes.size());
-      return result;
-    }
-    result.output =
-        GeneratePassphrase(randomBytes, g_state.passphraseWordCount,
-                           std::string(g_state.passphraseSeparator.data()),
-                           g_state.cachedWordList);
+  case 5: // Passphrase (wordlist loaded while sizing the request)
+    result.output = GeneratePassphrase(
+        randomBytes, g_state.passphraseWordCount, g_state.passphraseCount,
+        std::string(g_state.passphraseSeparator.data()), g_state.wordList);
     break;
 
   case 6: // OTP
@@ -745,7 +1333,7 @@ GenerationResult GenerateOutput() {
       std::ifstream file(g_state.otpFilePath.data(), std::ios::binary);
       if (!file.is_open()) {
         result.errorMessage = "Failed to open input file";
-        SecureZeroMemory(randomBytes.data(), randomBytes.size());
+        Crypto::SecureZero(randomBytes.data(), randomBytes.size());
         return result;
       }
 
@@ -756,18 +1344,13 @@ GenerationResult GenerateOutput() {
       std::vector<uint8_t> encrypted = GenerateOTPFile(randomBytes, fileData);
 
       // Output as hex
-      std::ostringstream oss;
-      for (uint8_t b : encrypted) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(b);
-      }
-      std::string s = oss.str();
-      result.output = std::vector<char>(s.begin(), s.end());
-      SecureZeroMemory(s.data(), s.size());
+      result.output.resize(Encoding::HexLength(encrypted.size()));
+      EncodeInChunks(encrypted.data(), encrypted.size(), result.output.data(),
+                     Encoding::HexLength, Encoding::EncodeHex);
 
       // Secure cleanup
-      SecureZeroMemory(fileData.data(), fileData.size());
-      SecureZeroMemory(encrypted.data(), encrypted.size());
+      Crypto::SecureZero(fileData.data(), fileData.size());
+      Crypto::SecureZero(encrypted.data(), encrypted.size());
     }
     break;
   }
@@ -812,109 +1395,245 @@ GenerationResult GenerateOutput() {
   return result;
 }
 
-void GenerateNistData(const std::string &filepath, size_t totalBytes) {
-  g_state.isExportingNist = true;
-  g_state.nistBytesWritten = 0;
-  g_state.nistTotalBytes = totalBytes;
-  g_state.nistError = "";
+//=============================================================================
+// NIST EXPORT ENGINE
+//=============================================================================
 
-  std::ofstream file(filepath, std::ios::binary);
-  if (!file.is_open()) {
-    g_state.nistError = "Failed to open output file";
-    g_state.isExportingNist = false;
-    return;
+// The pool is serialized and keyed once per export. Chunk k is the Quad-Layer
+// output for (export seed || k) with k in the HKDF info, the same derivation
+// trng_gen uses per chunk, so chunks are independent and can be produced in
+// any order. Worker t owns chunks t, t + W, t + 2W, ... and double-buffers
+// them; a single writer drains the chunks in file order, so disk writes
+// overlap with generation on every worker.
+//
+// Every chunk is a full Quad-Layer run on purpose: the file exists to validate
+// the Expansion pipeline users receive, not the ChaCha20 layer alone. That
+// makes the export CPU-bound at about 9-11 MB/s per worker (software AES-CTR
+// ~60%, SHA-512 ~20% of the time), so throughput scales with the worker count
+// rather than with the disk.
+static const size_t NIST_CHUNK_SIZE = 1024 * 1024; // 1 MB chunks
+
+namespace {
+
+class NistExport {
+public:
+  NistExport(int workers, size_t totalBytes)
+      : m_workers(workers), m_totalBytes(totalBytes),
+        m_totalChunks((totalBytes + NIST_CHUNK_SIZE - 1) / NIST_CHUNK_SIZE),
+        m_slots(static_cast<size_t>(workers) * 2) {
+    for (auto &slot : m_slots)
+      slot.data.resize(NIST_CHUNK_SIZE);
   }
 
-  // Capture initial entropy state
-  std::set<Entropy::EntropySource> sources;
-  // Enable all available sources for the seed
-  sources.insert(Entropy::EntropySource::ClockDrift);
-  sources.insert(Entropy::EntropySource::CpuJitter);
-  // (User input sources might be empty if automated, but we use what we have)
+  ~NistExport() {
+    for (auto &slot : m_slots)
+      Crypto::SecureClearVector(slot.data);
+  }
 
-  std::vector<Entropy::EntropyDataPoint> pooledData =
-      g_state.entropyPool.GetPooledData();
+  uint64_t TotalChunks() const { return m_totalChunks; }
+  bool Stopped() const { return m_stop.load(std::memory_order_acquire); }
 
-  if (pooledData.empty()) {
-    // Fallback: Force some collection if completely empty?
-    // For now, let GenerateRandomBytes handle it (it will just be deterministic
-    // if empty) But in a real scenario we'd want to block.
-    Logger::Log(Logger::Level::WARN, "CSPRNG",
-                "Exporting NIST data with empty entropy pool!");
+  void Stop(const std::string &error = std::string()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!error.empty() && m_error.empty())
+        m_error = error;
+      m_stop = true;
+    }
+    m_cv.notify_all();
   }
 
-  const size_t CHUNK_SIZE = 1024 * 1024; // 1 MB chunks
-  size_t remaining = totalBytes;
-  std::vector<uint8_t> buffer;
-  buffer.reserve(CHUNK_SIZE);
+  std::string Error() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+  }
 
-  GenerationMode mode; // Dummy
+  void Worker(int t, const std::vector<uint8_t> &exportSeed) {
+    Stats::QuickBattery check;
+    std::vector<uint8_t> chunkSeed;
+    try {
+      for (uint64_t seq = t; seq < m_totalChunks && !Stopped();
+           seq += m_workers) {
+        Slot &slot = SlotFor(seq);
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_cv.wait(lock, [&] { return !slot.full || m_stop; });
+          if (m_stop)
+            break;
+        }
 
-  while (remaining > 0 &&
-         g_state.isExportingNist) { // Check flag to allow cancellation
-    size_t currentChunk = std::min(remaining, CHUNK_SIZE);
+        size_t length = static_cast<size_t>(std::min<uint64_t>(
+            NIST_CHUNK_SIZE, m_totalBytes - seq * NIST_CHUNK_SIZE));
+        chunkSeed = exportSeed;
+        for (int i = 0; i < 8; i++)
+          chunkSeed.push_back(static_cast<uint8_t>((seq + 1) >> (i * 8)));
+        std::string infoStr = "TRNG-NIST|C:" + std::to_string(seq + 1);
+        std::vector<uint8_t> info(infoStr.begin(), infoStr.end());
+        Crypto::QuadLayer::Generate(chunkSeed, info, slot.data.data(), length);
+
+        int alarms = check.Feed(slot.data.data(), length);
+        if (alarms > 0) {
+          g_state.outputCheckAlarms += alarms;
+          const Stats::QuickBattery::Alarm &alarm = check.LastAlarm();
+          Logger::Log(Logger::Level::ERR, "CSPRNG",
+                      "NIST export self-test alarm: chunk %llu: %s p=%.3g",
+                      (unsigned long long)seq,
+                      Stats::QuickBattery::ResultName(alarm.result),
+                      alarm.pValue);
+        }
 
-    // Use Quad-Layer Generator (same as main output)
-    // Note: In a real NIST test, we want to test the DRBG mechanism mostly.
-    // We reuse the pooledData for the seed.
-    // Ideally we would "reseed" occasionally, but for 100MB expansion from one
-    // seed is fine for testing the expansion algo. Actually, to simulate
-    // continuous operation, we should refresh the pool if possible, but this
-    // function runs in a tight loop. The background threads might be adding
-    // entropy. validData = g_state.entropyPool.GetPooledData(); <-- would need
-    // mutex
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          slot.length = length;
+          slot.full = true;
+        }
+        m_cv.notify_all();
+      }
+    } catch (const std::bad_alloc &) {
+      Stop("Memory allocation failed during NIST export");
+    } catch (const std::exception &e) {
+      Stop(std::string("Unexpected NIST export error: ") + e.what());
+    }
+    Crypto::SecureClearVector(chunkSeed);
+  }
 
-    // For this test: We use the *initial* seed and let the CSPRNG expand it.
-    // This validates the specific CSPRNG "Expansion" algorithm (HKDF ->
-    // ChaCha20 -> AES -> ChaCha20).
+  // Writes every chunk in order; progress goes to g_state.nistBytesWritten.
+  // Returns false on cancellation or error.
+  bool Write(FILE *file) {
+    for (uint64_t seq = 0; seq < m_totalChunks; seq++) {
+      if (!g_state.isExportingNist) {
+        Stop("Export cancelled");
+        return false;
+      }
+      Slot &slot = SlotFor(seq);
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&] { return slot.full || m_stop; });
+        if (m_stop)
+          return false;
+      }
 
-    // We pass 'pooledData' (the seed) every time?
-    // GenerateRandomBytes uses the seed to derive keys.
-    // If we pass the SAME seed every time, we get the SAME output?
-    // WAIT. GenerateRandomBytes is stateless!
-    // It deterministically derives keys from the entropy pool!
-    // If the pool doesn't change, the keys don't change!
-    // AND 'GenerateStream' uses a nonce, but does it increment?
-    // 'GenerateRandomBytes' creates a fresh ChaCha20 key/nonce from HKDF(seed).
-    // If seed is identical, output is identical!
+      if (fwrite(slot.data.data(), 1, slot.length, file) != slot.length) {
+        Stop("Write to output file failed (disk full?)");
+        return false;
+      }
+      g_state.nistBytesWritten += slot.length;
 
-    // FIX: we need to vary the input to GenerateRandomBytes or modify it to be
-    // stateful. Since we can't easily make it stateful without refactoring, we
-    // will manually inject a counter into the "entropy" for this export loop.
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        slot.full = false;
+      }
+      m_cv.notify_all();
+    }
+    return true;
+  }
 
-    // Hack: Add a synthetic counter data point to the pool copy for each chunk
-    // This ensures unique key derivation for each 1MB chunk.
-    pooledData.push_back({
-        Entropy::GetNanosecondTimestamp(), // Increasing timestamp
-        static_cast<uint64_t>(
-            g_state.nistBytesWritten.load()), // Increasing counter (value)
-        Entropy::EntropySource::CpuJitter     // Fake source
-    });
+private:
+  struct Slot {
+    std::vector<uint8_t> data;
+    size_t length = 0;
+    bool full = false; // Generated, waiting for the writer
+  };
+
+  // Chunk seq: worker seq % W, that worker's (seq / W)-th chunk
+  Slot &SlotFor(uint64_t seq) {
+    uint64_t worker = seq % m_workers;
+    uint64_t turn = seq / m_workers;
+    return m_slots[worker * 2 + (turn & 1)];
+  }
 
-    // Generate chunk
-    std::vector<uint8_t> chunk =
-        GenerateRandomBytes(pooledData, currentChunk, mode);
+  const int m_workers;
+  const size_t m_totalBytes;
+  const uint64_t m_totalChunks;
+  std::vector<Slot> m_slots;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::atomic<bool> m_stop{false};
+  std::string m_error;
+};
 
-    // Write to file
-    file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+} // namespace
 
-    // Update progress
-    g_state.nistBytesWritten += currentChunk;
-    remaining -= currentChunk;
+void GenerateNistData(const std::string &filepath, size_t totalBytes) {
+  g_state.isExportingNist = true;
+  g_state.nistBytesWritten = 0;
+  g_state.nistTotalBytes = totalBytes;
+  g_state.nistError = "";
 
-    // Cleanup chunk
-    SecureZeroMemory(chunk.data(), chunk.size());
+  FILE *file = fopen(filepath.c_str(), "wb");
+  if (!file) {
+    g_state.nistError = "Failed to open output file";
+    g_state.isExportingNist = false;
+    return;
   }
+  // Chunks are written whole; stdio buffering would only add a copy
+  setvbuf(file, nullptr, _IONBF, 0);
 
-  file.close();
+  std::vector<Entropy::EntropyDataPoint> pooledData =
+      g_state.entropyPool.GetPooledData();
+  if (pooledData.empty()) {
+    Logger::Log(Logger::Level::WARN, "CSPRNG",
+                "Exporting NIST data with empty entropy pool!");
+  }
 
-  // Cleanup pool copy
-  SecureZeroMemory(pooledData.data(),
-                   pooledData.size() * sizeof(Entropy::EntropyDataPoint));
+  const auto start = std::chrono::steady_clock::now();
+  std::string error;
+  std::vector<uint8_t> exportSeed;
+  try {
+    // Key once: the pool is serialized and extracted a single time. The
+    // timestamp keeps two exports of an unchanged pool apart.
+    std::vector<uint8_t> poolBytes = SerializeEntropyData(pooledData);
+    std::string infoStr =
+        "TRNG-NIST|T:" + std::to_string(Entropy::GetNanosecondTimestamp());
+    std::vector<uint8_t> info(infoStr.begin(), infoStr.end());
+    exportSeed = Crypto::HKDF::DeriveKey(poolBytes, std::vector<uint8_t>(),
+                                         info, Crypto::SHA512::HASH_SIZE);
+    Crypto::SecureClearVector(poolBytes);
+
+    int workers = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    uint64_t chunks = (totalBytes + NIST_CHUNK_SIZE - 1) / NIST_CHUNK_SIZE;
+    workers = (int)std::min<uint64_t>(workers, std::max<uint64_t>(chunks, 1));
+
+    NistExport engine(workers, totalBytes);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < workers; t++)
+      threads.emplace_back(&NistExport::Worker, &engine, t,
+                           std::cref(exportSeed));
+    engine.Write(file);
+    engine.Stop();
+    for (auto &thread : threads)
+      thread.join();
+    error = engine.Error();
+  } catch (const std::bad_alloc &) {
+    error = "Memory allocation failed during NIST export";
+  } catch (const std::exception &e) {
+    error = std::string("Unexpected NIST export error: ") + e.what();
+  }
 
+  if (fclose(file) != 0 && error.empty())
+    error = "Write to output file failed (disk full?)";
+
+  // Cleanup pool copy and key
+  Crypto::SecureZero(pooledData.data(),
+                     pooledData.size() * sizeof(Entropy::EntropyDataPoint));
+  Crypto::SecureClearVector(exportSeed);
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (error.empty()) {
+    Logger::Log(Logger::Level::INFO, "CSPRNG",
+                "NIST Data Export verify complete: %zu bytes in %.1f s "
+                "(%.1f MB/s)",
+                totalBytes, seconds,
+                seconds > 0 ? totalBytes / (1024.0 * 1024.0) / seconds : 0.0);
+  } else {
+    g_state.nistError = error;
+    Logger::Log(Logger::Level::WARN, "CSPRNG",
+                "NIST Data Export stopped after %zu of %zu bytes: %s",
+                g_state.nistBytesWritten.load(), totalBytes, error.c_str());
+  }
   g_state.isExportingNist = false;
-  Logger::Log(Logger::Level::INFO, "CSPRNG",
-              "NIST Data Export verify complete: %zu bytes", totalBytes);
 }
 
 } // namespace CSPRNG
@@ -5,6 +5,7 @@
 #include <string>
 #include <set>
 #include "../entropy/entropy_common.h"
+#include "wordlist.h"
 
 namespace CSPRNG {
 
@@ -57,37 +58,81 @@ std::vector<uint8_t> SerializeEntropyData(
 // FORMAT-SPECIFIC GENERATORS
 //=============================================================================
 
-// Format 0: Decimal number (0.0 - 1.0)
+// Format 0: Decimal number (0.0 - 1.0), 18 digits per accepted 64-bit word
 std::vector<char> GenerateDecimal(const std::vector<uint8_t>& randomBytes, int digits);
 
-// Format 1: Integer in range [min, max]
-std::vector<char> GenerateInteger(const std::vector<uint8_t>& randomBytes, int min, int max);
+// Random bytes GenerateDecimal needs for `digits` (with rejection headroom)
+size_t DecimalBytesNeeded(int digits);
+
+// Format 1: `count` integers uniform in [min, max] (any 64-bit bounds),
+// joined by newlines (separator 0), spaces (1) or commas (2)
+std::vector<char> GenerateIntegers(const std::vector<uint8_t>& randomBytes,
+                                   long long min, long long max, size_t count, int separator);
+
+// Typed variant: writes `count` values to `out`
+void GenerateIntegerValues(const std::vector<uint8_t>& randomBytes,
+                           long long min, long long max, int64_t* out, size_t count);
+
+// Random bytes the integer generators need for `count` values (with rejection headroom)
+size_t IntegerBytesNeeded(long long min, long long max, size_t count);
+
+// Format 1 with arbitrary-precision decimal bounds ("-1", "10^40" written out).
+// Returns an "[Error: ...]" message for malformed bounds.
+std::vector<char> GenerateBigIntegers(const std::vector<uint8_t>& randomBytes,
+                                      const std::string& minText, const std::string& maxText,
+                                      size_t count, int separator);
+
+// Random bytes GenerateBigIntegers needs (0 for malformed bounds)
+size_t BigIntegerBytesNeeded(const std::string& minText, const std::string& maxText, size_t count);
+
+// Bit length of (max - min), the entropy one value can carry (0 for malformed bounds)
+double BigIntegerRangeBits(const std::string& minText, const std::string& maxText);
 
 // Format 2: Binary string of specified length
 std::vector<char> GenerateBinary(const std::vector<uint8_t>& randomBytes, int length);
 
-// Format 3: Custom string from character set
+// Format 3 alphabet: the selected classes plus `extra` (any UTF-8), minus
+// `exclude` and, optionally, the ambiguous glyphs 0 O 1 I l |. One entry per
+// code point, duplicates dropped. False (with `error`) for malformed UTF-8,
+// control characters or an empty result.
+bool BuildCustomAlphabet(bool includeNumbers, bool includeUppercase,
+                         bool includeLowercase, bool includeSpecial,
+                         const std::string& extra, const std::string& exclude,
+                         bool excludeAmbiguous,
+                         std::vector<std::string>& alphabet, std::string& error);
+
+// BuildCustomAlphabet over the format 3 settings in g_state
+bool CurrentCustomAlphabet(std::vector<std::string>& alphabet, std::string& error);
+
+// Format 3: Custom string of `length` symbols drawn uniformly from `alphabet`,
+// several per 64-bit word (about log2(N) bits each)
 std::vector<char> GenerateCustomString(
     const std::vector<uint8_t>& randomBytes,
     int length,
-    bool includeNumbers,
-    bool includeUppercase,
-    bool includeLowercase,
-    bool includeSpecial);
+    const std::vector<std::string>& alphabet);
 
-// Format 4: Bit/Byte output (hex, base64, or binary)
+// Random bytes GenerateCustomString needs (with rejection headroom)
+size_t CustomStringBytesNeeded(size_t alphabetSize, int length);
+
+// Format 4: Bit/Byte output (hex, base64, binary, base32, base58 or Z85)
 std::vector<char> GenerateBitByte(
     const std::vector<uint8_t>& randomBytes,
     int amount,
     int unit,    // 0=Bits, 1=Bytes
-    int format); // 0=Hex, 1=Base64, 2=Binary
+    int format); // 0=Hex, 1=Base64, 2=Binary, 3=Base32, 4=Base58, 5=Z85
 
-// Format 5: Passphrase from wordlist
+// Format 5: `count` passphrases of `wordCount` words, one per line. Words are
+// drawn without modulo bias, several per 64-bit word (log2(N) bits each).
 std::vector<char> GeneratePassphrase(
     const std::vector<uint8_t>& randomBytes,
     int wordCount,
+    int count,
     const std::string& separator,
-    const std::vector<std::string>& wordlist);
+    const WordList& wordlist);
+
+// Random bytes GeneratePassphrase needs for a list of `wordListSize` words
+// (with rejection headroom)
+size_t PassphraseBytesNeeded(size_t wordListSize, int wordCount, int count);
 
 // Format 6: One-Time Pad (XOR with message)
 std::vector<char> GenerateOTP(
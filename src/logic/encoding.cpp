@@ -0,0 +1,221 @@
+#include "encoding.h"
+#include <cstring>
+#include <vector>
+#include "../crypto/secure_mem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_ENCODING_SSE2 1
+#endif
+
+// SSSE3 kernel compiled alongside the baseline and picked at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRNG_ENCODING_SSSE3 1
+#define TRNG_ENCODING_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Encoding {
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+static const char BASE58_ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char Z85_ALPHABET[] =
+    "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+
+//=============================================================================
+// HEX
+//=============================================================================
+
+size_t HexLength(size_t bytes) {
+    return bytes * 2;
+}
+
+void EncodeHex(const uint8_t* in, size_t bytes, char* out) {
+    size_t i = 0;
+#ifdef TRNG_ENCODING_SSE2
+    // 16 bytes per step: split nibbles, add '0' and another 39 for a-f,
+    // then interleave high and low nibbles
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i letterGap = _mm_set1_epi8('a' - '0' - 10);
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), lowNibble);
+        __m128i lo = _mm_and_si128(v, lowNibble);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letterGap));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letterGap));
+        _mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; i < bytes; i++) {
+        out[i * 2] = HEX_DIGITS[in[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[in[i] & 0x0F];
+    }
+}
+
+//=============================================================================
+// BASE64
+//=============================================================================
+
+size_t Base64Length(size_t bytes) {
+    return (bytes + 2) / 3 * 4;
+}
+
+#ifdef TRNG_ENCODING_SSSE3
+// 12 bytes to 16 characters per step (Mula / Lemire): spread each 3-byte
+// group over a 32-bit lane, move the four 6-bit fields into separate bytes
+// with two multiplies, then map each index range to its ASCII offset with a
+// 16-entry shuffle. Reads 16 bytes per step. Returns the bytes consumed.
+TRNG_ENCODING_TARGET("ssse3")
+static size_t EncodeBase64Ssse3(const uint8_t* in, size_t bytes, char* out) {
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                          '/' - 63, 'A', 0, 0);
+    size_t i = 0, o = 0;
+    for (; i + 16 <= bytes; i += 12, o += 16) {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i)), spread);
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i index = _mm_or_si128(t0, t1);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12
+        __m128i slot = _mm_subs_epu8(index, _mm_set1_epi8(51));
+        slot = _mm_or_si128(slot, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), index), _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i*)(out + o), _mm_add_epi8(index, _mm_shuffle_epi8(offsets, slot)));
+    }
+    return i;
+}
+
+static bool HasSsse3() {
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    return ssse3;
+}
+#endif
+
+void EncodeBase64(const uint8_t* in, size_t bytes, char* out) {
+    size_t i = 0;
+#ifdef TRNG_ENCODING_SSSE3
+    if (HasSsse3()) i = EncodeBase64Ssse3(in, bytes, out);
+#endif
+    char* o = out + i / 3 * 4;
+    for (; i + 3 <= bytes; i += 3, o += 4) {
+        uint32_t triple = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+        o[0] = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+        o[1] = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+        o[2] = BASE64_ALPHABET[(triple >> 6) & 0x3F];
+        o[3] = BASE64_ALPHABET[triple & 0x3F];
+    }
+    if (i < bytes) {
+        uint32_t triple = (uint32_t)in[i] << 16;
+        if (i + 1 < bytes) triple |= (uint32_t)in[i + 1] << 8;
+        o[0] = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+        o[1] = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+        o[2] = (i + 1 < bytes) ? BASE64_ALPHABET[(triple >> 6) & 0x3F] : '=';
+        o[3] = '=';
+    }
+}
+
+//=============================================================================
+// BASE32
+//=============================================================================
+
+size_t Base32Length(size_t bytes) {
+    return (bytes + 4) / 5 * 8;
+}
+
+void EncodeBase32(const uint8_t* in, size_t bytes, char* out) {
+    for (size_t i = 0; i < bytes; i += 5, out += 8) {
+        // 5 bytes -> 40 bits -> 8 characters; a short last group is padded
+        size_t n = (bytes - i < 5) ? bytes - i : 5;
+        uint64_t group = 0;
+        for (size_t k = 0; k < 5; k++) group = (group << 8) | (k < n ? in[i + k] : 0);
+        size_t chars = (n * 8 + 4) / 5;
+        for (size_t k = 0; k < 8; k++)
+            out[k] = (k < chars) ? BASE32_ALPHABET[(group >> (35 - 5 * k)) & 0x1F] : '=';
+    }
+}
+
+//=============================================================================
+// BASE58
+//=============================================================================
+
+// Digits are accumulated in base 58^5 limbs (below 2^30), taking input 4 bytes
+// at a time, so every step is a 64-bit multiply-add and a division by a
+// constant
+static constexpr uint32_t BASE58_LIMB = 58u * 58u * 58u * 58u * 58u;
+static constexpr int BASE58_LIMB_DIGITS = 5;
+
+size_t Base58MaxLength(size_t bytes) {
+    // log(256) / log(58) < 1.3658
+    return bytes * 13658 / 10000 + 2 + BASE58_LIMB_DIGITS;
+}
+
+size_t EncodeBase58(const uint8_t* in, size_t bytes, char* out) {
+    size_t zeros = 0;
+    while (zeros < bytes && in[zeros] == 0) zeros++;
+
+    std::vector<uint32_t> limbs;    // Least significant first
+    limbs.reserve(Base58MaxLength(bytes) / BASE58_LIMB_DIGITS + 1);
+    for (size_t i = zeros; i < bytes;) {
+        size_t n = (bytes - i < 4) ? bytes - i : 4;
+        uint64_t carry = 0;
+        for (size_t k = 0; k < n; k++) carry = (carry << 8) | in[i + k];
+        i += n;
+        const uint64_t scale = 1ull << (8 * n);
+        for (uint32_t& limb : limbs) {
+            uint64_t t = (uint64_t)limb * scale + carry;
+            limb = (uint32_t)(t % BASE58_LIMB);
+            carry = t / BASE58_LIMB;
+        }
+        while (carry) {
+            limbs.push_back((uint32_t)(carry % BASE58_LIMB));
+            carry /= BASE58_LIMB;
+        }
+    }
+
+    char* o = out;
+    memset(o, BASE58_ALPHABET[0], zeros);
+    o += zeros;
+    for (size_t l = limbs.size(); l-- > 0;) {
+        char digits[BASE58_LIMB_DIGITS];
+        uint32_t v = limbs[l];
+        for (int k = BASE58_LIMB_DIGITS - 1; k >= 0; k--) {
+            digits[k] = BASE58_ALPHABET[v % 58];
+            v /= 58;
+        }
+        // The most significant limb drops its leading zero digits
+        int skip = 0;
+        if (l == limbs.size() - 1)
+            while (skip < BASE58_LIMB_DIGITS - 1 && digits[skip] == BASE58_ALPHABET[0]) skip++;
+        memcpy(o, digits + skip, BASE58_LIMB_DIGITS - skip);
+        o += BASE58_LIMB_DIGITS - skip;
+        Crypto::SecureZero(digits, sizeof(digits));
+    }
+    Crypto::SecureClearVector(limbs);
+    return (size_t)(o - out);
+}
+
+//=============================================================================
+// Z85
+//=============================================================================
+
+size_t Z85Length(size_t bytes) {
+    return bytes / 4 * 5;
+}
+
+void EncodeZ85(const uint8_t* in, size_t bytes, char* out) {
+    for (size_t i = 0; i + 4 <= bytes; i += 4, out += 5) {
+        uint32_t v = ((uint32_t)in[i] << 24) | ((uint32_t)in[i + 1] << 16) | ((uint32_t)in[i + 2] << 8) | in[i + 3];
+        for (int k = 4; k >= 0; k--) {
+            out[k] = Z85_ALPHABET[v % 85];
+            v /= 85;
+        }
+    }
+}
+
+} // namespace Encoding
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Text encodings of raw random bytes for Bit/Byte output and the OTP file
+// mode. Every encoder writes straight into a caller-sized buffer: size it
+// with the matching *Length function (an upper bound for Base58).
+namespace Encoding {
+
+// Lowercase hex, 2 characters per byte (SSE2)
+size_t HexLength(size_t bytes);
+void EncodeHex(const uint8_t* in, size_t bytes, char* out);
+
+// RFC 4648 Base64 with '=' padding (SSSE3 when the CPU has it)
+size_t Base64Length(size_t bytes);
+void EncodeBase64(const uint8_t* in, size_t bytes, char* out);
+
+// RFC 4648 Base32 (A-Z, 2-7) with '=' padding
+size_t Base32Length(size_t bytes);
+void EncodeBase32(const uint8_t* in, size_t bytes, char* out);
+
+// Bitcoin-alphabet Base58, one '1' per leading zero byte. Quadratic in the
+// input size, so callers cap it (AppConfig::BASE58_MAX_BYTES).
+// Returns the characters written.
+size_t Base58MaxLength(size_t bytes);
+size_t EncodeBase58(const uint8_t* in, size_t bytes, char* out);
+
+// ZeroMQ Z85 (RFC 32): 5 characters per 4 bytes; `bytes` must be a
+// multiple of 4
+size_t Z85Length(size_t bytes);
+void EncodeZ85(const uint8_t* in, size_t bytes, char* out);
+
+} // namespace Encoding
@@ -1,122 +1,147 @@
 #include "logic.h"
 #include "../logging/logger.h"
 #include "../core/app_state.h"
+#include "csprng.h"
 #include <cmath>
 #include <cstdint>
-#include <fstream>
 #include <string>
 #include <cstring>
 #include <algorithm>
 #include <vector>
 #include <set>
 #include <map>
-#include <windows.h> // For SecureZeroMemory
-#include <sstream>
+#include <windows.h> // Wordlist resource, module path
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include "../resource.h"
-// Default wordlist entropy: log2(123565) ≈ 16.9 bits per word
-// We use 16.5 bits for calculation (conservative)
-static const float DEFAULT_WORDLIST_ENTROPY = 16.5f;
+// Built-in wordlist size, used for the entropy target until a list is loaded
+static const size_t DEFAULT_WORDLIST_WORDS = 123565;
 
-// Load the default wordlist into memory for generation
-bool LoadWordListForGeneration() {
-    try {
-        // If already loaded, don't reload
-        if (!g_state.cachedWordList.empty()) {
-            return true;
-        }
-        
-        // --- ADDED: Try loading from embedded executable resource ---
-        HRSRC hRes = FindResourceA(NULL, MAKEINTRESOURCEA(IDR_WORDLIST), (LPCSTR)RT_RCDATA);
-        if (hRes) {
-            HGLOBAL hData = LoadResource(NULL, hRes);
-            if (hData) {
-                DWORD size = SizeofResource(NULL, hRes);
-                const char* data = (const char*)LockResource(hData);
-                if (data && size > 0) {
-                    g_state.cachedWordList.clear();
-                    g_state.cachedWordList.reserve(125000);
-                    
-                    std::string wordlistData(data, size);
-                    std::istringstream iss(wordlistData);
-                    std::string line;
-                    while (std::getline(iss, line)) {
-                        size_t start = line.find_first_not_of(" \t\r\n");
-                        size_t end = line.find_last_not_of(" \t\r\n");
-                        if (start != std::string::npos && end != std::string::npos) {
-                            g_state.cachedWordList.push_back(line.substr(start, end - start + 1));
-                        }
-                    }
-                    
-                    g_state.wordListCacheValid = true;
-                    Logger::Log(Logger::Level::INFO, "Logic", "Loaded %zu words from embedded resource", g_state.cachedWordList.size());
-                    return !g_state.cachedWordList.empty();
-                }
-            }
-        }
+// Guards g_state.wordList while it is (re)loaded
+static std::mutex s_wordListMutex;
+static std::thread s_wordListPreload;
+// Source of the loaded list (-1 = none, else passphraseWordListSource), the
+// custom file path, and the list size for the GUI
+static int s_wordListSource = -1;
+static std::string s_wordListPath;
+static std::atomic<size_t> s_wordListSize{0};
 
-        // Try multiple paths for the wordlist
-        std::vector<std::string> paths = {
-            "assets/default_wordlist.txt",
-            "./assets/default_wordlist.txt",
-            "../assets/default_wordlist.txt",
-            "default_wordlist.txt"
-        };
-        
-        // Also try to get exe directory path
-        char exePath[MAX_PATH];
-        if (GetModuleFileNameA(NULL, exePath, MAX_PATH) > 0) {
-            std::string exeDir = exePath;
-            size_t lastSlash = exeDir.find_last_of("\\/");
-            if (lastSlash != std::string::npos) {
-                exeDir = exeDir.substr(0, lastSlash + 1);
-                paths.insert(paths.begin(), exeDir + "assets/default_wordlist.txt");
-                paths.insert(paths.begin(), exeDir + "assets\\default_wordlist.txt");
+// Default wordlist: embedded resource first, then an index or text file next
+// to the executable or in assets/
+static bool LoadDefaultWordList(WordList& list) {
+    HRSRC hRes = FindResourceA(NULL, MAKEINTRESOURCEA(IDR_WORDLIST), (LPCSTR)RT_RCDATA);
+    if (hRes) {
+        HGLOBAL hData = LoadResource(NULL, hRes);
+        if (hData) {
+            DWORD size = SizeofResource(NULL, hRes);
+            const char* data = (const char*)LockResource(hData);
+            if (data && size > 0 && list.LoadText(data, size)) {
+                Logger::Log(Logger::Level::INFO, "Logic", "Loaded %zu words from embedded resource", list.Size());
+                return true;
             }
         }
-        
-        std::ifstream file;
-        for (const auto& path : paths) {
-            file.open(path);
-            if (file.is_open()) {
-                Logger::Log(Logger::Level::INFO, "Logic", 
-                            "Loaded wordlist from: %s", path.c_str());
-                break;
-            }
-        }
-        
-        if (!file.is_open()) {
-            Logger::Log(Logger::Level::ERR, "Logic", 
-                        "Failed to find wordlist in any path");
-            return false;
+    }
+
+    std::vector<std::string> paths;
+    char exePath[MAX_PATH];
+    if (GetModuleFileNameA(NULL, exePath, MAX_PATH) > 0) {
+        std::string exeDir = exePath;
+        size_t lastSlash = exeDir.find_last_of("\\/");
+        if (lastSlash != std::string::npos) {
+            exeDir = exeDir.substr(0, lastSlash + 1);
+            paths.push_back(exeDir + "assets\\default_wordlist.twl");
+            paths.push_back(exeDir + "assets\\default_wordlist.txt");
         }
-        
-        // Load all words
-        g_state.cachedWordList.clear();
-        g_state.cachedWordList.reserve(125000); // ~123565 words expected
-        
-        std::string line;
-        while (std::getline(file, line)) {
-            // Trim whitespace
-            size_t start = line.find_first_not_of(" \t\r\n");
-            size_t end = line.find_last_not_of(" \t\r\n");
-            if (start != std::string::npos && end != std::string::npos) {
-                g_state.cachedWordList.push_back(line.substr(start, end - start + 1));
-            }
+    }
+    for (const char* dir : {"assets/", "./assets/", "../assets/", ""}) {
+        paths.push_back(std::string(dir) + "default_wordlist.twl");
+        paths.push_back(std::string(dir) + "default_wordlist.txt");
+    }
+
+    for (const auto& path : paths) {
+        std::string error;
+        if (list.LoadFile(path, error)) {
+            Logger::Log(Logger::Level::INFO, "Logic", "Loaded %zu words from: %s", list.Size(), path.c_str());
+            return true;
         }
-        
-        file.close();
-        g_state.wordListCacheValid = true;
-        
-        Logger::Log(Logger::Level::INFO, "Logic", 
-                    "Loaded %zu words into wordlist cache", 
-                    g_state.cachedWordList.size());
-        
-        return !g_state.cachedWordList.empty();
-    } catch (...) {
-        g_state.cachedWordList.clear();
-        g_state.wordListCacheValid = false;
+    }
+    Logger::Log(Logger::Level::ERR, "Logic", "Failed to find wordlist in any path");
+    return false;
+}
+
+// Custom lists must hold at least two distinct words so every word is worth
+// exactly log2(N) bits
+static bool LoadCustomWordList(WordList& list, const std::string& path, std::string& error) {
+    if (path.empty()) {
+        error = "No wordlist file selected";
         return false;
     }
+    if (!list.LoadFile(path, error)) return false;
+    if (list.Size() < 2) {
+        error = path + ": needs at least 2 words";
+    } else if (size_t duplicates = list.CountDuplicates()) {
+        error = path + ": " + std::to_string(duplicates) + " duplicate word(s)";
+    } else {
+        return true;
+    }
+    list.Clear();
+    return false;
+}
+
+// Load the selected wordlist into memory for generation (waits for a preload
+// already in progress); reloads only when the selection changed
+bool LoadWordListForGeneration(std::string* error) {
+    std::lock_guard<std::mutex> lock(s_wordListMutex);
+    const int source = g_state.passphraseWordListSource;
+    const std::string path = (source == 1) ? std::string(g_state.passphraseWordListPath.data()) : std::string();
+    if (!g_state.wordList.Empty() && source == s_wordListSource && path == s_wordListPath) {
+        return true;
+    }
+
+    s_wordListSize = 0;
+    s_wordListSource = -1;
+    const auto start = std::chrono::steady_clock::now();
+    std::string loadError = "Failed to find the built-in wordlist";
+    bool ok;
+    if (source == 1) {
+        ok = LoadCustomWordList(g_state.wordList, path, loadError);
+        if (!ok) Logger::Log(Logger::Level::ERR, "Logic", "Custom wordlist rejected: %s", loadError.c_str());
+    } else {
+        ok = LoadDefaultWordList(g_state.wordList);
+    }
+    if (!ok) {
+        g_state.wordList.Clear();
+        if (error) *error = loadError;
+        return false;
+    }
+
+    s_wordListSource = source;
+    s_wordListPath = path;
+    s_wordListSize = g_state.wordList.Size();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Logger::Log(Logger::Level::INFO, "Logic", "Wordlist ready: %zu words (%.2f bits/word), %zu KB, %.1f ms",
+                g_state.wordList.Size(), std::log2((double)g_state.wordList.Size()),
+                g_state.wordList.MemoryBytes() / 1024, ms);
+    return true;
+}
+
+size_t LoadedWordListSize() {
+    return s_wordListSize;
+}
+
+void StartWordListPreload() {
+    if (s_wordListPreload.joinable()) return;
+    s_wordListPreload = std::thread([] { LoadWordListForGeneration(); });
+}
+
+void ReleaseWordList() {
+    if (s_wordListPreload.joinable()) s_wordListPreload.join();
+    std::lock_guard<std::mutex> lock(s_wordListMutex);
+    g_state.wordList.Clear();
+    s_wordListSource = -1;
+    s_wordListSize = 0;
 }
 
 float CalculateRequiredEntropy() {
@@ -130,9 +155,18 @@ float CalculateRequiredEntropy() {
             
         case 1: // Integer Range
         {
-            long long range = (long long)g_state.integerMax - (long long)g_state.integerMin + 1;
-            if (range <= 1) bits = 1.0f;
-            else bits = std::ceil(std::log2((double)range));
+            // Per value: log2 of the range size; the span is computed unsigned
+            // so LLONG_MIN..LLONG_MAX does not overflow (span + 1 == 2^64)
+            double perValue;
+            if (g_state.integerBigRange) {
+                perValue = CSPRNG::BigIntegerRangeBits(g_state.integerMinText.data(), g_state.integerMaxText.data());
+            } else {
+                uint64_t span = (uint64_t)std::max(g_state.integerMin, g_state.integerMax) -
+                                (uint64_t)std::min(g_state.integerMin, g_state.integerMax);
+                perValue = (span == UINT64_MAX) ? 64.0 : std::log2((double)span + 1.0);
+            }
+            if (perValue < 1.0) perValue = 1.0;
+            bits = (float)(std::ceil(perValue) * g_state.integerCount);
             break;
         }
             
@@ -142,13 +176,10 @@ float CalculateRequiredEntropy() {
             
         case 3: // Custom String
         {
-            int charsetSize = 0;
-            if (g_state.includeNumbers) charsetSize += 10;
-            if (g_state.includeUppercase) charsetSize += 26;
-            if (g_state.includeLowercase) charsetSize += 26;
-            if (g_state.includeSpecial) charsetSize += 32; // Approx standard special chars
-            
-            if (charsetSize < 1) charsetSize = 1;
+            std::vector<std::string> alphabet;
+            std::string error;
+            size_t charsetSize = 1;
+            if (CSPRNG::CurrentCustomAlphabet(alphabet, error)) charsetSize = alphabet.size();
             bits = g_state.customLength * std::log2((double)charsetSize);
             break;
         }
@@ -162,8 +193,10 @@ float CalculateRequiredEntropy() {
             
         case 5: // Passphrase
         {
-            // Default wordlist: 123,565 words = ~16.5 bits per word
-            bits = g_state.passphraseWordCount * DEFAULT_WORDLIST_ENTROPY;
+            // log2(N) per word of the loaded list (built-in size until it is in)
+            size_t words = LoadedWordListSize();
+            if (words < 2) words = DEFAULT_WORDLIST_WORDS;
+            bits = (float)((double)g_state.passphraseWordCount * g_state.passphraseCount * std::log2((double)words));
             break;
         }
         
@@ -2,10 +2,24 @@
 #include <vector>
 #include <cstdint>
 #include <set>
+#include <string>
 #include "../entropy/entropy_common.h"
 
-// Loads the default wordlist into memory for generation
-bool LoadWordListForGeneration();
+// Loads the wordlist selected in g_state (built-in, or the custom file at
+// passphraseWordListPath) into g_state.wordList for generation. Custom lists
+// with fewer than 2 words or with duplicates are rejected; `error` (optional)
+// receives the reason.
+bool LoadWordListForGeneration(std::string* error = nullptr);
+
+// Words in the loaded list, 0 while none is loaded (safe from any thread)
+size_t LoadedWordListSize();
+
+// Load the default wordlist on a background thread at startup, so the first
+// passphrase does not wait for it
+void StartWordListPreload();
+
+// Join the preload and wipe the wordlist (shutdown)
+void ReleaseWordList();
 
 // Calculates the required entropy bits based on current output configuration
 float CalculateRequiredEntropy();
@@ -0,0 +1,157 @@
+// TRNG - Passphrase Wordlist Implementation
+
+#include "wordlist.h"
+#include "../crypto/secure_mem.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+constexpr char WordList::INDEX_MAGIC[9];
+
+static constexpr size_t INDEX_HEADER_BYTES = 24;
+
+WordList::~WordList() {
+    Clear();
+}
+
+void WordList::Clear() {
+    Crypto::SecureClearVector(m_arena);
+    m_arena.shrink_to_fit();
+    m_arenaOffsets.clear();
+    m_arenaOffsets.shrink_to_fit();
+    m_file.Close();
+    m_blob = nullptr;
+    m_offsets = nullptr;
+    m_count = 0;
+    m_blobBytes = 0;
+    m_maxWordBytes = 0;
+}
+
+size_t WordList::MemoryBytes() const {
+    return m_arena.capacity() + m_arenaOffsets.capacity() * sizeof(uint32_t) + (size_t)m_file.Size();
+}
+
+size_t WordList::CountDuplicates() const {
+    std::vector<std::string_view> words(m_count);
+    for (size_t i = 0; i < m_count; i++) words[i] = Word(i);
+    std::sort(words.begin(), words.end());
+    size_t duplicates = 0;
+    for (size_t i = 1; i < words.size(); i++)
+        if (words[i] == words[i - 1]) duplicates++;
+    return duplicates;
+}
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool WordList::LoadText(const char* data, size_t size) {
+    Clear();
+    return ParseText(data, size);
+}
+
+bool WordList::ParseText(const char* data, size_t size) {
+    if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {   // UTF-8 BOM
+        data += 3;
+        size -= 3;
+    }
+    if (size > UINT32_MAX) return false;
+
+    // One reservation each: the blob is never larger than the text
+    m_arena.reserve(size);
+    m_arenaOffsets.reserve((size_t)std::count(data, data + size, '\n') + 2);
+    m_arenaOffsets.push_back(0);
+
+    const char* end = data + size;
+    for (const char* line = data; line < end;) {
+        const char* newline = (const char*)memchr(line, '\n', (size_t)(end - line));
+        const char* stop = newline ? newline : end;
+        const char* first = line;
+        const char* last = stop;
+        while (first < last && IsSpace(*first)) first++;
+        while (last > first && IsSpace(last[-1])) last--;
+        if (last > first) {
+            m_arena.insert(m_arena.end(), first, last);
+            m_arenaOffsets.push_back((uint32_t)m_arena.size());
+            m_maxWordBytes = std::max(m_maxWordBytes, (size_t)(last - first));
+        }
+        line = stop + 1;
+    }
+
+    m_blob = m_arena.data();
+    m_offsets = m_arenaOffsets.data();
+    m_count = m_arenaOffsets.size() - 1;
+    m_blobBytes = m_arena.size();
+    return m_count > 0;
+}
+
+bool WordList::AdoptIndex(const uint8_t* data, uint64_t size) {
+    uint32_t header[4];
+    memcpy(header, data + 8, sizeof(header));
+    const uint64_t count = header[0], blobBytes = header[1];
+    const uint64_t offsetsBytes = (count + 1) * 4;
+    if (count == 0 || INDEX_HEADER_BYTES + offsetsBytes + blobBytes > size) return false;
+
+    // Validated once here so Word() can index without checks: offsets start
+    // at 0, every word is non-empty, the last offset ends the blob and the
+    // header's longest word is the real one
+    const uint32_t* offsets = (const uint32_t*)(data + INDEX_HEADER_BYTES);
+    if (offsets[0] != 0 || offsets[count] != blobBytes) return false;
+    uint32_t longest = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (offsets[i + 1] <= offsets[i]) return false;
+        longest = std::max(longest, offsets[i + 1] - offsets[i]);
+    }
+    if (longest != header[2]) return false;
+
+    m_offsets = offsets;
+    m_blob = (const char*)(data + INDEX_HEADER_BYTES + offsetsBytes);
+    m_count = (size_t)count;
+    m_blobBytes = (size_t)blobBytes;
+    m_maxWordBytes = longest;
+    return true;
+}
+
+bool WordList::LoadFile(const std::string& path, std::string& error) {
+    Clear();
+    if (!m_file.Open(path, error)) return false;
+
+    const uint8_t* data = m_file.Data();
+    const uint64_t size = m_file.Size();
+    if (size >= INDEX_HEADER_BYTES && memcmp(data, INDEX_MAGIC, 8) == 0) {
+        if (AdoptIndex(data, size)) return true;
+        error = path + ": truncated or corrupt wordlist index";
+        Clear();
+        return false;
+    }
+
+    // Text: parse into the arena, then drop the mapping
+    bool ok = size <= UINT32_MAX && ParseText((const char*)data, (size_t)size);
+    m_file.Close();
+    if (!ok) {
+        error = path + ": no words found";
+        Clear();
+    }
+    return ok;
+}
+
+bool WordList::WriteIndex(const std::string& path, std::string& error) const {
+    if (Empty()) {
+        error = "no wordlist loaded";
+        return false;
+    }
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) {
+        error = "cannot create " + path + ": " + strerror(errno);
+        return false;
+    }
+    uint32_t header[4] = {(uint32_t)m_count, (uint32_t)m_blobBytes, (uint32_t)m_maxWordBytes, 0};
+    bool ok = fwrite(INDEX_MAGIC, 1, 8, out) == 8 &&
+              fwrite(header, sizeof(header), 1, out) == 1 &&
+              fwrite(m_offsets, sizeof(uint32_t), m_count + 1, out) == m_count + 1 &&
+              fwrite(m_blob, 1, m_blobBytes, out) == m_blobBytes;
+    if (fclose(out) != 0) ok = false;
+    if (!ok) error = "write to " + path + " failed";
+    return ok;
+}
@@ -0,0 +1,73 @@
+// TRNG - Passphrase Wordlist
+// All words live in one contiguous blob addressed by an offset table (no
+// per-word allocations). Text lists are parsed into an owned arena in a
+// single pass; the precomputed index format is memory-mapped and used in
+// place after one pass over its offset table to validate it.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../platform/mapped_file.h"
+
+// Index file layout (little-endian):
+//   char     magic[8]                 "TRNGWL1\n"
+//   uint32_t count, blobBytes, maxWordBytes, reserved
+//   uint32_t offsets[count + 1]       word i = blob[offsets[i] .. offsets[i + 1])
+//   char     blob[blobBytes]
+class WordList {
+public:
+    static constexpr char INDEX_MAGIC[9] = "TRNGWL1\n";
+
+    WordList() = default;
+    ~WordList();
+    WordList(const WordList&) = delete;
+    WordList& operator=(const WordList&) = delete;
+
+    // Parse newline-separated words (surrounding whitespace trimmed, blank
+    // lines skipped) into the arena. Replaces any loaded list.
+    bool LoadText(const char* data, size_t size);
+
+    // Map `path`: index files are validated and used in place, anything else
+    // is parsed as text. A truncated or inconsistent index is an error.
+    bool LoadFile(const std::string& path, std::string& error);
+
+    // Save the loaded list in index format
+    bool WriteIndex(const std::string& path, std::string& error) const;
+
+    size_t Size() const { return m_count; }
+    bool Empty() const { return m_count == 0; }
+    size_t MaxWordBytes() const { return m_maxWordBytes; }
+
+    // Word `i` (< Size()); the view stays valid until the list is cleared
+    std::string_view Word(size_t i) const {
+        return std::string_view(m_blob + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+    }
+
+    // Words that repeat an earlier entry (O(N log N)). Duplicates make the
+    // draw non-uniform over distinct words, so callers reject such lists.
+    size_t CountDuplicates() const;
+
+    // Heap and mapped bytes held by the list
+    size_t MemoryBytes() const;
+
+    // Wipe the arena and unmap any file
+    void Clear();
+
+private:
+    bool ParseText(const char* data, size_t size);
+    bool AdoptIndex(const uint8_t* data, uint64_t size);
+
+    std::vector<char> m_arena;
+    std::vector<uint32_t> m_arenaOffsets;
+    MappedFile m_file;
+
+    const char* m_blob = nullptr;
+    const uint32_t* m_offsets = nullptr;
+    size_t m_count = 0;
+    size_t m_blobBytes = 0;
+    size_t m_maxWordBytes = 0;
+};
@@ -18,9 +18,10 @@
 #include "logic/logic.h"
 #include "platform/dx11.h"
 #include "logging/logger.h"
+#include "crypto/secure_mem.h"
 
 #include <shellscalingapi.h>
-#include <windows.h> // For SecureZeroMemory
+#include <windows.h>
 #pragma comment(lib, "shcore.lib")
 #include "resource.h"
 
@@ -73,6 +74,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     // Initialize Logger FIRST
     Logger::Init("logs");
     Logger::Log(Logger::Level::INFO, "Main", "Application starting...");
+
+    // Parse the passphrase wordlist while the window comes up
+    StartWordListPreload();
     
     // Enable DPI awareness for sharp rendering
     SetProcessDpiAwareness(PROCESS_PER_MONITOR_DPI_AWARE);
@@ -199,6 +203,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 g_state.mouseCollector.Stop();
             }
 
+            if (g_state.cpuHwrngEnabled && !g_state.cpuHwrngCollector.IsRunning()) {
+                g_state.cpuHwrngCollector.Start();
+            }
+            else if (!g_state.cpuHwrngEnabled && g_state.cpuHwrngCollector.IsRunning()) {
+                g_state.cpuHwrngCollector.Stop();
+            }
+
             if (g_state.microphoneEnabled && !g_state.microphoneCollector.IsRunning()) {
                 g_state.microphoneCollector.Start();
             }
@@ -211,6 +222,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 auto data = g_state.clockDriftCollector.Harvest();
                 
                 if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::ClockDrift, data);
                     g_state.entropyPool.AddDataPoints(data);
                     
                     std::vector<uint64_t> values;
@@ -223,15 +235,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                     
                     // SECURITY: Securely clear both extracted values AND original data
                     if (!values.empty()) {
-                        SecureZeroMemory(values.data(), values.size() * sizeof(uint64_t));
+                        Crypto::SecureZero(values.data(), values.size() * sizeof(uint64_t));
                     }
-                    SecureZeroMemory(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                    Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
                 }
             }
 
             if (g_state.cpuJitterEnabled) {
                 auto data = g_state.cpuJitterCollector.Harvest();
                 if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::CpuJitter, data);
                     g_state.entropyPool.AddDataPoints(data);
                     
                     std::vector<uint64_t> values;
@@ -243,14 +256,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                     
                     // SECURITY: Securely clear both extracted values AND original data
                     if (!values.empty()) {
-                        SecureZeroMemory(values.data(), values.size() * sizeof(uint64_t));
+                        Crypto::SecureZero(values.data(), values.size() * sizeof(uint64_t));
                     }
-                    SecureZeroMemory(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                    Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
                 }
             }
             if (g_state.keystrokeEnabled) {
                 auto data = g_state.keystrokeCollector.Harvest();
                 if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::Keystroke, data);
                     g_state.entropyPool.AddDataPoints(data);
                     
                     std::vector<uint64_t> values;
@@ -262,15 +276,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                     
                     // SECURITY: Securely clear both extracted values AND original data
                     if (!values.empty()) {
-                        SecureZeroMemory(values.data(), values.size() * sizeof(uint64_t));
+                        Crypto::SecureZero(values.data(), values.size() * sizeof(uint64_t));
                     }
-                    SecureZeroMemory(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                    Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
                 }
             }
 
             if (g_state.mouseMovementEnabled) {
                 auto data = g_state.mouseCollector.Harvest();
                 if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::Mouse, data);
                     g_state.entropyPool.AddDataPoints(data);
                     
                     std::vector<uint64_t> values;
@@ -282,15 +297,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                     
                     // SECURITY: Securely clear both extracted values AND original data
                     if (!values.empty()) {
-                        SecureZeroMemory(values.data(), values.size() * sizeof(uint64_t));
+                        Crypto::SecureZero(values.data(), values.size() * sizeof(uint64_t));
                     }
-                    SecureZeroMemory(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                    Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
                 }
             }
 
             if (g_state.microphoneEnabled) {
                 auto data = g_state.microphoneCollector.Harvest();
                 if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::Microphone, data);
                     g_state.entropyPool.AddDataPoints(data);
                     
                     // Microphone entropy logic: 
@@ -308,11 +324,42 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                     // Actually, the vector contains structs with uint64_t values.
                     // Strictly speaking we should wipe it if it's sensitive.
                     if (!data.empty()) {
-                        SecureZeroMemory(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                        Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
                     }
                 }
             }
 
+            if (g_state.cpuHwrngEnabled) {
+                auto data = g_state.cpuHwrngCollector.Harvest();
+                if (!data.empty()) {
+                    g_state.noiseExporter.Tap(Entropy::EntropySource::CpuHwrng, data);
+                    g_state.entropyPool.AddDataPoints(data);
+
+                    // CPU DRNG: credited at the pool's per-point cap (32 bits),
+                    // never the full 64 - we can't inspect the hardware's noise source.
+                    float newEntropy = (float)data.size() * Entropy::MaxCreditBitsPerPoint(Entropy::EntropySource::CpuHwrng);
+                    g_state.entropyHwrng += newEntropy;
+
+                    Crypto::SecureZero(data.data(), data.size() * sizeof(Entropy::EntropyDataPoint));
+                }
+            }
+
+            // Duty-cycle the background sources once fresh (post-lock) entropy covers
+            // the target. Hook-driven sources (keys, mouse) cost nothing idle and stay on.
+            Entropy::CollectionState prevState = g_state.collectionPolicy.GetState();
+            Entropy::CollectionState policyState =
+                g_state.collectionPolicy.Update(g_state.freshBits, g_state.targetBits);
+            if (policyState != prevState) {
+                Logger::Log(Logger::Level::INFO, "Main", "Collection policy: %s -> %s (fresh %.0f / target %.0f bits)",
+                            Entropy::CollectionStateName(prevState), Entropy::CollectionStateName(policyState),
+                            g_state.freshBits, g_state.targetBits);
+            }
+            // A raw noise capture needs full-rate samples until every file is complete
+            if (g_state.noiseExporter.IsActive()) policyState = Entropy::CollectionState::Active;
+            g_state.clockDriftCollector.SetCollectionState(policyState);
+            g_state.cpuJitterCollector.SetCollectionState(policyState);
+            g_state.microphoneCollector.SetCollectionState(policyState);
+            g_state.cpuHwrngCollector.SetCollectionState(policyState);
 
             // Simulate other sources for now until implemented
             // logic::SimulateEntropyCollection() calls are currently in GUI... 
@@ -336,6 +383,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             if (g_state.microphoneCollector.IsRunning()) {
                 g_state.microphoneCollector.Stop();
             }
+            if (g_state.cpuHwrngCollector.IsRunning()) {
+                g_state.cpuHwrngCollector.Stop();
+            }
             // Clear visualization data
             g_state.mouseTrail.clear();
             g_state.keystrokePreview.clear();
@@ -424,6 +474,10 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     // SECURITY: Securely wipe all sensitive data before shutdown
     // This addresses FIPS 140-2 key zeroization requirements
     
+    // Close any raw noise capture still running (files keep what was captured)
+    std::string exportError;
+    g_state.noiseExporter.Stop(exportError);
+
     // Wipe entropy pool
     g_state.entropyPool.SecureWipe();
     
@@ -433,26 +487,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     
     // Wipe generated output (may contain cryptographic keys)
     if (!g_state.generatedOutput.empty()) {
-        SecureZeroMemory(g_state.generatedOutput.data(), g_state.generatedOutput.size());
+        Crypto::SecureZero(g_state.generatedOutput.data(), g_state.generatedOutput.size());
         g_state.generatedOutput.clear();
         g_state.generatedOutput.shrink_to_fit();
     }
     
     // Wipe keystroke preview (reveals user input patterns)
     if (!g_state.keystrokePreview.empty()) {
-        SecureZeroMemory(g_state.keystrokePreview.data(), g_state.keystrokePreview.size());
+        Crypto::SecureZero(g_state.keystrokePreview.data(), g_state.keystrokePreview.size());
         g_state.keystrokePreview.clear();
         g_state.keystrokePreview.shrink_to_fit();
     }
     
-    // Wipe wordlist cache
-    for (auto& word : g_state.cachedWordList) {
-        if (!word.empty()) {
-            SecureZeroMemory(word.data(), word.size());
-        }
-    }
-    g_state.cachedWordList.clear();
-    g_state.cachedWordList.shrink_to_fit();
+    // Wipe wordlist
+    ReleaseWordList();
     
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
@@ -0,0 +1,35 @@
+// TRNG - Portable Cycle Counter
+// Replaces direct __rdtsc calls so timing code builds on every target:
+// the TSC on x86, the generic timer's virtual count on ARM64, and
+// steady_clock nanoseconds anywhere else.
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TRNG_CYCLES_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__GNUC__)
+#define TRNG_CYCLES_CNTVCT 1
+#else
+#include <chrono>
+#endif
+
+// Free-running counter; only differences between two reads are meaningful
+inline uint64_t ReadCycleCounter() {
+#if defined(TRNG_CYCLES_TSC)
+    return __rdtsc();
+#elif defined(TRNG_CYCLES_CNTVCT)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
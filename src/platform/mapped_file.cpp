@@ -0,0 +1,218 @@
+// TRNG - Memory-Mapped Files Implementation
+
+#include "mapped_file.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+bool MappedOutputFile::Create(const std::string& path, uint64_t capacity, std::string& error) {
+    Close(m_capacity);
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot create " + path + " (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    m_file = file;
+    // Extending a (non-sparse) file through the mapping allocates its clusters,
+    // so a full disk fails here (ERROR_DISK_FULL) rather than on a later write
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(capacity >> 32),
+                                        (DWORD)(capacity & 0xFFFFFFFF), nullptr);
+    if (!mapping) {
+        error = "cannot map " + path + " (error " + std::to_string(GetLastError()) + ")";
+        Release();
+        return false;
+    }
+    m_mapping = mapping;
+    m_data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)capacity);
+    if (!m_data) {
+        error = "cannot map " + path + " (error " + std::to_string(GetLastError()) + ")";
+        Release();
+        return false;
+    }
+    m_capacity = capacity;
+    return true;
+}
+
+bool MappedOutputFile::Close(uint64_t finalSize) {
+    if (!m_file) return true;
+    bool ok = true;
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)finalSize;
+    if (!SetFilePointerEx((HANDLE)m_file, end, nullptr, FILE_BEGIN) || !SetEndOfFile((HANDLE)m_file)) ok = false;
+    Release();
+    return ok;
+}
+
+void MappedOutputFile::Release() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    if (m_file) CloseHandle((HANDLE)m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_capacity = 0;
+}
+
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedOutputFile::~MappedOutputFile() {
+    Close(m_capacity);
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path, std::string& error) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path + " (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        error = "cannot stat " + path + " (error " + std::to_string(GetLastError()) + ")";
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_size = (uint64_t)size.QuadPart;
+    if (m_size == 0) return true;   // CreateFileMapping rejects empty files
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        error = "cannot map " + path + " (error " + std::to_string(GetLastError()) + ")";
+        Close();
+        return false;
+    }
+    m_mapping = mapping;
+    m_data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data) {
+        error = "cannot map " + path + " (error " + std::to_string(GetLastError()) + ")";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::AdviseSequential() {
+    // FILE_FLAG_SEQUENTIAL_SCAN at open time already steers the cache manager
+}
+
+void MappedFile::Close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    if (m_file) CloseHandle((HANDLE)m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, std::string& error) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        error = "cannot stat " + path + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_size = (uint64_t)st.st_size;
+    if (m_size == 0) return true;   // mmap rejects zero-length mappings
+
+    void* data = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        error = "cannot map " + path + ": " + strerror(errno);
+        Close();
+        return false;
+    }
+    m_data = (const uint8_t*)data;
+    return true;
+}
+
+void MappedFile::AdviseSequential() {
+    if (m_data) madvise((void*)m_data, (size_t)m_size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::Close() {
+    if (m_data) munmap((void*)m_data, (size_t)m_size);
+    if (m_fd >= 0) close(m_fd);
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+bool MappedOutputFile::Create(const std::string& path, uint64_t capacity, std::string& error) {
+    Close(m_capacity);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "cannot create " + path + ": " + strerror(errno);
+        return false;
+    }
+    m_fd = fd;
+    // Allocate the blocks now: a sparse file (ftruncate) that runs out of disk
+    // while being filled raises SIGBUS through the mapping instead of an error
+    int rc;
+    do {
+        rc = posix_fallocate(fd, 0, (off_t)capacity);
+    } while (rc == EINTR);
+    if (rc != 0) {
+        error = rc == ENOSPC ? "not enough disk space for " + std::to_string(capacity) + " bytes at " + path
+                             : "cannot allocate " + path + ": " + strerror(rc);
+        Release();
+        unlink(path.c_str());   // Don't leave a partly allocated file behind
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        error = "cannot map " + path + ": " + strerror(errno);
+        Release();
+        return false;
+    }
+    m_data = (uint8_t*)data;
+    m_capacity = capacity;
+    return true;
+}
+
+bool MappedOutputFile::Close(uint64_t finalSize) {
+    if (m_fd < 0) return true;
+    bool ok = true;
+    if (m_data) munmap(m_data, (size_t)m_capacity);
+    m_data = nullptr;
+    if (ftruncate(m_fd, (off_t)finalSize) != 0) ok = false;
+    Release();
+    return ok;
+}
+
+void MappedOutputFile::Release() {
+    if (m_data) munmap(m_data, (size_t)m_capacity);
+    if (m_fd >= 0) close(m_fd);
+    m_data = nullptr;
+    m_fd = -1;
+    m_capacity = 0;
+}
+
+#endif
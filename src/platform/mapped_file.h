@@ -0,0 +1,74 @@
+// TRNG - Memory-Mapped Files
+// Maps a whole file for reading (CreateFileMapping / mmap) so large inputs
+// (test-suite dumps) are paged in on demand instead of copied into the heap,
+// or a pre-sized output file for writing in place (raw noise captures).
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map `path` read-only. An empty file opens successfully with Size() == 0.
+    bool Open(const std::string& path, std::string& error);
+
+    // Tell the OS the mapping will be read front to back (no-op where unsupported)
+    void AdviseSequential();
+
+    void Close();
+
+    const uint8_t* Data() const { return m_data; }
+    uint64_t Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;      // HANDLE
+    void* m_mapping = nullptr;   // HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
+
+// Writable mapping of a new file, pre-sized to a fixed capacity. Close() cuts
+// the file back to the bytes actually used.
+class MappedOutputFile {
+public:
+    MappedOutputFile() = default;
+    ~MappedOutputFile();
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    // Create (or truncate) `path` with `capacity` bytes (> 0) and map it read-write.
+    // The space is allocated up front, so a disk too small for `capacity` is
+    // reported here rather than faulting (SIGBUS) partway through the writes.
+    bool Create(const std::string& path, uint64_t capacity, std::string& error);
+
+    // Unmap and truncate the file to `finalSize` (<= capacity). Returns false if
+    // the data could not be flushed or the file could not be resized.
+    bool Close(uint64_t finalSize);
+
+    bool IsOpen() const { return m_data != nullptr; }
+    uint8_t* Data() const { return m_data; }
+    uint64_t Capacity() const { return m_capacity; }
+
+private:
+    void Release();
+
+    uint8_t* m_data = nullptr;
+    uint64_t m_capacity = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;      // HANDLE
+    void* m_mapping = nullptr;   // HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
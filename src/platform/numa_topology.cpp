@@ -0,0 +1,127 @@
+// TRNG - NUMA Topology Implementation
+// sysfs (Linux) / processor-group masks (Windows) node detection and pinning
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0601     // GetNumaNodeProcessorMaskEx, SetThreadGroupAffinity
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+#include "numa_topology.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+// Parse a sysfs CPU list such as "0-3,8-11" into CPU numbers
+static std::vector<int> ParseCpuList(const char* text) {
+    std::vector<int> cpus;
+    const char* p = text;
+    while (*p && *p != '\n') {
+        char* end = nullptr;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1) break;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) cpus.push_back((int)cpu);
+        if (*p == ',') p++;
+    }
+    return cpus;
+}
+#endif
+
+NumaTopology NumaTopology::Detect() {
+    NumaTopology topo;
+
+#ifdef _WIN32
+    ULONG highest = 0;
+    if (GetNumaHighestNodeNumber(&highest)) {
+        for (ULONG id = 0; id <= highest; id++) {
+            GROUP_AFFINITY affinity;
+            memset(&affinity, 0, sizeof(affinity));
+            if (!GetNumaNodeProcessorMaskEx((USHORT)id, &affinity) || affinity.Mask == 0) continue;
+            NumaNode node;
+            node.id = (int)id;
+            node.group = affinity.Group;
+            node.mask = (uint64_t)affinity.Mask;
+            for (int bit = 0; bit < 64; bit++) {
+                if (node.mask & (1ull << bit)) node.cpus.push_back(bit);
+            }
+            topo.m_nodes.push_back(node);
+        }
+    }
+#else
+    // Only CPUs this process may use (taskset, cpusets, containers)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool haveAllowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            if (strncmp(entry->d_name, "node", 4) != 0) continue;
+            char* end = nullptr;
+            long id = strtol(entry->d_name + 4, &end, 10);
+            if (end == entry->d_name + 4 || *end != '\0') continue;
+
+            std::string path = std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist";
+            FILE* f = fopen(path.c_str(), "r");
+            if (!f) continue;
+            char line[4096] = {};
+            bool read = fgets(line, sizeof(line), f) != nullptr;
+            fclose(f);
+            if (!read) continue;
+
+            NumaNode node;
+            node.id = (int)id;
+            for (int cpu : ParseCpuList(line)) {
+                if (!haveAllowed || CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+            }
+            // Memory-only nodes (and nodes we are fenced off from) get no work
+            if (!node.cpus.empty()) topo.m_nodes.push_back(node);
+        }
+        closedir(dir);
+    }
+    std::sort(topo.m_nodes.begin(), topo.m_nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+
+    topo.m_detected = !topo.m_nodes.empty();
+    if (!topo.m_detected) {
+        NumaNode node;
+        int cpus = std::max(1, (int)std::thread::hardware_concurrency());
+        for (int i = 0; i < cpus; i++) node.cpus.push_back(i);
+        topo.m_nodes.push_back(node);
+    }
+    return topo;
+}
+
+bool NumaTopology::PinCurrentThread(size_t index) const {
+    if (!m_detected || index >= m_nodes.size()) return false;
+    const NumaNode& node = m_nodes[index];
+
+#ifdef _WIN32
+    GROUP_AFFINITY affinity;
+    memset(&affinity, 0, sizeof(affinity));
+    affinity.Group = node.group;
+    affinity.Mask = (KAFFINITY)node.mask;
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : node.cpus) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
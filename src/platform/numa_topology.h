@@ -0,0 +1,38 @@
+// TRNG - NUMA Topology Header
+// Node detection and thread pinning for the headless generator (trng_gen).
+// Linux reads /sys/devices/system/node, Windows uses the NUMA processor masks;
+// no libnuma dependency. Memory placement relies on first touch: a buffer
+// written first by a thread pinned to a node is backed by that node's memory.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct NumaNode {
+    int id = 0;                 // OS node number
+    std::vector<int> cpus;      // Logical CPUs usable by this process (within `group` on Windows)
+    uint16_t group = 0;         // Windows processor group
+    uint64_t mask = 0;          // Windows affinity mask within the group
+};
+
+class NumaTopology {
+public:
+    // Nodes that have CPUs this process may run on. Always at least one node:
+    // if detection fails the whole machine is reported as node 0 (no pinning).
+    static NumaTopology Detect();
+
+    size_t NodeCount() const { return m_nodes.size(); }
+    const NumaNode& Node(size_t index) const { return m_nodes[index]; }
+
+    // True when there is more than one node worth placing work on
+    bool IsNuma() const { return m_nodes.size() > 1; }
+
+    // Restrict the calling thread to the node's CPUs. False if unsupported or refused.
+    bool PinCurrentThread(size_t index) const;
+
+private:
+    std::vector<NumaNode> m_nodes;
+    bool m_detected = false;    // False = fallback single node, pinning is a no-op
+};
@@ -0,0 +1,270 @@
+// TRNG - Bulk Stream Output Implementation
+// vmsplice / write(2) / stdio backends for the headless generator
+
+#include "stream_output.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux__)
+#define TRNG_HAS_VMSPLICE 1
+#endif
+
+// Pipe size we ask for before splicing when pipe-max-size can't be read
+static constexpr int DEFAULT_PIPE_SIZE = 1024 * 1024;
+
+//=============================================================================
+// PAGE-ALIGNED BUFFERS
+//=============================================================================
+
+size_t StreamPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+#endif
+}
+
+uint8_t* AllocPageAligned(size_t bytes) {
+    size_t page = StreamPageSize();
+    size_t rounded = (bytes + page - 1) / page * page;
+#ifdef _WIN32
+    return (uint8_t*)_aligned_malloc(rounded, page);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, page, rounded) != 0) return nullptr;
+    return (uint8_t*)ptr;
+#endif
+}
+
+void FreePageAligned(uint8_t* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+//=============================================================================
+// STREAM OUTPUT
+//=============================================================================
+
+const char* StreamOutputModeName(StreamOutputMode mode) {
+    switch (mode) {
+        case StreamOutputMode::Auto:     return "auto";
+        case StreamOutputMode::Stdio:    return "stdio";
+        case StreamOutputMode::Write:    return "write";
+        case StreamOutputMode::Vmsplice: return "vmsplice";
+    }
+    return "unknown";
+}
+
+StreamOutput::~StreamOutput() {
+    Close();
+}
+
+// "fd:N" names an inherited descriptor (e.g. bash `3> >(RNG_test stdin)`); -1 otherwise
+static int ParseFdTarget(const std::string& path) {
+    if (path.compare(0, 3, "fd:") != 0 || path.size() == 3) return -1;
+    char* end = nullptr;
+    long fd = strtol(path.c_str() + 3, &end, 10);
+    return (*end == '\0' && fd >= 0 && fd <= 65535) ? (int)fd : -1;
+}
+
+bool StreamOutput::Open(const std::string& path, StreamOutputMode mode, size_t stdioBuffer, std::string& error) {
+    const bool toStdout = path.empty() || path == "-";
+    const int inheritedFd = ParseFdTarget(path);
+
+#ifdef _WIN32
+    // No vmsplice, and the CRT write path is no faster than a large stdio buffer
+    (void)mode;
+    mode = StreamOutputMode::Stdio;
+#else
+    if (mode != StreamOutputMode::Stdio) {
+        if (toStdout) m_fd = STDOUT_FILENO;
+        else if (inheritedFd >= 0) m_fd = fcntl(inheritedFd, F_GETFD) != -1 ? inheritedFd : -1;
+        else m_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0) {
+            error = "Cannot open output file: " + path + " (" + strerror(errno) + ")";
+            return false;
+        }
+        m_owned = !toStdout;
+
+        struct stat st;
+        bool haveStat = fstat(m_fd, &st) == 0;
+        bool isPipe = haveStat && S_ISFIFO(st.st_mode);
+        m_regular = haveStat && S_ISREG(st.st_mode);
+        if (mode == StreamOutputMode::Auto) {
+            mode = isPipe ? StreamOutputMode::Vmsplice : StreamOutputMode::Write;
+        }
+#ifdef TRNG_HAS_VMSPLICE
+        if (mode == StreamOutputMode::Vmsplice && isPipe) {
+            // Grow the pipe to the unprivileged maximum: fewer wakeups, and the
+            // reader can't enlarge it further mid-run, which would let spliced
+            // pages outlive the retention window. Failure is harmless.
+            int maxSize = DEFAULT_PIPE_SIZE;
+            if (FILE* f = fopen("/proc/sys/fs/pipe-max-size", "r")) {
+                if (fscanf(f, "%d", &maxSize) != 1 || maxSize <= 0) maxSize = DEFAULT_PIPE_SIZE;
+                fclose(f);
+            }
+            fcntl(m_fd, F_SETPIPE_SZ, maxSize);
+            int size = fcntl(m_fd, F_GETPIPE_SZ);
+            if (size > 0) m_pipeSize = (size_t)size;
+            else mode = StreamOutputMode::Write;
+        } else if (mode == StreamOutputMode::Vmsplice) {
+            mode = StreamOutputMode::Write; // Not a pipe
+        }
+#else
+        if (mode == StreamOutputMode::Vmsplice) mode = StreamOutputMode::Write;
+#endif
+        m_mode = mode;
+        return true;
+    }
+#endif
+
+    // Stdio backend
+    if (toStdout) m_file = stdout;
+#ifdef _WIN32
+    else if (inheritedFd >= 0) m_file = _fdopen(inheritedFd, "wb");
+#else
+    else if (inheritedFd >= 0) m_file = fdopen(inheritedFd, "wb");
+#endif
+    else m_file = fopen(path.c_str(), "wb");
+    if (!m_file) {
+        error = "Cannot open output file: " + path;
+        return false;
+    }
+    m_owned = !toStdout;
+#ifdef _WIN32
+    if (toStdout || inheritedFd >= 0) _setmode(_fileno(m_file), _O_BINARY); // Critical on Windows
+#endif
+    if (stdioBuffer > 0) {
+        m_stdioBuffer = new char[stdioBuffer];
+        setvbuf(m_file, m_stdioBuffer, _IOFBF, stdioBuffer);
+    } else {
+        setvbuf(m_file, nullptr, _IONBF, 0);
+    }
+    m_mode = StreamOutputMode::Stdio;
+    return true;
+}
+
+bool StreamOutput::Write(const uint8_t* data, size_t len) {
+    switch (m_mode) {
+        case StreamOutputMode::Vmsplice: return SpliceFd(data, len);
+        case StreamOutputMode::Write:    return WriteFd(data, len);
+        default:                         return WriteCopy(data, len);
+    }
+}
+
+bool StreamOutput::WriteCopy(const uint8_t* data, size_t len) {
+    if (m_file) {
+        size_t written = fwrite(data, 1, len, m_file);
+        return written == len && !ferror(m_file);
+    }
+    return WriteFd(data, len);
+}
+
+bool StreamOutput::WriteFd(const uint8_t* data, size_t len) {
+#ifdef _WIN32
+    (void)data;
+    (void)len;
+    return false;
+#else
+    while (len > 0) {
+        ssize_t n = write(m_fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+#endif
+}
+
+bool StreamOutput::WriteAt(const uint8_t* data, size_t len, uint64_t offset) {
+#ifdef _WIN32
+    (void)data;
+    (void)len;
+    (void)offset;
+    return false;
+#else
+    if (!CanWriteAt()) return false;
+    while (len > 0) {
+        ssize_t n = pwrite(m_fd, data, len, (off_t)offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+#endif
+}
+
+bool StreamOutput::SpliceFd(const uint8_t* data, size_t len) {
+#ifdef TRNG_HAS_VMSPLICE
+    while (len > 0) {
+        struct iovec iov;
+        iov.iov_base = (void*)data;
+        iov.iov_len = len;
+        ssize_t n = vmsplice(m_fd, &iov, 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (!m_spliced && (errno == EINVAL || errno == ENOSYS)) {
+                // Kernel or descriptor refuses vmsplice: copy for the rest of the run
+                m_mode = StreamOutputMode::Write;
+                return WriteFd(data, len);
+            }
+            return false;
+        }
+        m_spliced = true;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+#else
+    return WriteFd(data, len);
+#endif
+}
+
+bool StreamOutput::Close() {
+    bool ok = true;
+    if (m_file) {
+        if (fflush(m_file) != 0) ok = false;
+        if (m_owned) {
+            if (fclose(m_file) != 0) ok = false;
+            delete[] m_stdioBuffer;
+        }
+        // stdout keeps its buffer: stdio may still touch it during exit
+        m_stdioBuffer = nullptr;
+        m_file = nullptr;
+    }
+#ifndef _WIN32
+    if (m_fd >= 0) {
+        if (m_owned && close(m_fd) != 0) ok = false;
+        m_fd = -1;
+    }
+#endif
+    m_owned = false;
+    m_regular = false;
+    return ok;
+}
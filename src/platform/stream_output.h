@@ -0,0 +1,77 @@
+// TRNG - Bulk Stream Output Header
+// Output backends for the headless generator (trng_gen): vmsplice into pipes,
+// direct write(2) for files and other descriptors, stdio everywhere else.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+//=============================================================================
+// PAGE-ALIGNED BUFFERS
+//=============================================================================
+// vmsplice hands whole pages to the pipe; aligned buffers avoid splitting a
+// page between two chunks and keep direct writes on page boundaries.
+size_t StreamPageSize();
+uint8_t* AllocPageAligned(size_t bytes);
+void FreePageAligned(uint8_t* ptr);
+
+//=============================================================================
+// STREAM OUTPUT
+//=============================================================================
+enum class StreamOutputMode {
+    Auto,     // vmsplice for pipes, write(2) for everything else, stdio on Windows
+    Stdio,    // fwrite through a user-sized stdio buffer
+    Write,    // write(2) straight from the caller's buffer (no stdio copy)
+    Vmsplice  // map the caller's pages into the pipe (no user-space copy at all)
+};
+
+const char* StreamOutputModeName(StreamOutputMode mode);
+
+class StreamOutput {
+public:
+    StreamOutput() = default;
+    ~StreamOutput();
+    StreamOutput(const StreamOutput&) = delete;
+    StreamOutput& operator=(const StreamOutput&) = delete;
+
+    // path empty or "-" = stdout, "fd:N" = inherited descriptor N (closed by Close).
+    // Unavailable modes fall back (vmsplice -> write -> stdio).
+    bool Open(const std::string& path, StreamOutputMode mode, size_t stdioBuffer, std::string& error);
+
+    // Zero-copy where possible. With vmsplice the pipe keeps referencing the
+    // caller's pages: the buffer must not be modified (or wiped) until at least
+    // RetainedBytes() further bytes have been written after it.
+    bool Write(const uint8_t* data, size_t len);
+
+    // Always copies; the buffer may be reused as soon as this returns
+    bool WriteCopy(const uint8_t* data, size_t len);
+
+    // Positional write (pwrite) for regular files in write(2) mode. Safe to call
+    // from several threads at once, so chunks can be written out of order.
+    bool CanWriteAt() const { return m_mode == StreamOutputMode::Write && m_regular; }
+    bool WriteAt(const uint8_t* data, size_t len, uint64_t offset);
+
+    // Flush and close (stdout is flushed but left open)
+    bool Close();
+
+    // Bytes that must follow a zero-copy write before its buffer is free again
+    size_t RetainedBytes() const { return m_mode == StreamOutputMode::Vmsplice ? m_pipeSize : 0; }
+
+    StreamOutputMode GetMode() const { return m_mode; }
+
+private:
+    bool WriteFd(const uint8_t* data, size_t len);
+    bool SpliceFd(const uint8_t* data, size_t len);
+
+    StreamOutputMode m_mode = StreamOutputMode::Stdio;
+    FILE* m_file = nullptr;
+    int m_fd = -1;
+    bool m_owned = false;
+    bool m_spliced = false;     // At least one vmsplice succeeded
+    bool m_regular = false;     // Regular file: supports WriteAt
+    size_t m_pipeSize = 0;
+    char* m_stdioBuffer = nullptr;
+};
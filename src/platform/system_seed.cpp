@@ -0,0 +1,132 @@
+// TRNG - System Seed Collection Implementation
+
+#ifdef _WIN32
+#include <windows.h>
+#include <bcrypt.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+#endif
+
+#include "system_seed.h"
+#include "cycles.h"
+#include "../crypto/secure_mem.h"
+#include "../entropy/cpu_hwrng/drng.h"
+#include <chrono>
+#include <functional>
+#include <thread>
+
+static void Append(std::vector<uint8_t>& seed, const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed.insert(seed.end(), p, p + len);
+}
+
+bool ReadOsEntropy(uint8_t* out, size_t len) {
+#ifdef _WIN32
+    return BCryptGenRandom(nullptr, out, (ULONG)len, BCRYPT_USE_SYSTEM_PREFERRED_RNG) == 0;
+#else
+#if defined(__linux__)
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = getrandom(out + got, len - got, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;  // ENOSYS on old kernels: fall back to /dev/urandom
+        }
+        got += (size_t)n;
+    }
+    if (got == len) return true;
+#endif
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = read(fd, out + done, len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    close(fd);
+    return done == len;
+#endif
+}
+
+std::vector<uint8_t> CollectSystemSeed(uint32_t* sources) {
+    std::vector<uint8_t> seed;
+    seed.reserve(320);
+    uint32_t used = SEED_SOURCE_TIMING;
+
+    // Source 1: Multiple cycle-counter samples with variable-time gaps
+    for (int i = 0; i < 16; i++) {
+        uint64_t tsc = ReadCycleCounter();
+        Append(seed, &tsc, 8);
+        // Variable work to create timing jitter
+        volatile uint64_t x = 0;
+        for (int j = 0; j < (i + 1) * 137; j++) x += j * tsc;
+    }
+
+    // Source 2: Performance counter (QPC / CLOCK_MONOTONIC_RAW)
+#ifdef _WIN32
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+    uint64_t perf = (uint64_t)qpc.QuadPart;
+#else
+    struct timespec mono;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &mono);
+    uint64_t perf = (uint64_t)mono.tv_sec * 1000000000ULL + (uint64_t)mono.tv_nsec;
+#endif
+    Append(seed, &perf, 8);
+
+    // Source 3: High-resolution clock
+    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    Append(seed, &ns, 8);
+
+    // Source 4: Uptime (GetTickCount64 / CLOCK_BOOTTIME)
+#ifdef _WIN32
+    uint64_t tick = GetTickCount64();
+#else
+    struct timespec boot;
+    clock_gettime(CLOCK_BOOTTIME, &boot);
+    uint64_t tick = (uint64_t)boot.tv_sec * 1000000000ULL + (uint64_t)boot.tv_nsec;
+#endif
+    Append(seed, &tick, 8);
+
+    // Source 5: Process/Thread IDs
+#ifdef _WIN32
+    uint32_t pid = GetCurrentProcessId();
+    uint32_t tid = GetCurrentThreadId();
+#else
+    uint32_t pid = (uint32_t)getpid();
+    uint32_t tid = (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+    Append(seed, &pid, 4);
+    Append(seed, &tid, 4);
+
+    // Source 6: CPU DRNG (RDSEED, RDRAND fallback) - 512 bits when present
+    Entropy::Drng::Support drng = Entropy::Drng::Detect();
+    if (drng.rdseed || drng.rdrand) {
+        uint64_t words[SYSTEM_SEED_SOURCE_BYTES / 8];
+        size_t got = drng.rdseed ? Entropy::Drng::ReadSeedBatch(words, SYSTEM_SEED_SOURCE_BYTES / 8)
+                                 : Entropy::Drng::ReadRandBatch(words, SYSTEM_SEED_SOURCE_BYTES / 8);
+        Append(seed, words, got * 8);
+        if (got > 0) used |= SEED_SOURCE_DRNG;
+        Crypto::SecureZero(words, sizeof(words));
+    }
+
+    // Source 7: Operating system CSPRNG - 512 bits
+    uint8_t os[SYSTEM_SEED_SOURCE_BYTES];
+    if (ReadOsEntropy(os, sizeof(os))) {
+        Append(seed, os, sizeof(os));
+        used |= SEED_SOURCE_OS;
+    }
+    Crypto::SecureZero(os, sizeof(os));
+
+    if (sources) *sources = used;
+    return seed;
+}
@@ -0,0 +1,27 @@
+// TRNG - System Seed Collection
+// Seed material for the headless consumers (trng_gen, libtrng) that have no
+// entropy pool: OS CSPRNG, CPU DRNG and timing/identity samples, concatenated.
+// The caller feeds the result through the Quad-Layer pipeline, which hashes it.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Which sources contributed to a seed (bit flags)
+enum SystemSeedSource : uint32_t {
+    SEED_SOURCE_TIMING = 1u << 0,   // Cycle counter jitter, clocks, process/thread ids
+    SEED_SOURCE_OS     = 1u << 1,   // getrandom(2) / BCryptGenRandom
+    SEED_SOURCE_DRNG   = 1u << 2    // RDSEED (RDRAND fallback)
+};
+
+// Bytes requested from the OS CSPRNG and the DRNG (each)
+constexpr size_t SYSTEM_SEED_SOURCE_BYTES = 64;
+
+// Collect a fresh seed. `sources` (optional) receives the SystemSeedSource bits that
+// succeeded; timing samples are always present.
+std::vector<uint8_t> CollectSystemSeed(uint32_t* sources = nullptr);
+
+// Fill `out` from the operating system CSPRNG. False if unavailable.
+bool ReadOsEntropy(uint8_t* out, size_t len);
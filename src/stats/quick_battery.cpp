@@ -0,0 +1,445 @@
+#include "quick_battery.h"
+#include "stats_math.h"
+#include "../crypto/secure_mem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_QUICK_SSE2 1
+#endif
+
+// AVX2 kernel compiled alongside the baseline and picked at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRNG_QUICK_AVX2 1
+#define TRNG_QUICK_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Stats {
+
+// The vector kernels below spell the lags out one by one
+static_assert(QuickBattery::LAGS[0] == 1 && QuickBattery::LAGS[1] == 2 && QuickBattery::LAGS[2] == 3 &&
+              QuickBattery::LAGS[3] == 4 && QuickBattery::LAGS[4] == 8 && QuickBattery::LAGS[5] == 16 &&
+              QuickBattery::LAGS[6] == 64 && QuickBattery::LAGS[7] == 256, "lag kernels out of date");
+
+static constexpr int LAG_COUNT = QuickBattery::LAG_COUNT;
+
+// Largest lag in whole words (256 bits); the vector loops read this far ahead
+static constexpr size_t MAX_WORD_LAG = 4;
+
+// Per-byte counters grow by at most 8 per vector step: fold them into 64-bit
+// totals every 31 steps, before they can wrap
+static constexpr int BYTE_ACC_STEPS = 31;
+
+// NIST SP 800-22 longest-run parameters for M = 10000 (1250 bytes per block)
+static constexpr size_t LONGEST_RUN_BLOCK_BYTES = 1250;
+static constexpr size_t LONGEST_RUN_BLOCK_WORDS = LONGEST_RUN_BLOCK_BYTES / 8;   // + 2 bytes
+static constexpr int LONGEST_RUN_CLASSES = 7;            // <= 10, 11, ..., 15, >= 16
+static const double LONGEST_RUN_PI[LONGEST_RUN_CLASSES] = {
+    0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727
+};
+
+// Pass 1 totals: ones, then differing bit pairs per lag
+struct BitCounts {
+    uint64_t ones = 0;
+    uint64_t diff[LAG_COUNT] = {};
+};
+
+static inline uint64_t LoadWord(const uint8_t* p) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+    return w;
+}
+
+static inline uint64_t Popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return (uint64_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+// Words [start, W): the vector loops' remainder, or everything without SIMD
+static void CountBitsScalar(const uint8_t* data, size_t W, size_t start, BitCounts& counts) {
+    for (size_t i = start; i < W; i++) {
+        uint64_t w = LoadWord(data + i * 8);
+        counts.ones += Popcount64(w);
+        for (int l = 0; l < LAG_COUNT; l++) {
+            const unsigned d = QuickBattery::LAGS[l];
+            if (d < 64) {
+                if (i + 1 < W) {
+                    uint64_t next = LoadWord(data + (i + 1) * 8);
+                    counts.diff[l] += Popcount64(w ^ ((w >> d) | (next << (64 - d))));
+                } else {
+                    // Last word: only the 64 - d pairs that stay inside the window
+                    counts.diff[l] += Popcount64((w ^ (w >> d)) & (~0ULL >> d));
+                }
+            } else if (i + d / 64 < W) {
+                counts.diff[l] += Popcount64(w ^ LoadWord(data + (i + d / 64) * 8));
+            }
+        }
+    }
+}
+
+#ifdef TRNG_QUICK_SSE2
+// Per-byte popcounts of v (each 0..8)
+static inline __m128i PopcountBytes(__m128i v) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+    v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+    return _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+}
+
+// a XOR (stream shifted by D bits), where b holds the words after a's
+template <int D>
+static inline __m128i LagXor(__m128i a, __m128i b) {
+    return _mm_xor_si128(a, _mm_or_si128(_mm_srli_epi64(a, D), _mm_slli_epi64(b, 64 - D)));
+}
+
+// Two words per step. Returns the first word not processed.
+static size_t CountBitsSse2(const uint8_t* data, size_t W, BitCounts& counts) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total[1 + LAG_COUNT];
+    for (__m128i& t : total) t = zero;
+
+    size_t i = 0;
+    while (i + 2 + MAX_WORD_LAG <= W) {
+        __m128i acc[1 + LAG_COUNT];
+        for (__m128i& a : acc) a = zero;
+        for (int step = 0; step < BYTE_ACC_STEPS && i + 2 + MAX_WORD_LAG <= W; step++, i += 2) {
+            const uint8_t* p = data + i * 8;
+            __m128i a = _mm_loadu_si128((const __m128i*)p);          // Words i, i+1
+            __m128i b = _mm_loadu_si128((const __m128i*)(p + 8));    // Words i+1, i+2
+            __m128i c = _mm_loadu_si128((const __m128i*)(p + 32));   // Words i+4, i+5
+            acc[0] = _mm_add_epi8(acc[0], PopcountBytes(a));
+            acc[1] = _mm_add_epi8(acc[1], PopcountBytes(LagXor<1>(a, b)));
+            acc[2] = _mm_add_epi8(acc[2], PopcountBytes(LagXor<2>(a, b)));
+            acc[3] = _mm_add_epi8(acc[3], PopcountBytes(LagXor<3>(a, b)));
+            acc[4] = _mm_add_epi8(acc[4], PopcountBytes(LagXor<4>(a, b)));
+            acc[5] = _mm_add_epi8(acc[5], PopcountBytes(LagXor<8>(a, b)));
+            acc[6] = _mm_add_epi8(acc[6], PopcountBytes(LagXor<16>(a, b)));
+            acc[7] = _mm_add_epi8(acc[7], PopcountBytes(_mm_xor_si128(a, b)));
+            acc[8] = _mm_add_epi8(acc[8], PopcountBytes(_mm_xor_si128(a, c)));
+        }
+        for (int k = 0; k <= LAG_COUNT; k++) total[k] = _mm_add_epi64(total[k], _mm_sad_epu8(acc[k], zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, total[0]);
+    counts.ones += lanes[0] + lanes[1];
+    for (int l = 0; l < LAG_COUNT; l++) {
+        _mm_storeu_si128((__m128i*)lanes, total[1 + l]);
+        counts.diff[l] += lanes[0] + lanes[1];
+    }
+    return i;
+}
+#endif
+
+#ifdef TRNG_QUICK_AVX2
+// Nibble-table popcount per byte (each 0..8)
+TRNG_QUICK_TARGET("avx2")
+static inline __m256i PopcountBytesAvx2(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, low);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(table, lo), _mm256_shuffle_epi8(table, hi));
+}
+
+template <int D>
+TRNG_QUICK_TARGET("avx2")
+static inline __m256i LagXorAvx2(__m256i a, __m256i b) {
+    return _mm256_xor_si256(a, _mm256_or_si256(_mm256_srli_epi64(a, D), _mm256_slli_epi64(b, 64 - D)));
+}
+
+// Four words per step. Returns the first word not processed.
+TRNG_QUICK_TARGET("avx2")
+static size_t CountBitsAvx2(const uint8_t* data, size_t W, BitCounts& counts) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total[1 + LAG_COUNT];
+    for (__m256i& t : total) t = zero;
+
+    size_t i = 0;
+    while (i + 4 + MAX_WORD_LAG <= W) {
+        __m256i acc[1 + LAG_COUNT];
+        for (__m256i& a : acc) a = zero;
+        for (int step = 0; step < BYTE_ACC_STEPS && i + 4 + MAX_WORD_LAG <= W; step++, i += 4) {
+            const uint8_t* p = data + i * 8;
+            __m256i a = _mm256_loadu_si256((const __m256i*)p);           // Words i .. i+3
+            __m256i b = _mm256_loadu_si256((const __m256i*)(p + 8));     // Words i+1 .. i+4
+            __m256i c = _mm256_loadu_si256((const __m256i*)(p + 32));    // Words i+4 .. i+7
+            acc[0] = _mm256_add_epi8(acc[0], PopcountBytesAvx2(a));
+            acc[1] = _mm256_add_epi8(acc[1], PopcountBytesAvx2(LagXorAvx2<1>(a, b)));
+            acc[2] = _mm256_add_epi8(acc[2], PopcountBytesAvx2(LagXorAvx2<2>(a, b)));
+            acc[3] = _mm256_add_epi8(acc[3], PopcountBytesAvx2(LagXorAvx2<3>(a, b)));
+            acc[4] = _mm256_add_epi8(acc[4], PopcountBytesAvx2(LagXorAvx2<4>(a, b)));
+            acc[5] = _mm256_add_epi8(acc[5], PopcountBytesAvx2(LagXorAvx2<8>(a, b)));
+            acc[6] = _mm256_add_epi8(acc[6], PopcountBytesAvx2(LagXorAvx2<16>(a, b)));
+            acc[7] = _mm256_add_epi8(acc[7], PopcountBytesAvx2(_mm256_xor_si256(a, b)));
+            acc[8] = _mm256_add_epi8(acc[8], PopcountBytesAvx2(_mm256_xor_si256(a, c)));
+        }
+        for (int k = 0; k <= LAG_COUNT; k++) total[k] = _mm256_add_epi64(total[k], _mm256_sad_epu8(acc[k], zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, total[0]);
+    counts.ones += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (int l = 0; l < LAG_COUNT; l++) {
+        _mm256_storeu_si256((__m256i*)lanes, total[1 + l]);
+        counts.diff[l] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return i;
+}
+
+static bool HasAvx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+static void CountBits(const uint8_t* data, size_t W, BitCounts& counts) {
+    size_t done = 0;
+#if defined(TRNG_QUICK_AVX2)
+    if (HasAvx2()) {
+        done = CountBitsAvx2(data, W, counts);
+    } else {
+        done = CountBitsSse2(data, W, counts);
+    }
+#elif defined(TRNG_QUICK_SSE2)
+    done = CountBitsSse2(data, W, counts);
+#endif
+    CountBitsScalar(data, W, done, counts);
+}
+
+// Bits `lo` followed by `hi` (a 128-bit window; only hi's low 16 bits matter)
+struct BitPair {
+    uint64_t lo;
+    uint64_t hi;
+};
+
+// Bits s.. of the pair (1 <= s <= 63)
+static inline uint64_t Funnel(const BitPair& x, int s) {
+    return (x.lo >> s) | (x.hi << (64 - s));
+}
+
+// Positions starting a run of >= 2k ones, given those starting a run of >= k
+static inline BitPair Double(const BitPair& x, int k) {
+    return {x.lo & Funnel(x, k), x.hi & (x.hi >> k)};
+}
+
+// Longest-run class of one block: 0 for runs <= 10, 1..5 for 11..15, 6 for >= 16.
+// Only words where a run of 11+ ones starts (about one in sixty) take the slow path.
+static int LongestRunClass(const uint8_t* block) {
+    int cls = 0;
+    uint64_t w = LoadWord(block);
+    for (size_t j = 0; j <= LONGEST_RUN_BLOCK_WORDS; j++) {
+        uint64_t next = 0;
+        if (j + 1 < LONGEST_RUN_BLOCK_WORDS) {
+            next = LoadWord(block + (j + 1) * 8);
+        } else if (j + 1 == LONGEST_RUN_BLOCK_WORDS) {
+            uint16_t tail;
+            memcpy(&tail, block + LONGEST_RUN_BLOCK_WORDS * 8, 2);   // 1250 = 156 * 8 + 2
+            next = tail;
+        }
+
+        BitPair r1 = {w, next};
+        BitPair r2 = Double(r1, 1);
+        BitPair r4 = Double(r2, 2);
+        BitPair r8 = Double(r4, 4);
+        // Overlapping windows: run >= 8 at j and >= 4 at j + 7 means >= 11 at j
+        uint64_t r11 = r8.lo & Funnel(r4, 7);
+        if (r11 != 0) {
+            int level = 1;
+            if (r8.lo & Funnel(r8, 8)) level = 6;
+            else if (r8.lo & Funnel(r8, 7)) level = 5;
+            else if (r8.lo & Funnel(r8, 6)) level = 4;
+            else if (r8.lo & Funnel(r8, 5)) level = 3;
+            else if (r8.lo & Funnel(r4, 8)) level = 2;
+            cls = std::max(cls, level);
+        }
+        w = next;
+    }
+    return cls;
+}
+
+QuickBattery::QuickBattery(size_t windowBytes, double alpha)
+    : m_windowBytes(std::max(MIN_WINDOW, windowBytes & ~(size_t)7)),
+      m_alpha(alpha) {
+    for (double& p : m_minP) p = 1.0;
+}
+
+QuickBattery::~QuickBattery() {
+    Crypto::SecureClearVector(m_window);
+}
+
+const char* QuickBattery::ResultName(int result) {
+    static const char* const NAMES[RESULT_COUNT] = {
+        "monobit", "runs", "byte chi-square", "serial 2-gram", "longest run",
+        "autocorr lag 1", "autocorr lag 2", "autocorr lag 3", "autocorr lag 4",
+        "autocorr lag 8", "autocorr lag 16", "autocorr lag 64", "autocorr lag 256"
+    };
+    return (result >= 0 && result < RESULT_COUNT) ? NAMES[result] : "unknown";
+}
+
+int QuickBattery::Feed(const uint8_t* data, size_t len) {
+    int alarms = 0;
+    while (len > 0) {
+        // Whole windows straight from the caller's buffer, no copy
+        if (m_fill == 0 && len >= m_windowBytes) {
+            alarms += Evaluate(data, m_windowBytes);
+            data += m_windowBytes;
+            len -= m_windowBytes;
+            continue;
+        }
+        if (m_window.size() != m_windowBytes) m_window.resize(m_windowBytes);
+        size_t take = std::min(len, m_windowBytes - m_fill);
+        memcpy(m_window.data() + m_fill, data, take);
+        m_fill += take;
+        data += take;
+        len -= take;
+        if (m_fill == m_windowBytes) {
+            alarms += Evaluate(m_window.data(), m_windowBytes);
+            Crypto::SecureZero(m_window.data(), m_windowBytes);
+            m_fill = 0;
+        }
+    }
+    return alarms;
+}
+
+int QuickBattery::Evaluate(const uint8_t* data, size_t len) {
+    double p[RESULT_COUNT];
+    TestWindow(data, len, p);
+
+    int alarms = 0;
+    for (int r = 0; r < RESULT_COUNT; r++) {
+        m_minP[r] = std::min(m_minP[r], p[r]);
+        if (p[r] < m_alpha) {
+            alarms++;
+            m_lastAlarm.window = m_windows;
+            m_lastAlarm.result = r;
+            m_lastAlarm.pValue = p[r];
+        }
+    }
+    m_alarms += alarms;
+    m_windows++;
+    return alarms;
+}
+
+void QuickBattery::TestWindow(const uint8_t* data, size_t len, double pValues[RESULT_COUNT]) {
+    const size_t W = len / 8;
+    const double n = (double)W * 64.0;
+
+    //-------------------------------------------------------------------------
+    // Pass 1: ones and lagged XOR popcounts (runs = lag-1 transitions)
+    //-------------------------------------------------------------------------
+    BitCounts counts;
+    CountBits(data, W, counts);
+    const uint64_t ones = counts.ones;
+    const uint64_t* diff = counts.diff;
+
+    //-------------------------------------------------------------------------
+    // Pass 2: nibble trigrams (low, high nibble of byte k, low nibble of byte k+1)
+    //-------------------------------------------------------------------------
+    // One 12-bit index per byte (circular) yields both the byte histogram and the
+    // cross-byte nibble pairs. Two tables alternate to keep increments independent.
+    uint32_t trigrams[2][4096] = {};
+    for (size_t i = 0; i < W; i++) {
+        uint64_t w = LoadWord(data + i * 8);
+        uint64_t next = LoadWord(data + (i + 1 < W ? i + 1 : 0) * 8);
+        trigrams[0][w & 0xFFF]++;
+        trigrams[1][(w >> 8) & 0xFFF]++;
+        trigrams[0][(w >> 16) & 0xFFF]++;
+        trigrams[1][(w >> 24) & 0xFFF]++;
+        trigrams[0][(w >> 32) & 0xFFF]++;
+        trigrams[1][(w >> 40) & 0xFFF]++;
+        trigrams[0][(w >> 48) & 0xFFF]++;
+        trigrams[1][(w >> 56) | ((next & 0xF) << 8)]++;
+    }
+    uint32_t bytes[256] = {};
+    uint32_t cross[256] = {};   // (high nibble of byte k, low nibble of byte k+1)
+    for (int t = 0; t < 4096; t++) {
+        const uint32_t count = trigrams[0][t] + trigrams[1][t];
+        bytes[t & 0xFF] += count;
+        cross[t >> 4] += count;
+    }
+
+    //-------------------------------------------------------------------------
+    // Pass 3: longest run of ones per 10000-bit block
+    //-------------------------------------------------------------------------
+    const size_t blocks = (W * 8) / LONGEST_RUN_BLOCK_BYTES;
+    uint32_t runClass[LONGEST_RUN_CLASSES] = {};
+    for (size_t blk = 0; blk < blocks; blk++) {
+        runClass[LongestRunClass(data + blk * LONGEST_RUN_BLOCK_BYTES)]++;
+    }
+
+    //-------------------------------------------------------------------------
+    // P-values
+    //-------------------------------------------------------------------------
+    // Monobit
+    const double s = 2.0 * (double)ones - n;
+    pValues[RESULT_MONOBIT] = std::erfc(std::fabs(s) / std::sqrt(2.0 * n));
+
+    // Runs, given the observed frequency. NIST fails it outright when
+    // |pi - 1/2| >= 2/sqrt(n), but that is a 4-sigma event (p ~ 6e-5 per
+    // window) and would swamp alpha; the bias itself is monobit's to report.
+    const double pi = (double)ones / n;
+    if (ones == 0 || ones == (uint64_t)n) {
+        pValues[RESULT_RUNS] = 0.0;
+    } else {
+        const double runs = (double)diff[0] + 1.0;
+        pValues[RESULT_RUNS] = std::erfc(std::fabs(runs - 2.0 * n * pi * (1.0 - pi)) /
+                                         (2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi)));
+    }
+
+    // Byte chi-square and overlapping nibble serial test (psi^2_2 - psi^2_1)
+    const double byteCount = (double)W * 8.0;
+    const double expected = byteCount / 256.0;
+    double chi2 = 0.0;
+    double sumPairs = 0.0;
+    double nibble[16] = {};
+    for (int v = 0; v < 256; v++) {
+        const double b = bytes[v];
+        const double c = cross[v];
+        chi2 += (b - expected) * (b - expected) / expected;
+        sumPairs += (b + c) * (b + c);
+        nibble[v & 15] += b;
+        nibble[v >> 4] += b;
+    }
+    pValues[RESULT_BYTE_CHI2] = StatsMath::ChiSquareP(chi2, 255.0);
+
+    const double nibbles = 2.0 * byteCount;   // Also the number of circular pairs
+    double sumSingles = 0.0;
+    for (double c : nibble) sumSingles += c * c;
+    const double psi2 = 256.0 / nibbles * sumPairs - nibbles;
+    const double psi1 = 16.0 / nibbles * sumSingles - nibbles;
+    pValues[RESULT_SERIAL] = StatsMath::ChiSquareP(std::max(0.0, psi2 - psi1), 240.0);
+
+    // Longest run
+    if (blocks > 0) {
+        double runChi2 = 0.0;
+        for (int k = 0; k < LONGEST_RUN_CLASSES; k++) {
+            const double e = (double)blocks * LONGEST_RUN_PI[k];
+            runChi2 += (runClass[k] - e) * (runClass[k] - e) / e;
+        }
+        pValues[RESULT_LONGEST_RUN] = StatsMath::ChiSquareP(runChi2, LONGEST_RUN_CLASSES - 1);
+    } else {
+        pValues[RESULT_LONGEST_RUN] = 1.0;
+    }
+
+    // Autocorrelation: differing pairs ~ Binomial(n - d, 1/2)
+    for (int l = 0; l < LAG_COUNT; l++) {
+        const double pairs = n - (double)LAGS[l];
+        const double z = (2.0 * (double)diff[l] - pairs) / std::sqrt(pairs);
+        pValues[RESULT_AUTOCORR_FIRST + l] = StatsMath::NormalP(z);
+    }
+}
+
+} // namespace Stats
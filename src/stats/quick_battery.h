@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Stats {
+
+// Always-on output sanity checks: a battery of cheap statistical tests run in
+// streaming fashion over generator output (CSPRNG::GenerateRandomBytes, every
+// trng_gen chunk with --check). Data is cut into fixed windows; each full window
+// is tested in three passes (SSE2/AVX2 popcounts, byte histograms, run masks)
+// and every p-value below `alpha` raises an alarm.
+//
+// Bit order is LSB-first within each byte (little-endian 64-bit words).
+// Windows hold copies of output and are wiped after testing.
+class QuickBattery {
+public:
+    // Results per window, in this order
+    enum Result {
+        RESULT_MONOBIT,         // Frequency of ones
+        RESULT_RUNS,            // NIST runs test
+        RESULT_BYTE_CHI2,       // Byte histogram, 255 df
+        RESULT_SERIAL,          // Overlapping nibble 2-grams (circular), 240 df
+        RESULT_LONGEST_RUN,     // Longest run of ones per 10000-bit block (NIST)
+        RESULT_AUTOCORR_FIRST,  // Bit autocorrelation, one result per lag
+        RESULT_COUNT = RESULT_AUTOCORR_FIRST + 8
+    };
+    static constexpr int LAG_COUNT = RESULT_COUNT - RESULT_AUTOCORR_FIRST;
+    static constexpr unsigned LAGS[LAG_COUNT] = {1, 2, 3, 4, 8, 16, 64, 256};  // In bits
+
+    static constexpr size_t DEFAULT_WINDOW = 1 << 20;
+    static constexpr size_t MIN_WINDOW = 128 << 10;   // Longest-run needs >= 750000 bits
+    // 13 p-values per 1 MiB window: about one false alarm per 700 TiB tested, while
+    // a broken generator (stuck bytes, repeated blocks, bias) scores p ~ 0
+    static constexpr double DEFAULT_ALPHA = 1e-10;
+
+    struct Alarm {
+        uint64_t window = 0;    // Index of the failing window (0-based)
+        int result = -1;        // Result enum
+        double pValue = 1.0;
+    };
+
+    explicit QuickBattery(size_t windowBytes = DEFAULT_WINDOW, double alpha = DEFAULT_ALPHA);
+    ~QuickBattery();
+
+    QuickBattery(const QuickBattery&) = delete;
+    QuickBattery& operator=(const QuickBattery&) = delete;
+
+    // Stream output in; complete windows are tested as they fill (tested in place
+    // when the caller's data covers a whole window). Returns alarms raised by this call.
+    int Feed(const uint8_t* data, size_t len);
+
+    // Test one window directly. `len` >= MIN_WINDOW; a tail of < 8 bytes is ignored.
+    static void TestWindow(const uint8_t* data, size_t len, double pValues[RESULT_COUNT]);
+
+    // "monobit", "runs", ..., "autocorr lag 64"
+    static const char* ResultName(int result);
+
+    uint64_t WindowsTested() const { return m_windows; }
+    uint64_t AlarmCount() const { return m_alarms; }
+    const Alarm& LastAlarm() const { return m_lastAlarm; }
+    double MinPValue(int result) const { return m_minP[result]; }
+
+private:
+    int Evaluate(const uint8_t* data, size_t len);
+
+    size_t m_windowBytes;
+    double m_alpha;
+    std::vector<uint8_t> m_window;  // Partial window carried between Feed calls
+    size_t m_fill = 0;
+    uint64_t m_windows = 0;
+    uint64_t m_alarms = 0;
+    Alarm m_lastAlarm;
+    double m_minP[RESULT_COUNT];
+};
+
+} // namespace Stats
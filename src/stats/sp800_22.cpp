@@ -0,0 +1,1086 @@
+#include "sp800_22.h"
+#include "stats_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_STS_SSE2 1
+#endif
+
+// AVX2 kernels are compiled with a target attribute and picked at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRNG_STS_AVX2 1
+#define TRNG_STS_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Stats {
+
+// sts-2.1.2 default parameters
+static constexpr int BLOCK_FREQUENCY_M = 128;
+static constexpr int NON_OVERLAPPING_M = 9;
+static constexpr int NON_OVERLAPPING_BLOCKS = 8;
+static constexpr int NON_OVERLAPPING_TEMPLATES = 148;
+static constexpr int OVERLAPPING_M = 9;
+static constexpr int OVERLAPPING_BLOCK = 1032;
+static constexpr int OVERLAPPING_K = 5;
+static constexpr int APEN_M = 10;
+static constexpr int SERIAL_M = 16;
+static constexpr int LINEAR_COMPLEXITY_M = 500;
+static constexpr int LINEAR_COMPLEXITY_K = 6;
+static constexpr int RANK_ROWS = 32;
+static constexpr int RANK_BITS = RANK_ROWS * RANK_ROWS;
+
+static constexpr double PI = 3.14159265358979323846;
+
+static constexpr int LC_WORDS = (LINEAR_COMPLEXITY_M + 63) / 64;
+static constexpr size_t SERIAL_BINS = size_t(1) << SERIAL_M;
+static constexpr size_t TEMPLATE_BINS = size_t(1) << NON_OVERLAPPING_M;
+
+// Random walk: bytes are stepped whole while |S| >= this (no state within +-9 reachable)
+static constexpr int WALK_FAR = 18;
+
+static constexpr int RESULT_COUNTS[Sp800_22::TEST_COUNT] = {
+    1, 1, 2, 1, 1, 1, 1, NON_OVERLAPPING_TEMPLATES, 1, 1, 1, 8, 18, 2, 1
+};
+
+static const char* const TEST_NAMES[Sp800_22::TEST_COUNT] = {
+    "Frequency", "BlockFrequency", "CumulativeSums", "Runs", "LongestRun", "Rank", "FFT",
+    "NonOverlappingTemplate", "OverlappingTemplate", "Universal", "ApproximateEntropy",
+    "RandomExcursions", "RandomExcursionsVariant", "Serial", "LinearComplexity"
+};
+
+static constexpr int CountResults() {
+    int total = 0;
+    for (int t = 0; t < Sp800_22::TEST_COUNT; t++) total += RESULT_COUNTS[t];
+    return total;
+}
+static_assert(CountResults() == Sp800_22::RESULT_COUNT, "RESULT_COUNT out of date");
+
+//=============================================================================
+// BIT ACCESS
+//=============================================================================
+// Stream bit i is bit (63 - i % 64) of word i / 64, i.e. the stream's bytes
+// loaded big-endian. The two words past the stream repeat its first 128 bits
+// (the circular extension used by the serial and approximate entropy tests).
+
+static inline uint64_t Popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return (uint64_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+#ifdef TRNG_STS_AVX2
+static bool HasAvx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+static inline uint64_t LoadBigEndian(const uint8_t* p) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+#if defined(__GNUC__)
+    return __builtin_bswap64(w);
+#else
+    uint64_t r = 0;
+    for (int i = 0; i < 8; i++) r = (r << 8) | p[i];
+    return r;
+#endif
+}
+
+// Bits i..i+63, bit i in the MSB
+static inline uint64_t Window(const uint64_t* w, size_t i) {
+    size_t q = i >> 6;
+    unsigned s = i & 63;
+    return (w[q] << s) | ((w[q + 1] >> 1) >> (63 - s));
+}
+
+// Ones among bits [begin, end)
+static uint64_t CountOnes(const uint64_t* w, size_t begin, size_t end) {
+    if (begin >= end) return 0;
+    size_t first = begin >> 6;
+    size_t last = (end - 1) >> 6;
+    uint64_t headMask = ~0ULL >> (begin & 63);
+    uint64_t tailMask = ~0ULL << (63 - ((end - 1) & 63));
+    if (first == last) return Popcount64(w[first] & headMask & tailMask);
+    uint64_t ones = Popcount64(w[first] & headMask) + Popcount64(w[last] & tailMask);
+    for (size_t q = first + 1; q < last; q++) ones += Popcount64(w[q]);
+    return ones;
+}
+
+void Sp800_22::LoadWords(const uint8_t* stream, std::vector<uint64_t>& words) const {
+    words.assign(m_words + 2, 0);
+    size_t bytes = m_bits / 8;
+    size_t full = bytes / 8;
+    for (size_t q = 0; q < full; q++) words[q] = LoadBigEndian(stream + q * 8);
+    for (size_t i = full * 8; i < bytes; i++)
+        words[i / 8] |= (uint64_t)stream[i] << (56 - (i % 8) * 8);
+
+    for (size_t i = 0; i < 128; i++) {
+        uint64_t bit = (words[i >> 6] >> (63 - (i & 63))) & 1;
+        size_t pos = m_bits + i;
+        words[pos >> 6] |= bit << (63 - (pos & 63));
+    }
+}
+
+//=============================================================================
+// BYTE TABLES
+//=============================================================================
+// Per byte (MSB first): walk of +-1 steps and runs of ones
+
+struct ByteTables {
+    int8_t net[256];        // Sum of the eight steps
+    int8_t maxPrefix[256];  // Highest partial sum after 1..8 steps
+    int8_t minPrefix[256];  // Lowest partial sum after 1..8 steps
+    uint8_t lead[256];      // Ones before the first zero
+    uint8_t trail[256];     // Ones after the last zero
+    uint8_t inner[256];     // Longest run of ones anywhere in the byte
+
+    ByteTables() {
+        for (int b = 0; b < 256; b++) {
+            int s = 0, hi = -8, lo = 8, run = 0, best = 0;
+            for (int i = 7; i >= 0; i--) {
+                bool one = (b >> i) & 1;
+                s += one ? 1 : -1;
+                hi = std::max(hi, s);
+                lo = std::min(lo, s);
+                run = one ? run + 1 : 0;
+                best = std::max(best, run);
+            }
+            int leadOnes = 0;
+            while (leadOnes < 8 && ((b << leadOnes) & 0x80)) leadOnes++;
+            int trailOnes = 0;
+            while (trailOnes < 8 && ((b >> trailOnes) & 1)) trailOnes++;
+            net[b] = (int8_t)s;
+            maxPrefix[b] = (int8_t)hi;
+            minPrefix[b] = (int8_t)lo;
+            lead[b] = (uint8_t)leadOnes;
+            trail[b] = (uint8_t)trailOnes;
+            inner[b] = (uint8_t)best;
+        }
+    }
+};
+
+static const ByteTables& Tables() {
+    static const ByteTables tables;
+    return tables;
+}
+
+//=============================================================================
+// SETUP
+//=============================================================================
+
+// Template B is aperiodic when no proper prefix equals the suffix of the same length
+static bool IsAperiodic(unsigned value, int m) {
+    for (int shift = 1; shift < m; shift++) {
+        unsigned len = m - shift;
+        unsigned mask = (1u << len) - 1;
+        if ((value >> shift) == (value & mask)) return false;
+    }
+    return true;
+}
+
+static void Factorize(size_t n, std::vector<int>& radices) {
+    while (n % 4 == 0) { radices.push_back(4); n /= 4; }
+    while (n % 2 == 0) { radices.push_back(2); n /= 2; }
+    for (int p = 3; n > 1; p += 2) {
+        while (n % p == 0) { radices.push_back(p); n /= p; }
+        if ((size_t)p * p > n && n > 1) { radices.push_back((int)n); break; }
+    }
+}
+
+Sp800_22::Sp800_22(size_t streamBits)
+    : m_bits(streamBits), m_words((streamBits + 63) / 64), m_fftSize(streamBits / 2) {
+    Factorize(m_fftSize, m_radices);
+    size_t count = m_fftSize;
+    for (int radix : m_radices) {
+        size_t m = count / radix;
+        m_twiddleOffsets.push_back(m_twRe.size());
+        for (int q = 1; q < radix; q++) {
+            for (size_t k = 0; k < m; k++) {
+                double angle = -2.0 * PI * (double)(q * k) / (double)count;
+                m_twRe.push_back(std::cos(angle));
+                m_twIm.push_back(std::sin(angle));
+            }
+        }
+        count = m;
+    }
+
+    size_t quarter = m_fftSize / 2;
+    m_unscramble.resize(2 * (quarter + 1));
+    for (size_t k = 0; k <= quarter; k++) {
+        double angle = -2.0 * PI * (double)k / (double)m_bits;
+        m_unscramble[2 * k] = std::cos(angle);
+        m_unscramble[2 * k + 1] = std::sin(angle);
+    }
+
+    for (unsigned v = 0; v < TEMPLATE_BINS; v++)
+        if (IsAperiodic(v, NON_OVERLAPPING_M)) m_templates.push_back((uint16_t)v);
+}
+
+int Sp800_22::ResultCount(int test) {
+    return RESULT_COUNTS[test];
+}
+
+int Sp800_22::ResultOffset(int test) {
+    int offset = 0;
+    for (int t = 0; t < test; t++) offset += RESULT_COUNTS[t];
+    return offset;
+}
+
+const char* Sp800_22::TestName(int test) {
+    return test >= 0 && test < TEST_COUNT ? TEST_NAMES[test] : "?";
+}
+
+//=============================================================================
+// FFT
+//=============================================================================
+// Mixed-radix decimation-in-time FFT on split real/imaginary arrays, recursing
+// depth first so the sub-transforms below the top levels stay in cache. The
+// butterfly loops run over contiguous k and vectorize (AVX2 when available).
+// The leaves read their inputs straight from the packed bits: complex point j
+// is the +-1 pair (bit 2j, bit 2j+1), so no unpacked copy of the sequence is made.
+
+template <int R>
+static inline void Butterfly(double* xr, double* xi) {
+    if (R == 2) {
+        double r0 = xr[0] + xr[1], i0 = xi[0] + xi[1];
+        xr[1] = xr[0] - xr[1];
+        xi[1] = xi[0] - xi[1];
+        xr[0] = r0;
+        xi[0] = i0;
+    } else if (R == 3) {
+        const double s = 0.86602540378443864676;     // sin(2 pi / 3)
+        double ar = xr[1] + xr[2], ai = xi[1] + xi[2];
+        double br = xr[1] - xr[2], bi = xi[1] - xi[2];
+        double tr = xr[0] - 0.5 * ar, ti = xi[0] - 0.5 * ai;
+        xr[0] += ar;
+        xi[0] += ai;
+        xr[1] = tr + s * bi;
+        xi[1] = ti - s * br;
+        xr[2] = tr - s * bi;
+        xi[2] = ti + s * br;
+    } else if (R == 4) {
+        double ar = xr[0] + xr[2], ai = xi[0] + xi[2];
+        double br = xr[0] - xr[2], bi = xi[0] - xi[2];
+        double cr = xr[1] + xr[3], ci = xi[1] + xi[3];
+        double dr = xr[1] - xr[3], di = xi[1] - xi[3];
+        xr[0] = ar + cr;
+        xi[0] = ai + ci;
+        xr[2] = ar - cr;
+        xi[2] = ai - ci;
+        xr[1] = br + di;
+        xi[1] = bi - dr;
+        xr[3] = br - di;
+        xi[3] = bi + dr;
+    } else if (R == 5) {
+        const double c1 = 0.30901699437494742410;    // cos(2 pi / 5)
+        const double c2 = -0.80901699437494742410;   // cos(4 pi / 5)
+        const double s1 = 0.95105651629515357212;    // sin(2 pi / 5)
+        const double s2 = 0.58778525229247312917;    // sin(4 pi / 5)
+        double a1r = xr[1] + xr[4], a1i = xi[1] + xi[4];
+        double b1r = xr[1] - xr[4], b1i = xi[1] - xi[4];
+        double a2r = xr[2] + xr[3], a2i = xi[2] + xi[3];
+        double b2r = xr[2] - xr[3], b2i = xi[2] - xi[3];
+        double t1r = xr[0] + c1 * a1r + c2 * a2r, t1i = xi[0] + c1 * a1i + c2 * a2i;
+        double t2r = xr[0] + c2 * a1r + c1 * a2r, t2i = xi[0] + c2 * a1i + c1 * a2i;
+        double u1r = s1 * b1r + s2 * b2r, u1i = s1 * b1i + s2 * b2i;
+        double u2r = s2 * b1r - s1 * b2r, u2i = s2 * b1i - s1 * b2i;
+        xr[0] += a1r + a2r;
+        xi[0] += a1i + a2i;
+        xr[1] = t1r + u1i;
+        xi[1] = t1i - u1r;
+        xr[4] = t1r - u1i;
+        xi[4] = t1i + u1r;
+        xr[2] = t2r + u2i;
+        xi[2] = t2i - u2r;
+        xr[3] = t2r - u2i;
+        xi[3] = t2i + u2r;
+    }
+}
+
+// Combine R sub-transforms of length m held at [q m, q m + m):
+//   X[k + q' m] = sum_q W^(q k) Y_q[k] w_R^(q q'),  W = exp(-2 pi i / (R m))
+// The level's twiddles W^(q k) are stored at [(q - 1) m + k].
+template <int R>
+static inline __attribute__((always_inline)) void ButterfliesBody(
+    double* __restrict re, double* __restrict im, size_t m,
+    const double* __restrict twRe, const double* __restrict twIm) {
+    for (size_t k = 0; k < m; k++) {
+        double xr[R], xi[R];
+        xr[0] = re[k];
+        xi[0] = im[k];
+        for (int q = 1; q < R; q++) {
+            double vr = re[k + q * m], vi = im[k + q * m];
+            double wr = twRe[(q - 1) * m + k], wi = twIm[(q - 1) * m + k];
+            xr[q] = vr * wr - vi * wi;
+            xi[q] = vr * wi + vi * wr;
+        }
+        Butterfly<R>(xr, xi);
+        for (int q = 0; q < R; q++) {
+            re[k + q * m] = xr[q];
+            im[k + q * m] = xi[q];
+        }
+    }
+}
+
+template <int R>
+static void Butterflies(double* re, double* im, size_t m, const double* twRe, const double* twIm) {
+    ButterfliesBody<R>(re, im, m, twRe, twIm);
+}
+
+#ifdef TRNG_STS_AVX2
+template <int R>
+TRNG_STS_TARGET("avx2")
+static void ButterfliesAvx2(double* re, double* im, size_t m, const double* twRe, const double* twIm) {
+    ButterfliesBody<R>(re, im, m, twRe, twIm);
+}
+#endif
+
+template <int R>
+static void ButterfliesDispatch(double* re, double* im, size_t m, const double* twRe, const double* twIm) {
+#ifdef TRNG_STS_AVX2
+    // Short loops gain nothing from the wider vectors
+    if (m >= 16 && HasAvx2()) {
+        ButterfliesAvx2<R>(re, im, m, twRe, twIm);
+        return;
+    }
+#endif
+    Butterflies<R>(re, im, m, twRe, twIm);
+}
+
+// Any other prime radix: direct O(R^2) DFT (only reached for unusual stream lengths)
+static void ButterfliesGeneric(double* re, double* im, size_t m, int radix, const double* twRe, const double* twIm) {
+    std::vector<double> xr(radix), xi(radix), rootRe(radix), rootIm(radix);
+    for (int e = 0; e < radix; e++) {
+        rootRe[e] = std::cos(-2.0 * PI * e / radix);
+        rootIm[e] = std::sin(-2.0 * PI * e / radix);
+    }
+    for (size_t k = 0; k < m; k++) {
+        xr[0] = re[k];
+        xi[0] = im[k];
+        for (int q = 1; q < radix; q++) {
+            double vr = re[k + q * m], vi = im[k + q * m];
+            double wr = twRe[(q - 1) * m + k], wi = twIm[(q - 1) * m + k];
+            xr[q] = vr * wr - vi * wi;
+            xi[q] = vr * wi + vi * wr;
+        }
+        for (int q2 = 0; q2 < radix; q2++) {
+            double sr = 0.0, si = 0.0;
+            for (int q = 0; q < radix; q++) {
+                int e = (int)((size_t)q * q2 % radix);
+                sr += xr[q] * rootRe[e] - xi[q] * rootIm[e];
+                si += xr[q] * rootIm[e] + xi[q] * rootRe[e];
+            }
+            re[k + q2 * m] = sr;
+            im[k + q2 * m] = si;
+        }
+    }
+}
+
+struct FftPlan {
+    const int* radices;
+    const size_t* twiddleOffsets;   // Per level, into twRe / twIm
+    const double* twRe;
+    const double* twIm;
+    const uint64_t* bits;
+};
+
+// [0, count) of re/im = DFT of the `count` points first, first + stride, ...
+static void FftWork(const FftPlan& plan, double* re, double* im, size_t first, size_t stride, int level, size_t count) {
+    int radix = plan.radices[level];
+    size_t m = count / radix;
+    if (m == 1) {
+        for (int q = 0; q < radix; q++) {
+            size_t j = first + q * stride;
+            unsigned pair = (unsigned)(plan.bits[j >> 5] >> (62 - 2 * (j & 31))) & 3;
+            re[q] = (pair >> 1) ? 1.0 : -1.0;
+            im[q] = (pair & 1) ? 1.0 : -1.0;
+        }
+    } else {
+        for (int q = 0; q < radix; q++)
+            FftWork(plan, re + q * m, im + q * m, first + q * stride, stride * radix, level + 1, m);
+    }
+    const double* twRe = plan.twRe + plan.twiddleOffsets[level];
+    const double* twIm = plan.twIm + plan.twiddleOffsets[level];
+    switch (radix) {
+    case 2: ButterfliesDispatch<2>(re, im, m, twRe, twIm); break;
+    case 3: ButterfliesDispatch<3>(re, im, m, twRe, twIm); break;
+    case 4: ButterfliesDispatch<4>(re, im, m, twRe, twIm); break;
+    case 5: ButterfliesDispatch<5>(re, im, m, twRe, twIm); break;
+    default: ButterfliesGeneric(re, im, m, radix, twRe, twIm); break;
+    }
+}
+
+// Discrete Fourier transform test. The +-1 sequence x (length n) is packed as
+// z_k = x_2k + i x_2k+1 and transformed at n/2 points; bin k of the real
+// transform is E_k + exp(-2 pi i k / n) O_k with E, O from Z_k and conj(Z_-k).
+double Sp800_22::SpectralTest(const std::vector<uint64_t>& words, Scratch& scratch) const {
+    size_t N = m_fftSize;
+    scratch.fftRe.resize(N);
+    scratch.fftIm.resize(N);
+    double* zr = scratch.fftRe.data();
+    double* zi = scratch.fftIm.data();
+    FftPlan plan = {m_radices.data(), m_twiddleOffsets.data(), m_twRe.data(), m_twIm.data(), words.data()};
+    FftWork(plan, zr, zi, 0, 1, 0, N);
+
+    // sts counts |X_k| < sqrt(2.995732274 n) for k = 0 .. n/2 - 1
+    const double bound = 2.995732274 * (double)m_bits;
+    size_t quarter = N / 2;
+    size_t count = 0;
+    for (size_t k = 0; k < N; k++) {
+        size_t mirror = k ? N - k : 0;                       // conj(Z_-k) = (zr, -zi)[mirror]
+        double er = 0.5 * (zr[k] + zr[mirror]), ei = 0.5 * (zi[k] - zi[mirror]);
+        double or_ = 0.5 * (zi[k] + zi[mirror]), oi = -0.5 * (zr[k] - zr[mirror]);   // (Z - conj) / 2i
+        double wr, wi;
+        if (k <= quarter) {
+            wr = m_unscramble[2 * k];
+            wi = m_unscramble[2 * k + 1];
+        } else {                                             // w^(N - j) = -conj(w^j)
+            wr = -m_unscramble[2 * (N - k)];
+            wi = m_unscramble[2 * (N - k) + 1];
+        }
+        double xr = er + wr * or_ - wi * oi;
+        double xi = ei + wr * oi + wi * or_;
+        if (xr * xr + xi * xi < bound) count++;
+    }
+
+    double expected = 0.95 * (double)m_bits / 2.0;
+    double d = ((double)count - expected) / std::sqrt((double)m_bits / 4.0 * 0.95 * 0.05);
+    return std::erfc(std::fabs(d) / std::sqrt(2.0));
+}
+
+//=============================================================================
+// INDIVIDUAL TESTS
+//=============================================================================
+
+static double FrequencyTest(const uint64_t* w, size_t n) {
+    double sum = 2.0 * (double)CountOnes(w, 0, n) - (double)n;
+    return std::erfc(std::fabs(sum) / std::sqrt((double)n) / std::sqrt(2.0));
+}
+
+static double BlockFrequencyTest(const uint64_t* w, size_t n) {
+    size_t blocks = n / BLOCK_FREQUENCY_M;
+    double sum = 0.0;
+    for (size_t i = 0; i < blocks; i++) {
+        double v = (double)CountOnes(w, i * BLOCK_FREQUENCY_M, (i + 1) * BLOCK_FREQUENCY_M) / BLOCK_FREQUENCY_M - 0.5;
+        sum += v * v;
+    }
+    double chi2 = 4.0 * BLOCK_FREQUENCY_M * sum;
+    return StatsMath::Igamc(blocks / 2.0, chi2 / 2.0);
+}
+
+static double RunsTest(const uint64_t* w, size_t n) {
+    double pi = (double)CountOnes(w, 0, n) / (double)n;
+    if (std::fabs(pi - 0.5) > 2.0 / std::sqrt((double)n)) return 0.0;
+
+    // Bit j of x: bit j differs from bit j + 1
+    uint64_t changes = 0;
+    size_t last = n - 1;
+    for (size_t q = 0; q * 64 < last; q++) {
+        uint64_t x = w[q] ^ Window(w, q * 64 + 1);
+        if (q * 64 + 64 > last) x &= ~0ULL << (64 - (last - q * 64));
+        changes += Popcount64(x);
+    }
+    double v = (double)(changes + 1);
+    double arg = std::fabs(v - 2.0 * n * pi * (1 - pi)) / (2.0 * pi * (1 - pi) * std::sqrt(2.0 * n));
+    return std::erfc(arg);
+}
+
+static double LongestRunTest(const uint8_t* stream, size_t n) {
+    static const double PI_128[6] = {0.1174035788, 0.242955959, 0.249363483, 0.17517706, 0.102701071, 0.112398847};
+    static const double PI_10000[7] = {0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727};
+    size_t M;
+    int K, vMin;
+    const double* pi;
+    if (n < 750000) {
+        M = 128;
+        K = 5;
+        vMin = 4;
+        pi = PI_128;
+    } else {
+        M = 10000;
+        K = 6;
+        vMin = 10;
+        pi = PI_10000;
+    }
+
+    const ByteTables& tb = Tables();
+    size_t blocks = n / M;
+    size_t blockBytes = M / 8;
+    unsigned nu[7] = {};
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8_t* p = stream + i * blockBytes;
+        int run = 0, best = 0;
+        for (size_t j = 0; j < blockBytes; j++) {
+            uint8_t b = p[j];
+            if (b == 0xFF) {
+                run += 8;
+                continue;
+            }
+            best = std::max(best, std::max(run + tb.lead[b], (int)tb.inner[b]));
+            run = tb.trail[b];
+        }
+        best = std::max(best, run);
+        nu[std::min(std::max(best, vMin), vMin + K) - vMin]++;
+    }
+
+    double chi2 = 0.0;
+    for (int i = 0; i <= K; i++) {
+        double expected = (double)blocks * pi[i];
+        chi2 += ((double)nu[i] - expected) * ((double)nu[i] - expected) / expected;
+    }
+    return StatsMath::Igamc(K / 2.0, chi2 / 2.0);
+}
+
+static int Rank32(uint32_t rows[RANK_ROWS]) {
+    int rank = 0;
+    for (int bit = 31; bit >= 0 && rank < RANK_ROWS; bit--) {
+        uint32_t mask = 1u << bit;
+        int pivot = rank;
+        while (pivot < RANK_ROWS && !(rows[pivot] & mask)) pivot++;
+        if (pivot == RANK_ROWS) continue;
+        std::swap(rows[rank], rows[pivot]);
+        for (int r = rank + 1; r < RANK_ROWS; r++)
+            if (rows[r] & mask) rows[r] ^= rows[rank];
+        rank++;
+    }
+    return rank;
+}
+
+// Probability of a random 32x32 binary matrix having rank r (sts formula)
+static double RankProbability(int r) {
+    double product = 1.0;
+    for (int i = 0; i <= r - 1; i++)
+        product *= ((1.0 - std::pow(2, i - 32)) * (1.0 - std::pow(2, i - 32))) / (1.0 - std::pow(2, i - r));
+    return std::pow(2, r * (32 + 32 - r) - 32 * 32) * product;
+}
+
+static double RankTest(const uint64_t* w, size_t n) {
+    static const double p32 = RankProbability(32);
+    static const double p31 = RankProbability(31);
+    static const double p30 = 1.0 - (p32 + p31);
+
+    size_t matrices = n / RANK_BITS;
+    size_t f32 = 0, f31 = 0;
+    for (size_t k = 0; k < matrices; k++) {
+        uint32_t rows[RANK_ROWS];
+        for (int i = 0; i < RANK_ROWS; i++)
+            rows[i] = (uint32_t)(Window(w, k * RANK_BITS + i * RANK_ROWS) >> 32);
+        int rank = Rank32(rows);
+        if (rank == 32) f32++;
+        else if (rank == 31) f31++;
+    }
+    double N = (double)matrices;
+    double f30 = N - (double)f32 - (double)f31;
+    double chi2 = std::pow((double)f32 - N * p32, 2) / (N * p32) +
+                  std::pow((double)f31 - N * p31, 2) / (N * p31) +
+                  std::pow(f30 - N * p30, 2) / (N * p30);
+    return std::exp(-chi2 / 2.0);
+}
+
+// Every overlapping 16-bit pattern of the circular sequence, plus per-block
+// counts of the 9-bit prefixes for the non-overlapping template test
+static void CountPatterns(const uint64_t* w, size_t n, uint32_t* serial, uint32_t* blocks) {
+    std::fill(serial, serial + SERIAL_BINS, 0u);
+    std::fill(blocks, blocks + NON_OVERLAPPING_BLOCKS * TEMPLATE_BINS, 0u);
+    size_t M = n / NON_OVERLAPPING_BLOCKS;
+    for (int b = 0; b < NON_OVERLAPPING_BLOCKS; b++) {
+        uint32_t* hist = blocks + b * TEMPLATE_BINS;
+        size_t begin = b * M;
+        size_t templateEnd = begin + M - NON_OVERLAPPING_M + 1;
+        size_t end = b + 1 == NON_OVERLAPPING_BLOCKS ? n : begin + M;
+        size_t p = begin;
+        for (; p < templateEnd; p++) {
+            unsigned v = (unsigned)(Window(w, p) >> (64 - SERIAL_M));
+            serial[v]++;
+            hist[v >> (SERIAL_M - NON_OVERLAPPING_M)]++;
+        }
+        for (; p < end; p++) serial[Window(w, p) >> (64 - SERIAL_M)]++;
+    }
+}
+
+// Fold pattern counts of length m into length m - 1 (circular sequence: every
+// (m-1)-pattern occurrence extends to exactly one m-pattern). May run in place.
+static void FoldPatterns(const uint32_t* in, uint32_t* out, int m) {
+    size_t bins = size_t(1) << (m - 1);
+    for (size_t v = 0; v < bins; v++) out[v] = in[2 * v] + in[2 * v + 1];
+}
+
+static double Psi2(const uint32_t* counts, int m, size_t n) {
+    double sum = 0.0;
+    for (size_t v = 0; v < (size_t(1) << m); v++) sum += (double)counts[v] * (double)counts[v];
+    return sum * std::pow(2, m) / (double)n - (double)n;
+}
+
+static double ApEn(const uint32_t* counts, int m, size_t n) {
+    double blocks = (double)n;
+    double sum = 0.0;
+    for (size_t v = 0; v < (size_t(1) << m); v++)
+        if (counts[v] > 0) sum += counts[v] * std::log(counts[v] / blocks);
+    return sum / blocks;
+}
+
+static double OverlappingProbability(int u, double eta) {
+    if (u == 0) return std::exp(-eta);
+    double sum = 0.0;
+    for (int l = 1; l <= u; l++)
+        sum += std::exp(-eta - u * std::log(2) + l * std::log(eta) - std::lgamma(l + 1) +
+                        std::lgamma(u) - std::lgamma(l) - std::lgamma(u - l + 1));
+    return sum;
+}
+
+static double OverlappingTemplateTest(const uint64_t* w, size_t n, size_t words, std::vector<uint64_t>& runs) {
+    static const struct Pi {
+        double p[OVERLAPPING_K + 1];
+        Pi() {
+            double lambda = (double)(OVERLAPPING_BLOCK - OVERLAPPING_M + 1) / std::pow(2, OVERLAPPING_M);
+            double eta = lambda / 2.0;
+            double sum = 0.0;
+            for (int i = 0; i < OVERLAPPING_K; i++) {
+                p[i] = OverlappingProbability(i, eta);
+                sum += p[i];
+            }
+            p[OVERLAPPING_K] = 1 - sum;
+        }
+    } pi;
+
+    // Bit j of runs: bits j .. j+8 are all ones
+    runs.resize(words + 1);
+    for (size_t q = 0; q < words; q++) {
+        uint64_t r = w[q];
+        for (int s = 1; s < OVERLAPPING_M; s++) r &= Window(w, q * 64 + s);
+        runs[q] = r;
+    }
+    runs[words] = 0;
+
+    size_t blocks = n / OVERLAPPING_BLOCK;
+    unsigned nu[OVERLAPPING_K + 1] = {};
+    for (size_t i = 0; i < blocks; i++) {
+        size_t begin = i * OVERLAPPING_BLOCK;
+        uint64_t matches = CountOnes(runs.data(), begin, begin + OVERLAPPING_BLOCK - OVERLAPPING_M + 1);
+        nu[matches <= 4 ? matches : OVERLAPPING_K]++;
+    }
+    double chi2 = 0.0;
+    for (int i = 0; i <= OVERLAPPING_K; i++) {
+        double expected = (double)blocks * pi.p[i];
+        chi2 += std::pow((double)nu[i] - expected, 2) / expected;
+    }
+    return StatsMath::Igamc(OVERLAPPING_K / 2.0, chi2 / 2.0);
+}
+
+static double UniversalTest(const uint64_t* w, size_t n, uint32_t* table) {
+    static const double EXPECTED[17] = {0, 0, 0, 0, 0, 0, 5.2177052, 6.1962507, 7.1836656, 8.1764248,
+                                        9.1723243, 10.170032, 11.168765, 12.168070, 13.167693, 14.167488, 15.167379};
+    static const double VARIANCE[17] = {0, 0, 0, 0, 0, 0, 2.954, 3.125, 3.238, 3.311, 3.356, 3.384,
+                                        3.401, 3.410, 3.416, 3.419, 3.421};
+    static const size_t MIN_LENGTH[11] = {387840, 904960, 2068480, 4654080, 10342400, 22753280,
+                                          49643520, 107560960, 231669760, 496435200, 1059061760};
+    int L = 5;
+    for (size_t threshold : MIN_LENGTH)
+        if (n >= threshold) L++;
+    if (L < 6 || L > 16) return std::numeric_limits<double>::quiet_NaN();
+
+    size_t Q = 10 * (size_t(1) << L);
+    size_t K = n / L - Q;
+    std::fill(table, table + (size_t(1) << L), 0u);
+    for (size_t i = 1; i <= Q; i++) table[Window(w, (i - 1) * L) >> (64 - L)] = (uint32_t)i;
+    double sum = 0.0;
+    const double log2 = std::log(2);
+    for (size_t i = Q + 1; i <= Q + K; i++) {
+        uint32_t& last = table[Window(w, (i - 1) * L) >> (64 - L)];
+        sum += std::log((double)(i - last)) / log2;
+        last = (uint32_t)i;
+    }
+
+    double c = 0.7 - 0.8 / (double)L + (4 + 32 / (double)L) * std::pow((double)K, -3 / (double)L) / 15;
+    double sigma = c * std::sqrt(VARIANCE[L] / (double)K);
+    double phi = sum / (double)K;
+    return std::erfc(std::fabs(phi - EXPECTED[L]) / (std::sqrt(2.0) * sigma));
+}
+
+// Linear complexity by Berlekamp-Massey over bit vectors: bit i of `recent`
+// is s_(N-i), so the discrepancy is the parity of C & recent, and `shifted`
+// tracks B x^(N-m). Branch-free: the discrepancy and the length change become
+// masks. During steps 64p .. 64p+63 every vector is below degree 64p + 65, so
+// only words 0 .. p+1 are touched. The SIMD kernels run one block per 64-bit
+// lane (2 with SSE2, 4 with AVX2) through the same steps.
+static inline int ActiveWords(int phase) {
+    return std::min(phase + 2, LC_WORDS);
+}
+
+static int LinearComplexity(const uint64_t* w, size_t begin) {
+    uint64_t seq[LC_WORDS];
+    for (int q = 0; q < LC_WORDS; q++) seq[q] = Window(w, begin + q * 64);
+    uint64_t C[LC_WORDS] = {1}, shifted[LC_WORDS] = {2}, recent[LC_WORDS] = {};
+    uint64_t L = 0;
+    for (int N = 0; N < LINEAR_COMPLEXITY_M; N++) {
+        int words = ActiveWords(N >> 6);
+        uint64_t bit = (seq[N >> 6] >> (63 - (N & 63))) & 1;
+        for (int q = words - 1; q > 0; q--) recent[q] = (recent[q] << 1) | (recent[q - 1] >> 63);
+        recent[0] = (recent[0] << 1) | bit;
+
+        uint64_t acc = 0;
+        for (int q = 0; q < words; q++) acc ^= C[q] & recent[q];
+        acc ^= acc >> 32;
+        acc ^= acc >> 16;
+        acc ^= acc >> 8;
+        acc ^= acc >> 4;
+        uint64_t d = 0 - (uint64_t)((0x6996u >> (acc & 0xF)) & 1);
+        uint64_t lengthen = d & (0 - (uint64_t)(L <= (uint64_t)(N / 2)));
+
+        // C ^= B x^(N-m); on a length change B becomes the old C (and m = N)
+        for (int q = 0; q < words; q++) {
+            uint64_t old = C[q];
+            C[q] ^= shifted[q] & d;
+            shifted[q] = (old & lengthen) | (shifted[q] & ~lengthen);
+        }
+        for (int q = words - 1; q > 0; q--) shifted[q] = (shifted[q] << 1) | (shifted[q - 1] >> 63);
+        shifted[0] <<= 1;
+        L ^= (L ^ (N + 1 - L)) & lengthen;
+    }
+    return (int)L;
+}
+
+#ifdef TRNG_STS_SSE2
+static void LinearComplexitySse2(const uint64_t* w, const size_t begin[2], int L[2]) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi64x(1);
+    __m128i seq[LC_WORDS], C[LC_WORDS], shifted[LC_WORDS], recent[LC_WORDS];
+    for (int q = 0; q < LC_WORDS; q++) {
+        seq[q] = _mm_set_epi64x((long long)Window(w, begin[1] + q * 64), (long long)Window(w, begin[0] + q * 64));
+        C[q] = shifted[q] = recent[q] = zero;
+    }
+    C[0] = one;
+    shifted[0] = _mm_set1_epi64x(2);
+    __m128i len = zero;
+    for (int N = 0; N < LINEAR_COMPLEXITY_M; N++) {
+        int words = ActiveWords(N >> 6);
+        __m128i bit = _mm_and_si128(_mm_srl_epi64(seq[N >> 6], _mm_cvtsi32_si128(63 - (N & 63))), one);
+        for (int q = words - 1; q > 0; q--)
+            recent[q] = _mm_or_si128(_mm_slli_epi64(recent[q], 1), _mm_srli_epi64(recent[q - 1], 63));
+        recent[0] = _mm_or_si128(_mm_slli_epi64(recent[0], 1), bit);
+
+        __m128i acc = zero;
+        for (int q = 0; q < words; q++) acc = _mm_xor_si128(acc, _mm_and_si128(C[q], recent[q]));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 32));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 16));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 8));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 4));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 2));
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 1));
+        __m128i dBit = _mm_and_si128(acc, one);
+        __m128i d = _mm_sub_epi64(zero, dBit);
+        // L <= N/2 <=> N/2 - L has a clear sign bit
+        __m128i tooLong = _mm_srli_epi64(_mm_sub_epi64(_mm_set1_epi64x(N / 2), len), 63);
+        __m128i lengthen = _mm_sub_epi64(zero, _mm_andnot_si128(tooLong, dBit));
+
+        for (int q = 0; q < words; q++) {
+            __m128i old = C[q];
+            C[q] = _mm_xor_si128(C[q], _mm_and_si128(shifted[q], d));
+            shifted[q] = _mm_or_si128(_mm_and_si128(old, lengthen), _mm_andnot_si128(lengthen, shifted[q]));
+        }
+        for (int q = words - 1; q > 0; q--)
+            shifted[q] = _mm_or_si128(_mm_slli_epi64(shifted[q], 1), _mm_srli_epi64(shifted[q - 1], 63));
+        shifted[0] = _mm_slli_epi64(shifted[0], 1);
+        __m128i grown = _mm_sub_epi64(_mm_set1_epi64x(N + 1), len);
+        len = _mm_xor_si128(len, _mm_and_si128(_mm_xor_si128(len, grown), lengthen));
+    }
+    uint64_t out[2];
+    _mm_storeu_si128((__m128i*)out, len);
+    L[0] = (int)out[0];
+    L[1] = (int)out[1];
+}
+#endif
+
+#ifdef TRNG_STS_AVX2
+TRNG_STS_TARGET("avx2")
+static void LinearComplexityAvx2(const uint64_t* w, const size_t begin[4], int L[4]) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i seq[LC_WORDS], C[LC_WORDS], shifted[LC_WORDS], recent[LC_WORDS];
+    for (int q = 0; q < LC_WORDS; q++) {
+        seq[q] = _mm256_set_epi64x((long long)Window(w, begin[3] + q * 64), (long long)Window(w, begin[2] + q * 64),
+                                   (long long)Window(w, begin[1] + q * 64), (long long)Window(w, begin[0] + q * 64));
+        C[q] = shifted[q] = recent[q] = zero;
+    }
+    C[0] = one;
+    shifted[0] = _mm256_set1_epi64x(2);
+    __m256i len = zero;
+    for (int N = 0; N < LINEAR_COMPLEXITY_M; N++) {
+        int words = ActiveWords(N >> 6);
+        __m256i bit = _mm256_and_si256(_mm256_srl_epi64(seq[N >> 6], _mm_cvtsi32_si128(63 - (N & 63))), one);
+        for (int q = words - 1; q > 0; q--)
+            recent[q] = _mm256_or_si256(_mm256_slli_epi64(recent[q], 1), _mm256_srli_epi64(recent[q - 1], 63));
+        recent[0] = _mm256_or_si256(_mm256_slli_epi64(recent[0], 1), bit);
+
+        __m256i acc = zero;
+        for (int q = 0; q < words; q++) acc = _mm256_xor_si256(acc, _mm256_and_si256(C[q], recent[q]));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 32));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 16));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 8));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 4));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 2));
+        acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 1));
+        __m256i dBit = _mm256_and_si256(acc, one);
+        __m256i d = _mm256_sub_epi64(zero, dBit);
+        __m256i tooLong = _mm256_cmpgt_epi64(len, _mm256_set1_epi64x(N / 2));
+        __m256i lengthen = _mm256_andnot_si256(tooLong, d);
+
+        for (int q = 0; q < words; q++) {
+            __m256i old = C[q];
+            C[q] = _mm256_xor_si256(C[q], _mm256_and_si256(shifted[q], d));
+            shifted[q] = _mm256_blendv_epi8(shifted[q], old, lengthen);
+        }
+        for (int q = words - 1; q > 0; q--)
+            shifted[q] = _mm256_or_si256(_mm256_slli_epi64(shifted[q], 1), _mm256_srli_epi64(shifted[q - 1], 63));
+        shifted[0] = _mm256_slli_epi64(shifted[0], 1);
+        __m256i grown = _mm256_sub_epi64(_mm256_set1_epi64x(N + 1), len);
+        len = _mm256_blendv_epi8(len, grown, lengthen);
+    }
+    uint64_t out[4];
+    _mm256_storeu_si256((__m256i*)out, len);
+    for (int j = 0; j < 4; j++) L[j] = (int)out[j];
+}
+#endif
+
+static double LinearComplexityTest(const uint64_t* w, size_t n) {
+    static const double CLASS_PI[LINEAR_COMPLEXITY_K + 1] = {0.01047, 0.03125, 0.12500, 0.50000, 0.25000, 0.06250, 0.020833};
+    const int M = LINEAR_COMPLEXITY_M;
+    size_t blocks = n / M;
+    double mean = M / 2.0 + (9.0 + std::pow(-1, M + 1)) / 36.0 - 1.0 / std::pow(2, M) * (M / 3.0 + 2.0 / 9.0);
+    int sign = (M + 1) % 2 == 0 ? -1 : 1;
+    unsigned nu[LINEAR_COMPLEXITY_K + 1] = {};
+    std::vector<int> complexity(blocks);
+    size_t i = 0;
+#if defined(TRNG_STS_AVX2)
+    if (HasAvx2()) {
+        for (; i + 4 <= blocks; i += 4) {
+            size_t begin[4] = {i * M, (i + 1) * M, (i + 2) * M, (i + 3) * M};
+            LinearComplexityAvx2(w, begin, &complexity[i]);
+        }
+    }
+#endif
+#if defined(TRNG_STS_SSE2)
+    for (; i + 2 <= blocks; i += 2) {
+        size_t begin[2] = {i * M, (i + 1) * M};
+        LinearComplexitySse2(w, begin, &complexity[i]);
+    }
+#endif
+    for (; i < blocks; i++) complexity[i] = LinearComplexity(w, i * M);
+
+    for (int L : complexity) {
+        double t = sign * (L - mean) + 2.0 / 9.0;
+        int cls;
+        if (t <= -2.5) cls = 0;
+        else if (t <= -1.5) cls = 1;
+        else if (t <= -0.5) cls = 2;
+        else if (t <= 0.5) cls = 3;
+        else if (t <= 1.5) cls = 4;
+        else if (t <= 2.5) cls = 5;
+        else cls = 6;
+        nu[cls]++;
+    }
+    double chi2 = 0.0;
+    for (int i = 0; i <= LINEAR_COMPLEXITY_K; i++) {
+        double expected = (double)blocks * CLASS_PI[i];
+        chi2 += std::pow((double)nu[i] - expected, 2) / expected;
+    }
+    return StatsMath::Igamc(LINEAR_COMPLEXITY_K / 2.0, chi2 / 2.0);
+}
+
+//=============================================================================
+// RANDOM WALK (cumulative sums, random excursions, variant)
+//=============================================================================
+
+struct Walk {
+    int final = 0;
+    int sup = 0;                 // max(0, highest partial sum)
+    int inf = 0;                 // min(0, lowest partial sum)
+    uint64_t cycles = 0;         // J
+    uint64_t visits[19] = {};    // Total visits to states -9..9
+    uint64_t nu[6][8] = {};      // Cycles visiting state -4..-1, 1..4 exactly k times (k >= 5 pooled)
+};
+
+static inline int ExcursionIndex(int s) {
+    return s < 0 ? s + 4 : s + 3;
+}
+
+static void EndCycle(Walk& walk, unsigned counter[8]) {
+    walk.cycles++;
+    for (int i = 0; i < 8; i++) {
+        walk.nu[std::min(counter[i], 5u)][i]++;
+        counter[i] = 0;
+    }
+}
+
+static void RandomWalk(const uint8_t* stream, size_t n, Walk& walk) {
+    const ByteTables& tb = Tables();
+    unsigned counter[8] = {};
+    int s = 0;
+    for (size_t i = 0; i < n / 8; i++) {
+        uint8_t b = stream[i];
+        walk.sup = std::max(walk.sup, s + tb.maxPrefix[b]);
+        walk.inf = std::min(walk.inf, s + tb.minPrefix[b]);
+        if (s >= WALK_FAR || s <= -WALK_FAR) {
+            s += tb.net[b];
+            continue;
+        }
+        for (int bit = 7; bit >= 0; bit--) {
+            s += ((b >> bit) & 1) ? 1 : -1;
+            if (s == 0) {
+                EndCycle(walk, counter);
+            } else if (s >= -9 && s <= 9) {
+                walk.visits[s + 9]++;
+                if (s >= -4 && s <= 4) counter[ExcursionIndex(s)]++;
+            }
+        }
+    }
+    if (s != 0) EndCycle(walk, counter);
+    walk.final = s;
+}
+
+static double StandardNormal(double x) {
+    const double sqrt2 = 1.414213562373095048801688724209698078569672;
+    return x > 0 ? 0.5 * (1 + std::erf(x / sqrt2)) : 0.5 * (1 - std::erf(-x / sqrt2));
+}
+
+// sts evaluates the summation bounds in int arithmetic; kept as is
+static double CumulativeSumsP(int n, int z) {
+    double sqrtN = std::sqrt((double)n);
+    double sum1 = 0.0;
+    for (int k = (-n / z + 1) / 4; k <= (n / z - 1) / 4; k++) {
+        sum1 += StandardNormal(((4 * k + 1) * z) / sqrtN);
+        sum1 -= StandardNormal(((4 * k - 1) * z) / sqrtN);
+    }
+    double sum2 = 0.0;
+    for (int k = (-n / z - 3) / 4; k <= (n / z - 1) / 4; k++) {
+        sum2 += StandardNormal(((4 * k + 3) * z) / sqrtN);
+        sum2 -= StandardNormal(((4 * k + 1) * z) / sqrtN);
+    }
+    return 1.0 - sum1 + sum2;
+}
+
+static void RandomExcursionsTests(const Walk& walk, size_t n, double excursions[8], double variant[18]) {
+    static const double VISITS_PI[5][6] = {
+        {0.0000000000, 0.00000000000, 0.00000000000, 0.00000000000, 0.00000000000, 0.0000000000},
+        {0.5000000000, 0.25000000000, 0.12500000000, 0.06250000000, 0.03125000000, 0.0312500000},
+        {0.7500000000, 0.06250000000, 0.04687500000, 0.03515625000, 0.02636718750, 0.0791015625},
+        {0.8333333333, 0.02777777778, 0.02314814815, 0.01929012346, 0.01607510288, 0.0803755143},
+        {0.8750000000, 0.01562500000, 0.01367187500, 0.01196289063, 0.01046752930, 0.0732727051}};
+    static const int STATES[8] = {-4, -3, -2, -1, 1, 2, 3, 4};
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    double J = (double)walk.cycles;
+    double constraint = std::max(0.005 * std::sqrt((double)n), 500.0);
+    bool applicable = J >= constraint;
+
+    // sts gives up on the (non-variant) test past max(1000, n/100) cycles
+    bool tooMany = walk.cycles > std::max<uint64_t>(1000, n / 100);
+    for (int i = 0; i < 8; i++) {
+        if (!applicable || tooMany) {
+            excursions[i] = nan;
+            continue;
+        }
+        int x = std::abs(STATES[i]);
+        double sum = 0.0;
+        for (int k = 0; k < 6; k++) {
+            double expected = J * VISITS_PI[x][k];
+            sum += std::pow((double)walk.nu[k][i] - expected, 2) / expected;
+        }
+        excursions[i] = StatsMath::Igamc(2.5, sum / 2.0);
+    }
+
+    for (int i = 0; i < 18; i++) {
+        int x = i < 9 ? i - 9 : i - 8;
+        if (!applicable) {
+            variant[i] = nan;
+            continue;
+        }
+        double count = (double)walk.visits[x + 9];
+        variant[i] = std::erfc(std::fabs(count - J) / std::sqrt(2.0 * J * (4.0 * std::abs(x) - 2)));
+    }
+}
+
+//=============================================================================
+// SUITE
+//=============================================================================
+
+void Sp800_22::Run(const uint8_t* stream, double pValues[RESULT_COUNT], Scratch& scratch) const {
+    const size_t n = m_bits;
+    LoadWords(stream, scratch.words);
+    const uint64_t* w = scratch.words.data();
+
+    pValues[ResultOffset(TEST_FREQUENCY)] = FrequencyTest(w, n);
+    pValues[ResultOffset(TEST_BLOCK_FREQUENCY)] = BlockFrequencyTest(w, n);
+
+    Walk walk;
+    RandomWalk(stream, n, walk);
+    int z = std::max(walk.sup, -walk.inf);
+    int zRev = std::max(walk.sup - walk.final, walk.final - walk.inf);
+    double* cusum = pValues + ResultOffset(TEST_CUMULATIVE_SUMS);
+    cusum[0] = CumulativeSumsP((int)n, z);
+    cusum[1] = CumulativeSumsP((int)n, zRev);
+
+    pValues[ResultOffset(TEST_RUNS)] = RunsTest(w, n);
+    pValues[ResultOffset(TEST_LONGEST_RUN)] = LongestRunTest(stream, n);
+    pValues[ResultOffset(TEST_RANK)] = RankTest(w, n);
+    pValues[ResultOffset(TEST_FFT)] = SpectralTest(scratch.words, scratch);
+
+    // Pattern counts shared by the template, serial and approximate entropy tests
+    scratch.patterns.resize(SERIAL_BINS + NON_OVERLAPPING_BLOCKS * TEMPLATE_BINS);
+    uint32_t* counts = scratch.patterns.data();
+    uint32_t* blocks = counts + SERIAL_BINS;
+    CountPatterns(w, n, counts, blocks);
+
+    double M = (double)(n / NON_OVERLAPPING_BLOCKS);
+    double lambda = (M - NON_OVERLAPPING_M + 1) / std::pow(2, NON_OVERLAPPING_M);
+    double var = M * (1.0 / std::pow(2.0, NON_OVERLAPPING_M) -
+                      (2.0 * NON_OVERLAPPING_M - 1.0) / std::pow(2.0, 2.0 * NON_OVERLAPPING_M));
+    double* nonOverlapping = pValues + ResultOffset(TEST_NON_OVERLAPPING_TEMPLATE);
+    for (size_t t = 0; t < m_templates.size(); t++) {
+        double chi2 = 0.0;
+        for (int b = 0; b < NON_OVERLAPPING_BLOCKS; b++) {
+            double d = ((double)blocks[b * TEMPLATE_BINS + m_templates[t]] - lambda) / std::sqrt(var);
+            chi2 += d * d;
+        }
+        nonOverlapping[t] = StatsMath::Igamc(NON_OVERLAPPING_BLOCKS / 2.0, chi2 / 2.0);
+    }
+
+    // Serial (m = 16, 15, 14), then approximate entropy (m = 11, 10), folding in place
+    double psi[3];
+    int m = SERIAL_M;
+    for (int i = 0; i < 3; i++, m--) {
+        psi[i] = Psi2(counts, m, n);
+        FoldPatterns(counts, counts, m);
+    }
+    for (; m > APEN_M + 1; m--) FoldPatterns(counts, counts, m);
+    double apenHigh = ApEn(counts, APEN_M + 1, n);
+    FoldPatterns(counts, counts, APEN_M + 1);
+    double apen = ApEn(counts, APEN_M, n) - apenHigh;
+    double chi2 = 2.0 * (double)n * (std::log(2) - apen);
+    pValues[ResultOffset(TEST_APPROXIMATE_ENTROPY)] = StatsMath::Igamc(std::pow(2, APEN_M - 1), chi2 / 2.0);
+
+    double* serial = pValues + ResultOffset(TEST_SERIAL);
+    double del1 = psi[0] - psi[1];
+    double del2 = psi[0] - 2.0 * psi[1] + psi[2];
+    serial[0] = StatsMath::Igamc(std::pow(2, SERIAL_M - 1) / 2, del1 / 2.0);
+    serial[1] = StatsMath::Igamc(std::pow(2, SERIAL_M - 2) / 2, del2 / 2.0);
+
+    pValues[ResultOffset(TEST_OVERLAPPING_TEMPLATE)] = OverlappingTemplateTest(w, n, m_words, scratch.runs);
+    pValues[ResultOffset(TEST_UNIVERSAL)] = UniversalTest(w, n, counts);
+    RandomExcursionsTests(walk, n, pValues + ResultOffset(TEST_RANDOM_EXCURSIONS),
+                          pValues + ResultOffset(TEST_RANDOM_EXCURSIONS_VARIANT));
+    pValues[ResultOffset(TEST_LINEAR_COMPLEXITY)] = LinearComplexityTest(w, n);
+}
+
+} // namespace Stats
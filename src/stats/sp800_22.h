@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Stats {
+
+// NIST SP 800-22 rev1a statistical test suite: the 15 tests of the reference
+// implementation (sts-2.1.2) with its default parameters, producing the same
+// P-values for the same bitstream. Bits are read MSB-first within each byte,
+// as `assess` does for binary input files.
+//
+// Instead of one array element per bit the sequence is kept as packed 64-bit
+// words: frequency, runs and template counts are popcounts over shifted words,
+// the serial and approximate-entropy tests share one pattern histogram, the
+// random walk steps a byte at a time, Berlekamp-Massey works on bit vectors and
+// the spectral test uses a mixed-radix real FFT.
+//
+// An Sp800_22 instance holds only read-only tables (FFT plan, templates) and
+// can be shared by any number of threads, each with its own Scratch.
+class Sp800_22 {
+public:
+    // Tests in the order of the sts report
+    enum Test {
+        TEST_FREQUENCY,
+        TEST_BLOCK_FREQUENCY,
+        TEST_CUMULATIVE_SUMS,           // Forward, reverse
+        TEST_RUNS,
+        TEST_LONGEST_RUN,
+        TEST_RANK,
+        TEST_FFT,
+        TEST_NON_OVERLAPPING_TEMPLATE,  // One result per aperiodic 9-bit template
+        TEST_OVERLAPPING_TEMPLATE,
+        TEST_UNIVERSAL,
+        TEST_APPROXIMATE_ENTROPY,
+        TEST_RANDOM_EXCURSIONS,         // States -4..-1, 1..4
+        TEST_RANDOM_EXCURSIONS_VARIANT, // States -9..-1, 1..9
+        TEST_SERIAL,                    // Two results
+        TEST_LINEAR_COMPLEXITY,
+        TEST_COUNT
+    };
+
+    static constexpr size_t DEFAULT_STREAM_BITS = 1000000;
+    static constexpr size_t MIN_STREAM_BITS = 387840;   // Universal test needs L >= 6
+    static constexpr double ALPHA = 0.01;               // Pass threshold per P-value
+    static constexpr int RESULT_COUNT = 188;            // P-values per stream
+
+    // Per-thread working memory, reused across streams
+    struct Scratch {
+        std::vector<uint64_t> words;
+        std::vector<uint64_t> runs;
+        std::vector<double> fftRe, fftIm;
+        std::vector<uint32_t> patterns;
+    };
+
+    // `streamBits` must be a multiple of 8 and at least MIN_STREAM_BITS
+    explicit Sp800_22(size_t streamBits = DEFAULT_STREAM_BITS);
+
+    size_t StreamBits() const { return m_bits; }
+
+    // Run all tests on one stream (StreamBits() / 8 bytes). Results land at
+    // ResultOffset(test) + i; NaN marks a result that does not apply to this
+    // stream (random excursions with too few cycles), as sts leaves it out.
+    void Run(const uint8_t* stream, double pValues[RESULT_COUNT], Scratch& scratch) const;
+
+    static int ResultCount(int test);
+    static int ResultOffset(int test);
+
+    // sts report name: "Frequency", "BlockFrequency", ...
+    static const char* TestName(int test);
+
+private:
+    void LoadWords(const uint8_t* stream, std::vector<uint64_t>& words) const;
+    double SpectralTest(const std::vector<uint64_t>& words, Scratch& scratch) const;
+
+    size_t m_bits;
+    size_t m_words;                        // 64-bit words holding the stream
+
+    // FFT of StreamBits() / 2 complex points (the real input packed in pairs)
+    size_t m_fftSize;
+    std::vector<int> m_radices;            // Outermost first
+    std::vector<double> m_twRe, m_twIm;    // Per level: exp(-2 pi i q k / (R m)) at [(q - 1) m + k]
+    std::vector<size_t> m_twiddleOffsets;
+    std::vector<double> m_unscramble;      // exp(-2 pi i k / n), k <= n / 4, for the real split
+
+    std::vector<uint16_t> m_templates;     // Aperiodic 9-bit templates, ascending
+};
+
+} // namespace Stats
@@ -0,0 +1,1459 @@
+#include "sp800_90b.h"
+#include "stats_math.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define TRNG_90B_SSE2 1
+#endif
+
+// AVX2 kernel compiled alongside the baseline and picked at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define TRNG_90B_AVX2 1
+#define TRNG_90B_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Stats {
+
+static constexpr double Z_ALPHA = 2.576;        // 99% upper confidence bound (SP 800-90B 6.3)
+static constexpr int SETTLE_RANK = 5;           // Ranks within 5 of either end reject IID
+static constexpr int TUPLE_CUTOFF = 35;         // t-tuple / LRS split
+static constexpr int MARKOV_LENGTH = 128;
+static constexpr int MCW_WINDOW_COUNT = 4;
+static constexpr int MCW_WINDOWS[MCW_WINDOW_COUNT] = {63, 255, 1023, 4095};
+static constexpr int LAG_DEPTH = 128;
+static constexpr int COMPRESSION_BLOCK_BITS = 6;
+static constexpr size_t COMPRESSION_DICTIONARY = 1000;
+static constexpr int MMC_DEPTH = 16;
+static constexpr size_t MMC_MAX_ENTRIES = 100000;       // (context, symbol) counts per model
+static constexpr int LZ78Y_DEPTH = 16;
+static constexpr uint32_t LZ78Y_MAX_DICTIONARY = 65536; // Contexts over all lengths
+static constexpr int CHI_SQUARE_MIN_EXPECTED = 5;
+static constexpr int CHI_SQUARE_MAX_BLOCK_BITS = 11;
+static constexpr int GOODNESS_SUBSETS = 10;
+
+static const char* const STAT_NAMES[Sp800_90b::STAT_COUNT] = {
+    "excursion", "directional runs", "longest directional run", "increases/decreases",
+    "runs about median", "longest run about median", "average collision", "maximum collision",
+    "periodicity lag 1", "periodicity lag 2", "periodicity lag 8", "periodicity lag 16", "periodicity lag 32",
+    "covariance lag 1", "covariance lag 2", "covariance lag 8", "covariance lag 16", "covariance lag 32",
+    "compression"
+};
+
+static const char* const ESTIMATOR_NAMES[Sp800_90b::EST_COUNT] = {
+    "Most Common Value", "Collision", "Markov", "Compression", "t-Tuple", "LRS", "MultiMCW Prediction",
+    "Lag Prediction", "MultiMMC Prediction", "LZ78Y Prediction"
+};
+
+static inline int HighestBit64(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    int bit = 0;
+    while (x >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Upper 99% bound on a proportion, as min-entropy
+static double UpperBoundEntropy(double p, size_t n) {
+    double upper = std::min(1.0, p + Z_ALPHA * std::sqrt(p * (1.0 - p) / (double)(n - 1)));
+    return -std::log2(upper);
+}
+
+//=============================================================================
+// SHUFFLING
+//=============================================================================
+// xoshiro256** seeded per permutation from (seed, index), so a permutation does
+// not depend on which worker draws it
+
+static inline uint64_t SplitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+class ShuffleRng {
+public:
+    ShuffleRng(uint64_t seed, uint64_t index) {
+        uint64_t x = seed ^ (index * 0xD1B54A32D192ED03ull);
+        for (int i = 0; i < 4; i++) m_s[i] = SplitMix64(x);
+    }
+
+    uint64_t Next() {
+        uint64_t result = Rotl(m_s[1] * 5, 7) * 9;
+        uint64_t t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = Rotl(m_s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, n): multiply-shift with rejection of the biased low range
+    uint32_t Below(uint32_t n) {
+        uint64_t m = (Next() >> 32) * n;
+        if ((uint32_t)m < n) {
+            uint32_t threshold = (0u - n) % n;
+            while ((uint32_t)m < threshold) m = (Next() >> 32) * n;
+        }
+        return (uint32_t)(m >> 32);
+    }
+
+private:
+    static inline uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t m_s[4];
+};
+
+static void Shuffle(uint8_t* data, size_t n, ShuffleRng& rng) {
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j = rng.Below((uint32_t)(i + 1));
+        std::swap(data[i], data[j]);
+    }
+}
+
+//=============================================================================
+// PERMUTATION TEST STATISTICS (SP 800-90B 5.1)
+//=============================================================================
+
+// Read-only inputs shared by every permutation
+struct StatSetup {
+    int bits = 8;
+    bool binary = false;
+    size_t length = 0;
+    double mean = 0.0;
+    double median = 0.0;
+
+    // Compression statistic: adaptive code length under a Krichevsky-Trofimov
+    // model with `contextSymbols` preceding symbols as context
+    int contextSymbols = 1;
+    std::vector<double> lgHalf;         // lgamma(n + 1/2)
+    std::vector<double> lgAlphabet;     // lgamma(n + K/2), K = 2^bits
+};
+
+// Per-worker buffers
+struct StatWorkspace {
+    std::vector<uint8_t> conversion1;   // Binary input: ones per 8-bit block
+    std::vector<uint8_t> conversion2;   // Binary input: 8-bit blocks as bytes
+    std::vector<uint32_t> contextCounts;
+};
+
+static inline uint32_t StatBit(int stat) { return 1u << stat; }
+
+static constexpr uint32_t RAW_STATS = (1u << Sp800_90b::STAT_EXCURSION) |
+    (1u << Sp800_90b::STAT_MEDIAN_RUNS) | (1u << Sp800_90b::STAT_LONGEST_MEDIAN_RUN);
+static constexpr uint32_t DIRECTIONAL_STATS = (1u << Sp800_90b::STAT_DIRECTIONAL_RUNS) |
+    (1u << Sp800_90b::STAT_LONGEST_DIRECTIONAL_RUN) | (1u << Sp800_90b::STAT_INCREASES_DECREASES);
+static constexpr uint32_t COLLISION_STATS = (1u << Sp800_90b::STAT_AVERAGE_COLLISION) |
+    (1u << Sp800_90b::STAT_MAX_COLLISION);
+static constexpr uint32_t LAG_STATS = (((1u << Sp800_90b::LAG_COUNT) - 1) << Sp800_90b::STAT_PERIODICITY_FIRST) |
+    (((1u << Sp800_90b::LAG_COUNT) - 1) << Sp800_90b::STAT_COVARIANCE_FIRST);
+static constexpr uint32_t ALL_STATS = (1u << Sp800_90b::STAT_COUNT) - 1;
+
+// Excursion and the runs about the median, in one pass over the samples
+static void RawStats(const StatSetup& setup, const uint8_t* s, size_t n, double out[]) {
+    double sum = 0.0;
+    double excursion = 0.0;
+    uint64_t runs = 1, run = 0, longest = 0;
+    bool previous = s[0] >= setup.median;
+    for (size_t i = 0; i < n; i++) {
+        sum += s[i];
+        excursion = std::max(excursion, std::fabs(sum - (double)(i + 1) * setup.mean));
+        bool above = s[i] >= setup.median;
+        bool same = above == previous;
+        run = same ? run + 1 : 1;
+        runs += !same;
+        longest = std::max(longest, run);
+        previous = above;
+    }
+    out[Sp800_90b::STAT_EXCURSION] = excursion;
+    out[Sp800_90b::STAT_MEDIAN_RUNS] = (double)runs;
+    out[Sp800_90b::STAT_LONGEST_MEDIAN_RUN] = (double)longest;
+}
+
+// Runs of increases (s_i <= s_i+1) and decreases
+static void DirectionalStats(const uint8_t* s, size_t n, double out[]) {
+    uint64_t runs = 1, run = 0, longest = 0, decreases = 0;
+    bool previous = n > 1 && s[0] > s[1];
+    for (size_t i = 0; i + 1 < n; i++) {
+        bool down = s[i] > s[i + 1];
+        bool same = down == previous;
+        run = same ? run + 1 : 1;
+        runs += !same;
+        longest = std::max(longest, run);
+        decreases += down;
+        previous = down;
+    }
+    uint64_t steps = n > 1 ? n - 1 : 0;
+    out[Sp800_90b::STAT_DIRECTIONAL_RUNS] = (double)runs;
+    out[Sp800_90b::STAT_LONGEST_DIRECTIONAL_RUN] = (double)longest;
+    out[Sp800_90b::STAT_INCREASES_DECREASES] = (double)std::max(decreases, steps - decreases);
+}
+
+// Samples until a value repeats, segment after segment
+static void CollisionStats(const uint8_t* s, size_t n, double out[]) {
+    uint64_t count = 0, total = 0, longest = 0;
+    size_t i = 0;
+    while (i + 1 < n) {
+        uint64_t seen[4] = {};
+        seen[s[i] >> 6] |= 1ull << (s[i] & 63);
+        size_t j = 1;
+        for (; i + j < n; j++) {
+            uint8_t v = s[i + j];
+            uint64_t bit = 1ull << (v & 63);
+            if (seen[v >> 6] & bit) break;
+            seen[v >> 6] |= bit;
+        }
+        if (i + j >= n) break;
+        count++;
+        total += j;
+        longest = std::max<uint64_t>(longest, j);
+        i += j + 1;
+    }
+    out[Sp800_90b::STAT_AVERAGE_COLLISION] = count ? (double)total / (double)count : 0.0;
+    out[Sp800_90b::STAT_MAX_COLLISION] = (double)longest;
+}
+
+// Periodicity (s_i == s_i+lag) and covariance (sum of s_i * s_i+lag)
+static void LagStatsScalar(const uint8_t* s, size_t n, size_t lag, uint64_t& matches, uint64_t& products) {
+    for (size_t i = 0; i + lag < n; i++) {
+        matches += s[i] == s[i + lag];
+        products += (uint64_t)s[i] * s[i + lag];
+    }
+}
+
+#ifdef TRNG_90B_SSE2
+// Byte match counters wrap after 255 steps and 32-bit product lanes after
+// ~16000, so both are folded into 64-bit totals every 255 steps
+static void LagStatsSse2(const uint8_t* s, size_t n, size_t lag, uint64_t& matches, uint64_t& products) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t end = n > lag ? n - lag : 0;
+    size_t i = 0;
+    while (i + 16 <= end) {
+        size_t stop = i + 16 * std::min<size_t>(255, (end - i) / 16);
+        __m128i eqAcc = zero, prodAcc = zero;
+        for (; i < stop; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(s + i + lag));
+            eqAcc = _mm_sub_epi8(eqAcc, _mm_cmpeq_epi8(a, b));
+            prodAcc = _mm_add_epi32(prodAcc, _mm_madd_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+            prodAcc = _mm_add_epi32(prodAcc, _mm_madd_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+        }
+        __m128i eqSum = _mm_sad_epu8(eqAcc, zero);
+        matches += (uint64_t)_mm_cvtsi128_si32(eqSum) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(eqSum, 8));
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, prodAcc);
+        products += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    LagStatsScalar(s + i, n - i, lag, matches, products);
+}
+#endif
+
+#ifdef TRNG_90B_AVX2
+TRNG_90B_TARGET("avx2")
+static void LagStatsAvx2(const uint8_t* s, size_t n, size_t lag, uint64_t& matches, uint64_t& products) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t end = n > lag ? n - lag : 0;
+    size_t i = 0;
+    while (i + 32 <= end) {
+        size_t stop = i + 32 * std::min<size_t>(255, (end - i) / 32);
+        __m256i eqAcc = zero, prodAcc = zero;
+        for (; i < stop; i += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(s + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(s + i + lag));
+            eqAcc = _mm256_sub_epi8(eqAcc, _mm256_cmpeq_epi8(a, b));
+            prodAcc = _mm256_add_epi32(prodAcc, _mm256_madd_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)));
+            prodAcc = _mm256_add_epi32(prodAcc, _mm256_madd_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)));
+        }
+        uint64_t eqLanes[4];
+        _mm256_storeu_si256((__m256i*)eqLanes, _mm256_sad_epu8(eqAcc, zero));
+        matches += eqLanes[0] + eqLanes[1] + eqLanes[2] + eqLanes[3];
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, prodAcc);
+        for (int k = 0; k < 8; k++) products += lanes[k];
+    }
+    LagStatsScalar(s + i, n - i, lag, matches, products);
+}
+
+static bool HasAvx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+static void LagStats(const uint8_t* s, size_t n, uint32_t wanted, double out[]) {
+    for (int k = 0; k < Sp800_90b::LAG_COUNT; k++) {
+        if (!(wanted & (StatBit(Sp800_90b::STAT_PERIODICITY_FIRST + k) | StatBit(Sp800_90b::STAT_COVARIANCE_FIRST + k)))) continue;
+        size_t lag = (size_t)Sp800_90b::LAGS[k];
+        uint64_t matches = 0, products = 0;
+#if defined(TRNG_90B_AVX2)
+        if (HasAvx2()) LagStatsAvx2(s, n, lag, matches, products);
+        else LagStatsSse2(s, n, lag, matches, products);
+#elif defined(TRNG_90B_SSE2)
+        LagStatsSse2(s, n, lag, matches, products);
+#else
+        LagStatsScalar(s, n, lag, matches, products);
+#endif
+        out[Sp800_90b::STAT_PERIODICITY_FIRST + k] = (double)matches;
+        out[Sp800_90b::STAT_COVARIANCE_FIRST + k] = (double)products;
+    }
+}
+
+// Stands in for the bzip2 length of the reference tool: the ideal adaptive code
+// length of the samples under an order-k KT model. It only depends on the
+// context/symbol counts, so no coder is run.
+static double CompressionStat(const StatSetup& setup, const uint8_t* s, size_t n, std::vector<uint32_t>& counts) {
+    const int bits = setup.bits;
+    const uint32_t contextMask = (1u << (bits * setup.contextSymbols)) - 1;
+    counts.assign((size_t)(contextMask + 1) << bits, 0);
+    uint32_t context = 0;
+    for (size_t i = 0; i < n; i++) {
+        counts[(context << bits) | s[i]]++;
+        context = ((context << bits) | s[i]) & contextMask;
+    }
+
+    const size_t alphabet = (size_t)1 << bits;
+    double length = 0.0;
+    for (size_t c = 0; c <= contextMask; c++) {
+        const uint32_t* row = &counts[c << bits];
+        uint64_t total = 0;
+        double symbols = 0.0;
+        for (size_t x = 0; x < alphabet; x++) {
+            if (!row[x]) continue;
+            total += row[x];
+            symbols += setup.lgHalf[row[x]] - setup.lgHalf[0];
+        }
+        if (total) length += setup.lgAlphabet[total] - setup.lgAlphabet[0] - symbols;
+    }
+    return length / std::log(2.0);
+}
+
+static void ComputeStats(const StatSetup& setup, const uint8_t* s, StatWorkspace& ws, uint32_t wanted, double out[]) {
+    const size_t n = setup.length;
+    const uint8_t* runsInput = s;
+    const uint8_t* collisionInput = s;
+    size_t convertedLength = n;
+
+    // Binary input: Conversion I for the directional and lag statistics,
+    // Conversion II for the collision statistics
+    if (setup.binary && (wanted & (DIRECTIONAL_STATS | LAG_STATS | COLLISION_STATS))) {
+        convertedLength = n / 8;
+        ws.conversion1.resize(convertedLength);
+        ws.conversion2.resize(convertedLength);
+        for (size_t b = 0; b < convertedLength; b++) {
+            const uint8_t* block = s + b * 8;
+            uint8_t ones = 0, value = 0;
+            for (int k = 0; k < 8; k++) {
+                ones += block[k];
+                value = (uint8_t)((value << 1) | block[k]);
+            }
+            ws.conversion1[b] = ones;
+            ws.conversion2[b] = value;
+        }
+        runsInput = ws.conversion1.data();
+        collisionInput = ws.conversion2.data();
+    }
+
+    if (wanted & RAW_STATS) RawStats(setup, s, n, out);
+    if (wanted & DIRECTIONAL_STATS) DirectionalStats(runsInput, convertedLength, out);
+    if (wanted & COLLISION_STATS) CollisionStats(collisionInput, convertedLength, out);
+    if (wanted & LAG_STATS) LagStats(runsInput, convertedLength, wanted, out);
+    if (wanted & StatBit(Sp800_90b::STAT_COMPRESSION)) {
+        out[Sp800_90b::STAT_COMPRESSION] = CompressionStat(setup, s, n, ws.contextCounts);
+    }
+}
+
+// Shuffles claimed by index from any worker. A statistic is settled (and
+// passes) once the original has beaten and been beaten by more than 5 shuffles
+// each: it can then no longer end in either 0.05% tail of 10,000.
+class PermutationTest {
+public:
+    PermutationTest(const StatSetup& setup, const uint8_t* samples, uint64_t seed)
+        : m_setup(setup), m_samples(samples), m_seed(seed), m_pending(ALL_STATS) {
+        StatWorkspace ws;
+        ComputeStats(setup, samples, ws, ALL_STATS, m_original);
+    }
+
+    void Work() {
+        StatWorkspace ws;
+        std::vector<uint8_t> shuffled(m_setup.length);
+        double values[Sp800_90b::STAT_COUNT];
+        for (;;) {
+            uint32_t wanted = m_pending.load();
+            if (!wanted) break;
+            int index = m_next++;
+            if (index >= Sp800_90b::PERMUTATIONS) break;
+
+            memcpy(shuffled.data(), m_samples, m_setup.length);
+            ShuffleRng rng(m_seed, (uint64_t)index);
+            Shuffle(shuffled.data(), shuffled.size(), rng);
+            ComputeStats(m_setup, shuffled.data(), ws, wanted, values);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            wanted &= m_pending.load();
+            for (int stat = 0; stat < Sp800_90b::STAT_COUNT; stat++) {
+                if (!(wanted & StatBit(stat))) continue;
+                Sp800_90b::PermutationCount& c = m_counts[stat];
+                if (m_original[stat] > values[stat]) c.greater++;
+                else if (m_original[stat] == values[stat]) c.equal++;
+                else c.less++;
+                if (c.greater + c.equal > SETTLE_RANK && c.less + c.equal > SETTLE_RANK) {
+                    m_pending &= ~StatBit(stat);
+                }
+            }
+            m_completed++;
+        }
+    }
+
+    void Finish(Sp800_90b::Report& report) const {
+        report.permutationsRun = m_completed;
+        report.permutationPassed = true;
+        for (int stat = 0; stat < Sp800_90b::STAT_COUNT; stat++) {
+            Sp800_90b::PermutationCount c = m_counts[stat];
+            c.original = m_original[stat];
+            c.passed = c.greater + c.equal > SETTLE_RANK && c.less + c.equal > SETTLE_RANK;
+            report.permutation[stat] = c;
+            report.permutationPassed = report.permutationPassed && c.passed;
+        }
+    }
+
+private:
+    const StatSetup& m_setup;
+    const uint8_t* m_samples;
+    uint64_t m_seed;
+    double m_original[Sp800_90b::STAT_COUNT];
+
+    std::mutex m_mutex;
+    std::atomic<uint32_t> m_pending;
+    std::atomic<int> m_next{0};
+    int m_completed = 0;
+    Sp800_90b::PermutationCount m_counts[Sp800_90b::STAT_COUNT];
+};
+
+//=============================================================================
+// CHI-SQUARE TESTS (SP 800-90B 5.2)
+//=============================================================================
+
+// Group cells, smallest expectation first, into bins expecting >= 5 each; a
+// short last bin is merged into the one before. Returns the bin count.
+static int AllocateBins(const std::vector<double>& expected, std::vector<int>& binOf, std::vector<double>& binExpected) {
+    std::vector<size_t> order(expected.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return expected[a] < expected[b]; });
+
+    binOf.assign(expected.size(), -1);
+    binExpected.clear();
+    double open = 0.0;
+    std::vector<size_t> members;
+    for (size_t cell : order) {
+        if (expected[cell] <= 0.0) continue;
+        open += expected[cell];
+        members.push_back(cell);
+        if (open >= CHI_SQUARE_MIN_EXPECTED) {
+            for (size_t m : members) binOf[m] = (int)binExpected.size();
+            binExpected.push_back(open);
+            open = 0.0;
+            members.clear();
+        }
+    }
+    if (!members.empty()) {
+        int last = binExpected.empty() ? 0 : (int)binExpected.size() - 1;
+        if (binExpected.empty()) binExpected.push_back(0.0);
+        for (size_t m : members) binOf[m] = last;
+        binExpected[last] += open;
+    }
+    return (int)binExpected.size();
+}
+
+static double IndependenceNonBinary(const uint8_t* s, size_t n, const std::vector<uint64_t>& counts, int alphabet) {
+    const size_t pairs = n / 2;
+    std::vector<double> expected(256 * 256, 0.0);
+    for (int a = 0; a < 256; a++) {
+        for (int b = 0; b < 256; b++) {
+            expected[a * 256 + b] = (double)counts[a] / n * ((double)counts[b] / n) * pairs;
+        }
+    }
+    std::vector<int> binOf;
+    std::vector<double> binExpected;
+    int bins = AllocateBins(expected, binOf, binExpected);
+    int df = bins - alphabet;
+    if (df < 1) return 1.0;
+
+    std::vector<uint64_t> observed(bins, 0);
+    for (size_t i = 0; i + 1 < n; i += 2) {
+        int bin = binOf[s[i] * 256 + s[i + 1]];
+        if (bin >= 0) observed[bin]++;
+    }
+    double chi2 = 0.0;
+    for (int b = 0; b < bins; b++) chi2 += (observed[b] - binExpected[b]) * (observed[b] - binExpected[b]) / binExpected[b];
+    return StatsMath::ChiSquareP(chi2, df);
+}
+
+static double GoodnessNonBinary(const uint8_t* s, size_t n, const std::vector<uint64_t>& counts) {
+    std::vector<double> expected(256);
+    for (int v = 0; v < 256; v++) expected[v] = counts[v] / (double)GOODNESS_SUBSETS;
+    std::vector<int> binOf;
+    std::vector<double> binExpected;
+    int bins = AllocateBins(expected, binOf, binExpected);
+    if (bins < 2) return 1.0;
+
+    const size_t subset = n / GOODNESS_SUBSETS;
+    double chi2 = 0.0;
+    std::vector<uint64_t> observed(bins);
+    for (int d = 0; d < GOODNESS_SUBSETS; d++) {
+        std::fill(observed.begin(), observed.end(), 0);
+        for (size_t i = d * subset; i < (d + 1) * subset; i++) observed[binOf[s[i]]]++;
+        for (int b = 0; b < bins; b++) chi2 += (observed[b] - binExpected[b]) * (observed[b] - binExpected[b]) / binExpected[b];
+    }
+    return StatsMath::ChiSquareP(chi2, 9.0 * (bins - 1));
+}
+
+static double IndependenceBinary(const uint8_t* s, size_t n, double p1) {
+    double p0 = 1.0 - p1;
+    double pMin = std::min(p0, p1);
+    int m = 0;
+    for (int bits = CHI_SQUARE_MAX_BLOCK_BITS; bits >= 1; bits--) {
+        if (std::pow(pMin, bits) * (double)(n / bits) >= CHI_SQUARE_MIN_EXPECTED) {
+            m = bits;
+            break;
+        }
+    }
+    if (m < 2) return 1.0;
+
+    const size_t blocks = n / m;
+    std::vector<uint64_t> observed((size_t)1 << m, 0);
+    for (size_t b = 0; b < blocks; b++) {
+        uint32_t value = 0;
+        for (int k = 0; k < m; k++) value = (value << 1) | s[b * m + k];
+        observed[value]++;
+    }
+    double chi2 = 0.0;
+    for (size_t value = 0; value < observed.size(); value++) {
+        int ones = 0;
+        for (size_t v = value; v; v >>= 1) ones += (int)(v & 1);
+        double e = std::pow(p1, ones) * std::pow(p0, m - ones) * blocks;
+        chi2 += (observed[value] - e) * (observed[value] - e) / e;
+    }
+    return StatsMath::ChiSquareP(chi2, (double)((1 << m) - 2));
+}
+
+static double GoodnessBinary(const uint8_t* s, size_t n, double p1) {
+    const size_t subset = n / GOODNESS_SUBSETS;
+    double e1 = p1 * subset;
+    double e0 = (1.0 - p1) * subset;
+    if (e0 <= 0.0 || e1 <= 0.0) return 0.0;
+    double chi2 = 0.0;
+    for (int d = 0; d < GOODNESS_SUBSETS; d++) {
+        uint64_t ones = 0;
+        for (size_t i = d * subset; i < (d + 1) * subset; i++) ones += s[i];
+        double zeros = (double)(subset - ones);
+        chi2 += (ones - e1) * (ones - e1) / e1 + (zeros - e0) * (zeros - e0) / e0;
+    }
+    return StatsMath::ChiSquareP(chi2, GOODNESS_SUBSETS - 1);
+}
+
+//=============================================================================
+// TUPLE COUNTS (t-tuple, LRS)
+//=============================================================================
+
+struct TupleCounts {
+    int longestRepeat = 0;          // Length of the longest repeated substring
+    std::vector<uint64_t> maxCount; // [W]: occurrences of the most common W-tuple
+    std::vector<double> pairs;      // [W]: sum over W-tuples of C(count, 2)
+};
+
+// Suffix array by prefix doubling with counting sorts, then Kasai's LCP array
+// (lcp[j] = common prefix of suffixes sa[j-1] and sa[j])
+static void SuffixArray(const uint8_t* s, int n, std::vector<int>& sa, std::vector<int>& lcp) {
+    sa.resize(n);
+    std::vector<int> rank(n), tmp(n), count(std::max(n, 256) + 1, 0);
+    for (int i = 0; i < n; i++) count[s[i] + 1]++;
+    for (int v = 1; v <= 256; v++) count[v] += count[v - 1];
+    for (int i = 0; i < n; i++) sa[count[s[i]]++] = i;
+    rank[sa[0]] = 0;
+    for (int j = 1; j < n; j++) rank[sa[j]] = rank[sa[j - 1]] + (s[sa[j]] != s[sa[j - 1]]);
+    int classes = rank[sa[n - 1]] + 1;
+
+    for (int k = 1; classes < n; k <<= 1) {
+        // Order by the second half, then stable-sort by the first
+        int p = 0;
+        for (int i = n - k; i < n; i++) tmp[p++] = i;
+        for (int j = 0; j < n; j++) {
+            if (sa[j] >= k) tmp[p++] = sa[j] - k;
+        }
+        std::fill(count.begin(), count.begin() + classes + 1, 0);
+        for (int i = 0; i < n; i++) count[rank[i] + 1]++;
+        for (int c = 1; c <= classes; c++) count[c] += count[c - 1];
+        for (int j = 0; j < n; j++) sa[count[rank[tmp[j]]]++] = tmp[j];
+
+        tmp[sa[0]] = 0;
+        for (int j = 1; j < n; j++) {
+            int a = sa[j - 1], b = sa[j];
+            int secondA = a + k < n ? rank[a + k] : -1;
+            int secondB = b + k < n ? rank[b + k] : -1;
+            tmp[b] = tmp[a] + (rank[a] != rank[b] || secondA != secondB);
+        }
+        rank.swap(tmp);
+        classes = rank[sa[n - 1]] + 1;
+    }
+
+    lcp.assign(n, 0);
+    int h = 0;
+    for (int i = 0; i < n; i++) {
+        if (rank[i] == 0) {
+            h = 0;
+            continue;
+        }
+        int j = sa[rank[i] - 1];
+        while (i + h < n && j + h < n && s[i + h] == s[j + h]) h++;
+        lcp[rank[i]] = h;
+        if (h > 0) h--;
+    }
+}
+
+// Every W-tuple shared by several positions is an LCP interval: a run of
+// suffixes with common prefix >= W. Walking the intervals bottom-up yields the
+// counts for all W at once.
+static void CountTuples(const uint8_t* s, size_t n, TupleCounts& out) {
+    std::vector<int> sa, lcp;
+    SuffixArray(s, (int)n, sa, lcp);
+    int longest = 0;
+    for (int h : lcp) longest = std::max(longest, h);
+    out.longestRepeat = longest;
+
+    std::vector<uint64_t> best(longest + 2, 1);
+    std::vector<double> pairDelta(longest + 2, 0.0);
+    struct Interval { int lcp; size_t lb; };
+    std::vector<Interval> stack;
+    stack.push_back({0, 0});
+    for (size_t i = 1; i <= n; i++) {
+        int h = i < n ? lcp[i] : 0;
+        size_t lb = i - 1;
+        while (h < stack.back().lcp) {
+            Interval top = stack.back();
+            stack.pop_back();
+            uint64_t size = i - top.lb;
+            int parent = std::max(h, stack.back().lcp);
+            best[top.lcp] = std::max(best[top.lcp], size);
+            // Pairs sharing exactly W = parent+1 .. lcp symbols
+            double pairs = (double)size * (double)(size - 1) / 2.0;
+            pairDelta[parent + 1] += pairs;
+            pairDelta[top.lcp + 1] -= pairs;
+            lb = top.lb;
+        }
+        if (h > stack.back().lcp) stack.push_back({h, lb});
+    }
+
+    out.maxCount.assign(longest + 2, 1);
+    out.pairs.assign(longest + 2, 0.0);
+    uint64_t runningMax = 1;
+    for (int w = longest; w >= 1; w--) {
+        runningMax = std::max(runningMax, best[w]);
+        out.maxCount[w] = runningMax;
+    }
+    double running = 0.0;
+    for (int w = 1; w <= longest + 1; w++) {
+        running += pairDelta[w];
+        out.pairs[w] = running;
+    }
+}
+
+static double TupleEntropy(const TupleCounts& counts, size_t n) {
+    int t = 0;
+    while (t + 1 < (int)counts.maxCount.size() && counts.maxCount[t + 1] >= TUPLE_CUTOFF) t++;
+    if (t == 0) return std::numeric_limits<double>::quiet_NaN();
+    double pMax = 0.0;
+    for (int w = 1; w <= t; w++) {
+        double p = (double)counts.maxCount[w] / (double)(n - w + 1);
+        pMax = std::max(pMax, std::pow(p, 1.0 / w));
+    }
+    return UpperBoundEntropy(pMax, n);
+}
+
+static double LrsEntropy(const TupleCounts& counts, size_t n) {
+    int u = 1;
+    while (u < (int)counts.maxCount.size() && counts.maxCount[u] >= TUPLE_CUTOFF) u++;
+    int v = counts.longestRepeat;
+    if (u > v) return std::numeric_limits<double>::quiet_NaN();
+    double pMax = 0.0;
+    for (int w = u; w <= v; w++) {
+        double positions = (double)(n - w + 1);
+        double p = counts.pairs[w] / (positions * (positions - 1) / 2.0);
+        pMax = std::max(pMax, std::pow(p, 1.0 / w));
+    }
+    return UpperBoundEntropy(pMax, n);
+}
+
+//=============================================================================
+// CONTEXT TABLES (MultiMMC, LZ78Y)
+//=============================================================================
+
+// The last 16 symbols, one per byte, newest in the low byte of `recent`;
+// `packed` holds them `bits` apiece
+struct SymbolHistory {
+    int bits = 8;
+    uint64_t recent = 0;
+    uint64_t older = 0;
+    uint64_t packed = 0;
+
+    void Push(uint8_t x) {
+        older = (older << 8) | (recent >> 56);
+        recent = (recent << 8) | x;
+        packed = (packed << bits) | x;
+    }
+
+    // Hash of the newest `length` (1..16) symbols
+    uint64_t Hash(int length) const {
+        uint64_t low = length >= 8 ? recent : recent & ((1ull << (8 * length)) - 1);
+        uint64_t high = length <= 8 ? 0 : length >= 16 ? older : older & ((1ull << (8 * (length - 8))) - 1);
+        uint64_t z = (low ^ (high * 0xC2B2AE3D27D4EB4Full)) + (uint64_t)length * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+static uint64_t ContextHash(const uint8_t* context, int length) {
+    SymbolHistory history;
+    for (int k = 0; k < length; k++) history.Push(context[k]);
+    return history.Hash(length);
+}
+
+// Contexts of one length; ids are handed out by the caller. Contexts of up to
+// 16 bits index an array of ids directly, longer ones go in a hash table that
+// stores the position of an occurrence in the samples.
+class ContextTable {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr int DIRECT_BITS = 16;
+
+    ContextTable(const uint8_t* s, int length, int bits)
+        : m_s(s), m_length(length), m_direct(bits * length <= DIRECT_BITS) {
+        if (m_direct) m_ids.assign((size_t)1 << (bits * length), NONE);
+        else m_slots.resize((size_t)1 << m_bits);
+    }
+
+    // Lookup key of the newest `length` symbols of the history
+    uint64_t Key(const SymbolHistory& history) const {
+        if (m_direct) return history.packed & ((1ull << (history.bits * m_length)) - 1);
+        return history.Hash(m_length);
+    }
+
+    // Id of the context s[start .. start + length), or NONE
+    uint32_t Find(size_t start, uint64_t key) const {
+        if (m_direct) return m_ids[key];
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = key >> (64 - m_bits); ; i = (i + 1) & mask) {
+            const Slot& slot = m_slots[i];
+            if (slot.id == NONE) return NONE;
+            if (memcmp(m_s + slot.start, m_s + start, m_length) == 0) return slot.id;
+        }
+    }
+
+    // The context must not be in the table yet
+    void Insert(size_t start, uint64_t key, uint32_t id) {
+        if (m_direct) {
+            m_ids[key] = id;
+            return;
+        }
+        if (2 * (m_used + 1) > m_slots.size()) Grow();
+        Place(key, (uint32_t)start, id);
+        m_used++;
+    }
+
+private:
+    struct Slot {
+        uint32_t start = 0;
+        uint32_t id = NONE;
+    };
+
+    void Place(uint64_t hash, uint32_t start, uint32_t id) {
+        const size_t mask = m_slots.size() - 1;
+        size_t i = hash >> (64 - m_bits);
+        while (m_slots[i].id != NONE) i = (i + 1) & mask;
+        m_slots[i].start = start;
+        m_slots[i].id = id;
+    }
+
+    void Grow() {
+        std::vector<Slot> old((size_t)1 << ++m_bits);
+        old.swap(m_slots);
+        for (const Slot& slot : old) {
+            if (slot.id != NONE) Place(ContextHash(m_s + slot.start, m_length), slot.start, slot.id);
+        }
+    }
+
+    const uint8_t* m_s;
+    int m_length;
+    bool m_direct;
+    std::vector<uint32_t> m_ids;
+    int m_bits = 6;
+    size_t m_used = 0;
+    std::vector<Slot> m_slots;
+};
+
+// Occurrence counts of (context id, next symbol): two per context id for
+// binary samples, otherwise a hash table keyed id << 8 | symbol
+class PairCounts {
+public:
+    explicit PairCounts(bool binary) : m_binary(binary) {
+        if (!binary) m_slots.resize((size_t)1 << m_bits);
+    }
+
+    // Count after the increment; 0 when the pair is new and !allowNew
+    uint32_t Increment(uint32_t id, uint8_t symbol, bool allowNew) {
+        if (m_binary) {
+            size_t index = (size_t)id * 2 + symbol;
+            if (index >= m_pairs.size()) m_pairs.resize(std::max<size_t>(64, 2 * (index + 2)), 0);
+            if (m_pairs[index] == 0 && !allowNew) return 0;
+            return ++m_pairs[index];
+        }
+        const uint32_t key = id << 8 | symbol;
+        const size_t mask = m_slots.size() - 1;
+        size_t i = Index(key);
+        for (; m_slots[i].key != EMPTY; i = (i + 1) & mask) {
+            if (m_slots[i].key == key) return ++m_slots[i].count;
+        }
+        if (!allowNew) return 0;
+        if (2 * (m_used + 1) > m_slots.size()) {
+            Grow();
+            for (i = Index(key); m_slots[i].key != EMPTY; i = (i + 1) & (m_slots.size() - 1)) {}
+        }
+        m_slots[i].key = key;
+        m_slots[i].count = 1;
+        m_used++;
+        return 1;
+    }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t key = EMPTY;
+        uint32_t count = 0;
+    };
+
+    size_t Index(uint32_t key) const { return (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> (64 - m_bits)); }
+
+    void Grow() {
+        std::vector<Slot> old((size_t)1 << ++m_bits);
+        old.swap(m_slots);
+        const size_t mask = m_slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.key == EMPTY) continue;
+            size_t i = Index(slot.key);
+            while (m_slots[i].key != EMPTY) i = (i + 1) & mask;
+            m_slots[i] = slot;
+        }
+    }
+
+    bool m_binary;
+    std::vector<uint32_t> m_pairs;
+    int m_bits = 10;
+    size_t m_used = 0;
+    std::vector<Slot> m_slots;
+};
+
+//=============================================================================
+// ESTIMATORS (SP 800-90B 6.3)
+//=============================================================================
+
+static double McvEntropy(const uint8_t* s, size_t n) {
+    uint64_t counts[256] = {};
+    for (size_t i = 0; i < n; i++) counts[s[i]]++;
+    uint64_t most = *std::max_element(counts, counts + 256);
+    return UpperBoundEntropy((double)most / n, n);
+}
+
+// Binary: expected samples until a repeat, inverted for the bias
+static double CollisionEntropy(const uint8_t* s, size_t n) {
+    double sum = 0.0, sumSquares = 0.0;
+    uint64_t v = 0;
+    size_t i = 0;
+    while (i + 1 < n) {
+        int t;
+        if (s[i] == s[i + 1]) t = 2;
+        else if (i + 2 < n) t = 3;
+        else break;
+        sum += t;
+        sumSquares += (double)t * t;
+        v++;
+        i += t;
+    }
+    if (v < 2) return std::numeric_limits<double>::quiet_NaN();
+    double mean = sum / v;
+    double sigma = std::sqrt(std::max(0.0, (sumSquares - v * mean * mean) / (v - 1)));
+    double bound = mean - Z_ALPHA * sigma / std::sqrt((double)v);
+
+    // E[t] for a coin with P(more likely side) = p; falls from 2.5 at p = 1/2
+    auto expected = [](double p) {
+        double q = 1.0 - p;
+        double f = 2.0 * q * q * q + 2.0 * q * q + q;     // Gamma(3, 1/q) q^-3 e^(1/q)
+        double d = 0.5 * (1.0 / p - 1.0 / q);
+        return p / (q * q) * (1.0 + d) * f - p / q * d;
+    };
+    double p = 0.5;
+    if (bound < expected(0.5)) {
+        double lo = 0.5, hi = 1.0;
+        for (int iter = 0; iter < 60; iter++) {
+            double mid = 0.5 * (lo + hi);
+            if (expected(mid) > bound) lo = mid;
+            else hi = mid;
+        }
+        p = lo;
+    }
+    return -std::log2(p);
+}
+
+// Binary: most likely 128-bit sequence under a first-order Markov model
+static double MarkovEntropy(const uint8_t* s, size_t n) {
+    uint64_t ones = 0, transitions[2][2] = {};
+    for (size_t i = 0; i < n; i++) ones += s[i];
+    for (size_t i = 0; i + 1 < n; i++) transitions[s[i]][s[i + 1]]++;
+    double p1 = (double)ones / n, p0 = 1.0 - p1;
+    double t[2][2];
+    for (int a = 0; a < 2; a++) {
+        uint64_t from = transitions[a][0] + transitions[a][1];
+        for (int b = 0; b < 2; b++) t[a][b] = from ? (double)transitions[a][b] / from : 0.0;
+    }
+    auto lg = [](double p) { return p > 0.0 ? std::log2(p) : -std::numeric_limits<double>::infinity(); };
+    const int k = MARKOV_LENGTH;
+    double candidates[6] = {
+        lg(p0) + (k - 1) * lg(t[0][0]),
+        lg(p0) + (k / 2) * lg(t[0][1]) + (k / 2 - 1) * lg(t[1][0]),
+        lg(p0) + lg(t[0][1]) + (k - 2) * lg(t[1][1]),
+        lg(p1) + lg(t[1][0]) + (k - 2) * lg(t[0][0]),
+        lg(p1) + (k / 2) * lg(t[1][0]) + (k / 2 - 1) * lg(t[0][1]),
+        lg(p1) + (k - 1) * lg(t[1][1]),
+    };
+    double best = *std::max_element(candidates, candidates + 6);
+    return std::min(1.0, -best / k);
+}
+
+// Binary: mean log2 distance back to the previous occurrence of each 6-bit
+// block (Maurer's universal statistic), inverted for the probability of the
+// most likely block
+static double CompressionEntropy(const uint8_t* s, size_t n) {
+    const int b = COMPRESSION_BLOCK_BITS;
+    const size_t blocks = n / b;
+    const size_t d = COMPRESSION_DICTIONARY;
+    if (blocks < d + 2) return std::numeric_limits<double>::quiet_NaN();
+    const size_t v = blocks - d;
+
+    std::vector<double> lg(blocks + 1, 0.0);
+    for (size_t u = 1; u <= blocks; u++) lg[u] = std::log2((double)u);
+
+    // Block i (from 1) last seen at last[value]; 0 = not yet
+    size_t last[1 << COMPRESSION_BLOCK_BITS] = {};
+    double sum = 0.0, sumSquares = 0.0;
+    for (size_t i = 1; i <= blocks; i++) {
+        const uint8_t* block = s + (i - 1) * b;
+        int value = 0;
+        for (int k = 0; k < b; k++) value = (value << 1) | block[k];
+        if (i > d) {
+            double x = lg[last[value] ? i - last[value] : i];
+            sum += x;
+            sumSquares += x * x;
+        }
+        last[value] = i;
+    }
+    double mean = sum / v;
+    double sigma = 0.5907 * std::sqrt(std::max(0.0, sumSquares / (v - 1) - mean * mean));
+    double bound = mean - Z_ALPHA * sigma / std::sqrt((double)v);
+
+    // G(z): expected log2 distance contributed by a block of probability z,
+    // summed over u with the (1 - z)^(u-1) factor built up term by term. The
+    // sum stops once the factor leaves the normal range: a subnormal factor
+    // never rounds down to 0 and is slow to multiply.
+    auto g = [&](double z) {
+        if (z <= 0.0) return 0.0;
+        double inner = 0.0, edge = 0.0, power = 1.0;
+        for (size_t u = 1; u <= blocks && power >= std::numeric_limits<double>::min(); u++) {
+            if (u < blocks) inner += lg[u] * power * (double)(blocks - std::max(u, d));
+            if (u > d) edge += lg[u] * power;
+            power *= 1.0 - z;
+        }
+        return (z * z * inner + z * edge) / v;
+    };
+    const double others = (double)((1 << b) - 1);
+    auto expected = [&](double p) { return g(p) + others * g((1.0 - p) / others); };
+
+    double p = std::ldexp(1.0, -b);
+    if (bound < expected(p)) {
+        double lo = p, hi = 1.0;
+        for (int iter = 0; iter < 60; iter++) {
+            double mid = 0.5 * (lo + hi);
+            if (expected(mid) > bound) lo = mid;
+            else hi = mid;
+        }
+        p = lo;
+    }
+    return -std::log2(p) / b;
+}
+
+struct PredictorRun {
+    size_t predictions = 0;
+    size_t correct = 0;
+    size_t longestRun = 0;      // Longest run of correct predictions
+
+    void Record(bool hit) {
+        predictions++;
+        correct += hit;
+        m_run = hit ? m_run + 1 : 0;
+        longestRun = std::max(longestRun, m_run);
+    }
+
+private:
+    size_t m_run = 0;
+};
+
+// Larger of the global (upper-bounded hit rate) and local (longest run of
+// hits) predictability, as min-entropy
+static double PredictorEntropy(const PredictorRun& run, int alphabet) {
+    const double n = (double)run.predictions;
+    if (run.predictions < 2) return std::numeric_limits<double>::quiet_NaN();
+    double pGlobal = run.correct / n;
+    double global = run.correct == 0 ? 1.0 - std::pow(0.01, 1.0 / n)
+                                     : std::min(1.0, pGlobal + Z_ALPHA * std::sqrt(pGlobal * (1.0 - pGlobal) / (n - 1)));
+
+    // p at which a longest run below r has probability 0.99
+    const double r = (double)run.longestRun + 1;
+    auto noRun = [&](double p) {
+        double q = 1.0 - p;
+        double x = 1.0;
+        for (int j = 0; j < 10; j++) x = 1.0 + q * std::pow(p, r) * std::pow(x, r + 1);
+        return std::log((1.0 - p * x) / ((r + 1.0 - r * x) * q)) - (n + 1) * std::log(x);
+    };
+    const double target = std::log(0.99);
+    double lo = 0.0, hi = 1.0;
+    for (int iter = 0; iter < 60; iter++) {
+        double mid = 0.5 * (lo + hi);
+        if (noRun(mid) > target) lo = mid;
+        else hi = mid;
+    }
+    double predictability = std::max(std::max(global, lo), 1.0 / alphabet);
+    return -std::log2(predictability);
+}
+
+// Most common value of each of four sliding windows; the subpredictor with the
+// best record so far makes the prediction
+static double MultiMcwEntropy(const uint8_t* s, size_t n, int bits, int alphabet) {
+    const int values = 1 << bits;
+    if (n <= (size_t)MCW_WINDOWS[0] + 1) return std::numeric_limits<double>::quiet_NaN();
+
+    struct Window {
+        uint32_t counts[256];
+        int mode;
+        uint32_t modeCount;
+    };
+    Window windows[MCW_WINDOW_COUNT];
+    for (Window& w : windows) {
+        memset(w.counts, 0, sizeof(w.counts));
+        w.mode = -1;
+        w.modeCount = 0;
+    }
+    std::vector<size_t> lastSeen(256, 0);
+    uint64_t scoreboard[MCW_WINDOW_COUNT] = {};
+    int winner = 0;
+    PredictorRun run;
+
+    for (size_t i = 0; i < n; i++) {
+        const int x = s[i];
+        if (i >= (size_t)MCW_WINDOWS[0]) {
+            bool ready = i >= (size_t)MCW_WINDOWS[winner];
+            run.Record(ready && windows[winner].mode == x);
+            for (int j = 0; j < MCW_WINDOW_COUNT; j++) {
+                if (i < (size_t)MCW_WINDOWS[j] || windows[j].mode != x) continue;
+                scoreboard[j]++;
+                if (scoreboard[j] >= scoreboard[winner]) winner = j;
+            }
+        }
+
+        // Slide: s[i] enters every window, s[i - w] leaves; ties go to the
+        // value seen most recently
+        lastSeen[x] = i;
+        for (int j = 0; j < MCW_WINDOW_COUNT; j++) {
+            Window& w = windows[j];
+            if (++w.counts[x] >= w.modeCount) {
+                w.mode = x;
+                w.modeCount = w.counts[x];
+            }
+            if (i < (size_t)MCW_WINDOWS[j]) continue;
+            int y = s[i - MCW_WINDOWS[j]];
+            w.counts[y]--;
+            if (y != w.mode) continue;
+            w.modeCount = 0;
+            for (int v = 0; v < values; v++) {
+                if (w.counts[v] > w.modeCount ||
+                    (w.counts[v] == w.modeCount && w.counts[v] && lastSeen[v] > lastSeen[w.mode])) {
+                    w.mode = v;
+                    w.modeCount = w.counts[v];
+                }
+            }
+        }
+    }
+    return PredictorEntropy(run, alphabet);
+}
+
+// 128 subpredictors guessing s[i - d]. Scoreboard slot j holds lag D - j, so
+// the lagged samples are the D bytes just before s[i], compared 16 at a time.
+static double LagEntropy(const uint8_t* s, size_t n, int alphabet) {
+    if (n < 2) return std::numeric_limits<double>::quiet_NaN();
+    uint64_t scoreboard[LAG_DEPTH] = {};
+    int winner = LAG_DEPTH - 1;     // Lag 1
+    PredictorRun run;
+
+    for (size_t i = 1; i < n; i++) {
+        const uint8_t x = s[i];
+        size_t lag = (size_t)(LAG_DEPTH - winner);
+        run.Record(i >= lag && s[i - lag] == x);
+
+        if (i < (size_t)LAG_DEPTH) {
+            for (size_t d = 1; d <= i; d++) {
+                if (s[i - d] != x) continue;
+                int j = LAG_DEPTH - (int)d;
+                if (++scoreboard[j] >= scoreboard[winner]) winner = j;
+            }
+            continue;
+        }
+
+        // Match masks over the window, bit j = (s[i - D + j] == x)
+        const uint8_t* window = s + i - LAG_DEPTH;
+        uint64_t masks[LAG_DEPTH / 64];
+#ifdef TRNG_90B_SSE2
+        const __m128i needle = _mm_set1_epi8((char)x);
+        for (int half = 0; half < LAG_DEPTH / 64; half++) {
+            uint64_t m = 0;
+            for (int k = 0; k < 4; k++) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(window + half * 64 + k * 16));
+                m |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)) << (k * 16);
+            }
+            masks[half] = m;
+        }
+#else
+        for (int half = 0; half < LAG_DEPTH / 64; half++) {
+            uint64_t m = 0;
+            for (int k = 0; k < 64; k++) m |= (uint64_t)(window[half * 64 + k] == x) << k;
+            masks[half] = m;
+        }
+#endif
+        // Lags in increasing order = slots from the top down
+        for (int half = LAG_DEPTH / 64 - 1; half >= 0; half--) {
+            uint64_t m = masks[half];
+            while (m) {
+                int bit = HighestBit64(m);
+                m &= ~(1ull << bit);
+                int j = half * 64 + bit;
+                if (++scoreboard[j] >= scoreboard[winner]) winner = j;
+            }
+        }
+    }
+    return PredictorEntropy(run, alphabet);
+}
+
+// Keeps the most frequent next symbol of a context as count << 8 | symbol, so
+// ties go to the larger symbol
+static inline void UpdateBest(uint64_t& best, uint32_t count, uint8_t symbol) {
+    best = std::max(best, (uint64_t)count << 8 | symbol);
+}
+
+// Markov models of order 1..16 over the preceding symbols, each limited to
+// 100,000 (context, next symbol) counts; the model with the best record so far
+// makes the prediction. The contexts looked up to predict s[i] are the ones
+// that learn s[i] at the next step, so their ids are kept.
+static double MultiMmcEntropy(const uint8_t* s, size_t n, int bits, int alphabet) {
+    if (n < 3) return std::numeric_limits<double>::quiet_NaN();
+    std::vector<ContextTable> models;
+    for (int d = 1; d <= MMC_DEPTH; d++) models.emplace_back(s, d, bits);
+    PairCounts pairs(bits == 1);
+    std::vector<uint64_t> best;         // Per context id
+    size_t entries[MMC_DEPTH] = {};
+    uint32_t ids[MMC_DEPTH];
+    uint64_t keys[MMC_DEPTH];
+    uint64_t scoreboard[MMC_DEPTH] = {};
+    int winner = 0;                     // Order 1
+    PredictorRun run;
+    SymbolHistory history;
+    history.bits = bits;
+    history.Push(s[0]);
+
+    for (size_t i = 1; i < n; i++) {
+        // Contexts ending at s[i - 2] learn s[i - 1]
+        const int learn = (int)std::min<size_t>(MMC_DEPTH, i - 1);
+        for (int j = 0; j < learn; j++) {
+            const bool room = entries[j] < MMC_MAX_ENTRIES;
+            if (ids[j] == ContextTable::NONE) {
+                if (!room) continue;
+                ids[j] = (uint32_t)best.size();
+                models[j].Insert(i - 2 - j, keys[j], ids[j]);
+                best.push_back(0);
+            }
+            uint32_t count = pairs.Increment(ids[j], s[i - 1], room);
+            if (count == 0) continue;
+            entries[j] += count == 1;
+            UpdateBest(best[ids[j]], count, s[i - 1]);
+        }
+
+        // Contexts ending at s[i - 1] predict s[i]
+        const int x = s[i];
+        const int orders = (int)std::min<size_t>(MMC_DEPTH, i);
+        int predictions[MMC_DEPTH];
+        for (int j = 0; j < orders; j++) {
+            keys[j] = models[j].Key(history);
+            ids[j] = models[j].Find(i - 1 - j, keys[j]);
+            predictions[j] = ids[j] == ContextTable::NONE ? -1 : (int)(best[ids[j]] & 0xFF);
+        }
+        if (i >= 2) {
+            run.Record(predictions[winner] == x);
+            for (int j = 0; j < orders; j++) {
+                if (predictions[j] != x) continue;
+                if (++scoreboard[j] >= scoreboard[winner]) winner = j;
+            }
+        }
+        history.Push(s[i]);
+    }
+    return PredictorEntropy(run, alphabet);
+}
+
+// LZ78Y: a dictionary of up to 65,536 contexts of length 1..16 with counts of
+// the symbol that followed; the longest context with the highest count
+// predicts. As in MultiMMC, the prediction contexts are the next step's
+// learning contexts.
+static double Lz78yEntropy(const uint8_t* s, size_t n, int bits, int alphabet) {
+    const size_t depth = LZ78Y_DEPTH;
+    if (n < depth + 3) return std::numeric_limits<double>::quiet_NaN();
+    std::vector<ContextTable> dictionary;
+    for (int length = 1; length <= LZ78Y_DEPTH; length++) dictionary.emplace_back(s, length, bits);
+    PairCounts pairs(bits == 1);
+    std::vector<uint64_t> best;
+    uint32_t ids[LZ78Y_DEPTH];
+    uint64_t keys[LZ78Y_DEPTH];
+    PredictorRun run;
+    SymbolHistory history;
+    history.bits = bits;
+    for (size_t i = 0; i < depth; i++) history.Push(s[i]);
+
+    for (size_t i = depth; i < n; i++) {
+        // Contexts ending at s[i - 2] learn s[i - 1], longest first
+        if (i > depth) {
+            for (int j = LZ78Y_DEPTH - 1; j >= 0; j--) {
+                if (ids[j] == ContextTable::NONE) {
+                    if (best.size() >= LZ78Y_MAX_DICTIONARY) continue;
+                    ids[j] = (uint32_t)best.size();
+                    dictionary[j].Insert(i - 2 - j, keys[j], ids[j]);
+                    best.push_back(0);
+                }
+                UpdateBest(best[ids[j]], pairs.Increment(ids[j], s[i - 1], true), s[i - 1]);
+            }
+        }
+
+        // Contexts ending at s[i - 1] predict s[i]; a shorter context only
+        // overrides with a strictly higher count
+        int prediction = -1;
+        uint64_t maxCount = 0;
+        for (int j = LZ78Y_DEPTH - 1; j >= 0; j--) {
+            keys[j] = dictionary[j].Key(history);
+            ids[j] = dictionary[j].Find(i - 1 - j, keys[j]);
+            if (ids[j] == ContextTable::NONE || (best[ids[j]] >> 8) <= maxCount) continue;
+            maxCount = best[ids[j]] >> 8;
+            prediction = (int)(best[ids[j]] & 0xFF);
+        }
+        if (i > depth) run.Record(prediction == s[i]);
+        history.Push(s[i]);
+    }
+    return PredictorEntropy(run, alphabet);
+}
+
+//=============================================================================
+// ASSESSMENT
+//=============================================================================
+
+const char* Sp800_90b::StatName(int stat) {
+    return (stat >= 0 && stat < STAT_COUNT) ? STAT_NAMES[stat] : "?";
+}
+
+const char* Sp800_90b::EstimatorName(int estimator) {
+    return (estimator >= 0 && estimator < EST_COUNT) ? ESTIMATOR_NAMES[estimator] : "?";
+}
+
+Sp800_90b::Report Sp800_90b::Assess(const uint8_t* samples, size_t count, const Options& options) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Report report;
+    const int bits = std::min(8, std::max(1, options.bitsPerSymbol));
+    const uint8_t mask = (uint8_t)((1u << bits) - 1);
+    report.bitsPerSymbol = bits;
+    report.samples = count;
+    for (int e = 0; e < EST_COUNT; e++) report.original[e] = report.bitstring[e] = nan;
+    report.iidEntropy = report.nonIidEntropy = report.minEntropy = nan;
+    if (count < 2 || count > (size_t)std::numeric_limits<int>::max() / bits) return report;
+
+    std::vector<uint8_t> symbols(count);
+    std::vector<uint64_t> histogram(256, 0);
+    for (size_t i = 0; i < count; i++) {
+        symbols[i] = samples[i] & mask;
+        histogram[symbols[i]]++;
+    }
+    for (uint64_t c : histogram) report.alphabetSize += c != 0;
+    const uint8_t* s = symbols.data();
+    const bool binary = bits == 1;
+
+    std::vector<uint8_t> bitstring;
+    if (!binary) {
+        bitstring.resize(count * bits);
+        for (size_t i = 0; i < count; i++) {
+            for (int k = 0; k < bits; k++) bitstring[i * bits + k] = (symbols[i] >> (bits - 1 - k)) & 1;
+        }
+    }
+
+    // Jobs are claimed in order by whichever worker is free (largest first);
+    // workers that run out of jobs join the permutation test
+    std::vector<std::function<void()>> jobs;
+    TupleCounts tuples, bitTuples;
+    jobs.push_back([&]() { CountTuples(s, count, tuples); });
+    if (options.nonIidTrack) {
+        if (!binary) {
+            jobs.push_back([&]() { report.bitstring[EST_MULTI_MMC] = MultiMmcEntropy(bitstring.data(), bitstring.size(), 1, 2); });
+            jobs.push_back([&]() { report.bitstring[EST_LZ78Y] = Lz78yEntropy(bitstring.data(), bitstring.size(), 1, 2); });
+            jobs.push_back([&]() { CountTuples(bitstring.data(), bitstring.size(), bitTuples); });
+            jobs.push_back([&]() { report.bitstring[EST_LAG] = LagEntropy(bitstring.data(), bitstring.size(), 2); });
+            jobs.push_back([&]() { report.bitstring[EST_MULTI_MCW] = MultiMcwEntropy(bitstring.data(), bitstring.size(), 1, 2); });
+            jobs.push_back([&]() {
+                report.bitstring[EST_COLLISION] = CollisionEntropy(bitstring.data(), bitstring.size());
+                report.bitstring[EST_MARKOV] = MarkovEntropy(bitstring.data(), bitstring.size());
+                report.bitstring[EST_COMPRESSION] = CompressionEntropy(bitstring.data(), bitstring.size());
+            });
+        } else {
+            jobs.push_back([&]() {
+                report.original[EST_COLLISION] = CollisionEntropy(s, count);
+                report.original[EST_MARKOV] = MarkovEntropy(s, count);
+                report.original[EST_COMPRESSION] = CompressionEntropy(s, count);
+            });
+        }
+        jobs.push_back([&]() { report.original[EST_MULTI_MMC] = MultiMmcEntropy(s, count, bits, report.alphabetSize); });
+        jobs.push_back([&]() { report.original[EST_LZ78Y] = Lz78yEntropy(s, count, bits, report.alphabetSize); });
+        jobs.push_back([&]() { report.original[EST_LAG] = LagEntropy(s, count, report.alphabetSize); });
+        jobs.push_back([&]() { report.original[EST_MULTI_MCW] = MultiMcwEntropy(s, count, bits, report.alphabetSize); });
+    }
+    jobs.push_back([&]() {
+        report.original[EST_MCV] = McvEntropy(s, count);
+        if (!binary) report.bitstring[EST_MCV] = McvEntropy(bitstring.data(), bitstring.size());
+    });
+    // The chi-square tests take milliseconds: when they already reject IID the
+    // permutation test cannot change the verdict and is not run
+    if (options.iidTrack) {
+        if (binary) {
+            double p1 = (double)histogram[1] / count;
+            report.chiIndependenceP = IndependenceBinary(s, count, p1);
+            report.chiGoodnessP = GoodnessBinary(s, count, p1);
+        } else {
+            report.chiIndependenceP = IndependenceNonBinary(s, count, histogram, report.alphabetSize);
+            report.chiGoodnessP = GoodnessNonBinary(s, count, histogram);
+        }
+        report.chiSquarePassed = report.chiIndependenceP >= CHI_SQUARE_ALPHA && report.chiGoodnessP >= CHI_SQUARE_ALPHA;
+    }
+
+    // Permutation test setup: the mean and median of the samples are the same
+    // for every shuffle (binary samples: median 0.5 by definition)
+    StatSetup setup;
+    setup.bits = bits;
+    setup.binary = binary;
+    setup.length = count;
+    uint64_t total = 0;
+    for (int v = 0; v < 256; v++) total += histogram[v] * (uint64_t)v;
+    setup.mean = (double)total / count;
+    if (binary) {
+        setup.median = 0.5;
+    } else {
+        size_t lowIndex = (count - 1) / 2, highIndex = count / 2, seen = 0;
+        int low = -1, high = -1;
+        for (int v = 0; v < 256 && high < 0; v++) {
+            seen += histogram[v];
+            if (low < 0 && seen > lowIndex) low = v;
+            if (seen > highIndex) high = v;
+        }
+        setup.median = 0.5 * (low + high);
+    }
+    setup.contextSymbols = std::max(1, 8 / bits);
+    std::unique_ptr<PermutationTest> permutation;
+    if (options.iidTrack && report.chiSquarePassed) {
+        setup.lgHalf.resize(count + 1);
+        setup.lgAlphabet.resize(count + 1);
+        const double halfAlphabet = 0.5 * (double)(1u << bits);
+        for (size_t k = 0; k <= count; k++) {
+            setup.lgHalf[k] = std::lgamma(k + 0.5);
+            setup.lgAlphabet[k] = std::lgamma(k + halfAlphabet);
+        }
+        permutation.reset(new PermutationTest(setup, s, options.seed));
+    }
+
+    int threads = options.threads > 0 ? options.threads : (int)std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> nextJob(0);
+    auto worker = [&]() {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++) jobs[j]();
+        if (permutation) permutation->Work();
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+
+    // Tuple-based results
+    if (options.nonIidTrack) {
+        report.original[EST_T_TUPLE] = TupleEntropy(tuples, count);
+        report.original[EST_LRS] = LrsEntropy(tuples, count);
+        if (!binary) {
+            report.bitstring[EST_T_TUPLE] = TupleEntropy(bitTuples, bitstring.size());
+            report.bitstring[EST_LRS] = LrsEntropy(bitTuples, bitstring.size());
+        }
+    }
+
+    if (options.iidTrack) {
+        if (permutation) permutation->Finish(report);
+        else report.permutationPassed = false;
+
+        // LRS test: chance of a repeat as long as the longest one seen
+        double collision = 0.0;
+        for (uint64_t c : histogram) collision += ((double)c / count) * ((double)c / count);
+        const int w = tuples.longestRepeat;
+        double positions = (double)(count - w + 1);
+        double pairs = positions * (positions - 1) / 2.0;
+        report.lrsP = -std::expm1(pairs * std::log1p(-std::pow(collision, w)));
+        report.lrsPassed = report.lrsP >= CHI_SQUARE_ALPHA;
+        report.iid = report.permutationPassed && report.chiSquarePassed && report.lrsPassed;
+    }
+
+    // A bound of probability 1 comes out of -log2 as -0
+    for (int e = 0; e < EST_COUNT; e++) {
+        if (report.original[e] <= 0.0) report.original[e] = 0.0;
+        if (report.bitstring[e] <= 0.0) report.bitstring[e] = 0.0;
+    }
+
+    // H = min(H_original, bits x H_bitstring), over MCV alone for the IID track
+    auto combine = [&](int first, int last) {
+        double h = std::numeric_limits<double>::infinity();
+        for (int e = first; e <= last; e++) {
+            if (!std::isnan(report.original[e])) h = std::min(h, report.original[e]);
+            if (!std::isnan(report.bitstring[e])) h = std::min(h, bits * report.bitstring[e]);
+        }
+        return std::min(h, (double)bits);
+    };
+    report.iidEntropy = combine(EST_MCV, EST_MCV);
+    report.nonIidEntropy = combine(EST_MCV, EST_COUNT - 1);
+    report.minEntropy = (options.iidTrack && report.iid) ? report.iidEntropy : report.nonIidEntropy;
+    return report;
+}
+
+} // namespace Stats
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace Stats {
+
+// NIST SP 800-90B entropy assessment of raw noise-source samples: the IID
+// track (permutation tests, chi-square tests, LRS test, MCV estimate) and the
+// non-IID estimators MCV, collision, Markov, compression, t-tuple, LRS,
+// MultiMCW, lag, MultiMMC and LZ78Y.
+// Samples are one symbol per byte; only the low `bitsPerSymbol` bits are used,
+// as the ea_iid / ea_non_iid tools read their input.
+//
+// The 10,000 shuffles of the permutation test are spread over a thread pool
+// together with the estimators. A statistic stops being computed once its
+// rank among the shuffles can no longer reach either 0.05% tail, and the test
+// ends when every statistic has settled (all 10,000 are only run for data
+// that is not IID). Data the chi-square tests already reject skips the
+// permutation test.
+class Sp800_90b {
+public:
+    // Permutation test statistics (SP 800-90B 5.1), in report order
+    enum Stat {
+        STAT_EXCURSION,
+        STAT_DIRECTIONAL_RUNS,
+        STAT_LONGEST_DIRECTIONAL_RUN,
+        STAT_INCREASES_DECREASES,
+        STAT_MEDIAN_RUNS,
+        STAT_LONGEST_MEDIAN_RUN,
+        STAT_AVERAGE_COLLISION,
+        STAT_MAX_COLLISION,
+        STAT_PERIODICITY_FIRST,                       // One per lag
+        STAT_COVARIANCE_FIRST = STAT_PERIODICITY_FIRST + 5,
+        STAT_COMPRESSION = STAT_COVARIANCE_FIRST + 5,
+        STAT_COUNT
+    };
+    static constexpr int LAG_COUNT = 5;
+    static constexpr int LAGS[LAG_COUNT] = {1, 2, 8, 16, 32};
+
+    // Min-entropy estimators (SP 800-90B 6.3)
+    enum Estimator {
+        EST_MCV,            // Most common value (also the IID estimate)
+        EST_COLLISION,      // Binary only
+        EST_MARKOV,         // Binary only
+        EST_COMPRESSION,    // Binary only
+        EST_T_TUPLE,
+        EST_LRS,
+        EST_MULTI_MCW,
+        EST_LAG,
+        EST_MULTI_MMC,
+        EST_LZ78Y,
+        EST_COUNT
+    };
+
+    static constexpr int PERMUTATIONS = 10000;
+    static constexpr size_t DEFAULT_SAMPLES = 1000000;   // ea_* read this many unless -a
+    static constexpr double CHI_SQUARE_ALPHA = 0.001;
+
+    struct Options {
+        int bitsPerSymbol = 8;      // 1..8
+        int threads = 0;            // 0 = hardware threads
+        uint64_t seed = 0;          // Shuffle seed (same seed, same permutations)
+        bool iidTrack = true;       // Permutation, chi-square and LRS tests
+        bool nonIidTrack = true;    // Estimators beyond MCV
+    };
+
+    struct PermutationCount {
+        double original = 0.0;      // Statistic of the unshuffled samples
+        int greater = 0;            // Shuffles the original beats
+        int equal = 0;
+        int less = 0;
+        bool passed = true;
+    };
+
+    struct Report {
+        int bitsPerSymbol = 8;
+        size_t samples = 0;
+        int alphabetSize = 0;       // Distinct symbols seen
+
+        // IID track
+        int permutationsRun = 0;    // 0 = skipped (chi-square tests rejected IID)
+        PermutationCount permutation[STAT_COUNT];
+        bool permutationPassed = true;
+        double chiIndependenceP = 1.0;
+        double chiGoodnessP = 1.0;
+        bool chiSquarePassed = true;
+        double lrsP = 1.0;
+        bool lrsPassed = true;
+        bool iid = false;           // All of the above passed
+
+        // Per estimator, in bits per symbol; NaN = not run / not applicable.
+        // For bitsPerSymbol > 1 the bitstring estimates are per bit. A
+        // predictability bound of 1 is reported as 0, not -0.
+        double original[EST_COUNT];
+        double bitstring[EST_COUNT];
+
+        double iidEntropy;          // min(H_original, bits x H_bitstring) of MCV
+        double nonIidEntropy;       // Same over all estimators that ran
+        double minEntropy;          // iidEntropy when IID, else nonIidEntropy
+    };
+
+    // Assess `count` samples (at least 1000 for meaningful results; count x
+    // bitsPerSymbol below 2^31)
+    static Report Assess(const uint8_t* samples, size_t count, const Options& options);
+
+    static const char* StatName(int stat);             // "excursion", "periodicity lag 8", ...
+    static const char* EstimatorName(int estimator);   // "Most Common Value", ...
+};
+
+} // namespace Stats
@@ -0,0 +1,85 @@
+#include "stats_math.h"
+#include <cmath>
+
+namespace Stats {
+
+static constexpr double MACHEP = 1.11022302462515654042e-16;   // 2^-53
+static constexpr double MAXLOG = 7.09782712893383996843e2;     // log(DBL_MAX)
+static constexpr double BIG = 4.503599627370496e15;
+static constexpr double BIGINV = 2.22044604925031308085e-16;
+
+double StatsMath::Igam(double a, double x) {
+    if (x <= 0.0 || a <= 0.0) return 0.0;
+    if (x > 1.0 && x > a) return 1.0 - Igamc(a, x);
+
+    double ax = a * std::log(x) - x - std::lgamma(a);
+    if (ax < -MAXLOG) return 0.0;
+    ax = std::exp(ax);
+
+    // Power series
+    double r = a;
+    double c = 1.0;
+    double ans = 1.0;
+    do {
+        r += 1.0;
+        c *= x / r;
+        ans += c;
+    } while (c / ans > MACHEP);
+    return ans * ax / a;
+}
+
+double StatsMath::Igamc(double a, double x) {
+    if (x <= 0.0 || a <= 0.0) return 1.0;
+    if (x < 1.0 || x < a) return 1.0 - Igam(a, x);
+
+    double ax = a * std::log(x) - x - std::lgamma(a);
+    if (ax < -MAXLOG) return 0.0;
+    ax = std::exp(ax);
+
+    // Continued fraction
+    double y = 1.0 - a;
+    double z = x + y + 1.0;
+    double c = 0.0;
+    double pkm2 = 1.0;
+    double qkm2 = x;
+    double pkm1 = x + 1.0;
+    double qkm1 = z * x;
+    double ans = pkm1 / qkm1;
+    double t;
+    do {
+        c += 1.0;
+        y += 1.0;
+        z += 2.0;
+        double yc = y * c;
+        double pk = pkm1 * z - pkm2 * yc;
+        double qk = qkm1 * z - qkm2 * yc;
+        if (qk != 0.0) {
+            double r = pk / qk;
+            t = std::fabs((ans - r) / r);
+            ans = r;
+        } else {
+            t = 1.0;
+        }
+        pkm2 = pkm1;
+        pkm1 = pk;
+        qkm2 = qkm1;
+        qkm1 = qk;
+        if (std::fabs(pk) > BIG) {
+            pkm2 *= BIGINV;
+            pkm1 *= BIGINV;
+            qkm2 *= BIGINV;
+            qkm1 *= BIGINV;
+        }
+    } while (t > MACHEP);
+    return ans * ax;
+}
+
+double StatsMath::ChiSquareP(double chi2, double df) {
+    return Igamc(df / 2.0, chi2 / 2.0);
+}
+
+double StatsMath::NormalP(double z) {
+    return std::erfc(std::fabs(z) / std::sqrt(2.0));
+}
+
+} // namespace Stats
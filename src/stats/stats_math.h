@@ -0,0 +1,22 @@
+#pragma once
+
+namespace Stats {
+
+// Special functions for test-statistic p-values (Cephes algorithms, as used by
+// the NIST SP 800-22 reference code)
+class StatsMath {
+public:
+    // Regularized lower incomplete gamma P(a, x)
+    static double Igam(double a, double x);
+
+    // Regularized upper incomplete gamma Q(a, x) = 1 - P(a, x)
+    static double Igamc(double a, double x);
+
+    // Upper tail of a chi-square distribution with `df` degrees of freedom
+    static double ChiSquareP(double chi2, double df);
+
+    // Two-sided p-value of a standard normal statistic: erfc(|z| / sqrt(2))
+    static double NormalP(double z);
+};
+
+} // namespace Stats
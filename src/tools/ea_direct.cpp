@@ -0,0 +1,200 @@
+/*
+ * ea_direct.cpp — Native SP 800-90B entropy assessment of raw noise samples
+ *
+ * Runs the IID track (permutation tests, chi-square and LRS tests) and the
+ * non-IID estimators of src/stats/sp800_90b.cpp over one or more raw sample
+ * dumps, one file per noise source, and reports min-entropy per source.
+ * Replaces `ea_iid` / `ea_non_iid` for routine re-certification: the
+ * permutation shuffles and estimators run on all cores and stop as soon as
+ * the IID verdict is settled.
+ *
+ * Input files hold one sample per byte, as written for the NIST tools; only
+ * the low <bits> bits of each byte are used. Like the NIST tools, the first
+ * 1,000,000 samples are assessed unless -a is given.
+ *
+ * Usage:
+ *   ./ea_direct mic.bin jitter.bin          (8 bits per sample)
+ *   ./ea_direct -b 1 -a drift.bin
+ *   ./ea_direct -i -t 4 -s 1 source.bin     (IID track only, fixed shuffle seed)
+ *
+ * Build:
+ *   g++ -std=c++17 -O3 -o ea_direct src/tools/ea_direct.cpp src/stats/sp800_90b.cpp \
+ *       src/stats/stats_math.cpp src/platform/mapped_file.cpp -lpthread
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../stats/sp800_90b.h"
+#include "../platform/mapped_file.h"
+
+using Stats::Sp800_90b;
+
+struct EaOptions {
+    Sp800_90b::Options assess;
+    bool allSamples = false;
+    size_t samples = Sp800_90b::DEFAULT_SAMPLES;
+    bool seedGiven = false;
+    std::vector<std::string> inputs;
+};
+
+static void Usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-b bits] [-a | -l samples] [-t threads] [-s seed] [-i | -n] file [file ...]\n"
+        "  -b <bits>     Bits per sample, 1-8 (default 8); the low bits of each byte are used\n"
+        "  -a            Assess every sample in the file (default: first %zu)\n"
+        "  -l <count>    Assess the first <count> samples\n"
+        "  -t <count>    Worker threads (default: all hardware threads)\n"
+        "  -s <seed>     Shuffle seed for reproducible permutation tests (default: random)\n"
+        "  -i            IID track only (permutation, chi-square, LRS tests and MCV)\n"
+        "  -n            Non-IID track only (estimators)\n",
+        prog, Sp800_90b::DEFAULT_SAMPLES);
+}
+
+static void PrintEstimate(const char* name, double original, double bitstring, bool showBitstring) {
+    char first[32] = "      -", second[32] = "      -";
+    if (!std::isnan(original)) snprintf(first, sizeof(first), "%9.6f", original);
+    if (!std::isnan(bitstring)) snprintf(second, sizeof(second), "%9.6f", bitstring);
+    if (showBitstring) printf("  %-28s %9s  %9s\n", name, first, second);
+    else printf("  %-28s %9s\n", name, first);
+}
+
+static void PrintReport(const std::string& name, const Sp800_90b::Report& r, const Sp800_90b::Options& opt, double seconds) {
+    printf("== %s\n", name.c_str());
+    printf("%zu samples, %d bit%s per sample, %d distinct values (%.1f s)\n\n",
+           r.samples, r.bitsPerSymbol, r.bitsPerSymbol == 1 ? "" : "s", r.alphabetSize, seconds);
+
+    if (opt.iidTrack) {
+        if (r.permutationsRun == 0) {
+            printf("IID permutation tests: skipped, the chi-square tests reject IID\n");
+        } else {
+            printf("IID permutation tests (%d shuffles):\n", r.permutationsRun);
+            printf("  %-28s %16s %7s %7s %7s\n", "statistic", "original", ">", "=", "<");
+            for (int stat = 0; stat < Sp800_90b::STAT_COUNT; stat++) {
+                const Sp800_90b::PermutationCount& c = r.permutation[stat];
+                printf("  %-28s %16.4f %7d %7d %7d  %s\n", Sp800_90b::StatName(stat), c.original,
+                       c.greater, c.equal, c.less, c.passed ? "pass" : "FAIL");
+            }
+        }
+        printf("Chi-square independence      p = %.6f  %s\n", r.chiIndependenceP,
+               r.chiIndependenceP >= Sp800_90b::CHI_SQUARE_ALPHA ? "pass" : "FAIL");
+        printf("Chi-square goodness-of-fit   p = %.6f  %s\n", r.chiGoodnessP,
+               r.chiGoodnessP >= Sp800_90b::CHI_SQUARE_ALPHA ? "pass" : "FAIL");
+        printf("Longest repeated substring   p = %.6f  %s\n", r.lrsP, r.lrsPassed ? "pass" : "FAIL");
+        printf("IID assumption: %s\n\n", r.iid ? "not rejected" : "REJECTED");
+    }
+
+    const bool showBitstring = r.bitsPerSymbol > 1;
+    printf("Min-entropy estimates (bits per %s):\n", showBitstring ? "sample / per bit" : "sample");
+    for (int e = 0; e < Sp800_90b::EST_COUNT; e++) {
+        if (std::isnan(r.original[e]) && std::isnan(r.bitstring[e])) continue;
+        PrintEstimate(Sp800_90b::EstimatorName(e), r.original[e], r.bitstring[e], showBitstring);
+    }
+    if (opt.iidTrack) printf("H (IID track)      = %.6f\n", r.iidEntropy);
+    if (opt.nonIidTrack) printf("H (non-IID track)  = %.6f\n", r.nonIidEntropy);
+    printf("Assessed min-entropy: %.6f bits per sample\n\n", r.minEntropy);
+}
+
+static bool ParseCount(const char* text, uint64_t& value) {
+    char* end = nullptr;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (end == text || *end != '\0') return false;
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    EaOptions opt;
+    for (int i = 1; i < argc; i++) {
+        uint64_t value = 0;
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-b") == 0 && hasValue && ParseCount(argv[i + 1], value) && value >= 1 && value <= 8) {
+            opt.assess.bitsPerSymbol = (int)value;
+            i++;
+        } else if (strcmp(argv[i], "-a") == 0) {
+            opt.allSamples = true;
+        } else if (strcmp(argv[i], "-l") == 0 && hasValue && ParseCount(argv[i + 1], value) && value > 0) {
+            opt.samples = (size_t)value;
+            i++;
+        } else if (strcmp(argv[i], "-t") == 0 && hasValue && ParseCount(argv[i + 1], value)) {
+            opt.assess.threads = (int)value;
+            i++;
+        } else if (strcmp(argv[i], "-s") == 0 && hasValue && ParseCount(argv[i + 1], value)) {
+            opt.assess.seed = value;
+            opt.seedGiven = true;
+            i++;
+        } else if (strcmp(argv[i], "-i") == 0) {
+            opt.assess.nonIidTrack = false;
+        } else if (strcmp(argv[i], "-n") == 0) {
+            opt.assess.iidTrack = false;
+        } else if (argv[i][0] != '-') {
+            opt.inputs.push_back(argv[i]);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opt.inputs.empty() || (!opt.assess.iidTrack && !opt.assess.nonIidTrack)) {
+        Usage(argv[0]);
+        return 1;
+    }
+    if (!opt.seedGiven) {
+        std::random_device rd;
+        opt.assess.seed = ((uint64_t)rd() << 32) ^ rd();
+    }
+
+    struct Summary {
+        std::string name;
+        size_t samples;
+        bool iid;
+        double entropy;
+    };
+    std::vector<Summary> summaries;
+    int failures = 0;
+
+    for (const std::string& path : opt.inputs) {
+        MappedFile file;
+        std::string error;
+        if (!file.Open(path, error)) {
+            fprintf(stderr, "ea_direct: %s\n", error.c_str());
+            failures++;
+            continue;
+        }
+        size_t count = (size_t)file.Size();
+        if (!opt.allSamples) count = std::min(count, opt.samples);
+        size_t limit = (size_t)0x7FFFFFFF / (size_t)opt.assess.bitsPerSymbol;
+        if (count > limit) {
+            fprintf(stderr, "ea_direct: %s: assessing the first %zu samples\n", path.c_str(), limit);
+            count = limit;
+        }
+        if (count < 1000) {
+            fprintf(stderr, "ea_direct: %s holds too few samples (%zu)\n", path.c_str(), count);
+            failures++;
+            continue;
+        }
+        file.AdviseSequential();
+
+        const auto start = std::chrono::steady_clock::now();
+        Sp800_90b::Report report = Sp800_90b::Assess(file.Data(), count, opt.assess);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        PrintReport(path, report, opt.assess, seconds);
+        fflush(stdout);
+        summaries.push_back({path, count, report.iid, report.minEntropy});
+    }
+
+    if (summaries.size() > 1) {
+        printf("%-32s %10s %5s %12s\n", "source", "samples", "IID", "H_min/sample");
+        for (const Summary& s : summaries) {
+            printf("%-32s %10zu %5s %12.6f\n", s.name.c_str(), s.samples,
+                   opt.assess.iidTrack ? (s.iid ? "yes" : "no") : "-", s.entropy);
+        }
+    }
+    return failures ? 1 : 0;
+}
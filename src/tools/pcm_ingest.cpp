@@ -0,0 +1,200 @@
+// pcm_ingest.cpp — Headless PCM audio entropy ingestion and throughput test
+//
+// Usage:  ./pcm_ingest capture.wav                        (WAV: format from header)
+//         ./pcm_ingest --raw s16 /dev/adc0                 (headerless PCM device)
+//         arecord -f S16_LE -t raw | ./pcm_ingest --raw s16 -
+//         ./pcm_ingest --emit capture.wav | RNG_test stdin64   (packed LSB words)
+//         ./pcm_ingest --capture lsb.bin --samples 1000000 capture.wav  (SP 800-90B samples)
+//
+// Runs the input through the same LSB extraction, packing and RMS health gate
+// as the microphone source, then reports throughput on stderr.
+// With --emit the packed 64-bit words are written to stdout (little-endian).
+// With --capture the LSBs are written one sample per byte for ea_iid /
+// ea_non_iid / ea_direct, before any pooling or conditioning.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "../entropy/pcm_file/pcm_file.h"
+#include "../entropy/noise_export.h"
+#include "../logging/logger.h"
+
+static void PrintUsage() {
+    fprintf(stderr,
+        "Usage: pcm_ingest [options] <path|->\n"
+        "  --raw <s16|s32|f32>  Headerless PCM in the given sample format (default: parse WAV)\n"
+        "  --shift <n>          Raw 32-bit only: padding bits below the LSB (8 for 24-in-32)\n"
+        "  --window <samples>   Health-gate window size (default 4800)\n"
+        "  --emit               Write packed 64-bit LSB words to stdout\n"
+        "  --capture <path>     Write raw LSB samples, one per byte (SP 800-90B format)\n"
+        "  --bits <1-8>         Capture: bits per sample (default 1)\n"
+        "  --samples <n>        Capture: stop after n samples (default 1000000, 0 = all)\n"
+        "  --mmap               Capture: write through a memory-mapped file\n"
+        "  --verbose            Log to stdout/logs directory\n");
+}
+
+static bool ParseRawFormat(const char* s, Entropy::PcmFormat& out) {
+    if (strcmp(s, "s16") == 0) out = Entropy::PcmFormat::Int16;
+    else if (strcmp(s, "s32") == 0) out = Entropy::PcmFormat::Int32;
+    else if (strcmp(s, "f32") == 0) out = Entropy::PcmFormat::Float32;
+    else return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Entropy::PcmFileConfig config;
+    bool emit = false;
+    bool verbose = false;
+    std::string capturePath;
+    Entropy::NoiseSampleFormat captureFormat = Entropy::DefaultNoiseSampleFormat(Entropy::EntropySource::PcmAudio);
+    uint64_t captureSamples = 1000000;
+    Entropy::NoiseExportOutput captureOutput = Entropy::NoiseExportOutput::Buffered;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--raw" && i + 1 < argc) {
+            config.rawInput = true;
+            if (!ParseRawFormat(argv[++i], config.rawFormat)) {
+                fprintf(stderr, "Unknown raw format: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--shift" && i + 1 < argc) {
+            config.rawLsbShift = atoi(argv[++i]);
+            if (config.rawLsbShift < 0 || config.rawLsbShift > 31) {
+                fprintf(stderr, "--shift must be 0-31\n");
+                return 1;
+            }
+        } else if (arg == "--window" && i + 1 < argc) {
+            long long w = atoll(argv[++i]);
+            if (w < 64) {
+                fprintf(stderr, "--window must be at least 64 samples\n");
+                return 1;
+            }
+            config.windowSamples = (size_t)w;
+        } else if (arg == "--emit") {
+            emit = true;
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--bits" && i + 1 < argc) {
+            int bits = atoi(argv[++i]);
+            if (bits < 1 || bits > 8 || 64 % bits != 0) {
+                fprintf(stderr, "--bits must be 1, 2, 4 or 8\n");
+                return 1;
+            }
+            // Consecutive LSBs of the packed word form one sample
+            captureFormat.bitsPerSample = bits;
+            captureFormat.samplesPerValue = 64 / bits;
+        } else if (arg == "--samples" && i + 1 < argc) {
+            captureSamples = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--mmap") {
+            captureOutput = Entropy::NoiseExportOutput::Mapped;
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (config.path.empty() && (arg == "-" || arg[0] != '-')) {
+            config.path = arg;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (config.path.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (verbose) {
+        Logger::Init("logs");
+        Logger::SetEnabled(true);
+    }
+
+    if (emit) {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        static char outBuf[4 * 1024 * 1024];
+        setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+    }
+
+    Entropy::RawNoiseExporter exporter;
+    if (!capturePath.empty()) {
+        std::string error;
+        if (!exporter.AddSource(Entropy::EntropySource::PcmAudio, capturePath, captureFormat,
+                                captureSamples, captureOutput, error)) {
+            fprintf(stderr, "--capture: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    Entropy::PcmFileCollector collector;
+    collector.Configure(config);
+
+    std::atomic<bool> keepRunning{true};
+    uint64_t words = 0;
+    bool writeFailed = false;
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = collector.Run([&](const std::vector<Entropy::EntropyDataPoint>& points) {
+        words += points.size();
+        if (!capturePath.empty()) {
+            exporter.Tap(Entropy::EntropySource::PcmAudio, points);
+            // Capture-only runs end once the sample target is reached
+            if (!emit && !exporter.IsActive()) keepRunning = false;
+        }
+        if (!emit || writeFailed) return;
+        for (const auto& pt : points) {
+            uint8_t le[8];
+            for (int b = 0; b < 8; b++) le[b] = (uint8_t)(pt.value >> (8 * b));
+            if (fwrite(le, 1, sizeof(le), stdout) != sizeof(le)) {
+                // Reader closed the pipe; stop early
+                writeFailed = true;
+                keepRunning = false;
+                return;
+            }
+        }
+    }, keepRunning);
+    if (emit) fflush(stdout);
+    uint64_t captured = exporter.SamplesWritten(Entropy::EntropySource::PcmAudio);
+    std::string captureError;
+    bool captureOk = exporter.Stop(captureError);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!ok) {
+        fprintf(stderr, "Failed to read %s\n", config.path.c_str());
+        Logger::Shutdown();
+        return 1;
+    }
+
+    double mb = collector.GetBytesRead() / (1024.0 * 1024.0);
+    fprintf(stderr, "Input:     %.2f MB in %.3f s (%.1f MB/s)\n", mb, seconds, seconds > 0 ? mb / seconds : 0.0);
+    fprintf(stderr, "Output:    %llu words (%llu bits)\n",
+            (unsigned long long)words, (unsigned long long)words * 64);
+    fprintf(stderr, "Rejected:  %llu windows (RMS <= %.1f)\n",
+            (unsigned long long)collector.GetRejectedWindows(), Entropy::PCM_DEAD_RMS_THRESHOLD);
+    if (!capturePath.empty()) {
+        fprintf(stderr, "Captured:  %llu %d-bit samples to %s\n",
+                (unsigned long long)captured, captureFormat.bitsPerSample, capturePath.c_str());
+        if (!captureOk) {
+            fprintf(stderr, "Capture failed: %s\n", captureError.c_str());
+            Logger::Shutdown();
+            return 1;
+        }
+    }
+
+    Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * pcm_kernel_check.cpp — Scalar/SIMD agreement check for the PCM kernels
+ *
+ * Each kernel runs an SSE2 body over whole groups of samples and a scalar
+ * loop over the tail. The two must extract the same LSBs and energy, or a
+ * sample's contribution would depend on where a packet boundary falls. This
+ * check runs every format over the same buffer twice: once in a single call
+ * (SIMD body + tail) and once one sample per call (scalar only), and compares
+ * the packed words and the sum of squares. The Float32 buffers carry NaN,
+ * +-inf and +-1e10 samples both in SIMD lanes and in the tail; those must map
+ * to INT32_MIN as _mm_cvttps_epi32 does. On x86 a plain float->int cast
+ * happens to give the same value, so build with UBSan to catch the undefined
+ * conversion itself.
+ * Exits with status 1 if any expectation fails.
+ *
+ * Usage:
+ *   ./pcm_kernel_check
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -fsanitize=undefined,float-cast-overflow -fno-sanitize-recover=all \
+ *       -o pcm_kernel_check src/tools/pcm_kernel_check.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "../entropy/microphone/pcm_kernels.h"
+
+using namespace Entropy;
+
+struct Run {
+    std::vector<EntropyDataPoint> out;
+    PcmBitPacker packer;
+    double sumSquares = 0.0;
+};
+
+static void RunWhole(PcmFormat format, const std::vector<uint8_t>& data, size_t samples, int shift, Run& run) {
+    run.sumSquares += ExtractPcmPacket(format, data.data(), samples, shift, 0, EntropySource::PcmAudio,
+                                       run.packer, run.out).sumSquares;
+}
+
+static void RunScalar(PcmFormat format, const std::vector<uint8_t>& data, size_t samples, int shift, Run& run) {
+    const size_t bytes = PcmBytesPerSample(format);
+    for (size_t i = 0; i < samples; i++) {
+        run.sumSquares += ExtractPcmPacket(format, data.data() + i * bytes, 1, shift, 0, EntropySource::PcmAudio,
+                                           run.packer, run.out).sumSquares;
+    }
+}
+
+static int Expect(bool ok, const char* what) {
+    printf("  %-64s %s\n", what, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+// Both paths must pack identical words; squares are summed in a different
+// order, so the energy only has to agree to rounding
+static int Compare(const char* name, PcmFormat format, const std::vector<uint8_t>& data, size_t samples,
+                   int shift = 0) {
+    Run whole, scalar;
+    RunWhole(format, data, samples, shift, whole);
+    RunScalar(format, data, samples, shift, scalar);
+    bool same = whole.out.size() == scalar.out.size() && whole.packer.accumulator == scalar.packer.accumulator &&
+                whole.packer.bitsCollected == scalar.packer.bitsCollected;
+    for (size_t i = 0; same && i < whole.out.size(); i++) {
+        same = whole.out[i].value == scalar.out[i].value;
+    }
+    double tolerance = 1e-12 * std::fmax(1.0, std::fabs(scalar.sumSquares));
+    same = same && std::fabs(whole.sumSquares - scalar.sumSquares) <= tolerance;
+    return Expect(same, name);
+}
+
+static uint64_t SplitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int main() {
+    int failures = 0;
+    uint64_t x = 1;
+
+#ifdef TRNG_PCM_SSE2
+    printf("SSE2 kernels vs scalar tail\n");
+#else
+    printf("no SSE2: scalar kernels only\n");
+#endif
+
+    // 203 samples: not a multiple of 4 or 16, so every format has a tail
+    const size_t N = 203;
+    {
+        std::vector<uint8_t> data(N * 2);
+        for (size_t i = 0; i < data.size(); i += 8) {
+            uint64_t v = SplitMix64(x);
+            memcpy(data.data() + i, &v, std::min<size_t>(8, data.size() - i));
+        }
+        failures += Compare("Int16", PcmFormat::Int16, data, N);
+    }
+    {
+        std::vector<uint8_t> data(N * 4);
+        for (size_t i = 0; i < data.size(); i += 4) {
+            uint32_t v = (uint32_t)SplitMix64(x);
+            memcpy(data.data() + i, &v, 4);
+        }
+        failures += Compare("Int32", PcmFormat::Int32, data, N);
+        failures += Compare("Int32, 24-in-32 (shift 8)", PcmFormat::Int32, data, N, 8);
+    }
+
+    const float specials[] = {std::numeric_limits<float>::quiet_NaN(), 1e10f, -1e10f,
+                              std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                              1.0f, -1.0f, 65536.0f, -65536.0f};
+    {
+        // Audio-range floats with the special values scattered through SIMD lanes and the tail
+        std::vector<float> samples(N);
+        for (size_t i = 0; i < N; i++) {
+            samples[i] = (float)((double)(int32_t)SplitMix64(x) / 2147483648.0);
+        }
+        for (size_t k = 0; k < sizeof(specials) / sizeof(specials[0]); k++) {
+            samples[k * 13 + 3] = specials[k];
+        }
+        samples[N - 3] = specials[0];
+        samples[N - 2] = specials[1];
+        samples[N - 1] = specials[2];
+        std::vector<uint8_t> data(N * 4);
+        memcpy(data.data(), samples.data(), data.size());
+        failures += Compare("Float32 with NaN/inf/1e10 in lanes and tail", PcmFormat::Float32, data, N);
+    }
+    {
+        // Tail-only packet: NaN, +1e10, -1e10 each become INT32_MIN (LSB 0, square 2^62)
+        const float tail[3] = {std::numeric_limits<float>::quiet_NaN(), 1e10f, -1e10f};
+        std::vector<uint8_t> data(sizeof(tail));
+        memcpy(data.data(), tail, sizeof(tail));
+        Run run;
+        RunWhole(PcmFormat::Float32, data, 3, 0, run);
+        const double expected = 3.0 * (double)INT32_MIN * (double)INT32_MIN;
+        failures += Expect(run.packer.bitsCollected == 3 && run.packer.accumulator == 0,
+                           "Float32 tail NaN/+-1e10: LSBs of INT32_MIN");
+        failures += Expect(run.sumSquares == expected, "Float32 tail NaN/+-1e10: squares of INT32_MIN");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
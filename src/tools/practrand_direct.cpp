@@ -0,0 +1,198 @@
+/*
+ * practrand_direct.cpp — In-process PractRand driver linked against libtrng
+ *
+ * Plugs the libtrng buffered fill into PractRand as a vRNG32 and runs the same
+ * battery as RNG_test's default (core tests plus standard folding), replacing
+ * `trng_gen | RNG_test stdin32`. Words come straight out of 4 MiB
+ * buffers that producer threads (trng_prefetch.c) refill while tests run.
+ * Results are reported at every power of two, in the RNG_test layout.
+ *
+ * Usage:
+ *   ./practrand_direct                  (runs to 32 TB)
+ *   ./practrand_direct -tlmax 1TB -t 3
+ *   ./practrand_direct -tf 2            (extra folding, as RNG_test -tf 2)
+ *
+ * Build (PractRand source tree in $PRACTRAND_DIR, after ./build_lib.sh):
+ *   g++ -std=c++14 -O3 -DWIN32 -o practrand_direct src/tools/practrand_direct.cpp \
+ *       src/tools/trng_prefetch.c $(find $PRACTRAND_DIR/src -name "*.cpp") \
+ *       -I src/lib -I $PRACTRAND_DIR/include -I $PRACTRAND_DIR/tools \
+ *       build/lib/libtrng.a -lpthread -lbcrypt
+ * On Linux drop -DWIN32 -lbcrypt.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "PractRand/config.h"
+#include "PractRand.h"
+#include "PractRand/RNGs/hc256.h"
+#include "PractRand/Tests/Batteries.h"
+#include "TestManager.h"
+
+#include "trng_prefetch.h"
+
+// Thresholds on min(p, 1-p), matching RNG_test's "unusual" and "FAIL" bands
+static const double UNUSUAL_P = 1e-3;
+static const double FAIL_P = 1e-12;
+
+class LibTrngRNG : public PractRand::RNGs::vRNG32 {
+public:
+    explicit LibTrngRNG(trng_prefetch* feed) : feed(feed), words(nullptr), pos(0), len(0) {}
+
+    PractRand::Uint32 raw32() override {
+        if (pos >= len) Refill();
+        return words[pos++];
+    }
+    std::string get_name() const override { return "libtrng"; }
+    void walk_state(PractRand::StateWalkingObject*) override {}  // Not reproducible by design
+
+private:
+    void Refill() {
+        size_t bytes = 0;
+        const uint8_t* buf = trng_prefetch_next(feed, &bytes);
+        if (!buf) {
+            fprintf(stderr, "practrand_direct: generator failed\n");
+            exit(1);
+        }
+        words = reinterpret_cast<const PractRand::Uint32*>(buf);
+        len = bytes / sizeof(PractRand::Uint32);
+        pos = 0;
+    }
+
+    trng_prefetch* feed;
+    const PractRand::Uint32* words;
+    size_t pos;
+    size_t len;
+};
+
+// "512MB", "2TB", "4G" -> bytes (0 on error)
+static PractRand::Uint64 ParseSize(const char* text) {
+    char* end = nullptr;
+    double value = strtod(text, &end);
+    if (end == text || value <= 0) return 0;
+    double scale = 1;
+    switch (*end) {
+        case 'K': case 'k': scale = 1024.0; break;
+        case 'M': case 'm': scale = 1024.0 * 1024; break;
+        case 'G': case 'g': scale = 1024.0 * 1024 * 1024; break;
+        case 'T': case 't': scale = 1024.0 * 1024 * 1024 * 1024; break;
+        case '\0': break;
+        default: return 0;
+    }
+    return (PractRand::Uint64)(value * scale);
+}
+
+static std::string FormatSize(PractRand::Uint64 bytes) {
+    int log2 = 0;
+    while ((1ull << (log2 + 1)) <= bytes) log2++;
+    static const char* units[] = {"bytes", "KB", "MB", "GB", "TB", "PB"};
+    char text[64];
+    snprintf(text, sizeof(text), "2^%d bytes (%llu %s)", log2,
+             (unsigned long long)(bytes >> (log2 / 10 * 10)), units[log2 / 10]);
+    return text;
+}
+
+static void Usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-tlmin SIZE] [-tlmax SIZE] [-tf 0|1|2] [-t producer_threads]\n"
+        "  -tf <n>   Folding as in RNG_test: 0 = none (core tests only),\n"
+        "            1 = standard (default), 2 = extra\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    PractRand::Uint64 minBytes = 1ull << 27;  // 128 MB, RNG_test's first report
+    PractRand::Uint64 maxBytes = 1ull << 45;  // 32 TB
+    int threads = 0;
+    int folding = 1;            // RNG_test's default
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-tlmin") == 0 && i + 1 < argc) {
+            minBytes = ParseSize(argv[++i]);
+        } else if (strcmp(argv[i], "-tlmax") == 0 && i + 1 < argc) {
+            maxBytes = ParseSize(argv[++i]);
+        } else if (strcmp(argv[i], "-tf") == 0 && i + 1 < argc) {
+            folding = atoi(argv[++i]);
+            if (folding < 0 || folding > 2) {
+                Usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (minBytes < PractRand::Tests::TestBlock::SIZE || maxBytes < minBytes) {
+        fprintf(stderr, "practrand_direct: invalid test length\n");
+        Usage(argv[0]);
+        return 1;
+    }
+
+    trng_prefetch* feed = trng_prefetch_open(threads, TRNG_PREFETCH_DEFAULT_BUFFER);
+    if (!feed) {
+        fprintf(stderr, "practrand_direct: could not start libtrng\n");
+        return 1;
+    }
+
+    PractRand::initialize_PractRand();
+    LibTrngRNG rng(feed);
+    PractRand::RNGs::Polymorphic::hc256 knownGood(PractRand::SEED_AUTO);
+    PractRand::Tests::ListOfTests tests =
+        folding == 0 ? PractRand::Tests::Batteries::get_core_tests() :
+        folding == 1 ? PractRand::Tests::Batteries::get_standard_tests(&rng) :
+                       PractRand::Tests::Batteries::get_folded_tests(&rng);
+    TestManager* manager = new TestManager(&rng, &tests, &knownGood);
+
+    static const char* const FOLDING_NAMES[] = {"none", "standard", "extra"};
+    printf("RNG_test using PractRand version %s\n", PractRand::version_str);
+    printf("RNG = %s (in-process), seed = unknown\n", rng.get_name().c_str());
+    printf("test set = core, folding = %s (32 bit)\n\n", FOLDING_NAMES[folding]);
+    fflush(stdout);
+
+    const PractRand::Uint64 blockSize = PractRand::Tests::TestBlock::SIZE;
+    const time_t start = time(NULL);
+    PractRand::Uint64 target = minBytes;
+    bool failed = false;
+
+    while (!failed) {
+        PractRand::Uint64 doneBlocks = manager->get_blocks_so_far();
+        manager->test(target / blockSize - doneBlocks);
+
+        std::vector<PractRand::TestResult> results;
+        manager->get_results(results);
+
+        printf("rng=%s, length= %s, time= %ld seconds\n", rng.get_name().c_str(),
+               FormatSize(target).c_str(), (long)(time(NULL) - start));
+        int anomalies = 0;
+        for (const PractRand::TestResult& result : results) {
+            double p = result.get_pvalue();
+            double tail = std::fmin(p, 1.0 - p);
+            if (tail >= UNUSUAL_P) continue;
+            if (anomalies++ == 0) printf("  Test Name                         p-value    Evaluation\n");
+            const char* evaluation = tail < FAIL_P ? "FAIL" : "unusual";
+            if (tail < FAIL_P) failed = true;
+            printf("  %-32s  %-9.3g  %s\n", result.name.c_str(), p, evaluation);
+        }
+        if (anomalies == 0) {
+            printf("  no anomalies in %d test result(s)\n", (int)results.size());
+        } else {
+            printf("  ...and %d test result(s) without anomalies\n", (int)results.size() - anomalies);
+        }
+        printf("\n");
+        fflush(stdout);
+
+        if (target >= maxBytes) break;
+        target = (target * 2 > maxBytes) ? maxBytes : target * 2;
+    }
+
+    fprintf(stderr, "practrand_direct: %.2f GB consumed\n", (double)trng_prefetch_consumed(feed) / 1e9);
+    delete manager;
+    trng_prefetch_close(feed);
+    return failed ? 1 : 0;
+}
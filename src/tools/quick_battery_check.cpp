@@ -0,0 +1,170 @@
+/*
+ * quick_battery_check.cpp — False-alarm regression check for Stats::QuickBattery
+ *
+ * The quick battery gates CSPRNG output, the NIST export and
+ * `trng_gen --check-abort`, so an alarm on honest output aborts a healthy
+ * generator. This check:
+ *   1. feeds ChaCha20 keystream through Feed() in uneven pieces, across many
+ *      128 KiB windows, and expects no alarm at DEFAULT_ALPHA;
+ *   2. tests a window whose ones count sits 4.05 sigma off n/2 (just past
+ *      NIST's runs pre-test cutoff): monobit p ~ 5e-5, and no result may alarm;
+ *   3. tests a biased and a repeating stream, which must alarm.
+ * Exits with status 1 if any expectation fails.
+ *
+ * Usage:
+ *   ./quick_battery_check                 (20000 windows, random key)
+ *   ./quick_battery_check -w 100000 -s 7  (more windows, fixed key)
+ *
+ * Build:
+ *   g++ -std=c++17 -O3 -o quick_battery_check src/tools/quick_battery_check.cpp \
+ *       src/stats/quick_battery.cpp src/stats/stats_math.cpp src/crypto/chacha20.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../crypto/chacha20.h"
+#include "../stats/quick_battery.h"
+
+using Stats::QuickBattery;
+
+static uint64_t SplitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int Expect(bool ok, const char* what) {
+    printf("  %-64s %s\n", what, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+static int ResultAlarms(const double p[QuickBattery::RESULT_COUNT]) {
+    int alarms = 0;
+    for (int r = 0; r < QuickBattery::RESULT_COUNT; r++) {
+        if (p[r] < QuickBattery::DEFAULT_ALPHA) {
+            printf("    %s p=%.3g\n", QuickBattery::ResultName(r), p[r]);
+            alarms++;
+        }
+    }
+    return alarms;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t windows = 20000;
+    uint64_t seed = 0;
+    bool seedGiven = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            windows = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+            seedGiven = true;
+        } else {
+            fprintf(stderr, "Usage: %s [-w windows] [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!seedGiven) {
+        std::random_device rd;
+        seed = ((uint64_t)rd() << 32) ^ rd();
+    }
+
+    Crypto::ChaCha20::Key key;
+    Crypto::ChaCha20::Nonce nonce{};
+    uint64_t x = seed;
+    for (size_t i = 0; i < key.size(); i += 8) {
+        uint64_t v = SplitMix64(x);
+        memcpy(key.data() + i, &v, 8);
+    }
+    printf("seed %llu, %llu windows of %zu bytes\n", (unsigned long long)seed,
+           (unsigned long long)windows, QuickBattery::MIN_WINDOW);
+
+    int failures = 0;
+    const size_t W = QuickBattery::MIN_WINDOW;
+
+    // 1. Honest output, fed in pieces that straddle window boundaries
+    {
+        QuickBattery battery(W);
+        const size_t pieces[] = {W / 3 + 1, W - 5, 7, W + W / 2, 4096};
+        std::vector<uint8_t> buffer(2 * W);
+        uint64_t fed = 0, block = 0;
+        const uint64_t total = windows * W;
+        for (size_t k = 0; fed < total; k++) {
+            size_t len = (size_t)std::min<uint64_t>(pieces[k % 5], total - fed);
+            size_t blocks = (len + Crypto::ChaCha20::BLOCK_SIZE - 1) / Crypto::ChaCha20::BLOCK_SIZE;
+            if ((block + blocks) >> 32) {
+                nonce[0]++;
+                block = 0;
+            }
+            Crypto::ChaCha20::GenerateInto(key, nonce, buffer.data(), len, (uint32_t)block);
+            block += blocks;
+            battery.Feed(buffer.data(), len);
+            fed += len;
+        }
+        if (battery.AlarmCount() > 0) {
+            const QuickBattery::Alarm& a = battery.LastAlarm();
+            printf("    last alarm: window %llu, %s p=%.3g\n", (unsigned long long)a.window,
+                   QuickBattery::ResultName(a.result), a.pValue);
+        }
+        printf("    lowest p: monobit %.3g, runs %.3g\n", battery.MinPValue(QuickBattery::RESULT_MONOBIT),
+               battery.MinPValue(QuickBattery::RESULT_RUNS));
+        failures += Expect(battery.WindowsTested() == windows, "every honest window tested");
+        failures += Expect(battery.AlarmCount() == 0, "no alarm on honest output");
+    }
+
+    // 2. Honest window pushed 4.05 sigma off balance by setting random zero bits
+    {
+        std::vector<uint8_t> window(W);
+        nonce[1] = 1;
+        Crypto::ChaCha20::GenerateInto(key, nonce, window.data(), W, 0);
+        const double n = (double)W * 8.0;
+        int64_t ones = 0;
+        for (uint8_t b : window) ones += __builtin_popcount(b);
+        const int64_t target = (int64_t)std::ceil(n / 2.0 + 4.05 * std::sqrt(n) / 2.0);
+        uint64_t y = seed ^ 0xA5A5A5A5ull;
+        while (ones < target) {
+            size_t bit = (size_t)(SplitMix64(y) % (uint64_t)n);
+            uint8_t mask = (uint8_t)(1u << (bit & 7));
+            if (window[bit >> 3] & mask) continue;
+            window[bit >> 3] |= mask;
+            ones++;
+        }
+        double p[QuickBattery::RESULT_COUNT];
+        QuickBattery::TestWindow(window.data(), W, p);
+        printf("    4.05 sigma window: monobit p=%.3g, runs p=%.3g\n",
+               p[QuickBattery::RESULT_MONOBIT], p[QuickBattery::RESULT_RUNS]);
+        failures += Expect(p[QuickBattery::RESULT_MONOBIT] > 1e-5 && p[QuickBattery::RESULT_MONOBIT] < 1e-4,
+                           "4.05 sigma window: monobit p near 5e-5");
+        failures += Expect(p[QuickBattery::RESULT_RUNS] > QuickBattery::DEFAULT_ALPHA,
+                           "4.05 sigma window: runs computed, not failed by the pre-test");
+        failures += Expect(ResultAlarms(p) == 0, "4.05 sigma window: no alarm");
+    }
+
+    // 3. Broken output must still alarm
+    {
+        std::vector<uint8_t> window(W);
+        nonce[1] = 2;
+        Crypto::ChaCha20::GenerateInto(key, nonce, window.data(), W, 0);
+        for (size_t i = 0; i < W; i += 4) window[i] |= 0x01;     // One bit in 32 stuck at 1
+        double p[QuickBattery::RESULT_COUNT];
+        QuickBattery::TestWindow(window.data(), W, p);
+        failures += Expect(p[QuickBattery::RESULT_MONOBIT] < QuickBattery::DEFAULT_ALPHA, "biased window alarms");
+
+        Crypto::ChaCha20::GenerateInto(key, nonce, window.data(), 1024, 0);
+        for (size_t i = 1024; i < W; i += 1024) memcpy(window.data() + i, window.data(), 1024);
+        QuickBattery::TestWindow(window.data(), W, p);
+        int alarms = 0;
+        for (int r = 0; r < QuickBattery::RESULT_COUNT; r++) alarms += p[r] < QuickBattery::DEFAULT_ALPHA;
+        failures += Expect(alarms > 0, "repeating 1 KiB block alarms");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
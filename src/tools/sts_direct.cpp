@@ -0,0 +1,280 @@
+/*
+ * sts_direct.cpp — In-process NIST SP 800-22 suite over libtrng or a file
+ *
+ * Runs the 15 SP 800-22 tests (src/stats/sp800_22.cpp, same P-values as
+ * sts-2.1.2 `assess` with default parameters) on many streams in parallel,
+ * one stream per worker at a time, and prints the finalAnalysisReport.txt
+ * layout: P-value histogram, uniformity P-value and pass proportion per test.
+ * Streams are drawn from libtrng per worker, or read in place from a
+ * memory-mapped file (e.g. nist_data.bin), so no `assess` run is needed.
+ *
+ * Usage:
+ *   ./sts_direct                          (8000 streams of 10^6 bits from libtrng)
+ *   ./sts_direct -n 1000 -t 4 -o finalAnalysisReport.txt
+ *   ./sts_direct nist_data.bin            (as many streams as the file holds)
+ *
+ * Build (after ./build_lib.sh):
+ *   g++ -std=c++17 -O3 -o sts_direct src/tools/sts_direct.cpp src/stats/sp800_22.cpp \
+ *       src/stats/stats_math.cpp src/platform/mapped_file.cpp -I src/lib \
+ *       build/lib/libtrng.a -lpthread -lbcrypt
+ * On Linux drop -lbcrypt.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../stats/sp800_22.h"
+#include "../stats/stats_math.h"
+#include "../platform/mapped_file.h"
+#include "trng.h"
+
+using Stats::Sp800_22;
+
+static const size_t DEFAULT_GENERATOR_STREAMS = 8000;
+
+struct StsOptions {
+    size_t streams = 0;             // 0 = default (8000, or all streams in the file)
+    size_t bits = Sp800_22::DEFAULT_STREAM_BITS;
+    int threads = 0;                // 0 = hardware threads
+    std::string input;              // Empty = libtrng
+    std::string output;             // Empty = stdout
+};
+
+static void Usage(const char* prog) {
+    fprintf(stderr,
+        "Usage: %s [-n streams] [-l bits] [-t threads] [-o report] [file]\n"
+        "  -n <count>   Streams to test (default %zu from libtrng, or all in the file)\n"
+        "  -l <bits>    Stream length in bits, a multiple of 8 (default %zu, minimum %zu)\n"
+        "  -t <count>   Worker threads (default: all hardware threads)\n"
+        "  -o <file>    Write the report to a file instead of stdout\n"
+        "  file         Read streams from a binary file instead of libtrng\n",
+        prog, DEFAULT_GENERATOR_STREAMS, Sp800_22::DEFAULT_STREAM_BITS, Sp800_22::MIN_STREAM_BITS);
+}
+
+//=============================================================================
+// REPORT
+//=============================================================================
+
+// sts computeMetrics(): one row per P-value. NaN results (random excursions
+// on streams with too few cycles) are left out of that row's sample.
+static void WriteRow(FILE* out, const std::vector<double>& pValues, size_t streams, int column, const char* name) {
+    int bins[10] = {};
+    int sampleSize = 0;
+    int passCount = 0;
+    for (size_t s = 0; s < streams; s++) {
+        double p = pValues[s * Sp800_22::RESULT_COUNT + column];
+        if (std::isnan(p)) continue;
+        bins[std::min(9, (int)(p * 10))]++;
+        sampleSize++;
+        if (p >= Sp800_22::ALPHA) passCount++;
+    }
+
+    for (int j = 0; j < 10; j++) fprintf(out, "%3d ", bins[j]);
+
+    double expCount = sampleSize / 10.0;
+    if (expCount == 0) {
+        fprintf(out, "    ----    ");
+    } else {
+        double chi2 = 0.0;
+        for (int j = 0; j < 10; j++) chi2 += (bins[j] - expCount) * (bins[j] - expCount) / expCount;
+        double uniformity = Stats::StatsMath::Igamc(9.0 / 2.0, chi2 / 2.0);
+        fprintf(out, uniformity < 0.0001 ? " %8.6f * " : " %8.6f   ", uniformity);
+    }
+
+    double pHat = 1.0 - Sp800_22::ALPHA;
+    double spread = 3.0 * std::sqrt(pHat * Sp800_22::ALPHA / std::max(sampleSize, 1));
+    double minPass = (pHat - spread) * sampleSize;
+    double maxPass = (pHat + spread) * sampleSize;
+    bool flagged = sampleSize == 0 || passCount < minPass || passCount > maxPass;
+    fprintf(out, flagged ? "%4d/%-4d *  %s\n" : "%4d/%-4d    %s\n", passCount, sampleSize, name);
+}
+
+static int MinimumPassRate(int sampleSize) {
+    if (sampleSize == 0) return 0;
+    double pHat = 1.0 - Sp800_22::ALPHA;
+    return (int)((pHat - 3.0 * std::sqrt(pHat * Sp800_22::ALPHA / sampleSize)) * sampleSize);
+}
+
+static void WriteReport(FILE* out, const std::vector<double>& pValues, size_t streams, const std::string& source) {
+    const char* rule = "------------------------------------------------------------------------------\n";
+    fprintf(out, "%s", rule);
+    fprintf(out, "RESULTS FOR THE UNIFORMITY OF P-VALUES AND THE PROPORTION OF PASSING SEQUENCES\n");
+    fprintf(out, "%s", rule);
+    fprintf(out, "   generator is <%s>\n", source.c_str());
+    fprintf(out, "%s", rule);
+    fprintf(out, " C1  C2  C3  C4  C5  C6  C7  C8  C9 C10  P-VALUE  PROPORTION  STATISTICAL TEST\n");
+    fprintf(out, "%s", rule);
+    for (int test = 0; test < Sp800_22::TEST_COUNT; test++) {
+        for (int i = 0; i < Sp800_22::ResultCount(test); i++) {
+            WriteRow(out, pValues, streams, Sp800_22::ResultOffset(test) + i, Sp800_22::TestName(test));
+        }
+    }
+
+    // Applicable sample of the random excursion tests (all rows share it)
+    int excursionSample = 0;
+    int excursionColumn = Sp800_22::ResultOffset(Sp800_22::TEST_RANDOM_EXCURSIONS);
+    for (size_t s = 0; s < streams; s++) {
+        if (!std::isnan(pValues[s * Sp800_22::RESULT_COUNT + excursionColumn])) excursionSample++;
+    }
+
+    fprintf(out, "\n\n- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -\n");
+    fprintf(out, "The minimum pass rate for each statistical test with the exception of the\n");
+    fprintf(out, "random excursion (variant) test is approximately = %d for a\n", MinimumPassRate((int)streams));
+    fprintf(out, "sample size = %zu binary sequences.\n\n", streams);
+    fprintf(out, "The minimum pass rate for the random excursion (variant) test\n");
+    fprintf(out, "is approximately = %d for a sample size = %d binary sequences.\n\n",
+            MinimumPassRate(excursionSample), excursionSample);
+    fprintf(out, "For further guidelines construct a probability table using the MAPLE program\n");
+    fprintf(out, "provided in the addendum section of the documentation.\n");
+    fprintf(out, "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -\n");
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+static bool ParseCount(const char* text, size_t& value) {
+    char* end = nullptr;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (end == text || *end != '\0' || parsed == 0) return false;
+    value = (size_t)parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    StsOptions opt;
+    for (int i = 1; i < argc; i++) {
+        size_t value = 0;
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-n") == 0 && hasValue && ParseCount(argv[i + 1], value)) {
+            opt.streams = value;
+            i++;
+        } else if (strcmp(argv[i], "-l") == 0 && hasValue && ParseCount(argv[i + 1], value)) {
+            opt.bits = value;
+            i++;
+        } else if (strcmp(argv[i], "-t") == 0 && hasValue && ParseCount(argv[i + 1], value)) {
+            opt.threads = (int)value;
+            i++;
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            opt.output = argv[++i];
+        } else if (argv[i][0] != '-' && opt.input.empty()) {
+            opt.input = argv[i];
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opt.bits % 8 != 0 || opt.bits < Sp800_22::MIN_STREAM_BITS) {
+        fprintf(stderr, "sts_direct: stream length must be a multiple of 8 and at least %zu bits\n",
+                Sp800_22::MIN_STREAM_BITS);
+        return 1;
+    }
+    if (opt.threads <= 0) opt.threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    const size_t streamBytes = opt.bits / 8;
+
+    // Stream source: a mapped file, read in place, or one shared libtrng context
+    MappedFile file;
+    trng_ctx* ctx = nullptr;
+    std::string source;
+    if (!opt.input.empty()) {
+        std::string error;
+        if (!file.Open(opt.input, error)) {
+            fprintf(stderr, "sts_direct: %s\n", error.c_str());
+            return 1;
+        }
+        size_t available = (size_t)(file.Size() / streamBytes);
+        if (available == 0) {
+            fprintf(stderr, "sts_direct: %s holds less than one stream of %zu bits\n", opt.input.c_str(), opt.bits);
+            return 1;
+        }
+        if (opt.streams == 0) opt.streams = available;
+        if (opt.streams > available) {
+            fprintf(stderr, "sts_direct: %s holds only %zu streams of %zu bits\n",
+                    opt.input.c_str(), available, opt.bits);
+            return 1;
+        }
+        file.AdviseSequential();
+        source = opt.input;
+    } else {
+        int rc = trng_open(&ctx, nullptr);
+        if (rc != TRNG_OK) {
+            fprintf(stderr, "sts_direct: could not start libtrng: %s\n", trng_strerror(rc));
+            return 1;
+        }
+        if (opt.streams == 0) opt.streams = DEFAULT_GENERATOR_STREAMS;
+        source = "libtrng (in-process)";
+    }
+    opt.threads = (int)std::min<size_t>((size_t)opt.threads, opt.streams);
+
+    FILE* out = stdout;
+    if (!opt.output.empty()) {
+        out = fopen(opt.output.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "sts_direct: cannot write %s\n", opt.output.c_str());
+            if (ctx) trng_close(ctx);
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "sts_direct: %zu streams of %zu bits, %d threads\n", opt.streams, opt.bits, opt.threads);
+
+    const Sp800_22 suite(opt.bits);
+    std::vector<double> pValues(opt.streams * Sp800_22::RESULT_COUNT);
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> done(0);
+    std::atomic<bool> failed(false);
+    const auto start = std::chrono::steady_clock::now();
+
+    // Each worker claims the next stream index and writes that stream's row of
+    // P-values, so the report is independent of scheduling
+    auto worker = [&]() {
+        Sp800_22::Scratch scratch;
+        std::vector<uint8_t> buffer(ctx ? streamBytes : 0);
+        for (size_t s = next++; s < opt.streams && !failed; s = next++) {
+            const uint8_t* stream;
+            if (ctx) {
+                if (trng_fill(ctx, buffer.data(), streamBytes) != TRNG_OK) {
+                    failed = true;
+                    break;
+                }
+                stream = buffer.data();
+            } else {
+                stream = file.Data() + s * streamBytes;
+            }
+            suite.Run(stream, &pValues[s * Sp800_22::RESULT_COUNT], scratch);
+            done++;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; t++) workers.emplace_back(worker);
+
+    // Progress on stderr while the workers run
+    while (done < opt.streams && !failed) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        fprintf(stderr, "\r  %zu / %zu streams", (size_t)done, opt.streams);
+    }
+    for (std::thread& t : workers) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "\r  %zu / %zu streams in %.1f s (%.1f ms per stream per thread)\n",
+            (size_t)done, opt.streams, seconds, seconds * 1000.0 * opt.threads / std::max<size_t>(done, 1));
+
+    if (ctx) trng_close(ctx);
+    if (failed) {
+        fprintf(stderr, "sts_direct: generator failed\n");
+        if (out != stdout) fclose(out);
+        return 1;
+    }
+
+    WriteReport(out, pValues, opt.streams, source);
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * testu01_direct.c — In-process TestU01 driver linked against libtrng
+ *
+ * Registers the libtrng buffered fill as a TestU01 unif01_Gen, so BigCrush
+ * draws words from memory instead of a pipe fed by a second trng_gen process.
+ * Producer threads (trng_prefetch.c) keep 4 MiB buffers ready while the
+ * single-threaded battery consumes them.
+ *
+ * Usage:
+ *   ./testu01_direct BigCrush
+ *   ./testu01_direct Crush -t 3
+ *   ./testu01_direct SmallCrush
+ *
+ * Build (after TestU01 is installed to /ucrt64 and ./build_lib.sh has run):
+ *   gcc -std=c99 -O2 -o testu01_direct src/tools/testu01_direct.c \
+ *       src/tools/trng_prefetch.c -I src/lib -I/ucrt64/include -L/ucrt64/lib \
+ *       build/lib/libtrng.a -ltestu01 -lprobdist -lmylib -lm -lws2_32 \
+ *       -lstdc++ -lpthread -lbcrypt
+ * (on Linux drop -lws2_32 -lbcrypt)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "unif01.h"
+#include "bbattery.h"
+#include "trng_prefetch.h"
+
+static trng_prefetch *feed;
+static const unsigned int *words;
+static size_t word_pos;
+static size_t word_len;
+
+static void refill_words(void) {
+    size_t len = 0;
+    const uint8_t *buf = trng_prefetch_next(feed, &len);
+    if (!buf) {
+        fprintf(stderr, "testu01_direct: generator failed\n");
+        exit(1);
+    }
+    words = (const unsigned int *)buf;
+    word_len = len / sizeof(unsigned int);
+    word_pos = 0;
+}
+
+static unsigned int trng_Bits(void) {
+    if (word_pos >= word_len) {
+        refill_words();
+    }
+    return words[word_pos++];
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [SmallCrush|Crush|BigCrush] [-t producer_threads]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    unif01_Gen *gen;
+    const char *battery = "BigCrush";
+    int threads = 0;
+    time_t start;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            battery = argv[i];
+        }
+    }
+    if (strcmp(battery, "SmallCrush") != 0 && strcmp(battery, "Crush") != 0 &&
+        strcmp(battery, "BigCrush") != 0) {
+        fprintf(stderr, "Unknown battery: %s\n", battery);
+        usage(argv[0]);
+        return 1;
+    }
+
+    feed = trng_prefetch_open(threads, TRNG_PREFETCH_DEFAULT_BUFFER);
+    if (!feed) {
+        fprintf(stderr, "testu01_direct: could not start libtrng\n");
+        return 1;
+    }
+
+    gen = unif01_CreateExternGenBits("libtrng", trng_Bits);
+
+    fprintf(stderr, "testu01_direct: Running %s battery in-process...\n", battery);
+    start = time(NULL);
+
+    if (strcmp(battery, "SmallCrush") == 0) {
+        bbattery_SmallCrush(gen);
+    } else if (strcmp(battery, "Crush") == 0) {
+        bbattery_Crush(gen);
+    } else {
+        bbattery_BigCrush(gen);
+    }
+
+    fprintf(stderr, "testu01_direct: %.2f GB consumed in %ld s\n",
+            (double)trng_prefetch_consumed(feed) / 1e9, (long)(time(NULL) - start));
+
+    unif01_DeleteExternGenBits(gen);
+    trng_prefetch_close(feed);
+    return 0;
+}
@@ -1,8 +1,12 @@
 // trng_gen.cpp — Standalone CLI for piping raw CSPRNG output to test suites
 // 
-// Usage:  ./trng_gen.exe | RNG_test stdin          (PractRand)
-//         ./trng_gen.exe | dieharder -a -g 200     (Dieharder)
-//         ./trng_gen.exe | head -c 100M > out.bin  (file dump for NIST)
+// Usage:  ./trng_gen.exe | RNG_test stdin                 (PractRand)
+//         ./trng_gen.exe | dieharder -a -g 200            (Dieharder)
+//         ./trng_gen.exe -n 100M -o out.bin               (file dump for NIST)
+//         ./trng_gen.exe -t 75% --chunk 8M | RNG_test stdin
+//         ./trng_gen.exe --seed-file seed.bin -n 1G -o a.bin  (reproducible run)
+//         ./trng_gen.exe --bench > bench.json             (throughput + per-layer breakdown)
+//         ./trng_gen.exe --check | RNG_test stdin          (built-in quick battery on every chunk)
 //
 // Implements the same Quad-Layer pipeline as the main TRNG application:
 //   Layer 1: HKDF(SHA-512) → ChaCha20 masking
@@ -12,10 +16,8 @@
 //
 // No GUI dependencies. Links only against crypto primitives.
 
-// Percentage of available CPU threads to use (1-100)
-static constexpr int THREAD_USAGE_PERCENT = 50;
-
 #include <cstdio>
+#include <cstdarg>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -25,198 +27,947 @@ static constexpr int THREAD_USAGE_PERCENT = 50;
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <io.h>
-#include <fcntl.h>
-#include <intrin.h>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#ifndef _WIN32
+#include <csignal>
 #endif
 
-#include "../crypto/sha512.h"
-#include "../crypto/hkdf.h"
-#include "../crypto/chacha20.h"
-#include "../crypto/aes.h"
+#include "../crypto/quad_layer.h"
 #include "../crypto/secure_mem.h"
-
-// Collect hardware entropy for seeding
-static std::vector<uint8_t> CollectSeed() {
-    std::vector<uint8_t> seed;
-    seed.reserve(256);
-
-    // Source 1: Multiple RDTSC samples with variable-time gaps
-    for (int i = 0; i < 16; i++) {
-        uint64_t tsc = __rdtsc();
-        const uint8_t* p = reinterpret_cast<const uint8_t*>(&tsc);
-        seed.insert(seed.end(), p, p + 8);
-        // Variable work to create timing jitter
-        volatile uint64_t x = 0;
-        for (int j = 0; j < (i + 1) * 137; j++) x += j * tsc;
-    }
-
-    // Source 2: QueryPerformanceCounter
-    LARGE_INTEGER qpc;
-    QueryPerformanceCounter(&qpc);
-    const uint8_t* qp = reinterpret_cast<const uint8_t*>(&qpc);
-    seed.insert(seed.end(), qp, qp + 8);
-
-    // Source 3: High-resolution clock
-    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
-    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
-    const uint8_t* np = reinterpret_cast<const uint8_t*>(&ns);
-    seed.insert(seed.end(), np, np + 8);
-
-    // Source 4: GetTickCount64
-    uint64_t tick = GetTickCount64();
-    const uint8_t* tp = reinterpret_cast<const uint8_t*>(&tick);
-    seed.insert(seed.end(), tp, tp + 8);
-
-    // Source 5: Process/Thread IDs
-    uint32_t pid = GetCurrentProcessId();
-    uint32_t tid = GetCurrentThreadId();
-    const uint8_t* pp = reinterpret_cast<const uint8_t*>(&pid);
-    const uint8_t* tp2 = reinterpret_cast<const uint8_t*>(&tid);
-    seed.insert(seed.end(), pp, pp + 4);
-    seed.insert(seed.end(), tp2, tp2 + 4);
-
-    return seed;
-}
-
-// Quad-Layer Generation (identical to CSPRNG::GenerateRandomBytes)
-static std::vector<uint8_t> QuadLayerGenerate(
+#include "../platform/cycles.h"
+#include "../platform/stream_output.h"
+#include "../platform/numa_topology.h"
+#include "../platform/system_seed.h"
+#include "../stats/quick_battery.h"
+
+// Defaults (all overridable on the command line, see --help)
+static constexpr int DEFAULT_THREAD_PERCENT = 50;
+static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+static constexpr size_t DEFAULT_BUFFER_SIZE = 4 * 1024 * 1024;
+static constexpr size_t MAX_SEED_FILE_BYTES = 1024 * 1024;
+
+// Per-stage timing for --bench (one accumulator per worker)
+using StageTimes = Crypto::QuadLayer::StageTimes;
+static constexpr int STAGE_COUNT = Crypto::QuadLayer::STAGE_COUNT;
+
+// Quad-Layer chunk (same pipeline as CSPRNG::GenerateRandomBytes); the chunk
+// counter goes into the HKDF info as well as the seed.
+// The final layer is written straight into `out` (numBytes long).
+static void QuadLayerGenerate(
     const std::vector<uint8_t>& entropyBytes,
+    uint8_t* out,
     size_t numBytes,
-    uint64_t counter)
+    uint64_t counter,
+    StageTimes* times = nullptr)
 {
-    // --- LAYER 1: ChaCha20 Masking ---
-    Crypto::SHA512::Hash masterSeed = Crypto::SHA512::Compute(entropyBytes);
-
     std::string infoStr = "TRNG-GEN|C:" + std::to_string(counter);
     std::vector<uint8_t> info(infoStr.begin(), infoStr.end());
-    std::vector<uint8_t> salt;
+    Crypto::QuadLayer::Generate(entropyBytes, info, out, numBytes, times);
+}
 
-    std::vector<uint8_t> keyMaterial = Crypto::HKDF::DeriveKey(
-        std::vector<uint8_t>(masterSeed.begin(), masterSeed.end()), salt, info, 44);
+// Per-chunk seed: base seed || counter (LE) || TSC salt (hardware-seeded runs only;
+// seed-file runs must repeat exactly)
+static void BuildChunkSeed(const std::vector<uint8_t>& seed, uint64_t counter, bool deterministic,
+                           std::vector<uint8_t>& chunkSeed) {
+    chunkSeed = seed;
+    for (int i = 0; i < 8; i++)
+        chunkSeed.push_back(static_cast<uint8_t>(counter >> (i * 8)));
+    if (!deterministic) {
+        uint64_t tsc = ReadCycleCounter();
+        const uint8_t* tp = reinterpret_cast<const uint8_t*>(&tsc);
+        chunkSeed.insert(chunkSeed.end(), tp, tp + 8);
+    }
+}
 
-    Crypto::ChaCha20::Key key1;
-    Crypto::ChaCha20::Nonce nonce1;
-    std::copy(keyMaterial.begin(), keyMaterial.begin() + 32, key1.begin());
-    std::copy(keyMaterial.begin() + 32, keyMaterial.begin() + 44, nonce1.begin());
+// Wakes idle workers when any ring frees a slot or stops. One per worker pool:
+// with several output streams a worker sleeps here only when every stream it
+// serves is full, instead of blocking on one slow stream.
+class WorkSignal {
+public:
+    uint64_t Epoch() const { return m_epoch.load(std::memory_order_acquire); }
+
+    void Notify() {
+        m_epoch.fetch_add(1, std::memory_order_acq_rel);
+        // Empty critical section orders the bump against a waiter's predicate check
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_cv.notify_all();
+    }
 
-    std::vector<uint8_t> stream1 = Crypto::ChaCha20::GenerateStream(key1, nonce1, numBytes);
+    // Sleep until something changed since `seen` was read
+    void Wait(uint64_t seen) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&] { return m_epoch.load(std::memory_order_acquire) != seen; });
+    }
 
-    // --- LAYER 2: XOR Entropy Injection ---
-    if (!entropyBytes.empty()) {
-        size_t loopCount = std::max(stream1.size(), entropyBytes.size());
-        for (size_t i = 0; i < loopCount; i++) {
-            stream1[i % stream1.size()] ^= entropyBytes[i % entropyBytes.size()];
+private:
+    std::atomic<uint64_t> m_epoch{0};
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+// Ordered ring of completed chunks between a persistent worker pool and one writer.
+// A ring owns the sequence numbers first, first + stride, first + 2*stride, ...
+// (stride 1 = every chunk; NUMA mode runs one ring per node with stride = nodes).
+// Workers claim the ring's k-th sequence number and fill slot k % size; the
+// writer drains slots strictly in sequence, so output order never depends on
+// which worker finishes first. Each slot carries a turn stamp:
+//   2*k     -> free for the worker producing the k-th chunk
+//   2*k + 1 -> holds it, ready for the writer
+// Hand-off is lock-free; workers never block on a ring (a full ring is skipped
+// and the pool's WorkSignal says when to look again), the writer sleeps on the
+// ring's own condvar. Slot buffers are page-aligned and allocated once, so
+// vmsplice can hand the pages straight to a pipe and no chunk is ever reallocated.
+class ChunkRing {
+public:
+    enum class ClaimResult { Claimed, Full, Done };
+
+    ChunkRing(WorkSignal& work, size_t slots, size_t chunkBytes, uint64_t first = 0, uint64_t stride = 1)
+        : m_work(work), m_slots(slots), m_chunkBytes(chunkBytes), m_first(first), m_stride(stride) {
+        for (size_t i = 0; i < slots; i++) {
+            m_slots[i].turn.store(2 * i, std::memory_order_relaxed);
+            m_slots[i].data = AllocPageAligned(chunkBytes);
         }
     }
 
-    // --- LAYER 3: AES-256-CTR Transformation ---
-    Crypto::SHA512::Hash s1Hash = Crypto::SHA512::Compute(stream1);
-    std::vector<uint8_t> aesKey(s1Hash.begin(), s1Hash.begin() + 32);
-    std::vector<uint8_t> aesIV(s1Hash.begin() + 32, s1Hash.begin() + 48);
-    std::vector<uint8_t> stream3 = Crypto::AES256::EncryptCTR(aesKey, aesIV, stream1);
+    ~ChunkRing() {
+        for (auto& slot : m_slots) {
+            if (!slot.data) continue;
+            Crypto::SecureZero(slot.data, m_chunkBytes);
+            FreePageAligned(slot.data);
+        }
+    }
 
-    // --- LAYER 4: ChaCha20 Final Whitening ---
-    Crypto::SHA512::Hash s3Hash = Crypto::SHA512::Compute(stream3);
-    std::vector<uint8_t> info4 = {'L', 'A', 'Y', 'E', 'R', '4'};
-    std::vector<uint8_t> key4Mat = Crypto::HKDF::DeriveKey(
-        std::vector<uint8_t>(s3Hash.begin(), s3Hash.end()), salt, info4, 44);
+    bool Allocated() const {
+        for (const auto& slot : m_slots) {
+            if (!slot.data) return false;
+        }
+        return true;
+    }
+
+    // Write every slot once from the calling thread. Under first-touch placement
+    // this backs the ring with the memory of the node that thread is pinned to.
+    void Touch() {
+        for (auto& slot : m_slots) memset(slot.data, 0, m_chunkBytes);
+    }
+
+    // Worker side, never blocks. Full = the next slot is still with the writer;
+    // Done = stopping or totalChunks reached.
+    ClaimResult TryClaim(uint64_t totalChunks, uint64_t& seq) {
+        if (m_stop.load(std::memory_order_acquire)) return ClaimResult::Done;
+        uint64_t k = m_nextIndex.load(std::memory_order_relaxed);
+        for (;;) {
+            seq = m_first + k * m_stride;
+            if (totalChunks > 0 && seq >= totalChunks) return ClaimResult::Done;
+            if (m_slots[k % m_slots.size()].turn.load(std::memory_order_acquire) != 2 * k) {
+                return ClaimResult::Full;
+            }
+            // Only the claimer of k moves the slot on, so the turn check stays valid
+            if (m_nextIndex.compare_exchange_weak(k, k + 1, std::memory_order_acq_rel)) {
+                return ClaimResult::Claimed;
+            }
+        }
+    }
 
-    Crypto::ChaCha20::Key key4;
-    Crypto::ChaCha20::Nonce nonce4;
-    std::copy(key4Mat.begin(), key4Mat.begin() + 32, key4.begin());
-    std::copy(key4Mat.begin() + 32, key4Mat.begin() + 44, nonce4.begin());
+    uint8_t* Data(uint64_t seq) { return SlotFor(seq).data; }
 
-    std::vector<uint8_t> result = Crypto::ChaCha20::GenerateStream(key4, nonce4, numBytes);
+    void Publish(uint64_t seq) {
+        SlotFor(seq).turn.store(2 * Index(seq) + 1, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_writerCv.notify_all();
+    }
+
+    // Writer side: wait for seq, use Data(seq), then Release(seq)
+    bool WaitReady(uint64_t seq) {
+        std::atomic<uint64_t>& turn = SlotFor(seq).turn;
+        const uint64_t want = 2 * Index(seq) + 1;
+        if (turn.load(std::memory_order_acquire) == want) return true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_writerCv.wait(lock, [&] { return m_stop || turn.load(std::memory_order_acquire) == want; });
+        return !m_stop;
+    }
 
-    // Secure cleanup
-    SecureZeroMemory(masterSeed.data(), masterSeed.size());
-    SecureZeroMemory(keyMaterial.data(), keyMaterial.size());
-    SecureZeroMemory(stream1.data(), stream1.size());
-    SecureZeroMemory(s1Hash.data(), s1Hash.size());
-    SecureZeroMemory(aesKey.data(), aesKey.size());
-    SecureZeroMemory(aesIV.data(), aesIV.size());
-    SecureZeroMemory(stream3.data(), stream3.size());
-    SecureZeroMemory(s3Hash.data(), s3Hash.size());
-    SecureZeroMemory(key4Mat.data(), key4Mat.size());
+    void Release(uint64_t seq) {
+        SlotFor(seq).turn.store(2 * (Index(seq) + m_slots.size()), std::memory_order_release);
+        m_work.Notify();
+    }
+
+    // Wake everyone and make all waits fail (write error, reader gone)
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_writerCv.notify_all();
+        m_work.Notify();
+    }
 
-    return result;
+private:
+    struct Slot {
+        std::atomic<uint64_t> turn{0};
+        uint8_t* data = nullptr;
+    };
+
+    uint64_t Index(uint64_t seq) const { return (seq - m_first) / m_stride; }
+    Slot& SlotFor(uint64_t seq) { return m_slots[Index(seq) % m_slots.size()]; }
+
+    WorkSignal& m_work;
+    std::vector<Slot> m_slots;
+    size_t m_chunkBytes;
+    uint64_t m_first;
+    uint64_t m_stride;
+    std::atomic<uint64_t> m_nextIndex{0};
+    std::mutex m_mutex;
+    std::condition_variable m_writerCv;
+    std::atomic<bool> m_stop{false};
+};
+
+enum class NumaMode { Auto, On, Off };
+
+struct GenOptions {
+    uint64_t totalBytes = 0;        // 0 = endless stream
+    int threads = 0;                // 0 = use threadPercent
+    int threadPercent = DEFAULT_THREAD_PERCENT;
+    size_t chunkSize = DEFAULT_CHUNK_SIZE;
+    size_t bufferSize = DEFAULT_BUFFER_SIZE;
+    std::string outputPath;         // empty or "-" = stdout
+    std::vector<std::string> streams;   // --stream targets (-o, if given, is prepended)
+    std::string seedFile;           // non-empty = deterministic output
+    StreamOutputMode ioMode = StreamOutputMode::Auto;
+    NumaMode numaMode = NumaMode::Auto;  // Auto = on when more than one node has CPUs
+    bool check = false;                 // Quick battery on every chunk before it is written
+    bool checkAbort = false;            // Stop all output at the first alarm
+
+    // --bench
+    bool bench = false;
+    double benchSeconds = 3.0;          // Per thread count (unless -n is given)
+    std::vector<int> benchThreads;      // Empty = sweep 1, 2, 4, ... hardware threads
+};
+
+static void PrintUsage() {
+    fprintf(stderr,
+        "Usage: trng_gen [options]\n"
+        "  -n, --bytes <size>     Write exactly <size> bytes then exit (default: endless)\n"
+        "  -t, --threads <n|p%%>   Worker count, or a percentage of hardware threads (default %d%%)\n"
+        "  -c, --chunk <size>     Bytes per worker chunk (default 4M)\n"
+        "  -o, --output <file>    Write to a file instead of stdout ('-' = stdout)\n"
+        "      --stream <target>  Add an independent output stream (repeatable): a file, FIFO,\n"
+        "                         '-' for stdout or fd:N for an inherited descriptor. All streams\n"
+        "                         share one worker pool. -n applies to each stream unless the\n"
+        "                         target ends in @<size> (e.g. nist.bin@1G)\n"
+        "  -b, --buffer <size>    Output stdio buffer size (default 4M, stdio mode only)\n"
+        "      --io <mode>        auto | vmsplice | write | stdio (default auto: vmsplice for\n"
+        "                         pipes and write(2) for files on Linux, stdio on Windows)\n"
+        "      --numa <mode>      auto | on | off (default auto: on multi-socket hosts, pin\n"
+        "                         workers per node and keep each node's chunks in local memory)\n"
+        "  -s, --seed-file <file> Seed from a file instead of hardware; output is reproducible\n"
+        "                         for the same seed file and chunk size\n"
+        "      --check            Run the quick statistical battery on every chunk in the\n"
+        "                         workers; alarms go to stderr\n"
+        "      --check-abort      As --check, but stop all output at the first alarm (exit 1)\n"
+        "      --bench            Measure generation speed instead of writing; JSON report on stdout\n"
+        "      --bench-time <s>   Seconds per thread count (default 3; -n sets a byte budget instead)\n"
+        "      --bench-threads <list>  Thread counts to test, e.g. 1,2,4,8 (default: -t, or a\n"
+        "                         1, 2, 4, ... sweep up to the hardware thread count)\n"
+        "                         With -o <path>, --bench also measures the output backend\n"
+        "  -h, --help             Show this help\n"
+        "Sizes accept K, M, G, T suffixes (powers of 1024), e.g. 512K, 100M, 1G.\n",
+        DEFAULT_THREAD_PERCENT);
 }
 
-int main() {
-    // Set stdout to binary mode (critical on Windows)
-#ifdef _WIN32
-    _setmode(_fileno(stdout), _O_BINARY);
-#endif
+// "100M" -> 104857600. Binary multipliers, matching `head -c`.
+static bool ParseSize(const char* text, uint64_t& out) {
+    char* end = nullptr;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text) return false;
+
+    uint64_t mult = 1;
+    switch (*end) {
+        case 'k': case 'K': mult = 1ULL << 10; end++; break;
+        case 'm': case 'M': mult = 1ULL << 20; end++; break;
+        case 'g': case 'G': mult = 1ULL << 30; end++; break;
+        case 't': case 'T': mult = 1ULL << 40; end++; break;
+        default: break;
+    }
+    if (mult > 1 && *end == 'i') end++;
+    if (*end == 'B' || *end == 'b') end++;
+    if (*end != '\0') return false;
+    if (value > UINT64_MAX / mult) return false;
+
+    out = (uint64_t)value * mult;
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, GenOptions& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        uint64_t size = 0;
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            exit(0);
+        } else if ((arg == "-n" || arg == "--bytes") && hasValue) {
+            if (!ParseSize(argv[++i], size) || size == 0) {
+                fprintf(stderr, "Invalid byte count: %s\n", argv[i]);
+                return false;
+            }
+            opt.totalBytes = size;
+        } else if ((arg == "-t" || arg == "--threads") && hasValue) {
+            std::string v = argv[++i];
+            bool percent = !v.empty() && v.back() == '%';
+            if (percent) v.pop_back();
+            int n = atoi(v.c_str());
+            if (n <= 0 || (percent && n > 100)) {
+                fprintf(stderr, "Invalid thread setting: %s\n", argv[i]);
+                return false;
+            }
+            if (percent) { opt.threadPercent = n; opt.threads = 0; }
+            else opt.threads = n;
+        } else if ((arg == "-c" || arg == "--chunk") && hasValue) {
+            // Upper bound keeps a single ChaCha20/AES stream well inside its counter space
+            if (!ParseSize(argv[++i], size) || size < 64 || size > (1ULL << 30)) {
+                fprintf(stderr, "Invalid chunk size (64 bytes to 1G): %s\n", argv[i]);
+                return false;
+            }
+            opt.chunkSize = (size_t)size;
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            opt.outputPath = argv[++i];
+        } else if (arg == "--stream" && hasValue) {
+            opt.streams.push_back(argv[++i]);
+        } else if ((arg == "-b" || arg == "--buffer") && hasValue) {
+            if (!ParseSize(argv[++i], size) || size > (1ULL << 30)) {
+                fprintf(stderr, "Invalid buffer size: %s\n", argv[i]);
+                return false;
+            }
+            opt.bufferSize = (size_t)size;
+        } else if (arg == "--bench") {
+            opt.bench = true;
+        } else if (arg == "--bench-time" && hasValue) {
+            opt.benchSeconds = atof(argv[++i]);
+            if (opt.benchSeconds <= 0.0) {
+                fprintf(stderr, "Invalid --bench-time: %s\n", argv[i]);
+                return false;
+            }
+        } else if (arg == "--bench-threads" && hasValue) {
+            std::string list = argv[++i];
+            size_t pos = 0;
+            while (pos <= list.size()) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos) comma = list.size();
+                int n = atoi(list.substr(pos, comma - pos).c_str());
+                if (n <= 0) {
+                    fprintf(stderr, "Invalid --bench-threads list: %s\n", list.c_str());
+                    return false;
+                }
+                opt.benchThreads.push_back(n);
+                pos = comma + 1;
+            }
+        } else if (arg == "--io" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "auto") opt.ioMode = StreamOutputMode::Auto;
+            else if (v == "vmsplice") opt.ioMode = StreamOutputMode::Vmsplice;
+            else if (v == "write") opt.ioMode = StreamOutputMode::Write;
+            else if (v == "stdio") opt.ioMode = StreamOutputMode::Stdio;
+            else {
+                fprintf(stderr, "Invalid --io mode: %s\n", v.c_str());
+                return false;
+            }
+        } else if (arg == "--numa" && hasValue) {
+            std::string v = argv[++i];
+            if (v == "auto") opt.numaMode = NumaMode::Auto;
+            else if (v == "on") opt.numaMode = NumaMode::On;
+            else if (v == "off") opt.numaMode = NumaMode::Off;
+            else {
+                fprintf(stderr, "Invalid --numa mode: %s\n", v.c_str());
+                return false;
+            }
+        } else if (arg == "--check") {
+            opt.check = true;
+        } else if (arg == "--check-abort") {
+            opt.check = true;
+            opt.checkAbort = true;
+        } else if ((arg == "-s" || arg == "--seed-file") && hasValue) {
+            opt.seedFile = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg.c_str());
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Domain separation between streams: stream s > 0 appends a fixed-length label,
+// so every stream feeds HKDF a different input. Stream 0 keeps the plain seed and
+// matches a single-stream run with the same seed file.
+static std::vector<uint8_t> StreamSeed(const std::vector<uint8_t>& seed, size_t stream) {
+    std::vector<uint8_t> out = seed;
+    if (stream == 0) return out;
+    static const char LABEL[] = "trng_gen/stream/";
+    out.insert(out.end(), LABEL, LABEL + sizeof(LABEL) - 1);
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(stream >> (i * 8)));
+    return out;
+}
+
+// Nodes to spread `threads` workers over (1 = no NUMA placement). Worker t runs
+// on node t % nodes and chunk seq is produced on node seq % nodes.
+static size_t NumaNodesFor(const GenOptions& opt, const NumaTopology& topo, int threads) {
+    bool enabled = opt.numaMode == NumaMode::On || (opt.numaMode == NumaMode::Auto && topo.IsNuma());
+    if (!enabled) return 1;
+    return std::max<size_t>(1, std::min<size_t>(topo.NodeCount(), (size_t)threads));
+}
 
-    // Enlarge stdout buffer to reduce syscall overhead
-    static char outBuf[4 * 1024 * 1024];
-    setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+static bool ReadSeedFile(const std::string& path, std::vector<uint8_t>& seed) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open seed file: %s\n", path.c_str());
+        return false;
+    }
+    seed.resize(MAX_SEED_FILE_BYTES);
+    size_t got = fread(seed.data(), 1, seed.size(), f);
+    bool more = fgetc(f) != EOF;
+    fclose(f);
+    seed.resize(got);
+
+    if (got == 0 || more) {
+        fprintf(stderr, "Seed file must be 1 byte to 1 MB: %s\n", path.c_str());
+        Crypto::SecureClearVector(seed);
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// BENCHMARK MODE
+//=============================================================================
+
+// printf-style append; grows the string instead of truncating
+static void AppendFormat(std::string& out, const char* fmt, ...) {
+    va_list args, copy;
+    va_start(args, fmt);
+    va_copy(copy, args);
+    int len = vsnprintf(nullptr, 0, fmt, copy);
+    va_end(copy);
+    if (len > 0) {
+        size_t old = out.size();
+        out.resize(old + (size_t)len + 1);
+        vsnprintf(&out[old], (size_t)len + 1, fmt, args);
+        out.resize(old + (size_t)len);
+    }
+    va_end(args);
+}
+
+// JSON string body: quotes, backslashes (Windows paths) and control characters
+static std::string JsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) AppendFormat(out, "\\u%04x", c);
+                else out += (char)c;
+        }
+    }
+    return out;
+}
 
-    // Seed from hardware
-    std::vector<uint8_t> seed = CollectSeed();
+// TSC ticks per second, measured against steady_clock
+static double CalibrateTsc() {
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = ReadCycleCounter();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t c1 = ReadCycleCounter();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return secs > 0.0 ? (double)(c1 - c0) / secs : 1.0;
+}
+
+struct BenchRun {
+    int threads = 0;
+    int nodes = 1;
+    double seconds = 0.0;
+    uint64_t bytes = 0;
+    StageTimes stages;
+};
+
+// Generate without writing: workers claim chunks from a shared counter until the
+// time or byte budget runs out, each accumulating its own stage cycles
+static BenchRun BenchGenerate(const GenOptions& opt, const std::vector<uint8_t>& seed,
+                              bool deterministic, int threads, const NumaTopology& topo) {
+    const size_t nodes = NumaNodesFor(opt, topo, threads);
+    const size_t chunk = opt.chunkSize;
+    const uint64_t totalChunks = opt.totalBytes > 0 ? (opt.totalBytes + chunk - 1) / chunk : 0;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> nextSeq{0};
+    std::vector<StageTimes> times(threads);
+    std::vector<uint64_t> bytes(threads, 0);
+
+    auto worker = [&](int t) {
+        // Pin before allocating so the private buffer is first-touched on this node
+        if (nodes > 1) topo.PinCurrentThread(t % nodes);
+        uint8_t* buf = AllocPageAligned(chunk);
+        if (!buf) return;
+        std::vector<uint8_t> chunkSeed;
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint64_t seq = nextSeq.fetch_add(1, std::memory_order_relaxed);
+            if (totalChunks > 0 && seq >= totalChunks) break;
+            BuildChunkSeed(seed, seq + 1, deterministic, chunkSeed);
+            QuadLayerGenerate(chunkSeed, buf, chunk, seq + 1, &times[t]);
+            bytes[t] += chunk;
+        }
+        Crypto::SecureClearVector(chunkSeed);
+        Crypto::SecureZero(buf, chunk);
+        FreePageAligned(buf);
+    };
 
-    const size_t CHUNK_SIZE = 4 * 1024 * 1024; // 4 MB per chunk
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker, t);
+    if (totalChunks == 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(opt.benchSeconds));
+        stop = true;
+    }
+    for (auto& th : pool) th.join();
+
+    BenchRun run;
+    run.threads = threads;
+    run.nodes = (int)nodes;
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (int t = 0; t < threads; t++) {
+        run.bytes += bytes[t];
+        for (int s = 0; s < STAGE_COUNT; s++) run.stages.cycles[s] += times[t].cycles[s];
+    }
+    return run;
+}
+
+// Push one pre-generated chunk through the chosen backend repeatedly.
+// The chunk is never modified while the pipe may still hold its pages.
+static bool BenchOutput(const GenOptions& opt, const std::vector<uint8_t>& seed,
+                        bool deterministic, std::string& json) {
+    StreamOutput output;
+    std::string error;
+    if (!output.Open(opt.outputPath, opt.ioMode, opt.bufferSize, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    uint8_t* buf = AllocPageAligned(opt.chunkSize);
+    if (!buf) return false;
+    std::vector<uint8_t> chunkSeed;
+    BuildChunkSeed(seed, 1, deterministic, chunkSeed);
+    QuadLayerGenerate(chunkSeed, buf, opt.chunkSize, 1);
+    Crypto::SecureClearVector(chunkSeed);
+
+    const uint64_t budget = opt.totalBytes;
+    uint64_t written = 0;
+    bool ok = true;
+    auto t0 = std::chrono::steady_clock::now();
+    while (ok) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (budget > 0 ? written >= budget : elapsed >= opt.benchSeconds) break;
+        size_t len = budget > 0 ? (size_t)std::min<uint64_t>(opt.chunkSize, budget - written) : opt.chunkSize;
+        ok = output.Write(buf, len);
+        written += len;
+    }
+    // Copied tail flushes every spliced page out of the pipe before the wipe
+    size_t tail = std::min(output.RetainedBytes(), opt.chunkSize);
+    if (ok && tail > 0) ok = output.WriteCopy(buf, tail);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!output.Close()) ok = false;
+    Crypto::SecureZero(buf, opt.chunkSize);
+    FreePageAligned(buf);
+
+    AppendFormat(json,
+                 "  \"output\": {\"mode\": \"%s\", \"path\": \"%s\", \"bytes\": %llu, \"seconds\": %.4f, \"gbps\": %.4f, \"ok\": %s},\n",
+                 StreamOutputModeName(output.GetMode()), JsonEscape(opt.outputPath).c_str(),
+                 (unsigned long long)written, seconds, seconds > 0 ? written / seconds / 1e9 : 0.0,
+                 ok ? "true" : "false");
+    return ok;
+}
+
+static int RunBench(const GenOptions& opt, const std::vector<uint8_t>& seed, bool deterministic) {
+    const int hwThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> counts = opt.benchThreads;
+    if (counts.empty() && opt.threads > 0) counts.push_back(opt.threads);
+    if (counts.empty()) {
+        for (int n = 1; n < hwThreads; n *= 2) counts.push_back(n);
+        counts.push_back(hwThreads);
+    }
+
+    const NumaTopology topo = NumaTopology::Detect();
+    const double tscHz = CalibrateTsc();
+    std::string json;
+    AppendFormat(json,
+                 "{\n  \"tool\": \"trng_gen\",\n  \"mode\": \"bench\",\n  \"chunk_bytes\": %zu,\n"
+                 "  \"hardware_threads\": %d,\n  \"numa_nodes\": %zu,\n  \"tsc_ghz\": %.4f,\n  \"seed\": \"%s\",\n",
+                 opt.chunkSize, hwThreads, topo.NodeCount(), tscHz / 1e9, deterministic ? "file" : "hardware");
+
+    if (!opt.outputPath.empty() && opt.outputPath != "-") {
+        fprintf(stderr, "trng_gen bench: output backend -> %s\n", opt.outputPath.c_str());
+        if (!BenchOutput(opt, seed, deterministic, json)) {
+            fprintf(stderr, "trng_gen bench: output test failed\n");
+        }
+    }
+
+    json += "  \"runs\": [\n";
+    double baseGbps = 0.0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        fprintf(stderr, "trng_gen bench: %d thread(s)...\n", counts[i]);
+        BenchRun run = BenchGenerate(opt, seed, deterministic, counts[i], topo);
+
+        double gbps = run.seconds > 0 ? run.bytes / run.seconds / 1e9 : 0.0;
+        if (i == 0) baseGbps = gbps / counts[i];
+        uint64_t totalCycles = 0;
+        for (int s = 0; s < STAGE_COUNT; s++) totalCycles += run.stages.cycles[s];
+        double bytes = run.bytes > 0 ? (double)run.bytes : 1.0;
+
+        AppendFormat(json,
+                     "    {\"threads\": %d, \"nodes\": %d, \"seconds\": %.4f, \"bytes\": %llu, \"gbps\": %.4f, "
+                     "\"scaling_efficiency\": %.3f, \"cycles_per_byte\": %.3f, \"stages\": {",
+                     run.threads, run.nodes, run.seconds, (unsigned long long)run.bytes, gbps,
+                     baseGbps > 0 ? gbps / (baseGbps * run.threads) : 0.0, totalCycles / bytes);
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            // Per-thread stage speed: bytes pushed through the stage per second of stage time
+            double stageSecs = run.stages.cycles[s] / tscHz;
+            AppendFormat(json,
+                         "%s\"%s\": {\"cycles_per_byte\": %.3f, \"gbps_per_thread\": %.4f, \"share\": %.4f}",
+                         s ? ", " : "", Crypto::QuadLayer::StageName(s), run.stages.cycles[s] / bytes,
+                         stageSecs > 0 ? run.bytes / stageSecs / 1e9 : 0.0,
+                         totalCycles ? (double)run.stages.cycles[s] / totalCycles : 0.0);
+        }
+        json += (i + 1 < counts.size()) ? "}},\n" : "}}\n";
+    }
+    json += "  ]\n}\n";
+
+    fputs(json.c_str(), stdout);
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    GenOptions opt;
+    if (!ParseArgs(argc, argv, opt)) return 1;
+
+    // Seed from hardware, or from a file for reproducible runs
+    const bool deterministic = !opt.seedFile.empty();
+    std::vector<uint8_t> seed;
+    if (deterministic) {
+        if (!ReadSeedFile(opt.seedFile, seed)) return 1;
+    } else {
+        seed = CollectSystemSeed();
+    }
+
+    if (opt.bench) {
+        int rc = RunBench(opt, seed, deterministic);
+        Crypto::SecureClearVector(seed);
+        return rc;
+    }
+
+    // Output targets: -o (or stdout) alone, or the --stream list with -o first
+    std::vector<std::string> targets = opt.streams;
+    if (targets.empty() || !opt.outputPath.empty()) targets.insert(targets.begin(), opt.outputPath);
+    const size_t K = targets.size();
+
+#ifndef _WIN32
+    // A reader that exits must end only its own stream: take EPIPE from write()
+    // instead of being killed by SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    struct OutputStream {
+        std::string target;
+        uint64_t totalBytes = 0;                        // 0 = endless
+        uint64_t totalChunks = 0;                       // Chunks needed when bounded
+        StreamOutput output;
+        std::vector<uint8_t> seed;                      // Domain-separated base seed
+        std::vector<std::unique_ptr<ChunkRing>> rings;  // One per NUMA node
+        size_t retained = 0;                            // vmsplice hold-back, bytes
+        bool perNodeWriters = false;
+        std::atomic<bool> failed{false};
+    };
+    std::vector<std::unique_ptr<OutputStream>> streams;
+    for (size_t s = 0; s < K; s++) {
+        std::unique_ptr<OutputStream> stream(new OutputStream);
+        stream->target = targets[s];
+        stream->totalBytes = opt.totalBytes;
+        // "target@size" bounds one stream on its own (overrides -n)
+        size_t at = stream->target.rfind('@');
+        uint64_t streamBytes = 0;
+        if (at != std::string::npos && ParseSize(stream->target.c_str() + at + 1, streamBytes) && streamBytes > 0) {
+            stream->target.resize(at);
+            stream->totalBytes = streamBytes;
+        }
+        std::string openError;
+        if (!stream->output.Open(stream->target, opt.ioMode, opt.bufferSize, openError)) {
+            fprintf(stderr, "%s\n", openError.c_str());
+            Crypto::SecureClearVector(seed);
+            return 1;
+        }
+        stream->seed = StreamSeed(seed, s);
+        stream->retained = stream->output.RetainedBytes();
+        streams.push_back(std::move(stream));
+    }
+
+    const size_t CHUNK_SIZE = opt.chunkSize;
     const int totalCores = std::max(1, (int)std::thread::hardware_concurrency());
-    const int N = std::max(1, totalCores * THREAD_USAGE_PERCENT / 100);
-    uint64_t counter = 0;
-
-    // Two batch buffers for pipelining (generate one while writing the other)
-    std::vector<std::vector<uint8_t>> batchA(N), batchB(N);
-
-    // Generate N chunks in parallel using worker threads
-    auto generateBatch = [&](std::vector<std::vector<uint8_t>>& batch) {
-        std::vector<std::thread> threads;
-        std::vector<uint64_t> counters(N);
-        for (int t = 0; t < N; t++) {
-            counter++;
-            counters[t] = counter;
-        }
-        for (int t = 0; t < N; t++) {
-            threads.emplace_back([&seed, &batch, t, c = counters[t], CHUNK_SIZE]() {
-                std::vector<uint8_t> chunkSeed = seed;
-                for (int i = 0; i < 8; i++)
-                    chunkSeed.push_back(static_cast<uint8_t>(c >> (i * 8)));
-                uint64_t tsc = __rdtsc();
-                const uint8_t* tp = reinterpret_cast<const uint8_t*>(&tsc);
-                chunkSeed.insert(chunkSeed.end(), tp, tp + 8);
-                batch[t] = QuadLayerGenerate(chunkSeed, CHUNK_SIZE, c);
-                SecureZeroMemory(chunkSeed.data(), chunkSeed.size());
-            });
-        }
-        for (auto& th : threads) th.join();
+    const int N = opt.threads > 0 ? opt.threads
+                                  : std::max(1, totalCores * opt.threadPercent / 100);
+
+    // Chunks are always full size and the last write of a bounded stream is
+    // truncated, so it is an exact prefix of the endless stream for the same seed
+    // and chunk size
+    for (auto& stream : streams) {
+        stream->totalChunks = (stream->totalBytes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+
+    // NUMA: one ring per node per stream, holding chunks seq % nodes == r, filled by
+    // workers pinned to that node. The seq -> chunk mapping is unchanged, so the
+    // stream is byte-identical to a single-ring run.
+    const NumaTopology topo = NumaTopology::Detect();
+    const size_t nodes = NumaNodesFor(opt, topo, N);
+
+    fprintf(stderr, "trng_gen: %d worker(s), %zu-byte chunks, %s%s\n",
+            N, CHUNK_SIZE, deterministic ? "seed file " : "hardware seed",
+            deterministic ? opt.seedFile.c_str() : "");
+    if (nodes > 1) fprintf(stderr, "trng_gen: %zu NUMA node(s)\n", nodes);
+
+    // Two slots per worker for a single stream: each worker can finish one chunk
+    // ahead while the writer drains the previous round. With K streams each ring
+    // gets w + w/K, enough for one stream to keep the whole pool busy when the
+    // others are stalled, without K times the memory. vmsplice'd chunks stay in
+    // the pipe until RetainedBytes() more have been written, so those are held
+    // back on top, spread over the node rings round-robin like everything else.
+    WorkSignal work;
+    for (size_t s = 0; s < K; s++) {
+        OutputStream& stream = *streams[s];
+        // Regular files on a NUMA host get one writer per node (pwrite at seq *
+        // chunk), so no chunk crosses the interconnect on its way out. Pipes and
+        // stdout need an ordered stream: one writer merges the rings round-robin.
+        stream.perNodeWriters = nodes > 1 && stream.output.CanWriteAt();
+        const size_t heldChunks = (stream.retained + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        for (size_t r = 0; r < nodes; r++) {
+            size_t nodeWorkers = N / nodes + (r < N % nodes ? 1 : 0);
+            size_t slots = nodeWorkers + std::max<size_t>(1, nodeWorkers / K) + (heldChunks + nodes - 1) / nodes;
+            stream.rings.emplace_back(new ChunkRing(work, slots, CHUNK_SIZE, r, nodes));
+            if (!stream.rings.back()->Allocated()) {
+                fprintf(stderr, "trng_gen: out of memory for %zu-byte chunks\n", CHUNK_SIZE);
+                return 1;
+            }
+        }
+        fprintf(stderr, "trng_gen: stream %zu -> %s (%s, %s%s)\n", s,
+                stream.target.empty() ? "-" : stream.target.c_str(),
+                StreamOutputModeName(stream.output.GetMode()),
+                stream.totalBytes ? (std::to_string(stream.totalBytes) + " bytes").c_str() : "endless",
+                stream.perNodeWriters ? ", per-node writers" : "");
+    }
+    auto stopStream = [&](OutputStream& stream) {
+        for (auto& ring : stream.rings) ring->Stop();
     };
 
-    // Write completed batch to stdout in sequential order
-    auto writeBatch = [&](std::vector<std::vector<uint8_t>>& batch) -> bool {
-        for (int t = 0; t < N; t++) {
-            size_t written = fwrite(batch[t].data(), 1, batch[t].size(), stdout);
-            if (written != batch[t].size() || ferror(stdout)) return false;
-            SecureZeroMemory(batch[t].data(), batch[t].size());
+    // Fault each ring's pages in from its own node before any worker uses them
+    if (nodes > 1) {
+        for (size_t r = 0; r < nodes; r++) {
+            std::thread([&, r]() {
+                topo.PinCurrentThread(r);
+                for (auto& stream : streams) stream->rings[r]->Touch();
+            }).join();
+        }
+    }
+
+    // --check: one battery per worker, fed each chunk before it is published, so
+    // with --check-abort a chunk that raises an alarm is never written
+    std::vector<std::unique_ptr<Stats::QuickBattery>> checks;
+    if (opt.check) {
+        for (int t = 0; t < N; t++) checks.emplace_back(new Stats::QuickBattery());
+    }
+    std::atomic<bool> checkFailed{false};
+    std::mutex checkLogMutex;
+
+    // Persistent shared workers: take the next chunk from the streams round-robin,
+    // skipping full ones, so every stream with a free slot gets an equal share and a
+    // stalled reader never holds up the rest. Sleep only when all of them are full.
+    auto worker = [&](size_t node, size_t start, Stats::QuickBattery* check) {
+        if (nodes > 1) topo.PinCurrentThread(node);
+        std::vector<uint8_t> chunkSeed;
+        size_t next = start;
+        for (;;) {
+            const uint64_t epoch = work.Epoch();
+            bool open = false;
+            bool claimed = false;
+            for (size_t i = 0; i < K; i++) {
+                OutputStream& stream = *streams[(next + i) % K];
+                ChunkRing& ring = *stream.rings[node];
+                uint64_t seq = 0;
+                ChunkRing::ClaimResult claim = ring.TryClaim(stream.totalChunks, seq);
+                if (claim == ChunkRing::ClaimResult::Done) continue;
+                open = true;
+                if (claim == ChunkRing::ClaimResult::Full) continue;
+
+                uint64_t c = seq + 1; // Chunk counters start at 1
+                BuildChunkSeed(stream.seed, c, deterministic, chunkSeed);
+                QuadLayerGenerate(chunkSeed, ring.Data(seq), CHUNK_SIZE, c);
+                Crypto::SecureZero(chunkSeed.data(), chunkSeed.size());
+                if (check && check->Feed(ring.Data(seq), CHUNK_SIZE) > 0) {
+                    const Stats::QuickBattery::Alarm& alarm = check->LastAlarm();
+                    {
+                        std::lock_guard<std::mutex> lock(checkLogMutex);
+                        fprintf(stderr, "trng_gen: check alarm: stream %zu chunk %llu: %s p=%.3g\n",
+                                (next + i) % K,
+                                (unsigned long long)seq, Stats::QuickBattery::ResultName(alarm.result),
+                                alarm.pValue);
+                    }
+                    if (opt.checkAbort) {
+                        checkFailed = true;
+                        for (auto& other : streams) stopStream(*other);
+                        return;
+                    }
+                }
+                ring.Publish(seq);
+                next = (next + i + 1) % K;
+                claimed = true;
+                break;
+            }
+            if (claimed) continue;
+            if (!open) return;  // Every stream finished or stopped
+            work.Wait(epoch);
         }
-        return true;
     };
 
-    // Generate first batch
-    generateBatch(batchA);
+    std::vector<std::thread> workers;
+    workers.reserve(N);
+    for (int t = 0; t < N; t++) {
+        workers.emplace_back(worker, (size_t)t % nodes, (size_t)t % K, opt.check ? checks[t].get() : nullptr);
+    }
+
+    // Each node's writer drains its own ring in order and writes in place
+    auto nodeWriter = [&](OutputStream& stream, size_t node) {
+        topo.PinCurrentThread(node);
+        ChunkRing& ring = *stream.rings[node];
+        const bool bounded = stream.totalBytes > 0;
+        for (uint64_t seq = node; !bounded || seq < stream.totalChunks; seq += nodes) {
+            if (!ring.WaitReady(seq)) return;
+            uint64_t offset = seq * CHUNK_SIZE;
+            size_t bytes = bounded ? (size_t)std::min<uint64_t>(CHUNK_SIZE, stream.totalBytes - offset)
+                                   : CHUNK_SIZE;
+            bool wrote = stream.output.WriteAt(ring.Data(seq), bytes, offset);
+            Crypto::SecureZero(ring.Data(seq), CHUNK_SIZE);
+            ring.Release(seq);
+            if (!wrote) {
+                stream.failed = true;
+                stopStream(stream);
+                return;
+            }
+        }
+    };
+
+    // Single ordered writer: drains the stream's rings strictly in sequence
+    auto mergedWriter = [&](OutputStream& stream) {
+        auto RingFor = [&](uint64_t seq) -> ChunkRing& { return *stream.rings[seq % nodes]; };
+        const size_t retained = stream.retained;
+        const bool bounded = stream.totalBytes > 0;
+        uint64_t toWrite = stream.totalBytes;
+
+        // Chunks written zero-copy but possibly still referenced by the pipe: (seq, end offset)
+        std::deque<std::pair<uint64_t, uint64_t>> held;
+        uint64_t streamPos = 0;
+        auto releaseDrained = [&](bool all) {
+            while (!held.empty() && (all || streamPos - held.front().second >= retained)) {
+                uint64_t seq = held.front().first;
+                Crypto::SecureZero(RingFor(seq).Data(seq), CHUNK_SIZE);
+                RingFor(seq).Release(seq);
+                held.pop_front();
+            }
+        };
+
+        // The final `retained` bytes of a bounded run are copied, not spliced:
+        // once that copy fits in the pipe, every spliced page before it has been
+        // consumed and can be wiped safely before exit
+        const uint64_t copyFrom = bounded ? stream.totalBytes - std::min<uint64_t>(stream.totalBytes, retained)
+                                          : UINT64_MAX;
+
+        for (uint64_t seq = 0; !bounded || seq < stream.totalChunks; seq++) {
+            ChunkRing& ring = RingFor(seq);
+            if (!ring.WaitReady(seq)) break;
+            const uint8_t* chunk = ring.Data(seq);
+            size_t bytes = bounded ? (size_t)std::min<uint64_t>(CHUNK_SIZE, toWrite) : CHUNK_SIZE;
+
+            size_t zeroCopy = bytes;
+            if (streamPos + bytes > copyFrom) {
+                zeroCopy = streamPos >= copyFrom ? 0 : (size_t)(copyFrom - streamPos);
+            }
+            if (!stream.output.Write(chunk, zeroCopy) ||
+                !stream.output.WriteCopy(chunk + zeroCopy, bytes - zeroCopy)) {
+                stream.failed = true;
+                break;
+            }
+            streamPos += bytes;
+            if (bounded) toWrite -= bytes;
+
+            if (retained > 0 && zeroCopy > 0) {
+                held.emplace_back(seq, streamPos);
+            } else {
+                Crypto::SecureZero(ring.Data(seq), CHUNK_SIZE);
+                ring.Release(seq);
+            }
+            releaseDrained(false);
+        }
+
+        // Done or failed. After the copied tail (or a dead reader) no spliced page
+        // is still needed; stop this stream so the pool moves on to the others.
+        releaseDrained(true);
+        stopStream(stream);
+        // Close now so the reader sees EOF while other streams keep running
+        if (!stream.output.Close()) stream.failed = true;
+    };
 
-    while (true) {
-        // Pipeline: generate batchB while writing batchA
-        std::thread bg([&]() { generateBatch(batchB); });
-        bool ok = writeBatch(batchA);
-        bg.join();
-        if (!ok) break;
+    std::vector<std::thread> writers;
+    for (auto& stream : streams) {
+        if (stream->perNodeWriters) {
+            for (size_t r = 0; r < nodes; r++) writers.emplace_back(nodeWriter, std::ref(*stream), r);
+        } else {
+            writers.emplace_back(mergedWriter, std::ref(*stream));
+        }
+    }
+    for (auto& th : writers) th.join();
+
+    // All writers done: release any worker still looking for work, then join
+    for (auto& stream : streams) stopStream(*stream);
+    for (auto& th : workers) th.join();
+
+    bool ok = true;
+    for (auto& stream : streams) {
+        if (!stream->output.Close()) stream->failed = true;
+        // Endless streams end when their reader closes the pipe; that is not an error
+        if (stream->failed && stream->totalBytes > 0) {
+            fprintf(stderr, "trng_gen: %s: write failed before %llu bytes were written\n",
+                    stream->target.empty() ? "-" : stream->target.c_str(),
+                    (unsigned long long)stream->totalBytes);
+            ok = false;
+        }
+        Crypto::SecureClearVector(stream->seed);
+    }
 
-        // Pipeline: generate batchA while writing batchB
-        std::thread bg2([&]() { generateBatch(batchA); });
-        ok = writeBatch(batchB);
-        bg2.join();
-        if (!ok) break;
+    if (opt.check) {
+        uint64_t windows = 0;
+        uint64_t alarms = 0;
+        for (auto& check : checks) {
+            windows += check->WindowsTested();
+            alarms += check->AlarmCount();
+        }
+        fprintf(stderr, "trng_gen: check: %llu window(s) of %zu bytes tested, %llu alarm(s)%s\n",
+                (unsigned long long)windows, Stats::QuickBattery::DEFAULT_WINDOW, (unsigned long long)alarms,
+                checkFailed ? ", output stopped" : "");
+        if (checkFailed) ok = false;
     }
 
-    SecureZeroMemory(seed.data(), seed.size());
-    return 0;
+    Crypto::SecureZero(seed.data(), seed.size());
+    return ok ? 0 : 1;
 }
@@ -0,0 +1,200 @@
+/*
+ * trng_prefetch.c — Buffered libtrng feed for in-process test drivers
+ *
+ * Buffers move between two stacks: `empty` (producers take, fill, push to
+ * `full`) and `full` (the consumer takes one, reads it, returns it to `empty`).
+ * Order between buffers does not matter for statistical testing.
+ */
+
+#include "trng_prefetch.h"
+#include "../lib/trng.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/* Buffers per producer: one being filled, one waiting, plus the consumer's */
+#define BUFFERS_PER_PRODUCER 2
+
+struct trng_prefetch {
+    trng_ctx* ctx;
+    size_t buffer_bytes;
+    int buffer_count;
+    uint8_t** buffers;
+
+    /* Stacks of buffer indices */
+    int* empty;
+    int empty_count;
+    int* full;
+    int full_count;
+    int current;            /* Buffer held by the consumer, -1 = none */
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_empty;
+    pthread_cond_t cond_full;
+    int stopping;
+    int failed;
+
+    int thread_count;
+    pthread_t* threads;
+    uint64_t consumed;
+};
+
+static int hardware_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static void wipe(void* ptr, size_t len) {
+    volatile unsigned char* p = (volatile unsigned char*)ptr;
+    while (len--) *p++ = 0;
+}
+
+static void* producer(void* arg) {
+    trng_prefetch* pf = (trng_prefetch*)arg;
+    for (;;) {
+        pthread_mutex_lock(&pf->mutex);
+        while (!pf->stopping && pf->empty_count == 0) pthread_cond_wait(&pf->cond_empty, &pf->mutex);
+        if (pf->stopping) {
+            pthread_mutex_unlock(&pf->mutex);
+            return NULL;
+        }
+        int index = pf->empty[--pf->empty_count];
+        pthread_mutex_unlock(&pf->mutex);
+
+        int rc = trng_fill(pf->ctx, pf->buffers[index], pf->buffer_bytes);
+
+        pthread_mutex_lock(&pf->mutex);
+        if (rc != TRNG_OK) {
+            fprintf(stderr, "trng_prefetch: trng_fill failed: %s\n", trng_strerror(rc));
+            pf->failed = 1;
+            pf->stopping = 1;
+            pthread_cond_broadcast(&pf->cond_full);
+            pthread_cond_broadcast(&pf->cond_empty);
+            pthread_mutex_unlock(&pf->mutex);
+            return NULL;
+        }
+        pf->full[pf->full_count++] = index;
+        pthread_cond_signal(&pf->cond_full);
+        pthread_mutex_unlock(&pf->mutex);
+    }
+}
+
+trng_prefetch* trng_prefetch_open(int threads, size_t buffer_bytes) {
+    if (threads <= 0) {
+        threads = hardware_threads() - 1;
+        if (threads < 1) threads = 1;
+    }
+    if (buffer_bytes == 0) buffer_bytes = TRNG_PREFETCH_DEFAULT_BUFFER;
+    buffer_bytes = (buffer_bytes + 7) & ~(size_t)7;
+
+    trng_prefetch* pf = (trng_prefetch*)calloc(1, sizeof(*pf));
+    if (!pf) return NULL;
+
+    int rc = trng_open(&pf->ctx, NULL);
+    if (rc != TRNG_OK) {
+        fprintf(stderr, "trng_prefetch: trng_open failed: %s\n", trng_strerror(rc));
+        free(pf);
+        return NULL;
+    }
+
+    pf->buffer_bytes = buffer_bytes;
+    pf->buffer_count = threads * BUFFERS_PER_PRODUCER + 1;
+    pf->buffers = (uint8_t**)calloc((size_t)pf->buffer_count, sizeof(uint8_t*));
+    pf->empty = (int*)calloc((size_t)pf->buffer_count, sizeof(int));
+    pf->full = (int*)calloc((size_t)pf->buffer_count, sizeof(int));
+    pf->threads = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    pf->current = -1;
+    if (!pf->buffers || !pf->empty || !pf->full || !pf->threads) {
+        trng_prefetch_close(pf);
+        return NULL;
+    }
+    for (int i = 0; i < pf->buffer_count; i++) {
+        pf->buffers[i] = (uint8_t*)malloc(buffer_bytes);
+        if (!pf->buffers[i]) {
+            trng_prefetch_close(pf);
+            return NULL;
+        }
+        pf->empty[pf->empty_count++] = i;
+    }
+
+    pthread_mutex_init(&pf->mutex, NULL);
+    pthread_cond_init(&pf->cond_empty, NULL);
+    pthread_cond_init(&pf->cond_full, NULL);
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&pf->threads[t], NULL, producer, pf) != 0) break;
+        pf->thread_count++;
+    }
+    if (pf->thread_count == 0) {
+        trng_prefetch_close(pf);
+        return NULL;
+    }
+    return pf;
+}
+
+const uint8_t* trng_prefetch_next(trng_prefetch* pf, size_t* len) {
+    pthread_mutex_lock(&pf->mutex);
+    if (pf->current >= 0) {
+        pf->empty[pf->empty_count++] = pf->current;
+        pf->current = -1;
+        pthread_cond_signal(&pf->cond_empty);
+    }
+    while (!pf->failed && pf->full_count == 0) pthread_cond_wait(&pf->cond_full, &pf->mutex);
+    if (pf->failed) {
+        pthread_mutex_unlock(&pf->mutex);
+        *len = 0;
+        return NULL;
+    }
+    pf->current = pf->full[--pf->full_count];
+    pf->consumed += pf->buffer_bytes;
+    pthread_mutex_unlock(&pf->mutex);
+
+    *len = pf->buffer_bytes;
+    return pf->buffers[pf->current];
+}
+
+uint64_t trng_prefetch_consumed(const trng_prefetch* pf) {
+    return pf->consumed;
+}
+
+void trng_prefetch_close(trng_prefetch* pf) {
+    if (!pf) return;
+    if (pf->thread_count > 0) {
+        pthread_mutex_lock(&pf->mutex);
+        pf->stopping = 1;
+        pthread_cond_broadcast(&pf->cond_empty);
+        pthread_mutex_unlock(&pf->mutex);
+        for (int t = 0; t < pf->thread_count; t++) pthread_join(pf->threads[t], NULL);
+    }
+    if (pf->buffers) {
+        for (int i = 0; i < pf->buffer_count; i++) {
+            if (!pf->buffers[i]) continue;
+            wipe(pf->buffers[i], pf->buffer_bytes);
+            free(pf->buffers[i]);
+        }
+    }
+    if (pf->thread_count > 0) {
+        pthread_mutex_destroy(&pf->mutex);
+        pthread_cond_destroy(&pf->cond_empty);
+        pthread_cond_destroy(&pf->cond_full);
+    }
+    trng_close(pf->ctx);
+    free(pf->buffers);
+    free(pf->empty);
+    free(pf->full);
+    free(pf->threads);
+    free(pf);
+}
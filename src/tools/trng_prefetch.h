@@ -0,0 +1,42 @@
+/*
+ * trng_prefetch.h — Buffered libtrng feed for in-process test drivers
+ *
+ * Producer threads keep a small pool of large buffers filled with trng_fill
+ * while the (single-threaded) test battery consumes the current one, so
+ * generation overlaps testing and no pipe or second process is involved.
+ * Used by testu01_direct.c and practrand_direct.cpp.
+ */
+
+#ifndef TRNG_PREFETCH_H
+#define TRNG_PREFETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRNG_PREFETCH_DEFAULT_BUFFER (4u << 20)   /* 4 MiB per buffer */
+
+typedef struct trng_prefetch trng_prefetch;
+
+/* threads <= 0: one producer per hardware thread minus one (at least 1).
+   buffer_bytes is rounded up to a multiple of 8. NULL on failure. */
+trng_prefetch* trng_prefetch_open(int threads, size_t buffer_bytes);
+
+/* Hand back the previous buffer and return the next full one (never NULL
+   unless generation failed). *len receives its size in bytes. */
+const uint8_t* trng_prefetch_next(trng_prefetch* pf, size_t* len);
+
+/* Bytes handed to the consumer so far */
+uint64_t trng_prefetch_consumed(const trng_prefetch* pf);
+
+/* Stop producers, wipe and free every buffer */
+void trng_prefetch_close(trng_prefetch* pf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRNG_PREFETCH_H */
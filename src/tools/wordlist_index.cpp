@@ -0,0 +1,40 @@
+/*
+ * wordlist_index.cpp — Precompute the passphrase wordlist index
+ *
+ * Converts a newline-separated wordlist into the index format WordList maps
+ * in place (offset table + contiguous blob), so the GUI loads it without
+ * parsing or copying the text. Place the output next to TRNG.exe as
+ * assets/default_wordlist.twl, or load it as a custom wordlist.
+ *
+ * Usage:
+ *   ./wordlist_index assets/default_wordlist.txt assets/default_wordlist.twl
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o wordlist_index src/tools/wordlist_index.cpp src/logic/wordlist.cpp \
+ *       src/platform/mapped_file.cpp
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "../logic/wordlist.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <wordlist.txt> <output.twl>\n", argv[0]);
+        return 1;
+    }
+
+    WordList list;
+    std::string error;
+    if (!list.LoadFile(argv[1], error)) {
+        fprintf(stderr, "wordlist_index: %s\n", error.c_str());
+        return 1;
+    }
+    if (!list.WriteIndex(argv[2], error)) {
+        fprintf(stderr, "wordlist_index: %s\n", error.c_str());
+        return 1;
+    }
+    printf("%zu words, longest %zu bytes -> %s\n", list.Size(), list.MaxWordBytes(), argv[2]);
+    return 0;
+}